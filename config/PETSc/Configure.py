@@ -142,7 +142,8 @@ class Configure(config.base.Configure):
                                             'unistd', 'sys/sysinfo', 'machine/endian', 'sys/param', 'sys/procfs', 'sys/resource',
                                             'sys/systeminfo', 'sys/times', 'sys/utsname','string', 'stdlib',
                                             'sys/socket','sys/wait','netinet/in','netdb','Direct','time','Ws2tcpip','sys/types',
-                                            'WindowsX', 'cxxabi','float','ieeefp','stdint','sched','pthread','inttypes','immintrin','zmmintrin'])
+                                            'WindowsX', 'cxxabi','float','ieeefp','stdint','sched','pthread','inttypes','immintrin','zmmintrin',
+                                            'linux/perf_event'])
     functions = ['access', '_access', 'clock', 'drand48', 'getcwd', '_getcwd', 'getdomainname', 'gethostname',
                  'gettimeofday', 'getwd', 'memalign', 'memmove', 'mkstemp', 'popen', 'PXFGETARG', 'rand', 'getpagesize',
                  'readlink', 'realpath',  'sigaction', 'signal', 'sigset', 'usleep', 'sleep', '_sleep', 'socket',
@@ -822,6 +823,15 @@ fprintf(f, "%lu\\n", (unsigned long)sizeof(struct mystruct));
       self.addDefine('HAVE_BUILTIN_EXPECT', 1)
     self.popLanguage()
 
+  def configureTargetAttribute(self):
+    '''Sees if functions can be compiled for a given instruction set with __attribute((target())) and selected at run time with __builtin_cpu_supports()'''
+    self.pushLanguage(self.languages.clanguage)
+    if self.checkCompile('#include <immintrin.h>\n__attribute((target("avx512f"))) static double f(const double *x,const int *i) {return _mm512_reduce_add_pd(_mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*)i),x,8));}\n', 'double x[8] = {0};int i[8] = {0};\nreturn (int)f(x,i);'):
+      self.addDefine('HAVE_ATTRIBUTE_TARGET', 1)
+    if self.checkLink('', 'if (__builtin_cpu_supports("avx2") || __builtin_cpu_supports("avx512f")) return 1;'):
+      self.addDefine('HAVE_BUILTIN_CPU_SUPPORTS', 1)
+    self.popLanguage()
+
   def configureFunctionName(self):
     '''Sees if the compiler supports __func__ or a variant.'''
     def getFunctionName(lang):
@@ -1089,6 +1099,7 @@ fprintf(f, "%lu\\n", (unsigned long)sizeof(struct mystruct));
     self.executeTest(self.configureDeprecated)
     self.executeTest(self.configureIsatty)
     self.executeTest(self.configureExpect);
+    self.executeTest(self.configureTargetAttribute);
     self.executeTest(self.configureAlign);
     self.executeTest(self.configureFunctionName);
     self.executeTest(self.configureIntptrt);
@@ -91,6 +91,12 @@
 #define MATAIJPERM         'aijperm'
 #define MATSEQAIJPERM      'seqaijperm'
 #define MATMPIAIJPERM      'mpiaijperm'
+#define MATAIJAUTOTUNE     'aijautotune'
+#define MATSEQAIJAUTOTUNE  'seqaijautotune'
+#define MATMPIAIJAUTOTUNE  'mpiaijautotune'
+#define MATAIJMIXED        'aijmixed'
+#define MATSEQAIJMIXED     'seqaijmixed'
+#define MATMPIAIJMIXED     'mpiaijmixed'
 #define MATAIJMKL          'aijmkl'
 #define MATSEQAIJMKL       'seqaijmkl'
 #define MATMPIAIJMKL       'mpiaijmkl'
@@ -161,6 +167,7 @@
 #define MATSOLVERMATLAB          'matlab'
 #define MATSOLVERPETSC           'petsc'
 #define MATSOLVERBAS             'bas'
+#define MATSOLVERCHOWILU         'chowilu'
 #define MATSOLVERCUSPARSE        'cusparse'
 
 !
@@ -8,6 +8,8 @@
 #include <petscdmda.h>
 #include <petsc/private/dmimpl.h>
 
+typedef struct _n_DMDAHalo *DMDAHalo;
+
 typedef struct {
   PetscInt              M,N,P;                 /* array dimensions */
   PetscInt              m,n,p;                 /* processor layout */
@@ -71,6 +73,11 @@ typedef struct {
   /* used by DMDASetMatPreallocateOnly() */
   PetscBool             prealloc_only;
   PetscInt              preallocCenterDim; /* Dimension of the points which connect adjacent points for preallocation */
+
+  /* used by DMDASetStridedGhostUpdate() */
+  PetscBool             stridedghost;        /* update the ghost points with strided copies of grid boxes instead of gtol */
+  PetscBool             stridedghoststar;    /* exchange only the ghost points of a star stencil */
+  DMDAHalo              halo;                /* created at the first update */
 } DM_DA;
 
 /*
@@ -95,5 +102,9 @@ PETSC_INTERN PetscErrorCode DMView_DA_VTK(DM,PetscViewer);
 PETSC_INTERN PetscErrorCode DMView_DA_GLVis(DM,PetscViewer);
 PETSC_EXTERN PetscErrorCode DMDAVTKWriteAll(PetscObject,PetscViewer);
 PETSC_EXTERN PetscErrorCode DMDASelectFields(DM,PetscInt*,PetscInt**);
+PETSC_INTERN PetscErrorCode DMDAHaloGetActive_Private(DM,InsertMode,PetscBool*);
+PETSC_INTERN PetscErrorCode DMDAHaloBegin_Private(DM,Vec,InsertMode,Vec);
+PETSC_INTERN PetscErrorCode DMDAHaloEnd_Private(DM,Vec,InsertMode,Vec);
+PETSC_INTERN PetscErrorCode DMDAHaloDestroy_Private(DMDAHalo*);
 
 #endif
@@ -455,6 +455,57 @@ M*/
 .seealso: PetscHSetTGetSize(), PetscHMapTGetKeys()
 M*/
 
+/*MC
+  PetscHMapTGetMany - Get the values for several keys in the hash table
+
+  Synopsis:
+  #include <petsc/private/hashmap.h>
+  PetscErrorCode PetscHMapTGetMany(PetscHMapT ht,PetscInt n,const KeyType keys[],ValType vals[])
+
+  Input Parameters:
++ ht   - The hash table
+. n    - The number of keys
+- keys - The keys
+
+  Output Parameter:
+. vals - The values, the default value of the table for missing keys
+
+  Notes:
+  keys and vals may be the same array.
+
+  Level: developer
+
+  Concepts: hash table, map
+
+.keywords: hash table, map, get
+.seealso:  PetscHMapTGet(), PetscHMapTSetMany()
+M*/
+
+/*MC
+  PetscHMapTSetMany - Set several (key,value) entries in the hash table
+
+  Synopsis:
+  #include <petsc/private/hashmap.h>
+  PetscErrorCode PetscHMapTSetMany(PetscHMapT ht,PetscInt n,const KeyType keys[],const ValType vals[])
+
+  Input Parameters:
++ ht   - The hash table
+. n    - The number of entries
+. keys - The keys
+- vals - The values
+
+  Notes:
+  The table is grown once, up front, to hold n more entries, rather than being rehashed several times
+  during the insertions.
+
+  Level: developer
+
+  Concepts: hash table, map
+
+.keywords: hash table, map, set
+.seealso: PetscHMapTSet(), PetscHMapTGetMany()
+M*/
+
 #define PETSC_HASH_MAP(HashT, KeyType, ValType, HashFunc, EqualFunc, DefaultValue)                   \
                                                                                                      \
 KHASH_INIT(HashT, KeyType, ValType, 1, HashFunc, EqualFunc)                                          \
@@ -702,5 +753,44 @@ PetscErrorCode Petsc##HashT##GetVals(Petsc##HashT ht,PetscInt *off,ValType array
   *off = pos;                                                                                        \
   PetscFunctionReturn(0);                                                                            \
 }                                                                                                    \
+                                                                                                     \
+PETSC_STATIC_INLINE PETSC_UNUSED                                                                     \
+PetscErrorCode Petsc##HashT##GetMany(Petsc##HashT ht,PetscInt n,const KeyType keys[],ValType vals[]) \
+{                                                                                                    \
+  PetscInt i;                                                                                        \
+  khiter_t iter;                                                                                     \
+  PetscFunctionBeginHot;                                                                             \
+  PetscValidPointer(ht,1);                                                                           \
+  if (n) PetscValidPointer(keys,3);                                                                  \
+  if (n) PetscValidPointer(vals,4);                                                                  \
+  for (i=0; i<n; i++) {                                                                              \
+    iter    = kh_get(HashT,ht,keys[i]);                                                              \
+    vals[i] = (iter != kh_end(ht)) ? kh_val(ht,iter) : (DefaultValue);                               \
+  }                                                                                                  \
+  PetscFunctionReturn(0);                                                                            \
+}                                                                                                    \
+                                                                                                     \
+PETSC_STATIC_INLINE PETSC_UNUSED                                                                     \
+PetscErrorCode Petsc##HashT##SetMany(Petsc##HashT ht,PetscInt n,                                     \
+                                      const KeyType keys[],const ValType vals[])                     \
+{                                                                                                    \
+  int      ret;                                                                                      \
+  PetscInt i;                                                                                        \
+  khiter_t iter;                                                                                     \
+  PetscFunctionBeginHot;                                                                             \
+  PetscValidPointer(ht,1);                                                                           \
+  if (n) PetscValidPointer(keys,3);                                                                  \
+  if (n) PetscValidPointer(vals,4);                                                                  \
+  if (kh_size(ht) + (khint_t)n > ht->upper_bound) {                                                  \
+    ret = kh_resize(HashT,ht,(khint_t)((kh_size(ht) + n)/__ac_HASH_UPPER) + 1);                      \
+    PetscHashAssert(ret>=0);                                                                         \
+  }                                                                                                  \
+  for (i=0; i<n; i++) {                                                                              \
+    iter = kh_put(HashT,ht,keys[i],&ret);                                                            \
+    PetscHashAssert(ret>=0);                                                                         \
+    kh_val(ht,iter) = vals[i];                                                                       \
+  }                                                                                                  \
+  PetscFunctionReturn(0);                                                                            \
+}                                                                                                    \
 
 #endif /* _PETSC_HASHMAP_H */
@@ -298,6 +298,26 @@ M*/
 .seealso: PetscHSetTGetSize()
 M*/
 
+/*MC
+  PetscHSetTAddMany - Add several entries to the hash table
+
+  Synopsis:
+  #include <petsc/private/hashset.h>
+  PetscErrorCode PetscHSetTAddMany(PetscHSetT ht,PetscInt n,const KeyType keys[])
+
+  Input Parameters:
++ ht   - The hash table
+. n    - The number of entries
+- keys - The entries, possibly with repetitions
+
+  Level: developer
+
+  Concepts: hash table, set
+
+.keywords: hash table, set, add
+.seealso: PetscHSetTAdd(), PetscHSetTGetElems()
+M*/
+
 #define PETSC_HASH_SET(HashT, KeyType, HashFunc, EqualFunc)                                          \
                                                                                                      \
 KHASH_INIT(HashT, KeyType, char, 0, HashFunc, EqualFunc)                                             \
@@ -458,5 +478,21 @@ PetscErrorCode Petsc##HashT##GetElems(Petsc##HashT ht,PetscInt *off,KeyType arra
   *off = pos;                                                                                        \
   PetscFunctionReturn(0);                                                                            \
 }                                                                                                    \
+                                                                                                     \
+PETSC_STATIC_INLINE PETSC_UNUSED                                                                     \
+PetscErrorCode Petsc##HashT##AddMany(Petsc##HashT ht,PetscInt n,const KeyType keys[])                \
+{                                                                                                    \
+  int      ret;                                                                                      \
+  PetscInt i;                                                                                        \
+  khiter_t iter;                                                                                     \
+  PetscFunctionBeginHot;                                                                             \
+  PetscValidPointer(ht,1);                                                                           \
+  if (n) PetscValidPointer(keys,3);                                                                  \
+  for (i=0; i<n; i++) {                                                                              \
+    iter = kh_put(HashT,ht,keys[i],&ret); (void)iter;                                                \
+    PetscHashAssert(ret>=0);                                                                         \
+  }                                                                                                  \
+  PetscFunctionReturn(0);                                                                            \
+}                                                                                                    \
 
 #endif /* _PETSC_HASHSET_H */
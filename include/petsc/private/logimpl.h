@@ -50,6 +50,12 @@ PETSC_EXTERN const char    *petsc_traceblanks;
 PETSC_EXTERN char           petsc_tracespace[128];
 PETSC_EXTERN PetscLogDouble petsc_tracetime;
 
+/* Hardware counters of the events */
+PETSC_EXTERN PetscBool      petsc_log_hwcounters;
+PETSC_EXTERN char           petsc_log_hwcounters_error[256];
+PETSC_EXTERN PetscLogDouble petsc_log_hwcounters_linesize;
+PETSC_EXTERN PetscErrorCode PetscLogHWCountersRead(PetscLogDouble*,PetscLogDouble*,PetscLogDouble*);
+
 #ifdef PETSC_USE_LOG
 
 PETSC_EXTERN PetscErrorCode PetscIntStackCreate(PetscIntStack *);
@@ -361,6 +361,10 @@ typedef struct {
 } Mat_CompressedRow;
 PETSC_EXTERN PetscErrorCode MatCheckCompressedRow(Mat,PetscInt,Mat_CompressedRow*,PetscInt*,PetscInt,PetscReal);
 
+/* Instruction set used by the SeqAIJ and SeqSELL kernels selected at run time, see PetscGetSIMDType() */
+PETSC_EXTERN PetscErrorCode MatGetSIMDType(PetscSIMDType*);
+PETSC_INTERN PetscErrorCode MatSIMDInitializePackage_Private(void);
+
 typedef struct { /* used by MatCreateRedundantMatrix() for reusing matredundant */
   PetscInt     nzlocal,nsends,nrecvs;
   PetscMPIInt  *send_rank,*recv_rank;
@@ -410,6 +414,7 @@ struct _p_Mat {
   MatFactorError         factorerrortype;               /* type of error in factorization */
   PetscReal              factorerror_zeropivot_value;   /* If numerical zero pivot was detected this is the computed value */
   PetscInt               factorerror_zeropivot_row;     /* Row where zero pivot was detected */
+  PetscErrorCode         (*multsetup)(Mat);             /* called once by the next MatMult() before the product, see MATAIJAUTOTUNE */
 };
 
 PETSC_INTERN PetscErrorCode MatAXPY_Basic(Mat,PetscScalar,Mat,MatStructure);
@@ -903,6 +903,14 @@ PETSC_INTERN PetscSpinlock PetscCommSpinLock;
 #endif
 #endif
 
+/*
+    Instruction set extensions for which some kernels (SeqAIJ and SeqSELL MatMult(), the tiled VecMDot() and VecMAXPY())
+    have variants that are selected at run time
+*/
+typedef enum {PETSC_SIMD_NONE,PETSC_SIMD_AVX2,PETSC_SIMD_AVX512} PetscSIMDType;
+PETSC_EXTERN const char *const PetscSIMDTypes[];
+PETSC_EXTERN PetscErrorCode PetscGetSIMDType(const char[],PetscSIMDType*);
+
 PETSC_EXTERN PetscLogEvent PETSC_Barrier;
 PETSC_EXTERN PetscLogEvent PETSC_BuildTwoSided;
 PETSC_EXTERN PetscLogEvent PETSC_BuildTwoSidedF;
@@ -13,6 +13,9 @@ PETSC_EXTERN PetscLogEvent PETSCSF_ReduceBegin;
 PETSC_EXTERN PetscLogEvent PETSCSF_ReduceEnd;
 PETSC_EXTERN PetscLogEvent PETSCSF_FetchAndOpBegin;
 PETSC_EXTERN PetscLogEvent PETSCSF_FetchAndOpEnd;
+PETSC_EXTERN PetscLogEvent PETSCSF_Pack;
+PETSC_EXTERN PetscLogEvent PETSCSF_Unpack;
+PETSC_EXTERN PetscLogEvent PETSCSF_Wait;
 
 struct _PetscSFOps {
   PetscErrorCode (*Reset)(PetscSF);
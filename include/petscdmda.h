@@ -113,6 +113,8 @@ PETSC_EXTERN PetscErrorCode DMDAGetOwnershipRanges(DM,const PetscInt**,const Pet
 PETSC_EXTERN PetscErrorCode DMDASetNumProcs(DM, PetscInt, PetscInt, PetscInt);
 PETSC_EXTERN PetscErrorCode DMDASetStencilType(DM, DMDAStencilType);
 PETSC_EXTERN PetscErrorCode DMDAGetStencilType(DM, DMDAStencilType*);
+PETSC_EXTERN PetscErrorCode DMDASetStridedGhostUpdate(DM,PetscBool,PetscBool);
+PETSC_EXTERN PetscErrorCode DMDAGetStridedGhostUpdate(DM,PetscBool*,PetscBool*);
 
 PETSC_EXTERN PetscErrorCode DMDAVecGetArray(DM,Vec,void *);
 PETSC_EXTERN PetscErrorCode DMDAVecRestoreArray(DM,Vec,void *);
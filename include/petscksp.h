@@ -38,6 +38,7 @@ typedef const char* KSPType;
 #define KSPPIPECG     "pipecg"
 #define KSPPIPECGRR   "pipecgrr"
 #define KSPPIPELCG     "pipelcg"
+#define KSPSCG        "scg"
 #define   KSPCGNE       "cgne"
 #define   KSPCGNASH     "nash"
 #define   KSPCGSTCG     "stcg"
@@ -50,6 +51,7 @@ typedef const char* KSPType;
 #define   KSPLGMRES     "lgmres"
 #define   KSPDGMRES     "dgmres"
 #define   KSPPGMRES     "pgmres"
+#define   KSPSGMRES     "sgmres"
 #define KSPTCQMR      "tcqmr"
 #define KSPBCGS       "bcgs"
 #define   KSPIBCGS      "ibcgs"
@@ -204,6 +206,7 @@ PETSC_EXTERN PetscErrorCode KSPGMRESGetRestart(KSP, PetscInt*);
 PETSC_EXTERN PetscErrorCode KSPGMRESSetHapTol(KSP,PetscReal);
 
 PETSC_EXTERN PetscErrorCode KSPGMRESSetPreAllocateVectors(KSP);
+PETSC_EXTERN PetscErrorCode KSPGMRESSetContiguousBasis(KSP,PetscBool);
 PETSC_EXTERN PetscErrorCode KSPGMRESSetOrthogonalization(KSP,PetscErrorCode (*)(KSP,PetscInt));
 PETSC_EXTERN PetscErrorCode KSPGMRESGetOrthogonalization(KSP,PetscErrorCode (**)(KSP,PetscInt));
 PETSC_EXTERN PetscErrorCode KSPGMRESModifiedGramSchmidtOrthogonalization(KSP,PetscInt);
@@ -212,6 +215,26 @@ PETSC_EXTERN PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP,Pe
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetAugDim(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetConstant(KSP);
 
+/*E
+    KSPSStepBasisType - The polynomial basis in which the s-step methods KSPSCG and KSPSGMRES generate the
+    Krylov vectors of each block
+
+$   KSP_SSTEP_BASIS_MONOMIAL  - v_{j+1} = A v_j, simple but ill-conditioned for larger s
+$   KSP_SSTEP_BASIS_NEWTON    - v_{j+1} = (A - theta_j) v_j, with shifts at Leja ordered Chebyshev points of the spectrum
+$   KSP_SSTEP_BASIS_CHEBYSHEV - Chebyshev polynomials scaled to the spectrum
+
+   Level: advanced
+
+.seealso: KSPSCG, KSPSGMRES, KSPSStepSetBasisType(), KSPSStepSetEigenvalues()
+E*/
+typedef enum {KSP_SSTEP_BASIS_MONOMIAL,KSP_SSTEP_BASIS_NEWTON,KSP_SSTEP_BASIS_CHEBYSHEV} KSPSStepBasisType;
+PETSC_EXTERN const char *const KSPSStepBasisTypes[];
+
+PETSC_EXTERN PetscErrorCode KSPSStepSetSteps(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPSStepGetSteps(KSP,PetscInt*);
+PETSC_EXTERN PetscErrorCode KSPSStepSetBasisType(KSP,KSPSStepBasisType);
+PETSC_EXTERN PetscErrorCode KSPSStepSetEigenvalues(KSP,PetscReal,PetscReal);
+
 PETSC_EXTERN PetscErrorCode KSPPIPEFGMRESSetShift(KSP,PetscScalar);
 
 PETSC_EXTERN PetscErrorCode KSPGCRSetRestart(KSP,PetscInt);
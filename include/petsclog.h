@@ -131,6 +131,9 @@ typedef struct {
   PetscLogDouble numMessages;   /* The number of messages in this event */
   PetscLogDouble messageLength; /* The total message lengths in this event */
   PetscLogDouble numReductions; /* The number of reductions in this event */
+  PetscLogDouble cycles;        /* The number of processor cycles in this event, see PetscLogHWCountersBegin() */
+  PetscLogDouble instructions;  /* The number of instructions completed in this event */
+  PetscLogDouble cacheMisses;   /* The number of last level cache misses in this event */
 } PetscEventPerfInfo;
 
 typedef struct _n_PetscEventRegLog *PetscEventRegLog;
@@ -233,6 +236,9 @@ PETSC_EXTERN PetscErrorCode PetscLogDefaultBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogAllBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogNestedBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogTraceBegin(FILE *);
+PETSC_EXTERN PetscErrorCode PetscLogTraceJSONBegin(PetscInt);
+PETSC_EXTERN PetscErrorCode PetscLogTraceJSONDump(const char[]);
+PETSC_EXTERN PetscErrorCode PetscLogHWCountersBegin(void);
 PETSC_EXTERN PetscErrorCode PetscLogActions(PetscBool);
 PETSC_EXTERN PetscErrorCode PetscLogObjects(PetscBool);
 PETSC_EXTERN PetscErrorCode PetscLogSetThreshold(PetscLogDouble,PetscLogDouble*);
@@ -462,6 +468,9 @@ PETSC_EXTERN PetscErrorCode PetscLogObjectState(PetscObject,const char[],...);
 #define PetscLogAllBegin()                 0
 #define PetscLogNestedBegin()              0
 #define PetscLogTraceBegin(file)           0
+#define PetscLogTraceJSONBegin(size)       0
+#define PetscLogTraceJSONDump(file)        0
+#define PetscLogHWCountersBegin()          0
 #define PetscLogActions(a)                 0
 #define PetscLogObjects(a)                 0
 #define PetscLogSetThreshold(a,b)          0
@@ -45,6 +45,12 @@ typedef const char* MatType;
 #define MATAIJPERM         "aijperm"
 #define MATSEQAIJPERM      "seqaijperm"
 #define MATMPIAIJPERM      "mpiaijperm"
+#define MATAIJAUTOTUNE     "aijautotune"
+#define MATSEQAIJAUTOTUNE  "seqaijautotune"
+#define MATMPIAIJAUTOTUNE  "mpiaijautotune"
+#define MATAIJMIXED        "aijmixed"
+#define MATSEQAIJMIXED     "seqaijmixed"
+#define MATMPIAIJMIXED     "mpiaijmixed"
 #define MATAIJMKL          "aijmkl"
 #define MATSEQAIJMKL       "seqaijmkl"
 #define MATMPIAIJMKL       "mpiaijmkl"
@@ -116,6 +122,7 @@ typedef const char* MatSolverType;
 #define MATSOLVERMATLAB           "matlab"
 #define MATSOLVERPETSC            "petsc"
 #define MATSOLVERBAS              "bas"
+#define MATSOLVERCHOWILU          "chowilu"
 #define MATSOLVERCUSPARSE         "cusparse"
 
 /*E
@@ -1010,6 +1017,7 @@ PETSC_EXTERN PetscErrorCode MatInodeAdjustForInodes(Mat,IS*,IS*);
 PETSC_EXTERN PetscErrorCode MatInodeGetInodeSizes(Mat,PetscInt *,PetscInt *[],PetscInt *);
 
 PETSC_EXTERN PetscErrorCode MatSeqAIJSetColumnIndices(Mat,PetscInt[]);
+PETSC_EXTERN PetscErrorCode MatSeqAIJSetHashAssembly(Mat,PetscBool);
 PETSC_EXTERN PetscErrorCode MatSeqBAIJSetColumnIndices(Mat,PetscInt[]);
 PETSC_EXTERN PetscErrorCode MatCreateSeqAIJWithArrays(MPI_Comm,PetscInt,PetscInt,PetscInt[],PetscInt[],PetscScalar[],Mat*);
 PETSC_EXTERN PetscErrorCode MatCreateSeqBAIJWithArrays(MPI_Comm,PetscInt,PetscInt,PetscInt,PetscInt[],PetscInt[],PetscScalar[],Mat*);
@@ -1134,6 +1142,7 @@ typedef struct {
   PetscReal     zeropivot;      /* pivot is called zero if less than this */
   PetscReal     shifttype;      /* type of shift added to matrix factor to prevent zero pivots */
   PetscReal     shiftamount;     /* how large the shift is */
+  PetscReal     solveiterative;  /* number of Jacobi sweeps replacing each triangular solve of MatSolve(), 0 for the exact solves */
 } MatFactorInfo;
 
 PETSC_EXTERN PetscErrorCode MatFactorInfoInitialize(MatFactorInfo*);
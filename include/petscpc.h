@@ -142,6 +142,8 @@ PETSC_EXTERN PetscErrorCode PCFactorSetPivotInBlocks(PC,PetscBool);
 
 PETSC_EXTERN PetscErrorCode PCFactorSetLevels(PC,PetscInt);
 PETSC_EXTERN PetscErrorCode PCFactorGetLevels(PC,PetscInt*);
+PETSC_EXTERN PetscErrorCode PCFactorSetSolveIterative(PC,PetscInt);
+PETSC_EXTERN PetscErrorCode PCFactorGetSolveIterative(PC,PetscInt*);
 PETSC_EXTERN PetscErrorCode PCFactorSetDropTolerance(PC,PetscReal,PetscReal,PetscInt);
 PETSC_EXTERN PetscErrorCode PCFactorGetZeroPivot(PC,PetscReal*);
 PETSC_EXTERN PetscErrorCode PCFactorGetShiftAmount(PC,PetscReal*);
@@ -16,17 +16,23 @@ PETSC_EXTERN PetscClassId PETSCSF_CLASSID;
    Level: beginner
 
    Notes:
-    The two approaches provided are
-$     PETSCSFBASIC which uses MPI 1 message passing to perform the communication and
+    The approaches provided are
+$     PETSCSFBASIC which uses MPI 1 message passing to perform the communication,
 $     PETSCSFWINDOW which uses MPI 2 one-sided operations to perform the communication, this may be more efficient,
 $                   but may not be available for all MPI distributions. In particular OpenMPI has bugs in its one-sided
-$                   operations that prevent its use.
+$                   operations that prevent its use,
+$     PETSCSFNEIGHBOR which uses the MPI 3 neighborhood collective MPI_Ineighbor_alltoallv() on the packed buffers of
+$                   PETSCSFBASIC, letting the MPI implementation schedule all the messages of an operation at once, and
+$     PETSCSFSHARED which exchanges the data of processes on the same node through MPI 3 shared memory windows, the
+$                   leaves reading directly the values packed by the roots, and uses PETSCSFBASIC between nodes.
 
 .seealso: PetscSFSetType(), PetscSF
 J*/
 typedef const char *PetscSFType;
-#define PETSCSFBASIC  "basic"
-#define PETSCSFWINDOW "window"
+#define PETSCSFBASIC    "basic"
+#define PETSCSFWINDOW   "window"
+#define PETSCSFNEIGHBOR "neighbor"
+#define PETSCSFSHARED   "shared"
 
 /*E
     PetscSFWindowSyncType - Type of synchronization for PETSCSFWINDOW
@@ -251,6 +251,7 @@ PETSC_EXTERN PetscErrorCode VecSwap(Vec,Vec);
 PETSC_EXTERN PetscErrorCode VecAXPY(Vec,PetscScalar,Vec);
 PETSC_EXTERN PetscErrorCode VecAXPBY(Vec,PetscScalar,PetscScalar,Vec);
 PETSC_EXTERN PetscErrorCode VecMAXPY(Vec,PetscInt,const PetscScalar[],Vec[]);
+PETSC_EXTERN PetscErrorCode VecMultiSetTileSize(PetscInt);
 PETSC_EXTERN PetscErrorCode VecAYPX(Vec,PetscScalar,Vec);
 PETSC_EXTERN PetscErrorCode VecWAXPY(Vec,PetscScalar,Vec,Vec);
 PETSC_EXTERN PetscErrorCode VecAXPBYPCZ(Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec);
@@ -434,6 +435,27 @@ PETSC_EXTERN PetscErrorCode VecMTDotBegin(Vec,PetscInt,const Vec[],PetscScalar[]
 PETSC_EXTERN PetscErrorCode VecMTDotEnd(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm);
 
+/*S
+     VecFusedOps - A short sequence of vector operations recorded with VecFusedOpsAXPY(), VecFusedOpsDot(), etc
+       and performed by VecFusedOpsExecute() in one pass over the vectors with one global reduction
+
+   Level: advanced
+
+.seealso:  VecFusedOpsCreate(), VecFusedOpsExecute(), VecFusedOpsDestroy()
+S*/
+typedef struct _n_VecFusedOps* VecFusedOps;
+PETSC_EXTERN PetscErrorCode VecFusedOpsCreate(VecFusedOps*);
+PETSC_EXTERN PetscErrorCode VecFusedOpsDestroy(VecFusedOps*);
+PETSC_EXTERN PetscErrorCode VecFusedOpsAXPY(VecFusedOps,Vec,PetscScalar,Vec);
+PETSC_EXTERN PetscErrorCode VecFusedOpsAYPX(VecFusedOps,Vec,PetscScalar,Vec);
+PETSC_EXTERN PetscErrorCode VecFusedOpsWAXPY(VecFusedOps,Vec,PetscScalar,Vec,Vec);
+PETSC_EXTERN PetscErrorCode VecFusedOpsAXPBYPCZ(VecFusedOps,Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec);
+PETSC_EXTERN PetscErrorCode VecFusedOpsMAXPY(VecFusedOps,Vec,PetscInt,const PetscScalar[],Vec[]);
+PETSC_EXTERN PetscErrorCode VecFusedOpsDot(VecFusedOps,Vec,Vec,PetscScalar*);
+PETSC_EXTERN PetscErrorCode VecFusedOpsTDot(VecFusedOps,Vec,Vec,PetscScalar*);
+PETSC_EXTERN PetscErrorCode VecFusedOpsNorm(VecFusedOps,Vec,NormType,PetscReal*);
+PETSC_EXTERN PetscErrorCode VecFusedOpsExecute(VecFusedOps);
+
 
 typedef enum {VEC_IGNORE_OFF_PROC_ENTRIES,VEC_IGNORE_NEGATIVE_INDICES,VEC_SUBSET_OFF_PROC_ENTRIES} VecOption;
 PETSC_EXTERN PetscErrorCode VecSetOption(Vec,VecOption,PetscBool );
@@ -0,0 +1,246 @@
+static char help[] = "Compares the PetscSF implementations on the ghost point exchange of a DMDA or a distributed DMPlex.\n\
+  -plex : use a box DMPlex distributed with one level of overlap instead of a 3d DMDA\n\
+  -sf_types <basic,neighbor,shared> : the PetscSF types to compare (default all those of this build)\n\
+  -dim <dim> : topological dimension of the DMPlex box mesh\n\
+  -faces <n> : number of faces along each side of the DMPlex box mesh\n\
+  -dof <dof> : degrees of freedom per DMDA grid point, or on each DMPlex vertex and cell\n\
+  -its <its> : number of exchanges to time\n\
+  -timing : print the time per exchange of each type\n\n";
+
+#include <petscdmda.h>
+#include <petscdmplex.h>
+#include <petscsf.h>
+#include <petsctime.h>
+
+/*
+   A 3d DMDA; in the graph of its exchange the roots are the grid points owned by the process, the leaves are all
+   the points of its local vector, and the unit is the dof values of a grid point
+*/
+static PetscErrorCode CreateDA(MPI_Comm comm,PetscInt dof,DM *dm,PetscSF *graph,MPI_Datatype *unit)
+{
+  PetscErrorCode         ierr;
+  ISLocalToGlobalMapping ltog;
+  PetscLayout            layout;
+  const PetscInt         *gidx;
+  PetscInt               *ilocal,*iremote,i,n,nleaves,xm,ym,zm;
+
+  PetscFunctionBeginUser;
+  ierr = DMDACreate3d(comm,DM_BOUNDARY_NONE,DM_BOUNDARY_NONE,DM_BOUNDARY_NONE,DMDA_STENCIL_BOX,8,8,8,PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE,dof,1,NULL,NULL,NULL,dm);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(*dm);CHKERRQ(ierr);
+  ierr = DMSetUp(*dm);CHKERRQ(ierr);
+  ierr = DMGetLocalToGlobalMapping(*dm,&ltog);CHKERRQ(ierr);
+  ierr = ISLocalToGlobalMappingGetSize(ltog,&n);CHKERRQ(ierr);
+  ierr = ISLocalToGlobalMappingGetBlockIndices(ltog,&gidx);CHKERRQ(ierr);
+  n   /= dof;
+  ierr = PetscMalloc2(n,&ilocal,n,&iremote);CHKERRQ(ierr);
+  for (i=0,nleaves=0; i<n; i++) {
+    if (gidx[i] < 0) continue;
+    ilocal[nleaves]    = i;
+    iremote[nleaves++] = gidx[i];
+  }
+  ierr = ISLocalToGlobalMappingRestoreBlockIndices(ltog,&gidx);CHKERRQ(ierr);
+  ierr = DMDAGetCorners(*dm,NULL,NULL,NULL,&xm,&ym,&zm);CHKERRQ(ierr);
+  ierr = PetscLayoutCreate(comm,&layout);CHKERRQ(ierr);
+  ierr = PetscLayoutSetLocalSize(layout,xm*ym*zm);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(layout);CHKERRQ(ierr);
+  ierr = PetscSFCreate(comm,graph);CHKERRQ(ierr);
+  ierr = PetscSFSetGraphLayout(*graph,layout,nleaves,ilocal,PETSC_COPY_VALUES,iremote);CHKERRQ(ierr);
+  ierr = PetscLayoutDestroy(&layout);CHKERRQ(ierr);
+  ierr = PetscFree2(ilocal,iremote);CHKERRQ(ierr);
+  ierr = MPI_Type_contiguous(dof,MPIU_SCALAR,unit);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(unit);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   A box DMPlex distributed with one level of overlap, so that the halo holds whole cells, with dof values on each
+   vertex and cell; the graph of its exchange is the default SF of the DM, from the global to the local values
+*/
+static PetscErrorCode CreatePlex(MPI_Comm comm,PetscInt dim,PetscInt nfaces,PetscInt dof,DM *dm,PetscSF *graph,MPI_Datatype *unit)
+{
+  PetscErrorCode ierr;
+  DM             dmDist;
+  PetscSection   s;
+  PetscInt       i,faces[3],pStart,pEnd,cStart,cEnd,vStart,vEnd,p;
+
+  PetscFunctionBeginUser;
+  for (i=0; i<3; i++) faces[i] = nfaces;
+  ierr = DMPlexCreateBoxMesh(comm,dim,PETSC_FALSE,faces,NULL,NULL,NULL,PETSC_TRUE,dm);CHKERRQ(ierr);
+  ierr = DMPlexDistribute(*dm,1,NULL,&dmDist);CHKERRQ(ierr);
+  if (dmDist) {
+    ierr = DMDestroy(dm);CHKERRQ(ierr);
+    *dm  = dmDist;
+  }
+  ierr = DMSetFromOptions(*dm);CHKERRQ(ierr);
+  ierr = DMPlexGetChart(*dm,&pStart,&pEnd);CHKERRQ(ierr);
+  ierr = DMPlexGetHeightStratum(*dm,0,&cStart,&cEnd);CHKERRQ(ierr);
+  ierr = DMPlexGetDepthStratum(*dm,0,&vStart,&vEnd);CHKERRQ(ierr);
+  ierr = PetscSectionCreate(comm,&s);CHKERRQ(ierr);
+  ierr = PetscSectionSetChart(s,pStart,pEnd);CHKERRQ(ierr);
+  for (p=cStart; p<cEnd; p++) {ierr = PetscSectionSetDof(s,p,dof);CHKERRQ(ierr);}
+  for (p=vStart; p<vEnd; p++) {ierr = PetscSectionSetDof(s,p,dof);CHKERRQ(ierr);}
+  ierr = PetscSectionSetUp(s);CHKERRQ(ierr);
+  ierr = DMSetDefaultSection(*dm,s);CHKERRQ(ierr);
+  ierr = PetscSectionDestroy(&s);CHKERRQ(ierr);
+  ierr = DMGetDefaultSF(*dm,graph);CHKERRQ(ierr);
+  ierr = PetscObjectReference((PetscObject)*graph);CHKERRQ(ierr);
+  ierr = MPI_Type_contiguous(1,MPIU_SCALAR,unit);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(unit);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode    ierr;
+  DM                dm;
+  Vec               g,l,gref,lref;
+  PetscSF           graph,sf;
+  MPI_Comm          comm;
+  MPI_Datatype      unit;
+  const PetscInt    *ilocal;
+  const PetscSFNode *iremote;
+  char              *types[16];
+  PetscInt          ntypes = 16,t,i,k,n,nroots,nleaves,rstart,dim = 2,nfaces = 8,dof = 1,its = 10;
+  PetscBool         plex = PETSC_FALSE,timing = PETSC_FALSE,flg;
+  PetscScalar       *array;
+  const PetscScalar *rarray;
+  PetscReal         nrm;
+  PetscLogDouble    t0,t1,tbcast,treduce;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  comm = PETSC_COMM_WORLD;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-plex",&plex,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dim",&dim,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-faces",&nfaces,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-timing",&timing,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetStringArray(NULL,NULL,"-sf_types",types,&ntypes,&flg);CHKERRQ(ierr);
+  if (!flg) {
+    ntypes = 0;
+    ierr   = PetscStrallocpy(PETSCSFBASIC,&types[ntypes++]);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+    ierr   = PetscStrallocpy(PETSCSFNEIGHBOR,&types[ntypes++]);CHKERRQ(ierr);
+#endif
+#if defined(PETSC_HAVE_MPI_WIN_CREATE_FEATURE) && defined(PETSC_HAVE_MPI_SHARED_COMM)
+    ierr   = PetscStrallocpy(PETSCSFSHARED,&types[ntypes++]);CHKERRQ(ierr);
+#endif
+  }
+
+  if (plex) {ierr = CreatePlex(comm,dim,nfaces,dof,&dm,&graph,&unit);CHKERRQ(ierr);}
+  else      {ierr = CreateDA(comm,dof,&dm,&graph,&unit);CHKERRQ(ierr);}
+  ierr = DMCreateGlobalVector(dm,&g);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(dm,&l);CHKERRQ(ierr);
+  ierr = VecDuplicate(g,&gref);CHKERRQ(ierr);
+  ierr = VecDuplicate(l,&lref);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(g,&rstart,NULL);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(g,&n);CHKERRQ(ierr);
+  ierr = VecGetArray(g,&array);CHKERRQ(ierr);
+  for (i=0; i<n; i++) array[i] = rstart + i;
+  ierr = VecRestoreArray(g,&array);CHKERRQ(ierr);
+
+  /* The references are the scatters of the DM: fill the ghost points, and add them back to their owners */
+  ierr = DMGlobalToLocalBegin(dm,g,INSERT_VALUES,lref);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm,g,INSERT_VALUES,lref);CHKERRQ(ierr);
+  ierr = VecSet(gref,0.0);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(dm,lref,ADD_VALUES,gref);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(dm,lref,ADD_VALUES,gref);CHKERRQ(ierr);
+
+  /* Each type is given the same graph, so all of them are compared on the same exchange in one run */
+  ierr = PetscSFGetGraph(graph,&nroots,&nleaves,&ilocal,&iremote);CHKERRQ(ierr);
+  for (t=0; t<ntypes; t++) {
+    ierr = PetscSFCreate(comm,&sf);CHKERRQ(ierr);
+    ierr = PetscSFSetType(sf,types[t]);CHKERRQ(ierr);
+    ierr = PetscSFSetFromOptions(sf);CHKERRQ(ierr);
+    ierr = PetscSFSetGraph(sf,nroots,nleaves,ilocal,PETSC_COPY_VALUES,iremote,PETSC_COPY_VALUES);CHKERRQ(ierr);
+    ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+
+    ierr = VecSet(l,0.0);CHKERRQ(ierr);
+    ierr = VecGetArrayRead(g,&rarray);CHKERRQ(ierr);
+    ierr = VecGetArray(l,&array);CHKERRQ(ierr);
+    /* A first exchange, not timed, creates the buffers, communicators and windows of the implementations */
+    ierr = PetscSFBcastBegin(sf,unit,rarray,array);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,unit,rarray,array);CHKERRQ(ierr);
+    ierr = MPI_Barrier(comm);CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (k=0; k<its; k++) {
+      ierr = PetscSFBcastBegin(sf,unit,rarray,array);CHKERRQ(ierr);
+      ierr = PetscSFBcastEnd(sf,unit,rarray,array);CHKERRQ(ierr);
+    }
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    tbcast = (t1 - t0)/its;
+    ierr = VecRestoreArray(l,&array);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(g,&rarray);CHKERRQ(ierr);
+    ierr = VecAXPY(l,-1.0,lref);CHKERRQ(ierr);
+    ierr = VecNorm(l,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    if (nrm > 0.0) {ierr = PetscPrintf(comm,"PetscSF %s broadcast differs from DMGlobalToLocal() by %g\n",types[t],(double)nrm);CHKERRQ(ierr);}
+
+    treduce = 0.0;
+    ierr = VecGetArrayRead(lref,&rarray);CHKERRQ(ierr);
+    for (k=0; k<=its; k++) {
+      ierr     = VecSet(g,0.0);CHKERRQ(ierr);
+      ierr     = VecGetArray(g,&array);CHKERRQ(ierr);
+      ierr     = MPI_Barrier(comm);CHKERRQ(ierr);
+      ierr     = PetscTime(&t0);CHKERRQ(ierr);
+      ierr     = PetscSFReduceBegin(sf,unit,rarray,array,MPIU_SUM);CHKERRQ(ierr);
+      ierr     = PetscSFReduceEnd(sf,unit,rarray,array,MPIU_SUM);CHKERRQ(ierr);
+      ierr     = PetscTime(&t1);CHKERRQ(ierr);
+      if (k) treduce += (t1 - t0)/its;
+      ierr     = VecRestoreArray(g,&array);CHKERRQ(ierr);
+    }
+    ierr = VecRestoreArrayRead(lref,&rarray);CHKERRQ(ierr);
+    ierr = VecAXPY(g,-1.0,gref);CHKERRQ(ierr);
+    ierr = VecNorm(g,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    if (nrm > 0.0) {ierr = PetscPrintf(comm,"PetscSF %s reduction differs from DMLocalToGlobal() by %g\n",types[t],(double)nrm);CHKERRQ(ierr);}
+
+    if (timing) {
+      PetscLogDouble tloc[2] = {tbcast,treduce},tmax[2];
+      ierr = MPIU_Allreduce(tloc,tmax,2,MPI_DOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+      ierr = PetscPrintf(comm,"%-10s broadcast %10.3e s  reduction %10.3e s\n",types[t],tmax[0],tmax[1]);CHKERRQ(ierr);
+    }
+    /* Restore the global vector for the next type */
+    ierr = VecGetArray(g,&array);CHKERRQ(ierr);
+    for (i=0; i<n; i++) array[i] = rstart + i;
+    ierr = VecRestoreArray(g,&array);CHKERRQ(ierr);
+    ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(comm,"done\n");CHKERRQ(ierr);
+
+  for (t=0; t<ntypes; t++) {ierr = PetscFree(types[t]);CHKERRQ(ierr);}
+  ierr = MPI_Type_free(&unit);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&graph);CHKERRQ(ierr);
+  ierr = VecDestroy(&g);CHKERRQ(ierr);
+  ierr = VecDestroy(&l);CHKERRQ(ierr);
+  ierr = VecDestroy(&gref);CHKERRQ(ierr);
+  ierr = VecDestroy(&lref);CHKERRQ(ierr);
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+      nsize: 8
+      args: -its 2
+
+   test:
+      suffix: 2
+      nsize: 4
+      args: -dof 3 -its 1 -da_grid_x 5 -da_grid_y 7 -da_grid_z 3 -sf_shared_node_size 2
+      output_file: output/ex46_1.out
+
+   test:
+      suffix: plex
+      nsize: 4
+      args: -plex -its 2
+      output_file: output/ex46_1.out
+
+   test:
+      suffix: plex_2
+      nsize: 4
+      args: -plex -dim 3 -faces 3 -dof 2 -its 1 -sf_shared_node_size 2
+      output_file: output/ex46_1.out
+
+TEST*/
@@ -0,0 +1,168 @@
+
+static char help[] = "Compares the strided ghost point update of DMDA with the VecScatter one.\n\
+  -dim <dim> : dimension of the grid\n\
+  -bx, -by, -bz <none,ghosted,periodic> : boundary types\n\
+  -star : use a star stencil\n\
+  -dof <dof> : degrees of freedom per grid point\n\
+  -s <s> : stencil width\n\
+  -its <its> : number of updates to time\n\
+  -timing : print the time per update of each method\n\n";
+
+#include <petscdmda.h>
+#include <petsctime.h>
+
+static PetscErrorCode TimeUpdates(DM da,Vec g,Vec l,PetscInt its,PetscLogDouble *t)
+{
+  PetscErrorCode ierr;
+  PetscLogDouble t0,t1;
+  PetscInt       k;
+
+  PetscFunctionBegin;
+  /* A first update, not timed, sets up the communication */
+  ierr = DMGlobalToLocalBegin(da,g,INSERT_VALUES,l);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(da,g,INSERT_VALUES,l);CHKERRQ(ierr);
+  ierr = MPI_Barrier(PetscObjectComm((PetscObject)da));CHKERRQ(ierr);
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  for (k=0; k<its; k++) {
+    ierr = DMGlobalToLocalBegin(da,g,INSERT_VALUES,l);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(da,g,INSERT_VALUES,l);CHKERRQ(ierr);
+  }
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  *t   = (t1 - t0)/its;
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode  ierr;
+  DM              da,dref;
+  Vec             g,l,lref;
+  MPI_Comm        comm;
+  DMBoundaryType  bx = DM_BOUNDARY_NONE,by = DM_BOUNDARY_NONE,bz = DM_BOUNDARY_NONE;
+  DMDAStencilType stype;
+  PetscInt        dim = 3,M,N,P,m,n,p,dof = 1,s = 1,i,rstart,nlocal,its = 10,mode;
+  const PetscInt  *lx,*ly,*lz;
+  PetscBool       star = PETSC_FALSE,strided,stridedstar,timing = PETSC_FALSE;
+  PetscScalar     *array;
+  PetscReal       nrm;
+  PetscLogDouble  tloc[2],tmax[2];
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  comm = PETSC_COMM_WORLD;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dim",&dim,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetEnum(NULL,NULL,"-bx",DMBoundaryTypes,(PetscEnum*)&bx,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetEnum(NULL,NULL,"-by",DMBoundaryTypes,(PetscEnum*)&by,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetEnum(NULL,NULL,"-bz",DMBoundaryTypes,(PetscEnum*)&bz,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-star",&star,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-s",&s,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-timing",&timing,NULL);CHKERRQ(ierr);
+
+  ierr = DMDACreate(comm,&da);CHKERRQ(ierr);
+  ierr = DMSetDimension(da,dim);CHKERRQ(ierr);
+  ierr = DMDASetSizes(da,8,8,8);CHKERRQ(ierr);
+  ierr = DMDASetBoundaryType(da,bx,by,bz);CHKERRQ(ierr);
+  ierr = DMDASetStencilType(da,star ? DMDA_STENCIL_STAR : DMDA_STENCIL_BOX);CHKERRQ(ierr);
+  ierr = DMDASetDof(da,dof);CHKERRQ(ierr);
+  ierr = DMDASetStencilWidth(da,s);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(da);CHKERRQ(ierr);
+  ierr = DMSetUp(da);CHKERRQ(ierr);
+  ierr = DMDAGetStridedGhostUpdate(da,NULL,&stridedstar);CHKERRQ(ierr);
+  ierr = DMDASetStridedGhostUpdate(da,PETSC_TRUE,stridedstar);CHKERRQ(ierr);
+
+  /* The reference is the VecScatter of a DMDA with the same decomposition, and a star stencil if only those ghost points are updated */
+  ierr = DMDAGetInfo(da,NULL,&M,&N,&P,&m,&n,&p,NULL,NULL,NULL,NULL,NULL,&stype);CHKERRQ(ierr);
+  ierr = DMDAGetOwnershipRanges(da,&lx,&ly,&lz);CHKERRQ(ierr);
+  ierr = DMDACreate(comm,&dref);CHKERRQ(ierr);
+  ierr = DMSetDimension(dref,dim);CHKERRQ(ierr);
+  ierr = DMDASetSizes(dref,M,N,P);CHKERRQ(ierr);
+  ierr = DMDASetNumProcs(dref,m,n,p);CHKERRQ(ierr);
+  ierr = DMDASetOwnershipRanges(dref,lx,ly,lz);CHKERRQ(ierr);
+  ierr = DMDASetBoundaryType(dref,bx,by,bz);CHKERRQ(ierr);
+  ierr = DMDASetStencilType(dref,stridedstar ? DMDA_STENCIL_STAR : stype);CHKERRQ(ierr);
+  ierr = DMDASetDof(dref,dof);CHKERRQ(ierr);
+  ierr = DMDASetStencilWidth(dref,s);CHKERRQ(ierr);
+  ierr = DMSetUp(dref);CHKERRQ(ierr);
+  ierr = DMDAGetStridedGhostUpdate(dref,&strided,NULL);CHKERRQ(ierr);
+  if (strided) SETERRQ(comm,PETSC_ERR_PLIB,"The reference DMDA must use the VecScatter");
+
+  ierr = DMCreateGlobalVector(da,&g);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(da,&l);CHKERRQ(ierr);
+  ierr = VecDuplicate(l,&lref);CHKERRQ(ierr);
+  ierr = VecGetOwnershipRange(g,&rstart,NULL);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(g,&nlocal);CHKERRQ(ierr);
+  ierr = VecGetArray(g,&array);CHKERRQ(ierr);
+  for (i=0; i<nlocal; i++) array[i] = rstart + i;
+  ierr = VecRestoreArray(g,&array);CHKERRQ(ierr);
+
+  /* The ghost points that are not updated keep their initial value, which must agree as well */
+  for (mode=0; mode<2; mode++) {
+    InsertMode imode = mode ? ADD_VALUES : INSERT_VALUES;
+
+    ierr = VecSet(l,-1.0);CHKERRQ(ierr);
+    ierr = VecSet(lref,-1.0);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalBegin(da,g,imode,l);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(da,g,imode,l);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalBegin(dref,g,imode,lref);CHKERRQ(ierr);
+    ierr = DMGlobalToLocalEnd(dref,g,imode,lref);CHKERRQ(ierr);
+    ierr = VecAXPY(l,-1.0,lref);CHKERRQ(ierr);
+    ierr = VecNorm(l,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    if (nrm > 0.0) {ierr = PetscPrintf(comm,"Strided update with %s differs from the VecScatter by %g\n",mode ? "ADD_VALUES" : "INSERT_VALUES",(double)nrm);CHKERRQ(ierr);}
+  }
+
+  ierr = TimeUpdates(dref,g,lref,its,&tloc[0]);CHKERRQ(ierr);
+  ierr = TimeUpdates(da,g,l,its,&tloc[1]);CHKERRQ(ierr);
+  if (timing) {
+    ierr = MPIU_Allreduce(tloc,tmax,2,MPI_DOUBLE,MPI_MAX,comm);CHKERRQ(ierr);
+    ierr = PetscPrintf(comm,"VecScatter %10.3e s  strided %10.3e s\n",tmax[0],tmax[1]);CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(comm,"done\n");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&g);CHKERRQ(ierr);
+  ierr = VecDestroy(&l);CHKERRQ(ierr);
+  ierr = VecDestroy(&lref);CHKERRQ(ierr);
+  ierr = DMDestroy(&dref);CHKERRQ(ierr);
+  ierr = DMDestroy(&da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+      nsize: 8
+      args: -its 2
+
+   test:
+      suffix: 2
+      nsize: 4
+      args: -its 2 -bx periodic -by ghosted -bz periodic -dof 3 -da_grid_x 5 -da_grid_y 7 -da_grid_z 3 -da_processors_z 1
+      output_file: output/ex47_1.out
+
+   test:
+      suffix: 3
+      nsize: 6
+      args: -its 2 -star -bx periodic -s 2
+      output_file: output/ex47_1.out
+
+   test:
+      suffix: 4
+      nsize: 4
+      args: -its 2 -da_strided_ghost_update_star -by periodic
+      output_file: output/ex47_1.out
+
+   test:
+      suffix: 2d
+      nsize: 3
+      args: -its 2 -dim 2 -bx periodic -by periodic -dof 2
+      output_file: output/ex47_1.out
+
+   test:
+      suffix: 1d
+      nsize: 3
+      args: -its 2 -dim 1 -bx periodic -s 2 -da_grid_x 12
+      output_file: output/ex47_1.out
+
+TEST*/
@@ -6,7 +6,7 @@ PetscErrorCode  DMSetFromOptions_DA(PetscOptionItems *PetscOptionsObject,DM da)
   PetscErrorCode ierr;
   DM_DA          *dd    = (DM_DA*)da->data;
   PetscInt       refine = 0,dim = da->dim,maxnlevels = 100,refx[100],refy[100],refz[100],n,i;
-  PetscBool      flg;
+  PetscBool      flg,strided,star;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(da,DM_CLASSID,1);
@@ -76,6 +76,12 @@ PetscErrorCode  DMSetFromOptions_DA(PetscOptionItems *PetscOptionsObject,DM da)
   }
 
   ierr = PetscOptionsInt("-da_refine","Uniformly refine DA one or more times","None",refine,&refine,NULL);CHKERRQ(ierr);
+
+  strided = dd->stridedghost;
+  star    = dd->stridedghoststar;
+  ierr = PetscOptionsBool("-da_strided_ghost_update","Update the ghost points with strided copies of the grid boxes instead of a VecScatter","DMDASetStridedGhostUpdate",strided,&strided,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-da_strided_ghost_update_star","Exchange only the ghost points of a star stencil","DMDASetStridedGhostUpdate",star,&star,NULL);CHKERRQ(ierr);
+  ierr = DMDASetStridedGhostUpdate(da,strided,star);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
 
   while (refine--) {
@@ -61,6 +61,7 @@ PetscErrorCode  DMDestroy_DA(DM da)
   }
 
   ierr = VecScatterDestroy(&dd->gtol);CHKERRQ(ierr);
+  ierr = DMDAHaloDestroy_Private(&dd->halo);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&dd->ltol);CHKERRQ(ierr);
   ierr = VecDestroy(&dd->natural);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&dd->gton);CHKERRQ(ierr);
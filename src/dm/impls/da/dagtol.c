@@ -8,12 +8,18 @@ PetscErrorCode  DMGlobalToLocalBegin_DA(DM da,Vec g,InsertMode mode,Vec l)
 {
   PetscErrorCode ierr;
   DM_DA          *dd = (DM_DA*)da->data;
+  PetscBool      strided;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(da,DM_CLASSID,1);
   PetscValidHeaderSpecific(g,VEC_CLASSID,2);
   PetscValidHeaderSpecific(l,VEC_CLASSID,4);
-  ierr = VecScatterBegin(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = DMDAHaloGetActive_Private(da,mode,&strided);CHKERRQ(ierr);
+  if (strided) {
+    ierr = DMDAHaloBegin_Private(da,g,mode,l);CHKERRQ(ierr);
+  } else {
+    ierr = VecScatterBegin(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
@@ -21,12 +27,18 @@ PetscErrorCode  DMGlobalToLocalEnd_DA(DM da,Vec g,InsertMode mode,Vec l)
 {
   PetscErrorCode ierr;
   DM_DA          *dd = (DM_DA*)da->data;
+  PetscBool      strided;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(da,DM_CLASSID,1);
   PetscValidHeaderSpecific(g,VEC_CLASSID,2);
   PetscValidHeaderSpecific(l,VEC_CLASSID,4);
-  ierr = VecScatterEnd(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = DMDAHaloGetActive_Private(da,mode,&strided);CHKERRQ(ierr);
+  if (strided) {
+    ierr = DMDAHaloEnd_Private(da,g,mode,l);CHKERRQ(ierr);
+  } else {
+    ierr = VecScatterEnd(dd->gtol,g,l,mode,SCATTER_FORWARD);CHKERRQ(ierr);
+  }
   PetscFunctionReturn(0);
 }
 
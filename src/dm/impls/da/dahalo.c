@@ -0,0 +1,453 @@
+/*
+   Ghost point update of a DMDA that uses the box geometry of the grid: the ghosted region of a process is cut into at
+   most 27 boxes, each owned by a single process, and every box is moved with contiguous copies of its x rows instead
+   of the indexed VecScatter gtol.
+*/
+
+#include <petsc/private/dmdaimpl.h>    /*I   "petscdmda.h"   I*/
+
+typedef struct {
+  PetscInt offset;                  /* offset of the first entry of the box in the array */
+  PetscInt nx,ny,nz;                /* entries in a row (degrees of freedom included), rows in a plane, planes */
+} DMDAHaloBox;
+
+struct _n_DMDAHalo {
+  PetscBool   active;               /* PETSC_FALSE if the layout is not handled, gtol is used instead */
+  PetscBool   inuse;                /* an update is in progress */
+  PetscInt    grow,gplane;          /* strides of the rows and planes of the global array */
+  PetscInt    lrow,lplane;          /* same for the local array */
+  PetscInt    nself;                /* boxes owned by this process, copied directly from the global to the local array */
+  DMDAHaloBox *selfg,*selfl;
+  PetscMPIInt nsend,nrecv;          /* number of processes sent to and received from */
+  PetscMPIInt *sranks,*rranks;
+  PetscInt    *soffset,*roffset;    /* the boxes of message i are [soffset[i],soffset[i+1]) of sboxes */
+  DMDAHaloBox *sboxes,*rboxes;
+  PetscInt    *sstart,*rstart;      /* message i is [sstart[i],sstart[i+1]) of sbuf */
+  PetscScalar *sbuf,*rbuf;
+  MPI_Request *reqs;                /* receives first, then sends */
+  PetscMPIInt tag;
+};
+
+/* The decomposition of the grid in one direction */
+typedef struct {
+  PetscInt       M,m,s;             /* grid points, processes and stencil width */
+  DMBoundaryType bd;
+  PetscInt       *start;            /* first grid point of each process, start[m] = M */
+} DMDAHaloDir;
+
+/* A piece of the ghosted range of a process in one direction that is owned by a single process */
+typedef struct {
+  PetscInt  proc;                   /* index of the owner in this direction */
+  PetscInt  own;                    /* first grid point, in the global numbering */
+  PetscInt  loc;                    /* first grid point, relative to the start of the ghosted range */
+  PetscInt  len;
+  PetscBool interior;               /* owned by the process itself without wrapping around the domain */
+} DMDAHaloSeg;
+
+static PetscErrorCode DMDAHaloGetRange(const DMDAHaloDir *dir,PetscInt j,PetscInt *gs,PetscInt *ge)
+{
+  PetscFunctionBegin;
+  if (dir->bd == DM_BOUNDARY_PERIODIC || dir->bd == DM_BOUNDARY_GHOSTED) {
+    *gs = dir->start[j] - dir->s;
+    *ge = dir->start[j+1] + dir->s;
+  } else {
+    *gs = PetscMax(dir->start[j] - dir->s,0);
+    *ge = PetscMin(dir->start[j+1] + dir->s,dir->M);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Cuts the ghosted range of process j at the boundaries of the owners, ghost points outside of a non periodic domain are skipped */
+static PetscErrorCode DMDAHaloGetSegments(const DMDAHaloDir *dir,PetscInt j,PetscInt *nseg,DMDAHaloSeg seg[])
+{
+  PetscErrorCode ierr;
+  PetscInt       gs,ge,c,cw,q;
+
+  PetscFunctionBegin;
+  ierr  = DMDAHaloGetRange(dir,j,&gs,&ge);CHKERRQ(ierr);
+  *nseg = 0;
+  for (c=gs; c<ge; ) {
+    cw = dir->bd == DM_BOUNDARY_PERIODIC ? ((c % dir->M) + dir->M) % dir->M : c;
+    if (cw < 0) {c = PetscMin(0,ge); continue;}
+    if (cw >= dir->M) break;
+    for (q=0; dir->start[q+1] <= cw; q++) ;
+    if (*nseg == 3) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Ghosted range spans more than three processes");
+    seg[*nseg].proc     = q;
+    seg[*nseg].own      = cw;
+    seg[*nseg].loc      = c - gs;
+    seg[*nseg].len      = PetscMin(ge - c,dir->start[q+1] - cw);
+    seg[*nseg].interior = (PetscBool)(c >= dir->start[j] && c < dir->start[j+1]);
+    c                  += seg[(*nseg)++].len;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Enumerates the boxes of the ghosted region of the process with indices idx[], with their owner, their position in
+   the global array of the owner and their position in the local array of the process. Both sides of a message
+   enumerate the boxes in the same order.
+*/
+static PetscErrorCode DMDAHaloGetBoxes(const DMDAHaloDir dir[],const PetscInt idx[],PetscInt w,PetscBool star,PetscInt *nb,PetscMPIInt owner[],DMDAHaloBox gbox[],DMDAHaloBox lbox[])
+{
+  PetscErrorCode ierr;
+  DMDAHaloSeg    seg[3][3];
+  PetscInt       nseg[3],d,a,b,c,gs[3],ge[3],lrow,lplane,grow,gplane;
+
+  PetscFunctionBegin;
+  for (d=0; d<3; d++) {
+    ierr = DMDAHaloGetSegments(&dir[d],idx[d],&nseg[d],seg[d]);CHKERRQ(ierr);
+    ierr = DMDAHaloGetRange(&dir[d],idx[d],&gs[d],&ge[d]);CHKERRQ(ierr);
+  }
+  lrow   = (ge[0] - gs[0])*w;
+  lplane = lrow*(ge[1] - gs[1]);
+  *nb    = 0;
+  for (c=0; c<nseg[2]; c++) {
+    const DMDAHaloSeg *sz = &seg[2][c];
+    for (b=0; b<nseg[1]; b++) {
+      const DMDAHaloSeg *sy = &seg[1][b];
+      for (a=0; a<nseg[0]; a++) {
+        const DMDAHaloSeg *sx = &seg[0][a];
+
+        /* A star stencil needs no ghost point that is outside of the owned range in more than one direction */
+        if (star && (!sx->interior + !sy->interior + !sz->interior) > 1) continue;
+        ierr = PetscMPIIntCast(sx->proc + dir[0].m*(sy->proc + dir[1].m*sz->proc),&owner[*nb]);CHKERRQ(ierr);
+        grow   = (dir[0].start[sx->proc+1] - dir[0].start[sx->proc])*w;
+        gplane = grow*(dir[1].start[sy->proc+1] - dir[1].start[sy->proc]);
+        gbox[*nb].offset = (sz->own - dir[2].start[sz->proc])*gplane + (sy->own - dir[1].start[sy->proc])*grow + (sx->own - dir[0].start[sx->proc])*w;
+        lbox[*nb].offset = sz->loc*lplane + sy->loc*lrow + sx->loc*w;
+        gbox[*nb].nx     = lbox[*nb].nx = sx->len*w;
+        gbox[*nb].ny     = lbox[*nb].ny = sy->len;
+        gbox[*nb].nz     = lbox[*nb].nz = sz->len;
+        (*nb)++;
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Copies, or adds, a box of nx by ny by nz entries between two arrays with the given row and plane strides */
+PETSC_STATIC_INLINE PetscErrorCode DMDAHaloCopy(PetscInt nx,PetscInt ny,PetscInt nz,const PetscScalar *x,PetscInt xrow,PetscInt xplane,InsertMode mode,PetscScalar *y,PetscInt yrow,PetscInt yplane)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,k;
+
+  PetscFunctionBegin;
+  if (xrow == nx && yrow == nx) {nx *= ny; ny = 1;} /* contiguous planes are copied at once */
+  for (k=0; k<nz; k++) {
+    for (j=0; j<ny; j++) {
+      const PetscScalar *xr = x + k*xplane + j*xrow;
+      PetscScalar       *yr = y + k*yplane + j*yrow;
+
+      if (mode == INSERT_VALUES) {
+        ierr = PetscMemcpy(yr,xr,nx*sizeof(PetscScalar));CHKERRQ(ierr);
+      } else {
+        for (i=0; i<nx; i++) yr[i] += xr[i];
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMDAHaloSetUp(DM da)
+{
+  DM_DA          *dd = (DM_DA*)da->data;
+  DMDAHalo       halo;
+  MPI_Comm       comm;
+  PetscErrorCode ierr;
+  DMDAHaloDir    dir[3];
+  PetscMPIInt    rank,owner[27],ranks[27],active,gactive;
+  DMDAHaloBox    gbox[27],lbox[27];
+  PetscBool      star = (PetscBool)(dd->stridedghoststar || dd->stencil_type == DMDA_STENCIL_STAR);
+  PetscInt       w = dd->w,d,i,j,k,nb,ncand[3],cand[3][3],idx[3],cidx[3],gs,ge;
+  const PetscInt *l[3],one = 1;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)da,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = PetscNewLog(da,&halo);CHKERRQ(ierr);
+  dd->halo = halo;
+
+  l[0] = dd->lx; l[1] = dd->ly; l[2] = dd->lz;
+  for (d=0; d<3; d++) {
+    if (d < da->dim) {
+      dir[d].M  = d == 0 ? dd->M : (d == 1 ? dd->N : dd->P);
+      dir[d].m  = d == 0 ? dd->m : (d == 1 ? dd->n : dd->p);
+      dir[d].s  = dd->s;
+      dir[d].bd = d == 0 ? dd->bx : (d == 1 ? dd->by : dd->bz);
+    } else {
+      dir[d].M  = 1;
+      dir[d].m  = 1;
+      dir[d].s  = 0;
+      dir[d].bd = DM_BOUNDARY_NONE;
+      l[d]      = &one;
+    }
+    ierr = PetscMalloc1(dir[d].m+1,&dir[d].start);CHKERRQ(ierr);
+    dir[d].start[0] = 0;
+    for (i=0; i<dir[d].m; i++) dir[d].start[i+1] = dir[d].start[i] + l[d][i];
+  }
+  idx[0] = rank % dir[0].m;
+  idx[1] = (rank / dir[0].m) % dir[1].m;
+  idx[2] = rank / (dir[0].m*dir[1].m);
+
+  /* Mirror boundaries and overlapping subdomains are left to gtol, the ghosted range must be the one of DMSetUp() */
+  active = !dd->xol && !dd->yol && !dd->zol;
+  for (d=0; d<3; d++) {
+    const PetscInt Gs[3] = {dd->Xs/w,dd->Ys,dd->Zs},Ge[3] = {dd->Xe/w,dd->Ye,dd->Ze};
+
+    if (dir[d].bd != DM_BOUNDARY_NONE && dir[d].bd != DM_BOUNDARY_GHOSTED && dir[d].bd != DM_BOUNDARY_PERIODIC) active = 0;
+    ierr = DMDAHaloGetRange(&dir[d],idx[d],&gs,&ge);CHKERRQ(ierr);
+    if (gs != Gs[d] || ge != Ge[d]) active = 0;
+  }
+  ierr = MPIU_Allreduce(&active,&gactive,1,MPI_INT,MPI_LAND,comm);CHKERRQ(ierr);
+  halo->active = (PetscBool)gactive;
+  if (!halo->active) {
+    ierr = PetscInfo(da,"Layout not handled by the strided ghost update, using the VecScatter\n");CHKERRQ(ierr);
+    for (d=0; d<3; d++) {ierr = PetscFree(dir[d].start);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  halo->grow   = dd->xe - dd->xs;
+  halo->gplane = halo->grow*(dd->ye - dd->ys);
+  halo->lrow   = dd->Xe - dd->Xs;
+  halo->lplane = halo->lrow*(dd->Ye - dd->Ys);
+
+  /* Receives: the boxes of this process owned by other processes, grouped by owner in increasing rank */
+  ierr = DMDAHaloGetBoxes(dir,idx,w,star,&nb,owner,gbox,lbox);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nb,&halo->selfg,nb,&halo->selfl);CHKERRQ(ierr);
+  for (i=0,j=0; i<nb; i++) {
+    if (owner[i] == rank) {
+      halo->selfg[halo->nself]   = gbox[i];
+      halo->selfl[halo->nself++] = lbox[i];
+    } else ranks[j++] = owner[i];
+  }
+  ierr = PetscSortRemoveDupsMPIInt(&j,ranks);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(j,&halo->nrecv);CHKERRQ(ierr);
+  ierr = PetscMalloc4(halo->nrecv,&halo->rranks,halo->nrecv+1,&halo->roffset,nb,&halo->rboxes,halo->nrecv+1,&halo->rstart);CHKERRQ(ierr);
+  halo->roffset[0] = 0;
+  halo->rstart[0]  = 0;
+  for (j=0; j<halo->nrecv; j++) {
+    halo->rranks[j]    = ranks[j];
+    halo->roffset[j+1] = halo->roffset[j];
+    halo->rstart[j+1]  = halo->rstart[j];
+    for (i=0; i<nb; i++) {
+      if (owner[i] != ranks[j]) continue;
+      halo->rboxes[halo->roffset[j+1]++] = lbox[i];
+      halo->rstart[j+1]                 += lbox[i].nx*lbox[i].ny*lbox[i].nz;
+    }
+  }
+
+  /*
+     Sends: the processes whose ghosted region meets the owned region are neighbors in every direction, since no
+     process is narrower than the stencil width. Enumerating their boxes in the order of the ranks gives the boxes they
+     expect from this process, in the order they expect them.
+  */
+  for (d=0; d<3; d++) {
+    PetscInt n = 0;
+    for (i=idx[d]-1; i<=idx[d]+1; i++) {
+      if (dir[d].bd == DM_BOUNDARY_PERIODIC) cand[d][n++] = (i + dir[d].m) % dir[d].m;
+      else if (i >= 0 && i < dir[d].m) cand[d][n++] = i;
+    }
+    ierr     = PetscSortRemoveDupsInt(&n,cand[d]);CHKERRQ(ierr);
+    ncand[d] = n;
+  }
+  ierr = PetscMalloc4(27,&halo->sranks,28,&halo->soffset,27*27,&halo->sboxes,28,&halo->sstart);CHKERRQ(ierr);
+  halo->soffset[0] = 0;
+  halo->sstart[0]  = 0;
+  for (k=0; k<ncand[2]; k++) {
+    for (j=0; j<ncand[1]; j++) {
+      for (i=0; i<ncand[0]; i++) {
+        PetscInt    b,nbc,n = halo->nsend;
+        PetscMPIInt crank;
+
+        cidx[0] = cand[0][i]; cidx[1] = cand[1][j]; cidx[2] = cand[2][k];
+        ierr    = PetscMPIIntCast(cidx[0] + dir[0].m*(cidx[1] + dir[1].m*cidx[2]),&crank);CHKERRQ(ierr);
+        if (crank == rank) continue;
+        ierr = DMDAHaloGetBoxes(dir,cidx,w,star,&nbc,owner,gbox,lbox);CHKERRQ(ierr);
+        halo->soffset[n+1] = halo->soffset[n];
+        halo->sstart[n+1]  = halo->sstart[n];
+        for (b=0; b<nbc; b++) {
+          if (owner[b] != rank) continue;
+          halo->sboxes[halo->soffset[n+1]++] = gbox[b];
+          halo->sstart[n+1]                 += gbox[b].nx*gbox[b].ny*gbox[b].nz;
+        }
+        if (halo->soffset[n+1] > halo->soffset[n]) halo->sranks[halo->nsend++] = crank;
+      }
+    }
+  }
+  ierr = PetscMalloc3(halo->sstart[halo->nsend],&halo->sbuf,halo->rstart[halo->nrecv],&halo->rbuf,halo->nsend+halo->nrecv,&halo->reqs);CHKERRQ(ierr);
+  ierr = PetscObjectGetNewTag((PetscObject)da,&halo->tag);CHKERRQ(ierr);
+  ierr = PetscInfo3(da,"Strided ghost update with %d sends, %d receives and %D local boxes\n",halo->nsend,halo->nrecv,halo->nself);CHKERRQ(ierr);
+  for (d=0; d<3; d++) {ierr = PetscFree(dir[d].start);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMDAHaloDestroy_Private(DMDAHalo *halo)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!*halo) PetscFunctionReturn(0);
+  ierr = PetscFree2((*halo)->selfg,(*halo)->selfl);CHKERRQ(ierr);
+  ierr = PetscFree4((*halo)->rranks,(*halo)->roffset,(*halo)->rboxes,(*halo)->rstart);CHKERRQ(ierr);
+  ierr = PetscFree4((*halo)->sranks,(*halo)->soffset,(*halo)->sboxes,(*halo)->sstart);CHKERRQ(ierr);
+  ierr = PetscFree3((*halo)->sbuf,(*halo)->rbuf,(*halo)->reqs);CHKERRQ(ierr);
+  ierr = PetscFree(*halo);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Whether DMGlobalToLocalBegin() and DMGlobalToLocalEnd() go through the strided ghost update */
+PetscErrorCode DMDAHaloGetActive_Private(DM da,InsertMode mode,PetscBool *active)
+{
+  DM_DA          *dd = (DM_DA*)da->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *active = PETSC_FALSE;
+  if (!dd->stridedghost || (mode != INSERT_VALUES && mode != ADD_VALUES)) PetscFunctionReturn(0);
+  if (!dd->halo) {ierr = DMDAHaloSetUp(da);CHKERRQ(ierr);}
+  *active = dd->halo->active;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMDAHaloBegin_Private(DM da,Vec g,InsertMode mode,Vec l)
+{
+  DM_DA             *dd   = (DM_DA*)da->data;
+  DMDAHalo          halo  = dd->halo;
+  MPI_Comm          comm  = PetscObjectComm((PetscObject)da);
+  PetscErrorCode    ierr;
+  PetscInt          i,b,n;
+  PetscMPIInt       count;
+  const PetscScalar *x;
+  PetscScalar       *y,*buf;
+
+  PetscFunctionBegin;
+  if (halo->inuse) SETERRQ(comm,PETSC_ERR_ARG_WRONGSTATE,"A ghost point update is already in progress, call DMGlobalToLocalEnd() first");
+  ierr = VecGetLocalSize(g,&n);CHKERRQ(ierr);
+  if (n != dd->Nlocal) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Global vector local size %D does not match DMDA %D",n,dd->Nlocal);
+  ierr = VecGetLocalSize(l,&n);CHKERRQ(ierr);
+  if (n != dd->nlocal) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Local vector size %D does not match DMDA %D",n,dd->nlocal);
+  halo->inuse = PETSC_TRUE;
+
+  for (i=0; i<halo->nrecv; i++) {
+    ierr = PetscMPIIntCast(halo->rstart[i+1] - halo->rstart[i],&count);CHKERRQ(ierr);
+    ierr = MPI_Irecv(halo->rbuf+halo->rstart[i],count,MPIU_SCALAR,halo->rranks[i],halo->tag,comm,&halo->reqs[i]);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(g,&x);CHKERRQ(ierr);
+  for (i=0; i<halo->nsend; i++) {
+    for (b=halo->soffset[i],buf=halo->sbuf+halo->sstart[i]; b<halo->soffset[i+1]; b++) {
+      const DMDAHaloBox *box = &halo->sboxes[b];
+
+      ierr = DMDAHaloCopy(box->nx,box->ny,box->nz,x+box->offset,halo->grow,halo->gplane,INSERT_VALUES,buf,box->nx,box->nx*box->ny);CHKERRQ(ierr);
+      buf += box->nx*box->ny*box->nz;
+    }
+    ierr = PetscMPIIntCast(halo->sstart[i+1] - halo->sstart[i],&count);CHKERRQ(ierr);
+    ierr = MPI_Isend(halo->sbuf+halo->sstart[i],count,MPIU_SCALAR,halo->sranks[i],halo->tag,comm,&halo->reqs[halo->nrecv+i]);CHKERRQ(ierr);
+  }
+  /* The owned points, and the ghost points this process owns in a periodic direction, are copied while the messages fly */
+  ierr = VecGetArray(l,&y);CHKERRQ(ierr);
+  for (b=0; b<halo->nself; b++) {
+    const DMDAHaloBox *gbox = &halo->selfg[b],*lbox = &halo->selfl[b];
+
+    ierr = DMDAHaloCopy(gbox->nx,gbox->ny,gbox->nz,x+gbox->offset,halo->grow,halo->gplane,mode,y+lbox->offset,halo->lrow,halo->lplane);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(l,&y);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(g,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode DMDAHaloEnd_Private(DM da,Vec g,InsertMode mode,Vec l)
+{
+  DM_DA             *dd  = (DM_DA*)da->data;
+  DMDAHalo          halo = dd->halo;
+  PetscErrorCode    ierr;
+  PetscInt          b;
+  PetscScalar       *y;
+  const PetscScalar *buf = halo->rbuf;
+
+  PetscFunctionBegin;
+  if (!halo->inuse) SETERRQ(PetscObjectComm((PetscObject)da),PETSC_ERR_ARG_WRONGSTATE,"No ghost point update in progress, call DMGlobalToLocalBegin() first");
+  ierr = MPI_Waitall(halo->nrecv+halo->nsend,halo->reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = VecGetArray(l,&y);CHKERRQ(ierr);
+  for (b=0; b<halo->roffset[halo->nrecv]; b++) {
+    const DMDAHaloBox *box = &halo->rboxes[b];
+
+    ierr = DMDAHaloCopy(box->nx,box->ny,box->nz,buf,box->nx,box->nx*box->ny,mode,y+box->offset,halo->lrow,halo->lplane);CHKERRQ(ierr);
+    buf += box->nx*box->ny*box->nz;
+  }
+  ierr = VecRestoreArray(l,&y);CHKERRQ(ierr);
+  halo->inuse = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMDASetStridedGhostUpdate - Sets whether DMGlobalToLocalBegin() and DMGlobalToLocalEnd() update the ghost points with
+  strided copies of the boxes of the grid instead of a general VecScatter
+
+  Logically Collective on DMDA
+
+  Input Parameters:
++ da      - The DMDA
+. strided - PETSC_TRUE to use the strided update
+- star    - PETSC_TRUE to exchange only the ghost points of a star stencil, even if the DMDA has a box stencil
+
+  Options Database:
++ -da_strided_ghost_update - use the strided update
+- -da_strided_ghost_update_star - exchange only the ghost points of a star stencil
+
+  Level: intermediate
+
+  Notes:
+  The ghosted region of each process is cut into the boxes of grid points owned by a single process, at most 27 in 3d,
+  whose x rows are contiguous in both the global and the local arrays. The boxes going to the same process are packed
+  into a single message with one contiguous copy per row, the owned points are copied directly between the arrays,
+  without any index list. The update is used for INSERT_VALUES and ADD_VALUES, other insert modes, mirror boundaries
+  and overlapping subdomains use the VecScatter.
+
+  With a star stencil, or with star set to PETSC_TRUE, the edges and corners of the ghosted region are neither sent
+  nor updated.
+
+.keywords:  distributed array, ghost points, scatter
+.seealso: DMDAGetStridedGhostUpdate(), DMGlobalToLocalBegin(), DMDASetStencilType(), DMDA
+@*/
+PetscErrorCode DMDASetStridedGhostUpdate(DM da,PetscBool strided,PetscBool star)
+{
+  DM_DA          *dd = (DM_DA*)da->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecificType(da,DM_CLASSID,1,DMDA);
+  PetscValidLogicalCollectiveBool(da,strided,2);
+  PetscValidLogicalCollectiveBool(da,star,3);
+  if (dd->halo && dd->halo->inuse) SETERRQ(PetscObjectComm((PetscObject)da),PETSC_ERR_ARG_WRONGSTATE,"Cannot change the ghost update while an update is in progress");
+  if (strided != dd->stridedghost || star != dd->stridedghoststar) {ierr = DMDAHaloDestroy_Private(&dd->halo);CHKERRQ(ierr);}
+  dd->stridedghost     = strided;
+  dd->stridedghoststar = star;
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMDAGetStridedGhostUpdate - Gets whether the ghost points are updated with strided copies of the boxes of the grid
+
+  Not Collective
+
+  Input Parameter:
+. da - The DMDA
+
+  Output Parameters:
++ strided - PETSC_TRUE if the strided update is used
+- star    - PETSC_TRUE if only the ghost points of a star stencil are exchanged
+
+  Level: intermediate
+
+.keywords:  distributed array, ghost points, scatter
+.seealso: DMDASetStridedGhostUpdate(), DMGlobalToLocalBegin(), DMDA
+@*/
+PetscErrorCode DMDAGetStridedGhostUpdate(DM da,PetscBool *strided,PetscBool *star)
+{
+  DM_DA *dd = (DM_DA*)da->data;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecificType(da,DM_CLASSID,1,DMDA);
+  if (strided) *strided = dd->stridedghost;
+  if (star)    *star    = dd->stridedghoststar;
+  PetscFunctionReturn(0);
+}
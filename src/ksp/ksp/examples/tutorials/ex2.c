@@ -262,6 +262,59 @@ int main(int argc,char **args)
       suffix: 3
       args: -pc_type sor -pc_sor_symmetric -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always
 
+   test:
+      suffix: aijmixed
+      args: -mat_type aijmixed -pc_type sor -pc_sor_symmetric -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always
+      output_file: output/ex2_3.out
+
+   test:
+      suffix: aijmixed_2
+      nsize: 2
+      args: -mat_type aijmixed -ksp_monitor_short -m 5 -n 5 -ksp_gmres_cgs_refinement_type refine_always
+      output_file: output/ex2_2.out
+
+   test:
+      suffix: contiguous_basis
+      nsize: 2
+      args: -ksp_monitor_short -m 5 -n 5 -ksp_gmres_cgs_refinement_type refine_always -ksp_gmres_contiguous_basis
+      output_file: output/ex2_2.out
+
+   test:
+      suffix: contiguous_basis_fgmres
+      args: -pc_type sor -pc_sor_symmetric -ksp_monitor_short -ksp_type fgmres -ksp_gmres_contiguous_basis
+      output_file: output/ex2_3.out
+
+   test:
+      suffix: compress_indices
+      args: -m 20 -n 300 -pc_type sor -ksp_monitor_short -ksp_max_it 10 -mat_aij_compress_indices
+
+   test:
+      suffix: multi_tile
+      args: -m 60 -n 60 -ksp_gmres_restart 40 -ksp_monitor_short -ksp_converged_reason -vec_multi_tile_size 256
+
+   test:
+      suffix: multi_tile_off
+      args: -m 60 -n 60 -ksp_gmres_restart 40 -ksp_monitor_short -ksp_converged_reason
+      output_file: output/ex2_multi_tile.out
+
+   test:
+      suffix: threads_solve
+      nsize: 2
+      args: -ksp_monitor_short -m 5 -n 5 -ksp_gmres_cgs_refinement_type refine_always -mat_aij_threads 3
+      output_file: output/ex2_2.out
+
+   test:
+      suffix: threads_solve_reorder
+      args: -m 20 -n 20 -pc_type ilu -pc_factor_levels 1 -pc_factor_mat_ordering_type nd -ksp_monitor_short -mat_aij_threads 3 -mat_aij_threads_reorder_solve
+
+   test:
+      suffix: solve_iterative
+      args: -m 20 -n 20 -pc_type ilu -pc_factor_solve_iterative 2 -ksp_monitor_short -mat_aij_threads 2
+
+   test:
+      suffix: chowilu
+      args: -m 20 -n 20 -pc_type ilu -pc_factor_levels 1 -pc_factor_mat_ordering_type nd -pc_factor_mat_solver_type chowilu -mat_chowilu_sweeps 3 -ksp_monitor_short -mat_aij_threads 2
+
    test:
       suffix: 4
       args: -pc_type eisenstat -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always
@@ -331,6 +384,19 @@ int main(int argc,char **args)
       args: -ksp_monitor_short -ksp_type pipelcg -m 9 -n 9 -pc_type none -ksp_pipelcg_pipel 2 -ksp_pipelcg_lmax 2
       filter: grep -v "sqrt breakdown in iteration"
 
+   test:
+      suffix: scg
+      args: -ksp_monitor_short -ksp_type scg -m 9 -n 9 -pc_type jacobi
+
+   test:
+      suffix: scg_2
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type scg -m 9 -n 9 -ksp_sstep_s 6 -ksp_sstep_basis chebyshev -ksp_norm_type natural
+
+   test:
+      suffix: scg_3
+      args: -ksp_monitor_short -ksp_type scg -m 9 -n 9 -pc_type jacobi -ksp_rtol 1e-1 -ksp_max_it 8 -ksp_converged_reason
+
    test:
       suffix: sell
       args: -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always -m 9 -n 9 -mat_type sell
@@ -340,6 +406,15 @@ int main(int argc,char **args)
       suffix: sell_mumps
       args: -ksp_type preonly -m 9 -n 12 -mat_type sell -pc_type lu -pc_factor_mat_solver_type mumps -pc_factor_mat_ordering_type natural
 
+   test:
+      suffix: sgmres
+      args: -ksp_monitor_short -ksp_type sgmres -m 9 -n 9 -ksp_gmres_restart 10 -ksp_sstep_s 3
+
+   test:
+      suffix: sgmres_2
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type sgmres -m 9 -n 9 -ksp_pc_side right -ksp_sstep_eigenvalues 0.1,2
+
    test:
       suffix: telescope
       nsize: 4
@@ -208,4 +208,8 @@ PetscErrorCode FormElementRhs(PetscScalar x,PetscScalar y,PetscReal H,PetscScala
       nsize: 2
       args: -ksp_monitor_short
 
+   test:
+      suffix: hash_assembly
+      args: -ksp_monitor_short -mat_aij_hash_assembly -mat_view ::ascii_info
+
 TEST*/
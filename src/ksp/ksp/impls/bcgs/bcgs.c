@@ -25,10 +25,11 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 {
   PetscErrorCode ierr;
   PetscInt       i;
-  PetscScalar    rho,rhoold,alpha,beta,omega,omegaold,d1;
+  PetscScalar    rho,rhonext = 0.0,rhoold,alpha,beta,omega,omegaold,d1;
   Vec            X,B,V,P,R,RP,T,S;
   PetscReal      dp    = 0.0,d2;
   KSP_BCGS       *bcgs = (KSP_BCGS*)ksp->data;
+  VecFusedOps    fops;
 
   PetscFunctionBegin;
   X  = ksp->vec_sol;
@@ -79,9 +80,12 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
   ierr     = VecSet(P,0.0);CHKERRQ(ierr);
   ierr     = VecSet(V,0.0);CHKERRQ(ierr);
 
+  ierr = VecFusedOpsCreate(&fops);CHKERRQ(ierr);
   i=0;
   do {
-    ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);       /*   rho <- (r,rp)      */
+    if (!i) {
+      ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);     /*   rho <- (r,rp)      */
+    } else rho = rhonext;                          /*   computed with the update of r */
     beta = (rho/rhoold) * (alpha/omegaold);
     ierr = VecAXPBYPCZ(P,1.0,-omegaold*beta,beta,R,V);CHKERRQ(ierr);  /* p <- r - omega * beta* v + beta * p */
     ierr = KSP_PCApplyBAorAB(ksp,P,V,T);CHKERRQ(ierr);  /*   v <- K p           */
@@ -116,11 +120,14 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
       break;
     }
     omega = d1 / d2;                               /*   w <- (t's) / (t't) */
-    ierr  = VecAXPBYPCZ(X,alpha,omega,1.0,P,S);CHKERRQ(ierr); /* x <- alpha * p + omega * s + x */
-    ierr  = VecWAXPY(R,-omega,T,S);CHKERRQ(ierr);     /*   r <- s - w t       */
+    /* the updates of x and r, the norm of r and the next rho are done in one pass over the vectors */
+    ierr  = VecFusedOpsAXPBYPCZ(fops,X,alpha,omega,1.0,P,S);CHKERRQ(ierr); /* x <- alpha * p + omega * s + x */
+    ierr  = VecFusedOpsWAXPY(fops,R,-omega,T,S);CHKERRQ(ierr);     /*   r <- s - w t       */
     if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+      ierr = VecFusedOpsNorm(fops,R,NORM_2,&dp);CHKERRQ(ierr);
     }
+    ierr  = VecFusedOpsDot(fops,R,RP,&rhonext);CHKERRQ(ierr);       /*   rho <- (r,rp)      */
+    ierr  = VecFusedOpsExecute(fops);CHKERRQ(ierr);
 
     rhoold   = rho;
     omegaold = omega;
@@ -139,6 +146,7 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     }
     i++;
   } while (i<ksp->max_it);
+  ierr = VecFusedOpsDestroy(&fops);CHKERRQ(ierr);
 
   if (i >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
 
@@ -102,6 +102,7 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
   KSP_CG         *cg;
   Mat            Amat,Pmat;
   PetscBool      diagonalscale;
+  VecFusedOps    fops;
 
   PetscFunctionBegin;
   ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
@@ -162,6 +163,7 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     KSPCheckDot(ksp,beta);
   }
 
+  ierr = VecFusedOpsCreate(&fops);CHKERRQ(ierr);
   i = 0;
   do {
     ksp->its = i+1;
@@ -200,13 +202,18 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     }
     a = beta/dpi;                                              /*     a = beta/p'w                     */
     if (eigs) d[i] = PetscSqrtReal(PetscAbsScalar(b))*e[i] + 1.0/a;
-    ierr = VecAXPY(X,a,P);CHKERRQ(ierr);                       /*     x <- x + ap                      */
-    ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                      /*     r <- r - aw                      */
+    /* the updates of x and r, and the norm of r, are done in one pass over the vectors */
+    ierr = VecFusedOpsAXPY(fops,X,a,P);CHKERRQ(ierr);          /*     x <- x + ap                      */
+    ierr = VecFusedOpsAXPY(fops,R,-a,W);CHKERRQ(ierr);         /*     r <- r - aw                      */
+    if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
+      ierr = VecFusedOpsNorm(fops,R,NORM_2,&dp);CHKERRQ(ierr); /*     dp <- r'*r                       */
+    }
+    ierr = VecFusedOpsExecute(fops);CHKERRQ(ierr);
     if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i+2) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
       ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- z'*z                       */
     } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- r'*r                       */
+      /* dp was computed together with the update of r */
     } else if (ksp->normtype == KSP_NORM_NATURAL) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
       ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*     beta <- r'*z                     */
@@ -232,6 +239,7 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
 
     i++;
   } while (i<ksp->max_it);
+  ierr = VecFusedOpsDestroy(&fops);CHKERRQ(ierr);
   if (i >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
   PetscFunctionReturn(0);
 }
@@ -7,6 +7,63 @@
     given for correct computation of inner products.
 */
 #include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+#include <petscblaslapack.h>
+
+/*
+   With the Krylov basis in one block (KSPGMRESSetContiguousBasis()) the products with the first it+1
+   basis vectors are dense matrix-vector products with the leading columns of the block.
+
+   lhh[j] = <VEC_VV(it+1),VEC_VV(j)>, j = 0,...,it
+*/
+static PetscErrorCode KSPGMRESBasisMDot_Private(KSP ksp,PetscInt it,PetscScalar *lhh)
+{
+  KSP_GMRES         *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode    ierr;
+  const PetscScalar *w;
+  PetscScalar       one = 1.0,zero = 0.0;
+  PetscBLASInt      m,k,lda,ione = 1;
+  PetscInt          n,j;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(VEC_VV(it+1),&n);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&m);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(it+1,&k);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(gmres->basis_lda,&lda);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(VEC_VV(it+1),&w);CHKERRQ(ierr);
+  if (m) {
+    PetscStackCallBLAS("BLASgemv",BLASgemv_("C",&m,&k,&one,gmres->basis,&lda,(PetscScalar*)w,&ione,&zero,lhh,&ione));
+  } else {
+    for (j=0; j<=it; j++) lhh[j] = 0.0;
+  }
+  ierr = VecRestoreArrayRead(VEC_VV(it+1),&w);CHKERRQ(ierr);
+  ierr = PetscLogFlops(PetscMax(2.0*n*k - k,0.0));CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,lhh,k,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   VEC_VV(it+1) += sum_j lhh[j] VEC_VV(j), j = 0,...,it
+*/
+static PetscErrorCode KSPGMRESBasisMAXPY_Private(KSP ksp,PetscInt it,PetscScalar *lhh)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode ierr;
+  PetscScalar    *w,one = 1.0;
+  PetscBLASInt   m,k,lda,ione = 1;
+  PetscInt       n;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(VEC_VV(it+1),&n);CHKERRQ(ierr);
+  if (!n) PetscFunctionReturn(0);
+  ierr = PetscBLASIntCast(n,&m);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(it+1,&k);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(gmres->basis_lda,&lda);CHKERRQ(ierr);
+  ierr = VecGetArray(VEC_VV(it+1),&w);CHKERRQ(ierr);
+  PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&m,&k,&one,gmres->basis,&lda,lhh,&ione,&one,w,&ione));
+  ierr = VecRestoreArray(VEC_VV(it+1),&w);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*n*k);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
 /*@C
      KSPGMRESClassicalGramSchmidtOrthogonalization -  This is the basic orthogonalization routine
@@ -46,6 +103,9 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
   if (!gmres->orthogwork) {
     ierr = PetscMalloc1(gmres->max_k + 2,&gmres->orthogwork);CHKERRQ(ierr);
   }
+  if (!gmres->orthogfops) {
+    ierr = VecFusedOpsCreate(&gmres->orthogfops);CHKERRQ(ierr);
+  }
   lhh = gmres->orthogwork;
 
   /* update Hessenberg matrix and do unmodified Gram-Schmidt */
@@ -62,7 +122,11 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
      This is really a matrix-vector product, with the matrix stored
      as pointer to rows
   */
-  ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  if (gmres->basis) {
+    ierr = KSPGMRESBasisMDot_Private(ksp,it,lhh);CHKERRQ(ierr);
+  } else {
+    ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  }
   for (j=0; j<=it; j++) {
     KSPCheckDot(ksp,lhh[j]);
     lhh[j] = -lhh[j];
@@ -72,7 +136,17 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
          This is really a matrix vector product:
          [h[0],h[1],...]*[ v[0]; v[1]; ...] subtracted from v[it+1].
   */
-  ierr = VecMAXPY(VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
+  if (gmres->basis) {
+    ierr = KSPGMRESBasisMAXPY_Private(ksp,it,lhh);CHKERRQ(ierr);
+    if (!refine) {ierr = VecNorm(VEC_VV(it+1),NORM_2,&wnrm);CHKERRQ(ierr);}
+  } else {
+    ierr = VecFusedOpsMAXPY(gmres->orthogfops,VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
+    /* unless it is refined, the norm of the new vector is computed in the same pass and returned to the caller */
+    if (!refine) {
+      ierr = VecFusedOpsNorm(gmres->orthogfops,VEC_VV(it+1),NORM_2,&wnrm);CHKERRQ(ierr);
+    }
+    ierr = VecFusedOpsExecute(gmres->orthogfops);CHKERRQ(ierr);
+  }
   /* note lhh[j] is -<v,vnew> , hence the subtraction */
   for (j=0; j<=it; j++) {
     hh[j]  -= lhh[j];     /* hh += <v,vnew> */
@@ -88,7 +162,6 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
     for (j=0; j<=it; j++) hnrm +=  PetscRealPart(lhh[j] * PetscConj(lhh[j]));
 
     hnrm = PetscSqrtReal(hnrm);
-    ierr = VecNorm(VEC_VV(it+1),NORM_2, &wnrm);CHKERRQ(ierr);
     if (wnrm < hnrm) {
       refine = PETSC_TRUE;
       ierr   = PetscInfo2(ksp,"Performing iterative refinement wnorm %g hnorm %g\n",(double)wnrm,(double)hnrm);CHKERRQ(ierr);
@@ -96,15 +169,26 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
   }
 
   if (refine) {
-    ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
-    for (j=0; j<=it; j++) lhh[j] = -lhh[j];
-    ierr = VecMAXPY(VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
+    if (gmres->basis) {
+      ierr = KSPGMRESBasisMDot_Private(ksp,it,lhh);CHKERRQ(ierr);
+      for (j=0; j<=it; j++) lhh[j] = -lhh[j];
+      ierr = KSPGMRESBasisMAXPY_Private(ksp,it,lhh);CHKERRQ(ierr);
+      ierr = VecNorm(VEC_VV(it+1),NORM_2,&wnrm);CHKERRQ(ierr);
+    } else {
+      ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+      for (j=0; j<=it; j++) lhh[j] = -lhh[j];
+      ierr = VecFusedOpsMAXPY(gmres->orthogfops,VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
+      ierr = VecFusedOpsNorm(gmres->orthogfops,VEC_VV(it+1),NORM_2,&wnrm);CHKERRQ(ierr);
+      ierr = VecFusedOpsExecute(gmres->orthogfops);CHKERRQ(ierr);
+    }
     /* note lhh[j] is -<v,vnew> , hence the subtraction */
     for (j=0; j<=it; j++) {
       hh[j]  -= lhh[j];     /* hh += <v,vnew> */
       hes[j] -= lhh[j];     /* hes += <v,vnew> */
     }
   }
+  gmres->orthognorm    = wnrm;
+  gmres->orthognormset = PETSC_TRUE;
   ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
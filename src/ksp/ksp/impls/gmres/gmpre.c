@@ -29,3 +29,38 @@ PetscErrorCode  KSPGMRESSetPreAllocateVectors(KSP ksp)
   PetscFunctionReturn(0);
 }
 
+/*@
+    KSPGMRESSetContiguousBasis - Causes GMRES, FGMRES and LGMRES to store all the Krylov vectors in one
+    column-major block, so that the classical Gram-Schmidt orthogonalization is done with dense BLAS
+    matrix-vector products on the block instead of VecMDot() and VecMAXPY() on separate vectors.
+
+    Logically Collective on KSP
+
+    Input Parameters:
++   ksp - iterative context obtained from KSPCreate
+-   flg - PETSC_TRUE to use one block
+
+    Options Database Key:
+.   -ksp_gmres_contiguous_basis - Activates KSPGMRESSetContiguousBasis()
+
+    Notes:
+    Must be called before KSPSetUp(). The block is preallocated for the full restart. It is only used
+    for standard sequential and MPI vectors; with other vector types the Krylov vectors are allocated
+    separately as usual.
+
+    Level: intermediate
+
+.keywords: GMRES, vectors, orthogonalization, BLAS
+
+.seealso: KSPGMRESSetPreAllocateVectors(), KSPGMRESSetRestart(), KSPGMRESClassicalGramSchmidtOrthogonalization()
+@*/
+PetscErrorCode  KSPGMRESSetContiguousBasis(KSP ksp,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveBool(ksp,flg,2);
+  ierr = PetscTryMethod(ksp,"KSPGMRESSetContiguousBasis_C",(KSP,PetscBool),(ksp,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
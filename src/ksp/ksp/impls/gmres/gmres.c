@@ -29,11 +29,76 @@
  */
 
 #include <../src/ksp/ksp/impls/gmres/gmresimpl.h>       /*I  "petscksp.h"  I*/
+#include <petsc/private/vecimpl.h>
+#include <petscdm.h>
 #define GMRES_DELTA_DIRECTIONS 10
 #define GMRES_DEFAULT_MAXK     30
 static PetscErrorCode KSPGMRESUpdateHessenberg(KSP,PetscInt,PetscBool,PetscReal*);
 static PetscErrorCode KSPGMRESBuildSoln(PetscScalar*,Vec,Vec,KSP,PetscInt);
 
+/*
+   Creates the two temporary vectors as usual, and all the Krylov vectors (plus any extra ones) as
+   columns of one block so the orthogonalization can use BLAS on it. This requires standard sequential
+   or MPI vectors; for other types the basis is left to KSPSetUp_GMRES() and gmres->basis stays NULL.
+*/
+static PetscErrorCode KSPGMRESCreateContiguousBasis_Private(KSP ksp)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)ksp->data;
+  PetscErrorCode ierr;
+  Vec            tmpl;
+  DM             dm;
+  VecType        vtype;
+  PetscBool      isseq,ismpi;
+  PetscInt       n,N,bs,lda,nv,k;
+
+  PetscFunctionBegin;
+  ierr = KSPCreateVecs(ksp,VEC_OFFSET,&gmres->user_work[0],0,NULL);CHKERRQ(ierr);
+  tmpl = gmres->user_work[0][0];
+  ierr = PetscObjectTypeCompare((PetscObject)tmpl,VECSEQ,&isseq);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)tmpl,VECMPI,&ismpi);CHKERRQ(ierr);
+  if (!isseq && !ismpi) {
+    ierr = VecGetType(tmpl,&vtype);CHKERRQ(ierr);
+    ierr = PetscInfo1(ksp,"Vectors of type %s cannot share one block, allocating the Krylov basis separately\n",vtype);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(VEC_OFFSET,&gmres->user_work[0]);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscLogObjectParents(ksp,VEC_OFFSET,gmres->user_work[0]);CHKERRQ(ierr);
+  for (k=0; k<VEC_OFFSET; k++) gmres->vecs[k] = gmres->user_work[0][k];
+  gmres->mwork_alloc[0] = VEC_OFFSET;
+
+  ierr = VecGetLocalSize(tmpl,&n);CHKERRQ(ierr);
+  ierr = VecGetSize(tmpl,&N);CHKERRQ(ierr);
+  ierr = VecGetBlockSize(tmpl,&bs);CHKERRQ(ierr);
+  ierr = VecGetDM(tmpl,&dm);CHKERRQ(ierr);
+  /* pad the columns to a multiple of 8 entries so each vector starts as aligned as the block */
+  lda  = PetscMax(8*((n + 7)/8),1);
+  nv   = gmres->vecs_allocated - VEC_OFFSET;
+  ierr = PetscMalloc1(lda*nv,&gmres->basis);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,lda*nv*sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = PetscMalloc1(nv,&gmres->user_work[1]);CHKERRQ(ierr);
+  for (k=0; k<nv; k++) {
+    Vec v;
+
+    if (isseq) {
+      ierr = VecCreateSeqWithArray(PetscObjectComm((PetscObject)tmpl),bs,n,gmres->basis + k*lda,&v);CHKERRQ(ierr);
+    } else {
+      ierr = VecCreateMPIWithArray(PetscObjectComm((PetscObject)tmpl),bs,n,N,gmres->basis + k*lda,&v);CHKERRQ(ierr);
+    }
+    /* keep any operations (such as VecView()) the application or the DM set on its vectors */
+    ierr = PetscMemcpy(v->ops,tmpl->ops,sizeof(struct _VecOps));CHKERRQ(ierr);
+    if (dm) {ierr = VecSetDM(v,dm);CHKERRQ(ierr);}
+    gmres->user_work[1][k]      = v;
+    gmres->vecs[VEC_OFFSET + k] = v;
+  }
+  ierr = PetscLogObjectParents(ksp,nv,gmres->user_work[1]);CHKERRQ(ierr);
+  gmres->mwork_alloc[1] = nv;
+  gmres->nwork_alloc    = 2;
+  gmres->vv_allocated   = gmres->vecs_allocated;
+  gmres->basis_lda      = lda;
+  ierr = PetscInfo3(ksp,"Krylov basis of %D vectors stored in one block with %D local rows and leading dimension %D\n",nv,n,lda);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode    KSPSetUp_GMRES(KSP ksp)
 {
   PetscInt       hh,hes,rs,cc;
@@ -68,6 +133,10 @@ PetscErrorCode    KSPSetUp_GMRES(KSP ksp)
   ierr = PetscMalloc1(VEC_OFFSET+2+max_k,&gmres->mwork_alloc);CHKERRQ(ierr);
   ierr = PetscLogObjectMemory((PetscObject)ksp,(VEC_OFFSET+2+max_k)*(sizeof(Vec*)+sizeof(PetscInt)) + gmres->vecs_allocated*sizeof(Vec));CHKERRQ(ierr);
 
+  if (gmres->contiguous) {
+    ierr = KSPGMRESCreateContiguousBasis_Private(ksp);CHKERRQ(ierr);
+    if (gmres->basis) PetscFunctionReturn(0);
+  }
   if (gmres->q_preallocate) {
     gmres->vv_allocated = VEC_OFFSET + 2 + max_k;
 
@@ -152,11 +221,17 @@ PetscErrorCode KSPGMRESCycle(PetscInt *itcount,KSP ksp)
     ierr = KSP_PCApplyBAorAB(ksp,VEC_VV(it),VEC_VV(1+it),VEC_TEMP_MATOP);CHKERRQ(ierr);
 
     /* update hessenberg matrix and do Gram-Schmidt */
+    gmres->orthognormset = PETSC_FALSE;
     ierr = (*gmres->orthog)(ksp,it);CHKERRQ(ierr);
     if (ksp->reason) break;
 
     /* vv(i+1) . vv(i+1) */
-    ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    if (gmres->orthognormset) {
+      tt   = gmres->orthognorm;
+      if (tt != 0.0) {ierr = VecScale(VEC_VV(it+1),1.0/tt);CHKERRQ(ierr);}
+    } else {
+      ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    }
 
     /* save the magnitude */
     *HH(it+1,it)  = tt;
@@ -276,6 +351,7 @@ PetscErrorCode KSPReset_GMRES(KSP ksp)
     ierr = VecDestroyVecs(gmres->mwork_alloc[i],&gmres->user_work[i]);CHKERRQ(ierr);
   }
   gmres->nwork_alloc = 0;
+  ierr = PetscFree(gmres->basis);CHKERRQ(ierr);
   if (gmres->vecb)  {
     ierr = VecDestroyVecs(gmres->max_k+1,&gmres->vecb);CHKERRQ(ierr);
   }
@@ -287,6 +363,7 @@ PetscErrorCode KSPReset_GMRES(KSP ksp)
   ierr = PetscFree(gmres->Rsvd);CHKERRQ(ierr);
   ierr = PetscFree(gmres->Dsvd);CHKERRQ(ierr);
   ierr = PetscFree(gmres->orthogwork);CHKERRQ(ierr);
+  ierr = VecFusedOpsDestroy(&gmres->orthogfops);CHKERRQ(ierr);
 
   gmres->sol_temp       = 0;
   gmres->vv_allocated   = 0;
@@ -304,6 +381,7 @@ PetscErrorCode KSPDestroy_GMRES(KSP ksp)
   ierr = PetscFree(ksp->data);CHKERRQ(ierr);
   /* clear composed functions */
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetPreAllocateVectors_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetContiguousBasis_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetOrthogonalization_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetOrthogonalization_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",NULL);CHKERRQ(ierr);
@@ -513,6 +591,9 @@ PetscErrorCode KSPView_GMRES(KSP ksp,PetscViewer viewer)
   if (iascii) {
     ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, using %s\n",gmres->max_k,cstr);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"  happy breakdown tolerance %g\n",(double)gmres->haptol);CHKERRQ(ierr);
+    if (gmres->basis) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  Krylov basis stored in one block, orthogonalized with BLAS\n");CHKERRQ(ierr);
+    }
   } else if (isstring) {
     ierr = PetscViewerStringSPrintf(viewer,"%s restart %D",cstr,gmres->max_k);CHKERRQ(ierr);
   }
@@ -568,7 +649,7 @@ PetscErrorCode KSPSetFromOptions_GMRES(PetscOptionItems *PetscOptionsObject,KSP
   PetscInt       restart;
   PetscReal      haptol;
   KSP_GMRES      *gmres = (KSP_GMRES*)ksp->data;
-  PetscBool      flg;
+  PetscBool      flg,set;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"KSP GMRES Options");CHKERRQ(ierr);
@@ -579,6 +660,8 @@ PetscErrorCode KSPSetFromOptions_GMRES(PetscOptionItems *PetscOptionsObject,KSP
   flg  = PETSC_FALSE;
   ierr = PetscOptionsBool("-ksp_gmres_preallocate","Preallocate Krylov vectors","KSPGMRESSetPreAllocateVectors",flg,&flg,NULL);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetPreAllocateVectors(ksp);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-ksp_gmres_contiguous_basis","Store the Krylov vectors in one block and orthogonalize with BLAS","KSPGMRESSetContiguousBasis",gmres->contiguous,&flg,&set);CHKERRQ(ierr);
+  if (set) {ierr = KSPGMRESSetContiguousBasis(ksp,flg);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroupBegin("-ksp_gmres_classicalgramschmidt","Classical (unmodified) Gram-Schmidt (fast)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESClassicalGramSchmidtOrthogonalization);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroupEnd("-ksp_gmres_modifiedgramschmidt","Modified Gram-Schmidt (slow,more stable)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
@@ -657,6 +740,16 @@ PetscErrorCode  KSPGMRESSetPreAllocateVectors_GMRES(KSP ksp)
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode  KSPGMRESSetContiguousBasis_GMRES(KSP ksp,PetscBool flg)
+{
+  KSP_GMRES *gmres = (KSP_GMRES*)ksp->data;
+
+  PetscFunctionBegin;
+  if (ksp->setupstage && gmres->contiguous != flg) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ORDER,"Must call KSPGMRESSetContiguousBasis() before KSPSetUp()");
+  gmres->contiguous = flg;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode  KSPGMRESSetCGSRefinementType_GMRES(KSP ksp,KSPGMRESCGSRefinementType type)
 {
   KSP_GMRES *gmres = (KSP_GMRES*)ksp->data;
@@ -840,6 +933,7 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
 .   -ksp_gmres_haptol <tol> - sets the tolerance for "happy ending" (exact convergence)
 .   -ksp_gmres_preallocate - preallocate all the Krylov search directions initially (otherwise groups of
                              vectors are allocated as needed)
+.   -ksp_gmres_contiguous_basis - store the Krylov search directions in one block and use BLAS for the classical Gram-Schmidt
 .   -ksp_gmres_classicalgramschmidt - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space (fast) (the default)
 .   -ksp_gmres_modifiedgramschmidt - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
 .   -ksp_gmres_cgs_refinement_type <never,ifneeded,always> - determine if iterative refinement is used to increase the
@@ -858,7 +952,8 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPFGMRES, KSPLGMRES,
            KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetOrthogonalization(), KSPGMRESGetOrthogonalization(),
            KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(),
-           KSPGMRESCGSRefinementType, KSPGMRESSetCGSRefinementType(), KSPGMRESGetCGSRefinementType(), KSPGMRESMonitorKrylov(), KSPSetPCSide()
+           KSPGMRESCGSRefinementType, KSPGMRESSetCGSRefinementType(), KSPGMRESGetCGSRefinementType(), KSPGMRESMonitorKrylov(), KSPSetPCSide(),
+           KSPGMRESSetContiguousBasis()
 
 M*/
 
@@ -890,6 +985,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_GMRES(KSP ksp)
   ksp->ops->computeritz                  = KSPComputeRitz_GMRES;
 #endif
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetPreAllocateVectors_C",KSPGMRESSetPreAllocateVectors_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetContiguousBasis_C",KSPGMRESSetContiguousBasis_GMRES);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetOrthogonalization_C",KSPGMRESSetOrthogonalization_GMRES);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetOrthogonalization_C",KSPGMRESGetOrthogonalization_GMRES);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_GMRES);CHKERRQ(ierr);
@@ -18,6 +18,9 @@
   PetscScalar *rs_origin;   /* holds the right-hand-side of the Hessenberg system */ \
                                                                         \
   PetscScalar *orthogwork; /* holds dot products computed in orthogonalization */ \
+  VecFusedOps orthogfops;  /* fuses the last update of the orthogonalization with the norm of the new vector */ \
+  PetscReal   orthognorm;  /* norm of the new vector, if computed by the orthogonalization */ \
+  PetscBool   orthognormset;                                           \
                                                                         \
   /* Work space for computing eigenvalues/singular values */            \
   PetscReal   *Dsvd;                                                    \
@@ -41,6 +44,9 @@
   Vec      **user_work;                                              \
   PetscInt *mwork_alloc;       /* Number of work vectors allocated as part of  a work-vector chunck */ \
   PetscInt nwork_alloc;        /* Number of work vector chunks allocated */ \
+  PetscBool   contiguous;      /* requested storage of the Krylov basis in one column-major block */ \
+  PetscScalar *basis;          /* the block holding the local part of VEC_VV(0), VEC_VV(1), ..., if it could be used */ \
+  PetscInt    basis_lda;       /* leading dimension of basis */ \
                                                                         \
   /* Information for building solution */                               \
   PetscInt    it;              /* Current iteration: inside restart */  \
@@ -66,6 +72,7 @@ typedef PetscErrorCode (*FCN)(KSP,PetscInt); /* force argument to next function
 
 PETSC_INTERN PetscErrorCode KSPGMRESSetHapTol_GMRES(KSP,PetscReal);
 PETSC_INTERN PetscErrorCode KSPGMRESSetPreAllocateVectors_GMRES(KSP);
+PETSC_INTERN PetscErrorCode KSPGMRESSetContiguousBasis_GMRES(KSP,PetscBool);
 PETSC_INTERN PetscErrorCode KSPGMRESSetRestart_GMRES(KSP,PetscInt);
 PETSC_INTERN PetscErrorCode KSPGMRESGetRestart_GMRES(KSP,PetscInt*);
 PETSC_INTERN PetscErrorCode KSPGMRESSetOrthogonalization_GMRES(KSP,FCN);
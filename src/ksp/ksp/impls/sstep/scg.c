@@ -0,0 +1,337 @@
+
+/*
+    The s-step conjugate gradient method (Chronopoulos and Gear), with one global reduction every s iterations
+*/
+#include <../src/ksp/ksp/impls/sstep/sstepimpl.h>       /*I  "petscksp.h"  I*/
+#include <petscblaslapack.h>
+
+typedef struct {
+  KSPSStepBasis basis;              /* must be first */
+  PetscInt      salloc;             /* s when the work space was allocated */
+  Vec           *V,*AV;             /* the Krylov vectors of the block and their products with A */
+  Vec           *P,*AP;             /* the search directions of the previous block and their products with A */
+  PetscScalar   *D,*C,*W,*Bc,*g,*a; /* s x s Gram matrices and s vectors, leading dimension s */
+} KSP_SCG;
+
+static PetscErrorCode KSPReset_SCG(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (scg->salloc) {
+    ierr = VecDestroyVecs(scg->salloc,&scg->V);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(scg->salloc,&scg->AV);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(scg->salloc,&scg->P);CHKERRQ(ierr);
+    ierr = VecDestroyVecs(scg->salloc,&scg->AP);CHKERRQ(ierr);
+  }
+  ierr = PetscFree6(scg->D,scg->C,scg->W,scg->Bc,scg->g,scg->a);CHKERRQ(ierr);
+  scg->salloc = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetUp_SCG(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscInt       s    = scg->basis.s;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetWorkVecs(ksp,1);CHKERRQ(ierr);
+  ierr = KSPCreateVecs(ksp,s,&scg->V,s,&scg->AV);CHKERRQ(ierr);
+  ierr = KSPCreateVecs(ksp,s,&scg->P,s,&scg->AP);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,s,scg->V);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,s,scg->AV);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,s,scg->P);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,s,scg->AP);CHKERRQ(ierr);
+  ierr = PetscMalloc6(s*s,&scg->D,s*s,&scg->C,s*s,&scg->W,s*s,&scg->Bc,s,&scg->g,s,&scg->a);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(4*s*s + 2*s)*sizeof(PetscScalar));CHKERRQ(ierr);
+  scg->salloc = s;
+  ierr = KSPSStepBasisSetUp_Private(ksp,&scg->basis);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The first block uses the monomial basis, for which the Gram matrix of the Krylov vectors in the inner product
+   of the preconditioner is [g, D(:,0:sb-2)] since B^{-1} v_j = A v_{j-1}. The Ritz values of the preconditioned
+   operator are the eigenvalues of the pencil (D, [g, D(:,0:sb-2)]).
+*/
+static PetscErrorCode KSPSCGEstimateInterval_Private(KSP ksp,PetscInt sb)
+{
+#if defined(PETSC_USE_COMPLEX)
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscInfo(ksp,"No estimate of the spectrum with complex numbers, use KSPSStepSetEigenvalues()\n");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#else
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscInt       s    = scg->basis.s,i,j;
+  PetscErrorCode ierr;
+  PetscScalar    *A,*G,*work;
+  PetscReal      *eig,emin,emax;
+  PetscBLASInt   n,lwork,itype = 1,info;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(sb,&n);CHKERRQ(ierr);
+  lwork = 3*n;
+  ierr = PetscMalloc4(sb*sb,&A,sb*sb,&G,sb,&eig,lwork,&work);CHKERRQ(ierr);
+  for (j=0; j<sb; j++) {
+    for (i=0; i<sb; i++) {
+      A[i+j*sb] = scg->D[i+j*s];
+      G[i+j*sb] = j ? scg->D[i+(j-1)*s] : scg->g[i];
+    }
+  }
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKsygv",LAPACKsygv_(&itype,"N","U",&n,A,&n,G,&n,eig,work,&lwork,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) {
+    ierr = PetscInfo1(ksp,"Could not estimate the spectrum from the first block, LAPACK info %d; keeping the monomial basis\n",(int)info);CHKERRQ(ierr);
+  } else {
+    emin = eig[0];
+    emax = eig[sb-1];
+    ierr = KSPSStepBasisSetInterval_Private(ksp,&scg->basis,emin - 0.05*(emax - emin),emax + 0.05*(emax - emin));CHKERRQ(ierr);
+  }
+  ierr = PetscFree4(A,G,eig,work);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#endif
+}
+
+static PetscErrorCode KSPSolve_SCG(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  KSPSStepBasis  *b   = &scg->basis;
+  PetscErrorCode ierr;
+  PetscInt       s = b->s,sb,sbold = 0,i,j;
+  PetscScalar    *D = scg->D,*C = scg->C,*W = scg->W,*Bc = scg->Bc,*g = scg->g,*a = scg->a,one = 1.0,mone = -1.0;
+  PetscReal      dp = 0.0;
+  PetscBLASInt   n,nold,lds,ione = 1,info;
+  Vec            X,B,R,*tmp;
+  Mat            Amat,Pmat;
+  MPI_Comm       comm;
+  PetscBool      diagonalscale,redo = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+  ierr = PetscObjectGetComm((PetscObject)ksp,&comm);CHKERRQ(ierr);
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(s,&lds);CHKERRQ(ierr);
+  ierr = KSPSStepBasisStart_Private(ksp,b);CHKERRQ(ierr);
+
+  X = ksp->vec_sol;
+  B = ksp->vec_rhs;
+  R = ksp->work[0];
+
+  ksp->its = 0;
+  if (!ksp->guess_zero) {
+    ierr = KSP_MatMult(ksp,Amat,X,R);CHKERRQ(ierr);            /*     r <- b - Ax     */
+    ierr = VecAYPX(R,-1.0,B);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(B,R);CHKERRQ(ierr);                         /*     r <- b (x is 0) */
+  }
+
+  do {
+    sb = PetscMin(s,ksp->max_it - ksp->its);
+    ierr = PetscBLASIntCast(sb,&n);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(sbold,&nold);CHKERRQ(ierr);
+
+    /* the Krylov vectors v_0 = B r, v_{j+1} = p_j(BA) v_0 of the block, and A v_j */
+    ierr = KSP_PCApply(ksp,R,scg->V[0]);CHKERRQ(ierr);
+    for (j=0; j<sb; j++) {
+      ierr = KSP_MatMult(ksp,Amat,scg->V[j],scg->AV[j]);CHKERRQ(ierr);
+      if (j < sb-1) {
+        ierr = KSP_PCApply(ksp,scg->AV[j],scg->V[j+1]);CHKERRQ(ierr);
+        ierr = KSPSStepBasisNext_Private(b,j,scg->V[j+1],scg->V[j],j ? scg->V[j-1] : NULL);CHKERRQ(ierr);
+      }
+    }
+
+    /* the only global reduction of the block: D = V'AV, C = (AP)'V, g = V'r and the residual norm */
+    for (j=0; j<sb; j++) {ierr = VecMDotBegin(scg->AV[j],sb,scg->V,D+j*s);CHKERRQ(ierr);}
+    for (j=0; j<sb && sbold; j++) {ierr = VecMDotBegin(scg->V[j],sbold,scg->AP,C+j*s);CHKERRQ(ierr);}
+    ierr = VecMDotBegin(R,sb,scg->V,g);CHKERRQ(ierr);
+    if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+      ierr = VecNormBegin(scg->V[0],NORM_2,&dp);CHKERRQ(ierr);
+    } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+      ierr = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);
+    }
+    ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+    for (j=0; j<sb; j++) {ierr = VecMDotEnd(scg->AV[j],sb,scg->V,D+j*s);CHKERRQ(ierr);}
+    for (j=0; j<sb && sbold; j++) {ierr = VecMDotEnd(scg->V[j],sbold,scg->AP,C+j*s);CHKERRQ(ierr);}
+    ierr = VecMDotEnd(R,sb,scg->V,g);CHKERRQ(ierr);
+    if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+      ierr = VecNormEnd(scg->V[0],NORM_2,&dp);CHKERRQ(ierr);
+    } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+      ierr = VecNormEnd(R,NORM_2,&dp);CHKERRQ(ierr);
+    } else if (ksp->normtype == KSP_NORM_NATURAL) {
+      KSPCheckDot(ksp,g[0]);
+      dp = PetscSqrtReal(PetscAbsScalar(g[0]));                 /*     dp <- r'*B*r       */
+    } else dp = 0.0;
+
+    if (!redo) {
+      ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ksp->rnorm = dp;
+      ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,ksp->its,dp);CHKERRQ(ierr);
+      ierr = (*ksp->converged)(ksp,ksp->its,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason) break;
+    }
+    redo = PETSC_FALSE;
+
+    if (!ksp->its && !b->eigknown && b->type != KSP_SSTEP_BASIS_MONOMIAL && sb > 1) {
+      ierr = KSPSCGEstimateInterval_Private(ksp,sb);CHKERRQ(ierr);
+      /* the monomial block only served to estimate the spectrum, the loss of conjugacy it would cause grows quickly with s */
+      if (b->eigknown) {redo = PETSC_TRUE; continue;}
+    }
+
+    if (sbold) {
+      /* make the new directions A-orthogonal to the previous ones: P = V - P_old Bc with Bc = W_old^{-1} C */
+      for (j=0; j<sb; j++) {ierr = PetscMemcpy(Bc+j*s,C+j*s,sbold*sizeof(PetscScalar));CHKERRQ(ierr);}
+      PetscStackCallBLAS("LAPACKpotrs",LAPACKpotrs_("U",&nold,&n,W,&lds,Bc,&lds,&info));
+      if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+      /* P'AP = D - C'Bc */
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&n,&n,&nold,&mone,C,&lds,Bc,&lds,&one,D,&lds));
+      for (j=0; j<sb; j++) {
+        for (i=0; i<sbold; i++) a[i] = -Bc[i+j*s];
+        ierr = VecMAXPY(scg->V[j],sbold,a,scg->P);CHKERRQ(ierr);
+        ierr = VecMAXPY(scg->AV[j],sbold,a,scg->AP);CHKERRQ(ierr);
+      }
+    }
+    tmp = scg->P; scg->P = scg->V; scg->V = tmp;
+    tmp = scg->AP; scg->AP = scg->AV; scg->AV = tmp;
+
+    /* step lengths a = W^{-1} P'r, where P'r = V'r since the residual is orthogonal to the previous directions */
+    for (j=0; j<sb; j++) {ierr = PetscMemcpy(W+j*s,D+j*s,sb*sizeof(PetscScalar));CHKERRQ(ierr);}
+    PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&n,W,&lds,&info));
+    if (info) {
+      ierr = PetscInfo1(ksp,"Matrix P'AP of the block is not positive definite (LAPACK info %d), reduce s or use a better conditioned basis\n",(int)info);CHKERRQ(ierr);
+      if (ksp->errorifnotconverged) SETERRQ(comm,PETSC_ERR_NOT_CONVERGED,"s-step CG breakdown: P'AP is not positive definite");
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+    ierr = PetscMemcpy(a,g,sb*sizeof(PetscScalar));CHKERRQ(ierr);
+    PetscStackCallBLAS("LAPACKpotrs",LAPACKpotrs_("U",&n,&ione,W,&lds,a,&lds,&info));
+    if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+    ierr = PetscLogFlops(2.0*sb*sb*sbold + 1.0*sb*sb*sb/3.0 + 2.0*sb*sb);CHKERRQ(ierr);
+
+    ierr = VecMAXPY(X,sb,a,scg->P);CHKERRQ(ierr);              /*     x <- x + P a       */
+    for (j=0; j<sb; j++) a[j] = -a[j];
+    ierr = VecMAXPY(R,sb,a,scg->AP);CHKERRQ(ierr);             /*     r <- r - AP a      */
+
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->its += sb;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    sbold = sb;
+  } while (ksp->its < ksp->max_it);
+  if (!ksp->reason) {
+    /* the last block may have converged: test the residual of its update */
+    PetscScalar rBr;
+
+    if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+    } else if (ksp->normtype != KSP_NORM_NONE) {
+      ierr = KSP_PCApply(ksp,R,scg->V[0]);CHKERRQ(ierr);
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+        ierr = VecNorm(scg->V[0],NORM_2,&dp);CHKERRQ(ierr);
+      } else {
+        ierr = VecDot(scg->V[0],R,&rBr);CHKERRQ(ierr);
+        KSPCheckDot(ksp,rBr);
+        dp = PetscSqrtReal(PetscAbsScalar(rBr));
+      }
+    } else dp = 0.0;
+    ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ksp->rnorm = dp;
+    ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+    ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,ksp->its,dp);CHKERRQ(ierr);
+    ierr = (*ksp->converged)(ksp,ksp->its,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+    if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_SCG(KSP ksp)
+{
+  KSP_SCG        *scg = (KSP_SCG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_SCG(ksp);CHKERRQ(ierr);
+  ierr = KSPSStepBasisDestroy_Private(&scg->basis);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetSteps_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepGetSteps_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetBasisType_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetEigenvalues_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_SCG(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetFromOptions_SStep(PetscOptionsObject,ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   KSPSCG - The s-step (communication avoiding) preconditioned conjugate gradient method. Each block of s iterations
+   builds s Krylov vectors with s matrix-vector products and preconditioner applications, and then needs a single
+   global reduction, compared to 2s for KSPCG and s for KSPPIPECG.
+
+   Options Database Keys:
++   -ksp_sstep_s <s> - number of iterations per block (default 4)
+.   -ksp_sstep_basis <monomial,newton,chebyshev> - polynomial basis of the Krylov vectors (default newton)
+-   -ksp_sstep_eigenvalues <emin,emax> - interval containing the spectrum of the preconditioned operator, for the newton
+                                         and chebyshev bases; estimated from the first block of each solve if not given
+
+   Level: intermediate
+
+   Notes:
+   The matrix and the preconditioner must be symmetric positive definite. The residual norm is only available at
+   the start of each block, so the convergence test, the monitors and the residual history see the iterations
+   0, s, 2s, ... Each block orthogonalizes its directions against the previous block only, as in the s-step
+   method of Chronopoulos and Gear; in finite precision the attainable accuracy decreases as s grows, the Newton
+   and Chebyshev bases allow larger s than the monomial one.
+
+   References:
++   1. - A. T. Chronopoulos and C. W. Gear, "s-step iterative methods for symmetric linear systems",
+        Journal of Computational and Applied Mathematics 25, 1989.
+-   2. - M. Hoemmen, "Communication-avoiding Krylov subspace methods", PhD thesis, UC Berkeley, 2010.
+
+.seealso: KSPCreate(), KSPSetType(), KSPCG, KSPPIPECG, KSPSGMRES, KSPSStepSetSteps(), KSPSStepSetBasisType(),
+          KSPSStepSetEigenvalues()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_SCG(KSP ksp)
+{
+  KSP_SCG        *scg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&scg);CHKERRQ(ierr);
+  scg->basis.s    = 4;
+  scg->basis.type = KSP_SSTEP_BASIS_NEWTON;
+  ksp->data       = (void*)scg;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_SCG;
+  ksp->ops->solve          = KSPSolve_SCG;
+  ksp->ops->reset          = KSPReset_SCG;
+  ksp->ops->destroy        = KSPDestroy_SCG;
+  ksp->ops->view           = KSPView_SStep;
+  ksp->ops->setfromoptions = KSPSetFromOptions_SCG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetSteps_C",KSPSStepSetSteps_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepGetSteps_C",KSPSStepGetSteps_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetBasisType_C",KSPSStepSetBasisType_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetEigenvalues_C",KSPSStepSetEigenvalues_SStep);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,473 @@
+
+/*
+    The s-step (communication avoiding) GMRES method: blocks of s Krylov vectors orthogonalized with one global reduction
+*/
+#include <../src/ksp/ksp/impls/sstep/sstepimpl.h>       /*I  "petscksp.h"  I*/
+#include <petscblaslapack.h>
+
+typedef struct {
+  KSPSStepBasis basis;                /* must be first */
+  PetscInt      max_k;                /* restart */
+  PetscInt      salloc,kalloc;        /* s and max_k when the work space was allocated */
+  Vec           *Q;                   /* the max_k+1 orthonormal Krylov vectors */
+  PetscScalar   *H,*hh,*cc,*ss,*rs,*y; /* Hessenberg matrix, its triangular factor from the Givens rotations, and the least squares problem */
+  PetscScalar   *Cb,*R,*Rb,*Bm,*T,*a; /* the dot products of a block, its triangular factor and the change of basis */
+} KSP_SGMRES;
+
+#define VEC_TEMP       ksp->work[0]
+#define VEC_TEMP_MATOP ksp->work[1]
+
+static PetscErrorCode KSPReset_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (sg->kalloc) {ierr = VecDestroyVecs(sg->kalloc+1,&sg->Q);CHKERRQ(ierr);}
+  ierr = PetscFree6(sg->H,sg->hh,sg->cc,sg->ss,sg->rs,sg->y);CHKERRQ(ierr);
+  ierr = PetscFree6(sg->Cb,sg->R,sg->Rb,sg->Bm,sg->T,sg->a);CHKERRQ(ierr);
+  sg->salloc = 0;
+  sg->kalloc = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetUp_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  PetscInt       s   = sg->basis.s,m = sg->max_k,ld = m+1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetWorkVecs(ksp,2);CHKERRQ(ierr);
+  ierr = KSPCreateVecs(ksp,m+1,&sg->Q,0,NULL);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,m+1,sg->Q);CHKERRQ(ierr);
+  ierr = PetscMalloc6(ld*m,&sg->H,ld*m,&sg->hh,m,&sg->cc,m,&sg->ss,ld,&sg->rs,m,&sg->y);CHKERRQ(ierr);
+  ierr = PetscMalloc6(ld*s,&sg->Cb,s*s,&sg->R,ld*(s+1),&sg->Rb,(s+1)*s,&sg->Bm,ld*s,&sg->T,ld,&sg->a);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(2*ld*m + 3*m + 2*ld + ld*(3*s+1) + s*s + (s+1)*s)*sizeof(PetscScalar));CHKERRQ(ierr);
+  sg->salloc = s;
+  sg->kalloc = m;
+  ierr = KSPSStepBasisSetUp_Private(ksp,&sg->basis);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The first block of a solve uses the monomial basis; the real parts of the Ritz values, the eigenvalues of the leading
+   sb x sb block of its Hessenberg matrix, give the interval for the Newton and Chebyshev bases of the next blocks.
+*/
+static PetscErrorCode KSPSGMRESEstimateInterval_Private(KSP ksp,PetscInt sb)
+{
+#if defined(PETSC_USE_COMPLEX) || defined(PETSC_HAVE_ESSL)
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscInfo(ksp,"No estimate of the spectrum with complex numbers or ESSL, use KSPSStepSetEigenvalues()\n");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#else
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  PetscInt       ld  = sg->max_k+1,i,j;
+  PetscErrorCode ierr;
+  PetscScalar    *A,*wr,*wi,*work,sdummy;
+  PetscReal      emin,emax;
+  PetscBLASInt   n,lwork,idummy = 1,info;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(sb,&n);CHKERRQ(ierr);
+  lwork = 5*n;
+  ierr = PetscMalloc4(sb*sb,&A,sb,&wr,sb,&wi,lwork,&work);CHKERRQ(ierr);
+  for (j=0; j<sb; j++) {
+    for (i=0; i<sb; i++) A[i+j*sb] = sg->H[i+j*ld];
+  }
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","N",&n,A,&n,wr,wi,&sdummy,&idummy,&sdummy,&idummy,work,&lwork,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) {
+    ierr = PetscInfo1(ksp,"Could not estimate the spectrum from the first block, LAPACK info %d; keeping the monomial basis\n",(int)info);CHKERRQ(ierr);
+  } else {
+    emin = emax = wr[0];
+    for (i=1; i<sb; i++) {
+      emin = PetscMin(emin,wr[i]);
+      emax = PetscMax(emax,wr[i]);
+    }
+    ierr = KSPSStepBasisSetInterval_Private(ksp,&sg->basis,emin - 0.05*(emax - emin),emax + 0.05*(emax - emin));CHKERRQ(ierr);
+  }
+  ierr = PetscFree4(A,wr,wi,work);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#endif
+}
+
+/*
+   Applies the previous Givens rotations to column it of the Hessenberg matrix, computes the new rotation and
+   returns the updated residual norm, as KSPGMRESUpdateHessenberg() does
+*/
+static PetscErrorCode KSPSGMRESUpdateHessenberg_Private(KSP ksp,PetscInt it,PetscReal *res)
+{
+  KSP_SGMRES  *sg = (KSP_SGMRES*)ksp->data;
+  PetscInt    ld  = sg->max_k+1,j;
+  PetscScalar *hh = sg->hh + it*ld,*cc = sg->cc,*ss = sg->ss,*rs = sg->rs,tt;
+
+  PetscFunctionBegin;
+  for (j=0; j<it; j++) {
+    tt      = hh[j];
+    hh[j]   = PetscConj(cc[j])*tt + ss[j]*hh[j+1];
+    hh[j+1] = cc[j]*hh[j+1] - ss[j]*tt;
+  }
+  tt = PetscSqrtScalar(PetscConj(hh[it])*hh[it] + PetscConj(hh[it+1])*hh[it+1]);
+  if (tt == 0.0) {
+    ksp->reason = KSP_DIVERGED_NULL;
+    PetscFunctionReturn(0);
+  }
+  cc[it]    = hh[it]/tt;
+  ss[it]    = hh[it+1]/tt;
+  rs[it+1]  = -(ss[it]*rs[it]);
+  rs[it]    = PetscConj(cc[it])*rs[it];
+  hh[it]    = PetscConj(cc[it])*hh[it] + ss[it]*hh[it+1];
+  hh[it+1]  = 0.0;
+  *res      = PetscAbsScalar(rs[it+1]);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Orthonormalizes the sb new vectors Q[ks+1..ks+sb] of a block against Q[0..ks] and among themselves with one global
+   reduction (Gram matrix and Cholesky factorization), then computes the columns ks..ks+sb-1 of the Hessenberg matrix.
+   On return sb may be smaller if the new vectors are numerically dependent, and *happy is set if the first of them
+   already lies in the span of Q[0..ks], in which case Q[ks+1] is not formed and the cycle must end.
+*/
+static PetscErrorCode KSPSGMRESBlock_Private(KSP ksp,PetscInt ks,PetscInt *sbb,PetscBool *happy)
+{
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  PetscInt       s   = sg->basis.s,ld = sg->max_k+1,sb = *sbb,i,j,l;
+  PetscScalar    *Cb = sg->Cb,*R = sg->R,*Rb = sg->Rb,*Bm = sg->Bm,*T = sg->T,*a = sg->a,*H = sg->H,one = 1.0,mone = -1.0,zero = 0.0;
+  PetscReal      rjj = 0.0;
+  PetscBLASInt   bm,bn,bk,bld,bldb;
+  Vec            *Q = sg->Q;
+  MPI_Comm       comm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)ksp,&comm);CHKERRQ(ierr);
+  /* the only global reduction of the block: column j of Cb holds Q[0..ks+1+j]' v_{j+1} */
+  for (j=0; j<sb; j++) {ierr = VecMDotBegin(Q[ks+1+j],ks+2+j,Q,Cb+j*ld);CHKERRQ(ierr);}
+  ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+  for (j=0; j<sb; j++) {ierr = VecMDotEnd(Q[ks+1+j],ks+2+j,Q,Cb+j*ld);CHKERRQ(ierr);}
+
+  /* Cholesky factorization R'R of the Gram matrix of the new vectors projected out of Q[0..ks], stopped at the first dependent vector */
+  *happy = PETSC_FALSE;
+  for (j=0; j<sb; j++) {
+    for (l=0; l<=j; l++) {
+      PetscScalar sum = Cb[ks+1+l+j*ld];
+      for (i=0; i<=ks; i++) sum -= PetscConj(Cb[i+l*ld])*Cb[i+j*ld];
+      for (i=0; i<l; i++) sum -= PetscConj(R[i+l*s])*R[i+j*s];
+      if (l < j) R[l+j*s] = sum/R[l+l*s];
+      else rjj = PetscRealPart(sum);
+    }
+    if (rjj <= PETSC_SQRT_MACHINE_EPSILON*PetscRealPart(Cb[ks+1+j+j*ld])) break;
+    R[j+j*s] = PetscSqrtReal(rjj);
+  }
+  if (j < sb) {
+    ierr = PetscInfo3(ksp,"Vector %D of the block starting at column %D is numerically dependent, using %D vectors\n",j,ks,j);CHKERRQ(ierr);
+  }
+  if (!j) {
+    /* the Krylov space is (numerically) invariant: keep the norm of the remainder as the last subdiagonal entry */
+    *happy = PETSC_TRUE;
+    R[0]   = PetscSqrtReal(PetscMax(rjj,0.0));
+    sb     = 1;
+  } else sb = j;
+  *sbb = sb;
+
+  /* the new orthonormal vectors q_{ks+1+j} = (v_{j+1} - Q[0..ks+j] [C_j; R_j])/R_jj */
+  for (j=0; j<sb && !*happy; j++) {
+    for (i=0; i<=ks; i++) a[i] = -Cb[i+j*ld];
+    for (l=0; l<j; l++) a[ks+1+l] = -R[l+j*s];
+    ierr = VecMAXPY(Q[ks+1+j],ks+1+j,a,Q);CHKERRQ(ierr);
+    ierr = VecScale(Q[ks+1+j],1.0/R[j+j*s]);CHKERRQ(ierr);
+  }
+
+  /* [v_0 ... v_sb] = Q[0..ks+sb] Rb with v_0 = q_ks */
+  for (j=0; j<=sb; j++) {ierr = PetscMemzero(Rb+j*ld,(ks+sb+1)*sizeof(PetscScalar));CHKERRQ(ierr);}
+  Rb[ks] = 1.0;
+  for (j=0; j<sb; j++) {
+    for (i=0; i<=ks; i++) Rb[i+(j+1)*ld] = Cb[i+j*ld];
+    for (l=0; l<=j; l++) Rb[ks+1+l+(j+1)*ld] = R[l+j*s];
+  }
+
+  /*
+     Op [v_0 ... v_{sb-1}] = [v_0 ... v_sb] Bm gives H(:,ks:ks+sb-1) Rb(ks:ks+sb-1,0:sb-1) = Rb Bm - H(:,0:ks-1) Rb(0:ks-1,0:sb-1),
+     solved with the upper triangular Rb(ks:ks+sb-1,0:sb-1)
+  */
+  ierr = KSPSStepBasisChange_Private(&sg->basis,sb,Bm,s+1);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ks+sb+1,&bm);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(sb,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(sb+1,&bk);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ld,&bld);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(s+1,&bldb);CHKERRQ(ierr);
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bm,&bn,&bk,&one,Rb,&bld,Bm,&bldb,&zero,T,&bld));
+  if (ks) {
+    ierr = PetscBLASIntCast(ks+1,&bm);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(ks,&bk);CHKERRQ(ierr);
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bm,&bn,&bk,&mone,H,&bld,Rb,&bld,&one,T,&bld));
+    ierr = PetscBLASIntCast(ks+sb+1,&bm);CHKERRQ(ierr);
+  }
+  PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","U","N","N",&bm,&bn,&one,Rb+ks,&bld,T,&bld));
+  for (j=0; j<sb; j++) {
+    ierr = PetscMemzero(H+(ks+j)*ld,ld*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMemcpy(H+(ks+j)*ld,T+j*ld,(ks+j+2)*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  ierr = PetscLogFlops(1.0*sb*sb*(ks+sb) + 2.0*(ks+sb+1)*(sb+1)*sb + 2.0*(ks+1)*ks*sb + 1.0*(ks+sb+1)*sb*sb);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   One restart cycle; on entry Q[0] holds the initial (preconditioned) residual
+*/
+static PetscErrorCode KSPSGMRESCycle_Private(KSP ksp,PetscInt *itcount)
+{
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  KSPSStepBasis  *b  = &sg->basis;
+  PetscInt       ld  = sg->max_k+1,ks = 0,sb,i,j,k;
+  PetscReal      res;
+  PetscBool      happy = PETSC_FALSE;
+  Vec            *Q = sg->Q;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *itcount = 0;
+  ierr = VecNormalize(Q[0],&res);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,res);
+  sg->rs[0] = res;
+
+  ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = res;
+  ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    ierr = PetscInfo(ksp,"Converged due to zero residual norm on entry\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+
+  while (!ksp->reason && !happy && ks < sg->max_k && ksp->its < ksp->max_it) {
+    sb = PetscMin(b->s,PetscMin(sg->max_k - ks,ksp->max_it - ksp->its));
+    /* the Krylov vectors v_0 = q_ks, v_{j+1} = p_j(Op) v_0 of the block, generated in place of Q[ks+1..ks+sb] */
+    for (j=0; j<sb; j++) {
+      ierr = KSP_PCApplyBAorAB(ksp,Q[ks+j],Q[ks+j+1],VEC_TEMP_MATOP);CHKERRQ(ierr);
+      ierr = KSPSStepBasisNext_Private(b,j,Q[ks+j+1],Q[ks+j],j ? Q[ks+j-1] : NULL);CHKERRQ(ierr);
+    }
+    ierr = KSPSGMRESBlock_Private(ksp,ks,&sb,&happy);CHKERRQ(ierr);
+    if (!ks && !ksp->its && !b->eigknown && b->type != KSP_SSTEP_BASIS_MONOMIAL && sb > 1) {
+      ierr = KSPSGMRESEstimateInterval_Private(ksp,sb);CHKERRQ(ierr);
+    }
+
+    /* the residual norm of each iteration of the block */
+    for (j=0; j<sb; j++) {
+      i    = ks + j;
+      ierr = PetscMemcpy(sg->hh+i*ld,sg->H+i*ld,(i+2)*sizeof(PetscScalar));CHKERRQ(ierr);
+      ierr = KSPSGMRESUpdateHessenberg_Private(ksp,i,&res);CHKERRQ(ierr);
+      if (ksp->reason) break;
+      (*itcount)++;
+      ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ksp->its++;
+      ksp->rnorm = res;
+      ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+      ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+      ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason) break;
+    }
+    ks += sb;
+  }
+  if (happy && !ksp->reason) {
+    ierr = PetscInfo1(ksp,"Invariant Krylov space found at iteration %D, restarting\n",ksp->its);CHKERRQ(ierr);
+  }
+
+  /* the solution update from the triangular system of the Givens rotations */
+  k = *itcount;
+  for (i=k-1; i>=0; i--) {
+    if (sg->hh[i+i*ld] == 0.0) {
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      ierr = PetscInfo1(ksp,"Likely breakdown, zero diagonal in the Hessenberg matrix at %D\n",i);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    sg->y[i] = sg->rs[i];
+    for (j=i+1; j<k; j++) sg->y[i] -= sg->hh[i+j*ld]*sg->y[j];
+    sg->y[i] /= sg->hh[i+i*ld];
+  }
+  if (!k) PetscFunctionReturn(0);
+  if (ksp->pc_side == PC_RIGHT) {
+    ierr = VecSet(VEC_TEMP,0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(VEC_TEMP,k,sg->y,Q);CHKERRQ(ierr);
+    ierr = KSPUnwindPreconditioner(ksp,VEC_TEMP,VEC_TEMP_MATOP);CHKERRQ(ierr);
+    ierr = VecAXPY(ksp->vec_sol,1.0,VEC_TEMP);CHKERRQ(ierr);
+  } else {
+    ierr = VecMAXPY(ksp->vec_sol,k,sg->y,Q);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       its,itcount = 0;
+  PetscBool      guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  ierr = KSPSStepBasisStart_Private(ksp,&sg->basis);CHKERRQ(ierr);
+  ierr     = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr     = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    ierr     = KSPInitialResidual(ksp,ksp->vec_sol,VEC_TEMP,VEC_TEMP_MATOP,sg->Q[0],ksp->vec_rhs);CHKERRQ(ierr);
+    ierr     = KSPSGMRESCycle_Private(ksp,&its);CHKERRQ(ierr);
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSGMRESSetRestart_SGMRES(KSP ksp,PetscInt max_k)
+{
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (max_k < 1) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Restart must be positive");
+  if (!ksp->setupstage) {
+    sg->max_k = max_k;
+  } else if (sg->max_k != max_k) {
+    sg->max_k       = max_k;
+    ksp->setupstage = KSP_SETUP_NEW;
+    /* free the data structures, then create them again */
+    ierr = KSPReset_SGMRES(ksp);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSGMRESGetRestart_SGMRES(KSP ksp,PetscInt *max_k)
+{
+  PetscFunctionBegin;
+  *max_k = ((KSP_SGMRES*)ksp->data)->max_k;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_SGMRES(ksp);CHKERRQ(ierr);
+  ierr = KSPSStepBasisDestroy_Private(&sg->basis);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetSteps_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepGetSteps_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetBasisType_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetEigenvalues_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",NULL);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_SGMRES(KSP ksp,PetscViewer viewer)
+{
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D\n",sg->max_k);CHKERRQ(ierr);
+  }
+  ierr = KSPView_SStep(ksp,viewer);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_SGMRES(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_SGMRES     *sg = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       restart;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP s-step GMRES Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_gmres_restart","Number of Krylov search directions","KSPGMRESSetRestart",sg->max_k,&restart,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGMRESSetRestart(ksp,restart);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  ierr = KSPSetFromOptions_SStep(PetscOptionsObject,ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   KSPSGMRES - The s-step (communication avoiding) GMRES method. Each block of s iterations generates s Krylov
+   vectors with s operator applications and orthogonalizes them against the previous ones and among themselves with a
+   single global reduction, compared to at least s for KSPGMRES with classical Gram-Schmidt and KSPPGMRES.
+
+   Options Database Keys:
++   -ksp_gmres_restart <restart> - the number of Krylov directions to orthogonalize against (default 30)
+.   -ksp_sstep_s <s> - number of iterations per block (default 4)
+.   -ksp_sstep_basis <monomial,newton,chebyshev> - polynomial basis of the Krylov vectors (default newton)
+-   -ksp_sstep_eigenvalues <emin,emax> - interval containing the real parts of the spectrum of the preconditioned
+                                         operator, for the newton and chebyshev bases; estimated from the first block
+                                         of each solve if not given
+
+   Level: intermediate
+
+   Notes:
+   The residual norm of every iteration is available from the Hessenberg matrix, so the convergence test and the
+   monitors see each iteration as for KSPGMRES, but the block is always completed before they are called. The vectors
+   of a block are orthogonalized with the Cholesky factorization of their Gram matrix (CholQR) instead of a tall skinny
+   QR factorization; a block is shortened when one of its vectors is numerically dependent on the previous ones, so
+   s should stay moderate (up to about 10 with the Newton basis). The restart is rounded to whole blocks, the last block
+   of a cycle may be shorter. KSPGMRESSetRestart() applies to this method.
+
+   References:
++   1. - M. Hoemmen, "Communication-avoiding Krylov subspace methods", PhD thesis, UC Berkeley, 2010.
+-   2. - Z. Bai, D. Hu and L. Reichel, "A Newton basis GMRES implementation", IMA Journal of Numerical Analysis 14, 1994.
+
+.seealso: KSPCreate(), KSPSetType(), KSPGMRES, KSPPGMRES, KSPSCG, KSPSStepSetSteps(), KSPSStepSetBasisType(),
+          KSPSStepSetEigenvalues(), KSPGMRESSetRestart()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&sg);CHKERRQ(ierr);
+  sg->basis.s    = 4;
+  sg->basis.type = KSP_SSTEP_BASIS_NEWTON;
+  sg->max_k      = 30;
+  ksp->data      = (void*)sg;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_RIGHT,1);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_SGMRES;
+  ksp->ops->solve          = KSPSolve_SGMRES;
+  ksp->ops->reset          = KSPReset_SGMRES;
+  ksp->ops->destroy        = KSPDestroy_SGMRES;
+  ksp->ops->view           = KSPView_SGMRES;
+  ksp->ops->setfromoptions = KSPSetFromOptions_SGMRES;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetSteps_C",KSPSStepSetSteps_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepGetSteps_C",KSPSStepGetSteps_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetBasisType_C",KSPSStepSetBasisType_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSStepSetEigenvalues_C",KSPSStepSetEigenvalues_SStep);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPSGMRESSetRestart_SGMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",KSPSGMRESGetRestart_SGMRES);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
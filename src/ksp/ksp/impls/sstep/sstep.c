@@ -0,0 +1,352 @@
+
+/*
+    Routines shared by the s-step Krylov methods: the polynomial bases and the options
+*/
+#include <../src/ksp/ksp/impls/sstep/sstepimpl.h>       /*I  "petscksp.h"  I*/
+
+PetscErrorCode KSPSStepBasisNext_Private(KSPSStepBasis *b,PetscInt j,Vec w,Vec vj,Vec vjm1)
+{
+  PetscErrorCode ierr;
+  PetscReal      c = 0.5*(b->emax + b->emin),d = 0.5*(b->emax - b->emin);
+
+  PetscFunctionBegin;
+  switch (KSPSStepBasisType_Private(b)) {
+  case KSP_SSTEP_BASIS_MONOMIAL:
+    break;
+  case KSP_SSTEP_BASIS_NEWTON:
+    ierr = VecAXPY(w,-b->theta[j],vj);CHKERRQ(ierr);
+    break;
+  case KSP_SSTEP_BASIS_CHEBYSHEV:
+    if (!j) {
+      ierr = VecAXPBY(w,-c/d,1.0/d,vj);CHKERRQ(ierr);                   /* v_1 = (Op - c) v_0 / d */
+    } else {
+      ierr = VecAXPBYPCZ(w,-2.0*c/d,-1.0,2.0/d,vj,vjm1);CHKERRQ(ierr);  /* v_{j+1} = 2 (Op - c) v_j / d - v_{j-1} */
+    }
+    break;
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepBasisChange_Private(KSPSStepBasis *b,PetscInt s,PetscScalar *B,PetscInt ldb)
+{
+  PetscErrorCode ierr;
+  PetscInt       j;
+  PetscReal      c = 0.5*(b->emax + b->emin),d = 0.5*(b->emax - b->emin);
+
+  PetscFunctionBegin;
+  for (j=0; j<s; j++) {
+    ierr = PetscMemzero(B + j*ldb,(s+1)*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  switch (KSPSStepBasisType_Private(b)) {
+  case KSP_SSTEP_BASIS_MONOMIAL:
+    for (j=0; j<s; j++) B[j*ldb+j+1] = 1.0;
+    break;
+  case KSP_SSTEP_BASIS_NEWTON:
+    for (j=0; j<s; j++) {
+      B[j*ldb+j]   = b->theta[j];
+      B[j*ldb+j+1] = 1.0;
+    }
+    break;
+  case KSP_SSTEP_BASIS_CHEBYSHEV:
+    B[0] = c;
+    B[1] = d;
+    for (j=1; j<s; j++) {
+      B[j*ldb+j-1] = 0.5*d;
+      B[j*ldb+j]   = c;
+      B[j*ldb+j+1] = 0.5*d;
+    }
+    break;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Sets the interval of the spectrum and computes the Newton shifts: the Chebyshev points of the interval in Leja
+   order, so that the products of the first few factors do not over- or underflow.
+*/
+PetscErrorCode KSPSStepBasisSetInterval_Private(KSP ksp,KSPSStepBasis *b,PetscReal emin,PetscReal emax)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,k,l,imax;
+  PetscReal      *x,c = 0.5*(emax + emin),d = 0.5*(emax - emin),p,pmax;
+
+  PetscFunctionBegin;
+  if (!(emax > emin) || PetscIsInfOrNanReal(emin) || PetscIsInfOrNanReal(emax)) {
+    ierr = PetscInfo2(ksp,"Cannot use the interval [%g,%g], keeping the monomial basis\n",(double)emin,(double)emax);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  b->emin     = emin;
+  b->emax     = emax;
+  b->eigknown = PETSC_TRUE;
+  ierr = PetscMalloc1(b->s,&x);CHKERRQ(ierr);
+  for (i=0; i<b->s; i++) x[i] = c + d*PetscCosReal((2*i+1)*PETSC_PI/(2*b->s));
+  for (k=0; k<b->s; k++) {
+    imax = k;
+    pmax = -1.0;
+    for (i=k; i<b->s; i++) {
+      p = PetscAbsReal(x[i]);
+      if (k) {
+        for (p=1.0,l=0; l<k; l++) p *= PetscAbsReal(x[i] - b->theta[l]);
+      }
+      if (p > pmax) {pmax = p; imax = i;}
+    }
+    b->theta[k] = x[imax];
+    x[imax]     = x[k];
+  }
+  ierr = PetscFree(x);CHKERRQ(ierr);
+  ierr = PetscInfo2(ksp,"Basis built for the interval [%g,%g]\n",(double)emin,(double)emax);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepBasisSetUp_Private(KSP ksp,KSPSStepBasis *b)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(b->theta);CHKERRQ(ierr);
+  ierr = PetscMalloc1(b->s,&b->theta);CHKERRQ(ierr);
+  b->eigknown = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Called at the start of each solve: the operator may have changed, so an estimated interval is not reused
+*/
+PetscErrorCode KSPSStepBasisStart_Private(KSP ksp,KSPSStepBasis *b)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  b->eigknown = PETSC_FALSE;
+  if (b->eiguser && b->type != KSP_SSTEP_BASIS_MONOMIAL) {
+    ierr = KSPSStepBasisSetInterval_Private(ksp,b,b->emin,b->emax);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepBasisDestroy_Private(KSPSStepBasis *b)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(b->theta);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSetFromOptions_SStep(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  PetscErrorCode    ierr;
+  KSPSStepBasis     *b = (KSPSStepBasis*)ksp->data;
+  PetscInt          s,neig = 2;
+  KSPSStepBasisType type;
+  PetscReal         eig[2];
+  PetscBool         flg;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP s-step Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_sstep_s","Number of iterations per global reduction","KSPSStepSetSteps",b->s,&s,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPSStepSetSteps(ksp,s);CHKERRQ(ierr);}
+  ierr = PetscOptionsEnum("-ksp_sstep_basis","Polynomial basis of the Krylov vectors of a block","KSPSStepSetBasisType",KSPSStepBasisTypes,(PetscEnum)b->type,(PetscEnum*)&type,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPSStepSetBasisType(ksp,type);CHKERRQ(ierr);}
+  eig[0] = b->emin;
+  eig[1] = b->emax;
+  ierr = PetscOptionsRealArray("-ksp_sstep_eigenvalues","Interval containing the spectrum of the preconditioned operator","KSPSStepSetEigenvalues",eig,&neig,&flg);CHKERRQ(ierr);
+  if (flg) {
+    if (neig != 2) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_SIZ,"-ksp_sstep_eigenvalues needs two values: emin,emax");
+    ierr = KSPSStepSetEigenvalues(ksp,eig[0],eig[1]);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPView_SStep(KSP ksp,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  KSPSStepBasis  *b = (KSPSStepBasis*)ksp->data;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  s=%D iterations per global reduction, %s basis\n",b->s,KSPSStepBasisTypes[b->type]);CHKERRQ(ierr);
+    if (b->type != KSP_SSTEP_BASIS_MONOMIAL && b->eigknown) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  basis built for the interval [%g,%g] (%s)\n",(double)b->emin,(double)b->emax,b->eiguser ? "user provided" : "estimated from the first block");CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepSetSteps_SStep(KSP ksp,PetscInt s)
+{
+  PetscErrorCode ierr;
+  KSPSStepBasis  *b = (KSPSStepBasis*)ksp->data;
+
+  PetscFunctionBegin;
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of steps %D must be positive",s);
+  if (s == b->s) PetscFunctionReturn(0);
+  b->s = s;
+  if (ksp->setupstage) {
+    ksp->setupstage = KSP_SETUP_NEW;
+    /* free the data structures, then create them again */
+    ierr = (*ksp->ops->reset)(ksp);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepGetSteps_SStep(KSP ksp,PetscInt *s)
+{
+  PetscFunctionBegin;
+  *s = ((KSPSStepBasis*)ksp->data)->s;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepSetBasisType_SStep(KSP ksp,KSPSStepBasisType type)
+{
+  PetscFunctionBegin;
+  ((KSPSStepBasis*)ksp->data)->type = type;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPSStepSetEigenvalues_SStep(KSP ksp,PetscReal emin,PetscReal emax)
+{
+  KSPSStepBasis *b = (KSPSStepBasis*)ksp->data;
+
+  PetscFunctionBegin;
+  if (emax <= emin) SETERRQ2(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_INCOMP,"Maximum eigenvalue %g must be larger than minimum %g",(double)emax,(double)emin);
+  b->emin    = emin;
+  b->emax    = emax;
+  b->eiguser = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSStepSetSteps - Sets the number of iterations that the s-step methods KSPSCG and KSPSGMRES perform for each
+   global reduction.
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  s - the number of iterations per block
+
+   Options Database Key:
+.  -ksp_sstep_s <s> - number of iterations per block
+
+   Notes:
+   Larger s means fewer reductions but a worse conditioned basis; with the Newton or Chebyshev basis values up to
+   about 10 are usually safe. For KSPSGMRES the restart is rounded to whole blocks of s iterations, the last block of a
+   cycle may be shorter.
+
+   Level: intermediate
+
+.keywords: KSP, s-step, communication avoiding
+
+.seealso: KSPSCG, KSPSGMRES, KSPSStepGetSteps(), KSPSStepSetBasisType(), KSPSStepSetEigenvalues()
+@*/
+PetscErrorCode KSPSStepSetSteps(KSP ksp,PetscInt s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,s,2);
+  ierr = PetscTryMethod(ksp,"KSPSStepSetSteps_C",(KSP,PetscInt),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSStepGetSteps - Gets the number of iterations that the s-step methods KSPSCG and KSPSGMRES perform for each
+   global reduction.
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameter:
+.  s - the number of iterations per block
+
+   Level: intermediate
+
+.keywords: KSP, s-step, communication avoiding
+
+.seealso: KSPSCG, KSPSGMRES, KSPSStepSetSteps()
+@*/
+PetscErrorCode KSPSStepGetSteps(KSP ksp,PetscInt *s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidIntPointer(s,2);
+  ierr = PetscUseMethod(ksp,"KSPSStepGetSteps_C",(KSP,PetscInt*),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSStepSetBasisType - Sets the polynomial basis in which the s-step methods KSPSCG and KSPSGMRES generate the
+   Krylov vectors of a block.
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  type - KSP_SSTEP_BASIS_MONOMIAL, KSP_SSTEP_BASIS_NEWTON (the default) or KSP_SSTEP_BASIS_CHEBYSHEV
+
+   Options Database Key:
+.  -ksp_sstep_basis <monomial,newton,chebyshev> - the basis
+
+   Notes:
+   The Newton and Chebyshev bases need an interval containing the spectrum (the real parts of the eigenvalues for
+   KSPSGMRES) of the preconditioned operator. Unless it is given with KSPSStepSetEigenvalues(), the first block of
+   each solve uses the monomial basis and the interval is estimated from its Ritz values, which come with the
+   reduction of that block at no extra communication.
+
+   Level: intermediate
+
+.keywords: KSP, s-step, communication avoiding
+
+.seealso: KSPSCG, KSPSGMRES, KSPSStepBasisType, KSPSStepSetSteps(), KSPSStepSetEigenvalues()
+@*/
+PetscErrorCode KSPSStepSetBasisType(KSP ksp,KSPSStepBasisType type)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(ksp,type,2);
+  ierr = PetscTryMethod(ksp,"KSPSStepSetBasisType_C",(KSP,KSPSStepBasisType),(ksp,type));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSStepSetEigenvalues - Sets the interval containing the spectrum of the preconditioned operator, used to build
+   the Newton and Chebyshev bases of the s-step methods KSPSCG and KSPSGMRES.
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+.  emin - lower end of the interval
+-  emax - upper end of the interval
+
+   Options Database Key:
+.  -ksp_sstep_eigenvalues <emin,emax> - the interval
+
+   Level: intermediate
+
+.keywords: KSP, s-step, communication avoiding, eigenvalues
+
+.seealso: KSPSCG, KSPSGMRES, KSPSStepSetBasisType(), KSPChebyshevSetEigenvalues()
+@*/
+PetscErrorCode KSPSStepSetEigenvalues(KSP ksp,PetscReal emin,PetscReal emax)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveReal(ksp,emin,2);
+  PetscValidLogicalCollectiveReal(ksp,emax,3);
+  ierr = PetscTryMethod(ksp,"KSPSStepSetEigenvalues_C",(KSP,PetscReal,PetscReal),(ksp,emin,emax));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,44 @@
+/*
+    Private data common to the s-step (communication avoiding) Krylov methods KSPSCG and KSPSGMRES.
+    Each block of s iterations generates s Krylov vectors with a polynomial basis and then needs a
+    single global reduction.
+*/
+#if !defined(__SSTEPIMPL_H)
+#define __SSTEPIMPL_H
+
+#include <petsc/private/kspimpl.h>        /*I "petscksp.h" I*/
+
+/*
+   This must be the first member of the data structure of each s-step method, the shared routines below
+   find it at ksp->data.
+*/
+typedef struct {
+  PetscInt          s;           /* number of iterations per block */
+  KSPSStepBasisType type;        /* requested basis; the monomial one is used until the spectrum is known */
+  PetscBool         eigknown;    /* emin and emax are available, set by the user or estimated from the first block */
+  PetscBool         eiguser;     /* emin and emax were set by the user */
+  PetscReal         emin,emax;   /* interval containing the (real parts of the) spectrum of the preconditioned operator */
+  PetscReal         *theta;      /* the s Newton shifts, in Leja order */
+} KSPSStepBasis;
+
+/*
+   Given w = Op v_j, computes in place the next basis vector w <- v_{j+1}; vjm1 = v_{j-1} is only used by the Chebyshev basis.
+*/
+PETSC_INTERN PetscErrorCode KSPSStepBasisNext_Private(KSPSStepBasis*,PetscInt,Vec,Vec,Vec);
+/* the (s+1) x s matrix B with Op [v_0 ... v_{s-1}] = [v_0 ... v_s] B, with leading dimension ldb */
+PETSC_INTERN PetscErrorCode KSPSStepBasisChange_Private(KSPSStepBasis*,PetscInt,PetscScalar*,PetscInt);
+PETSC_INTERN PetscErrorCode KSPSStepBasisSetInterval_Private(KSP,KSPSStepBasis*,PetscReal,PetscReal);
+PETSC_INTERN PetscErrorCode KSPSStepBasisSetUp_Private(KSP,KSPSStepBasis*);
+PETSC_INTERN PetscErrorCode KSPSStepBasisStart_Private(KSP,KSPSStepBasis*);
+PETSC_INTERN PetscErrorCode KSPSStepBasisDestroy_Private(KSPSStepBasis*);
+PETSC_INTERN PetscErrorCode KSPSetFromOptions_SStep(PetscOptionItems*,KSP);
+PETSC_INTERN PetscErrorCode KSPView_SStep(KSP,PetscViewer);
+PETSC_INTERN PetscErrorCode KSPSStepSetSteps_SStep(KSP,PetscInt);
+PETSC_INTERN PetscErrorCode KSPSStepGetSteps_SStep(KSP,PetscInt*);
+PETSC_INTERN PetscErrorCode KSPSStepSetBasisType_SStep(KSP,KSPSStepBasisType);
+PETSC_INTERN PetscErrorCode KSPSStepSetEigenvalues_SStep(KSP,PetscReal,PetscReal);
+
+/* the basis actually used for the next block */
+#define KSPSStepBasisType_Private(b) ((b)->eigknown ? (b)->type : KSP_SSTEP_BASIS_MONOMIAL)
+
+#endif
@@ -9050,7 +9050,7 @@ PetscErrorCode MatMPIAIJRestrict(Mat A, MPI_Comm ccomm, Mat *B)
 
     if (a->colmap) {
 #if defined(PETSC_USE_CTABLE)
-      ierr = PetscTableCreateCopy(a->colmap,&b->colmap);CHKERRQ(ierr);
+      ierr = PetscHMapIDuplicate(a->colmap,&b->colmap);CHKERRQ(ierr);
 #else
       ierr = PetscMalloc1(At->cmap->N,&b->colmap);CHKERRQ(ierr);
       ierr = PetscLogObjectMemory((PetscObject)*B,At->cmap->N*sizeof(PetscInt));CHKERRQ(ierr);
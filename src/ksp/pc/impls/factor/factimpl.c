@@ -144,6 +144,29 @@ PetscErrorCode  PCFactorSetLevels_Factor(PC pc,PetscInt levels)
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode  PCFactorGetSolveIterative_Factor(PC pc,PetscInt *sweeps)
+{
+  PC_Factor *dir = (PC_Factor*)pc->data;
+
+  PetscFunctionBegin;
+  *sweeps = (PetscInt)dir->info.solveiterative;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode  PCFactorSetSolveIterative_Factor(PC pc,PetscInt sweeps)
+{
+  PC_Factor      *dir = (PC_Factor*)pc->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (pc->setupcalled && dir->info.solveiterative != (PetscReal)sweeps) {
+    ierr            = (*pc->ops->reset)(pc);CHKERRQ(ierr); /* the solve is chosen by the numeric factorization */
+    pc->setupcalled = 0;
+  }
+  dir->info.solveiterative = (PetscReal)sweeps;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode  PCFactorSetAllowDiagonalFill_Factor(PC pc,PetscBool flg)
 {
   PC_Factor *dir = (PC_Factor*)pc->data;
@@ -230,6 +253,7 @@ PetscErrorCode  PCSetFromOptions_Factor(PetscOptionItems *PetscOptionsObject,PC
   PetscFunctionList ordlist;
   PetscEnum         etmp;
   PetscBool         inplace;
+  PetscInt          sweeps;
 
   PetscFunctionBegin;
   ierr = PCFactorGetUseInPlace(pc,&inplace);CHKERRQ(ierr);
@@ -246,6 +270,10 @@ PetscErrorCode  PCSetFromOptions_Factor(PetscOptionItems *PetscOptionsObject,PC
   ierr = PetscOptionsReal("-pc_factor_shift_amount","Shift added to diagonal","PCFactorSetShiftAmount",((PC_Factor*)factor)->info.shiftamount,&((PC_Factor*)factor)->info.shiftamount,0);CHKERRQ(ierr);
 
   ierr = PetscOptionsReal("-pc_factor_zeropivot","Pivot is considered zero if less than","PCFactorSetZeroPivot",((PC_Factor*)factor)->info.zeropivot,&((PC_Factor*)factor)->info.zeropivot,0);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-pc_factor_solve_iterative","Number of Jacobi sweeps replacing each triangular solve, 0 for the exact solves","PCFactorSetSolveIterative",(PetscInt)factor->info.solveiterative,&sweeps,&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = PCFactorSetSolveIterative(pc,sweeps);CHKERRQ(ierr);
+  }
   ierr = PetscOptionsReal("-pc_factor_column_pivot","Column pivot tolerance (used only for some factorization)","PCFactorSetColumnPivot",((PC_Factor*)factor)->info.dtcol,&((PC_Factor*)factor)->info.dtcol,&flg);CHKERRQ(ierr);
 
   ierr = PetscOptionsBool("-pc_factor_pivot_in_blocks","Pivot inside matrix dense blocks for BAIJ and SBAIJ","PCFactorSetPivotInBlocks",((PC_Factor*)factor)->info.pivotinblocks ? PETSC_TRUE : PETSC_FALSE,&flg,&set);CHKERRQ(ierr);
@@ -312,6 +340,9 @@ PetscErrorCode PCView_Factor(PC pc,PetscViewer viewer)
     }
 
     ierr = PetscViewerASCIIPrintf(viewer,"  matrix ordering: %s\n",factor->ordering);CHKERRQ(ierr);
+    if (factor->info.solveiterative > 0) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  triangular solves approximated by %D Jacobi sweeps\n",(PetscInt)factor->info.solveiterative);CHKERRQ(ierr);
+    }
 
     if (factor->fact) {
       MatInfo info;
@@ -317,6 +317,75 @@ PetscErrorCode  PCFactorSetLevels(PC pc,PetscInt levels)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCFactorGetSolveIterative - Gets the number of Jacobi sweeps that replace each triangular solve with the factors.
+
+   Not Collective
+
+   Input Parameters:
+.  pc - the preconditioner context
+
+   Output Parameter:
+.  sweeps - number of Jacobi sweeps, 0 means the triangular solves are exact
+
+   Level: intermediate
+
+.keywords: PC, triangular solve, Jacobi, factorization, incomplete, ILU
+.seealso: PCFactorSetSolveIterative()
+@*/
+PetscErrorCode  PCFactorGetSolveIterative(PC pc,PetscInt *sweeps)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidIntPointer(sweeps,2);
+  ierr = PetscUseMethod(pc,"PCFactorGetSolveIterative_C",(PC,PetscInt*),(pc,sweeps));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PCFactorSetSolveIterative - Replaces the forward and backward substitutions with the factors by a fixed number of
+   Jacobi sweeps on each factor.
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  sweeps - number of Jacobi sweeps, 0 (the default) for the exact triangular solves
+
+   Options Database Key:
+.  -pc_factor_solve_iterative <sweeps> - Sets the number of sweeps
+
+   Notes:
+   A substitution is sequential by nature, each unknown needs the ones before it, while a Jacobi sweep
+   x = D^{-1} (b - (L+U-D) x) on a triangular factor only needs the previous iterate and is computed row by row
+   independently, like MatMult(). The sweeps therefore parallelize as well as MatMult() with -mat_aij_threads, at the
+   price of an approximate application of the preconditioner. Since the factors are triangular the iteration is exact
+   after as many sweeps as the factor has levels, a few sweeps are usually enough to keep the Krylov iteration count
+   close to the one with the exact solves for an ILU preconditioner.
+
+   Only the LU and ILU factors of SEQAIJ matrices computed by PETSc support it, other factors ignore it. Since the
+   approximate solve is a fixed linear operator, the preconditioner can still be used with CG or GMRES, but it may
+   not be symmetric.
+
+   Level: intermediate
+
+.keywords: PC, triangular solve, Jacobi, factorization, incomplete, ILU
+.seealso: PCFactorGetSolveIterative(), PCFactorSetLevels()
+@*/
+PetscErrorCode  PCFactorSetSolveIterative(PC pc,PetscInt sweeps)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  if (sweeps < 0) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_OUTOFRANGE,"negative number of sweeps");
+  PetscValidLogicalCollectiveInt(pc,sweeps,2);
+  ierr = PetscTryMethod(pc,"PCFactorSetSolveIterative_C",(PC,PetscInt),(pc,sweeps));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    PCFactorSetAllowDiagonalFill - Causes all diagonal matrix entries to be
    treated as level 0 fill even if there is no non-zero location.
@@ -733,6 +802,8 @@ PetscErrorCode PCFactorInitialize(PC pc)
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorSetMatOrderingType_C",PCFactorSetMatOrderingType_Factor);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorSetLevels_C",PCFactorSetLevels_Factor);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorGetLevels_C",PCFactorGetLevels_Factor);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorSetSolveIterative_C",PCFactorSetSolveIterative_Factor);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorGetSolveIterative_C",PCFactorGetSolveIterative_Factor);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorSetAllowDiagonalFill_C",PCFactorSetAllowDiagonalFill_Factor);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorGetAllowDiagonalFill_C",PCFactorGetAllowDiagonalFill_Factor);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorSetPivotInBlocks_C",PCFactorSetPivotInBlocks_Factor);CHKERRQ(ierr);
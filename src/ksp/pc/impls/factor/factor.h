@@ -32,6 +32,8 @@ PETSC_INTERN PetscErrorCode PCFactorSetFill_Factor(PC,PetscReal);
 PETSC_INTERN PetscErrorCode PCFactorSetMatOrderingType_Factor(PC,MatOrderingType);
 PETSC_INTERN PetscErrorCode PCFactorGetLevels_Factor(PC,PetscInt*);
 PETSC_INTERN PetscErrorCode PCFactorSetLevels_Factor(PC,PetscInt);
+PETSC_INTERN PetscErrorCode PCFactorGetSolveIterative_Factor(PC,PetscInt*);
+PETSC_INTERN PetscErrorCode PCFactorSetSolveIterative_Factor(PC,PetscInt);
 PETSC_INTERN PetscErrorCode PCFactorSetAllowDiagonalFill_Factor(PC,PetscBool);
 PETSC_INTERN PetscErrorCode PCFactorGetAllowDiagonalFill_Factor(PC,PetscBool*);
 PETSC_INTERN PetscErrorCode PCFactorSetPivotInBlocks_Factor(PC,PetscBool);
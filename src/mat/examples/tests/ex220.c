@@ -0,0 +1,154 @@
+
+static char help[] = "Tests and times the SIMD variants of MatMult(), MatMultAdd() and MatMultTranspose() for AIJ and SELL.\n\
+  The variant is selected with -mat_simd <none,avx2,avx512>, the results are compared with those of a dense matrix.\n\
+  -m <rows>, -n <columns> : size of the matrix\n\
+  -its <its> : number of products to time\n\
+  -timing : print the time and flop rate of each variant\n\n";
+
+#include <petsc/private/matimpl.h>
+#include <petsctime.h>
+
+/*
+   Builds a matrix with row lengths from 0 to 22 so that rows shorter and longer than a vector register, partial
+   SELL slices and columns shared by several rows of a slice all occur.
+*/
+static PetscErrorCode CreateTestMatrix(MatType type,PetscInt m,PetscInt n,Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,nc,cols[23];
+  PetscScalar    vals[23];
+
+  PetscFunctionBegin;
+  ierr = MatCreate(PETSC_COMM_SELF,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,type);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(*A,23,NULL);CHKERRQ(ierr);
+  ierr = MatSeqSELLSetPreallocation(*A,23,NULL);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    nc = PetscMin((5*i)%23,n);
+    for (j=0; j<nc; j++) {
+      cols[j] = (7*i+13*j)%n;
+      vals[j] = 1.0 + 0.01*i - 0.1*j;
+    }
+    ierr = MatSetValues(*A,1,&i,nc,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckResult(const char op[],MatType type,const char simd[],Vec y,Vec yref)
+{
+  PetscErrorCode ierr;
+  PetscReal      nrm,nrmref;
+  Vec            r;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(y,&r);CHKERRQ(ierr);
+  ierr = VecWAXPY(r,-1.0,yref,y);CHKERRQ(ierr);
+  ierr = VecNorm(r,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  ierr = VecNorm(yref,NORM_INFINITY,&nrmref);CHKERRQ(ierr);
+  if (nrm > 100*PETSC_MACHINE_EPSILON*nrmref) {
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%s %s %s: error %g\n",op,type,simd,(double)(nrm/nrmref));CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  const MatType  types[] = {MATSEQAIJ,MATSEQSELL};
+  const char     *simd;
+  PetscSIMDType  type;
+  Mat            A,Aaij,Aref;
+  Vec            x,y,z,xt,yt,yref,zref,ytref;
+  PetscInt       m = 203,n = 157,its = 100,i,t;
+  PetscBool      timing = PETSC_FALSE;
+  PetscLogDouble t0,t1;
+  MatInfo        info;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-timing",&timing,NULL);CHKERRQ(ierr);
+
+  ierr = MatGetSIMDType(&type);CHKERRQ(ierr);
+  simd = PetscSIMDTypes[type];
+  ierr = PetscPrintf(PETSC_COMM_SELF,"Using the %s kernels\n",simd);CHKERRQ(ierr);
+
+  /* reference results from a dense matrix, whose products do not depend on -mat_simd */
+  ierr = CreateTestMatrix(MATSEQAIJ,m,n,&Aaij);CHKERRQ(ierr);
+  ierr = MatGetInfo(Aaij,MAT_LOCAL,&info);CHKERRQ(ierr);
+  ierr = MatConvert(Aaij,MATSEQDENSE,MAT_INITIAL_MATRIX,&Aref);CHKERRQ(ierr);
+  ierr = MatDestroy(&Aaij);CHKERRQ(ierr);
+  ierr = MatCreateVecs(Aref,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&yref);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&zref);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&xt);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&yt);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&ytref);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {ierr = VecSetValue(x,i,1.0/(i+1),INSERT_VALUES);CHKERRQ(ierr);}
+  for (i=0; i<m; i++) {ierr = VecSetValue(xt,i,0.5+i%3,INSERT_VALUES);CHKERRQ(ierr);}
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(xt);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(xt);CHKERRQ(ierr);
+  ierr = MatMult(Aref,x,yref);CHKERRQ(ierr);
+  ierr = MatMultAdd(Aref,x,xt,zref);CHKERRQ(ierr);
+  ierr = MatMultTranspose(Aref,xt,ytref);CHKERRQ(ierr);
+
+  for (t=0; t<2; t++) {
+    ierr = CreateTestMatrix(types[t],m,n,&A);CHKERRQ(ierr);
+    ierr = MatMult(A,x,y);CHKERRQ(ierr);
+    ierr = CheckResult("MatMult",types[t],simd,y,yref);CHKERRQ(ierr);
+    ierr = MatMultAdd(A,x,xt,z);CHKERRQ(ierr);
+    ierr = CheckResult("MatMultAdd",types[t],simd,z,zref);CHKERRQ(ierr);
+    ierr = VecCopy(xt,z);CHKERRQ(ierr);
+    ierr = MatMultAdd(A,x,z,z);CHKERRQ(ierr);
+    ierr = CheckResult("MatMultAdd in place",types[t],simd,z,zref);CHKERRQ(ierr);
+    ierr = MatMultTranspose(A,xt,yt);CHKERRQ(ierr);
+    ierr = CheckResult("MatMultTranspose",types[t],simd,yt,ytref);CHKERRQ(ierr);
+    if (timing) {
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      for (i=0; i<its; i++) {ierr = MatMult(A,x,y);CHKERRQ(ierr);}
+      ierr = PetscTime(&t1);CHKERRQ(ierr);
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%s %s: %g seconds per MatMult, %g GFlop/s\n",types[t],simd,(t1-t0)/its,2.0*info.nz_used*its/(t1-t0)/1.e9);CHKERRQ(ierr);
+    }
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%s %s: done\n",types[t],simd);CHKERRQ(ierr);
+    ierr = MatDestroy(&A);CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&xt);CHKERRQ(ierr);
+  ierr = VecDestroy(&yt);CHKERRQ(ierr);
+  ierr = VecDestroy(&yref);CHKERRQ(ierr);
+  ierr = VecDestroy(&zref);CHKERRQ(ierr);
+  ierr = VecDestroy(&ytref);CHKERRQ(ierr);
+  ierr = MatDestroy(&Aref);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+     requires: !complex
+     args: -mat_simd none
+
+   test:
+     suffix: 2
+     requires: !complex
+     args: -m 64 -n 300 -mat_simd avx2
+
+   test:
+     suffix: avx512
+     requires: !complex
+     args: -mat_simd avx512
+
+TEST*/
@@ -0,0 +1,172 @@
+
+static char help[] = "Tests and times MatSetValuesBatch() against MatSetValues() with the element matrices of a 2D grid of quadrilaterals.\n\
+  -n <nodes> : number of nodes along each side of the grid\n\
+  -its <its> : number of reassemblies to time\n\
+  -timing : print the time of the reassemblies\n\n";
+
+#include <petscmat.h>
+#include <petsctime.h>
+
+/*
+   The elements of this process, with a few of the degenerate cases of finite element codes: every 7th element has a
+   Dirichlet node given as a negative index and every 11th element is a collapsed quadrilateral with a repeated node.
+*/
+static PetscErrorCode CreateElements(PetscInt n,PetscInt *ne,PetscInt **rows,PetscScalar **v)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       e,estart,eend,i,j,r,c,*idx;
+  PetscScalar    *val;
+
+  PetscFunctionBegin;
+  ierr   = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr   = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  estart = rank*(n-1)*(n-1)/size;
+  eend   = (rank+1)*(n-1)*(n-1)/size;
+  *ne    = eend - estart;
+  ierr   = PetscMalloc2(4*(*ne),rows,16*(*ne),v);CHKERRQ(ierr);
+  for (e=estart; e<eend; e++) {
+    i      = e/(n-1);
+    j      = e%(n-1);
+    idx    = *rows + 4*(e-estart);
+    val    = *v + 16*(e-estart);
+    idx[0] = i*n + j;
+    idx[1] = i*n + j + 1;
+    idx[2] = (i+1)*n + j + 1;
+    idx[3] = (i+1)*n + j;
+    if (!(e%7))  idx[0] = -1;
+    if (!(e%11)) idx[3] = idx[2];
+    for (r=0; r<4; r++) {
+      for (c=0; c<4; c++) val[4*r+c] = (r == c) ? 4.0 : -1.0 + 0.125*r - 0.0625*c + 0.001*(e%5);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CreateMatrix(PetscInt n,Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(PETSC_COMM_WORLD,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,PETSC_DECIDE,PETSC_DECIDE,n*n,n*n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(*A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(*A,9,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(*A,9,NULL,9,NULL);CHKERRQ(ierr);
+  /* for the element that adds new nonzeros */
+  ierr = MatSetOption(*A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Assemble(Mat A,PetscBool batch,PetscInt ne,PetscInt rows[],const PetscScalar v[])
+{
+  PetscErrorCode ierr;
+  PetscInt       e;
+
+  PetscFunctionBegin;
+  if (batch) {
+    ierr = MatSetValuesBatch(A,ne,4,rows,v);CHKERRQ(ierr);
+  } else {
+    for (e=0; e<ne; e++) {
+      ierr = MatSetValues(A,4,rows+4*e,4,rows+4*e,v+16*e,ADD_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Compare(const char stage[],Mat A,Mat B)
+{
+  PetscErrorCode ierr;
+  Mat            D;
+  PetscReal      norm,diff;
+
+  PetscFunctionBegin;
+  ierr = MatDuplicate(A,MAT_COPY_VALUES,&D);CHKERRQ(ierr);
+  ierr = MatAXPY(D,-1.0,B,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatNorm(B,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+  ierr = MatNorm(D,NORM_FROBENIUS,&diff);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s\n",stage,diff <= 1.e-12*norm ? "same matrix" : "different matrices");CHKERRQ(ierr);
+  ierr = MatDestroy(&D);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  Mat            A,B;
+  PetscInt       n = 20,its = 10,ne = 0,*rows,extra[4],k;
+  PetscScalar    *v,ev[16];
+  PetscBool      timing = PETSC_FALSE;
+  PetscLogDouble t0,t1,tbatch = 0.0,tvalues = 0.0;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-timing",&timing,NULL);CHKERRQ(ierr);
+  ierr = CreateElements(n,&ne,&rows,&v);CHKERRQ(ierr);
+
+  ierr = CreateMatrix(n,&A);CHKERRQ(ierr);
+  ierr = CreateMatrix(n,&B);CHKERRQ(ierr);
+
+  /* the first assembly inserts the sorted elements, the second finds their positions, the third reuses them */
+  ierr = Assemble(A,PETSC_TRUE,ne,rows,v);CHKERRQ(ierr);
+  ierr = Assemble(B,PETSC_FALSE,ne,rows,v);CHKERRQ(ierr);
+  ierr = Compare("First assembly",A,B);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    ierr = MatZeroEntries(A);CHKERRQ(ierr);
+    ierr = MatZeroEntries(B);CHKERRQ(ierr);
+    ierr = Assemble(A,PETSC_TRUE,ne,rows,v);CHKERRQ(ierr);
+    ierr = Assemble(B,PETSC_FALSE,ne,rows,v);CHKERRQ(ierr);
+    ierr = Compare("Reassembly",A,B);CHKERRQ(ierr);
+  }
+
+  /* a batch adding to the previous values, then one that needs new nonzeros */
+  ierr = Assemble(A,PETSC_TRUE,ne,rows,v);CHKERRQ(ierr);
+  ierr = Assemble(B,PETSC_FALSE,ne,rows,v);CHKERRQ(ierr);
+  ierr = Compare("Added twice",A,B);CHKERRQ(ierr);
+  extra[0] = 0; extra[1] = n*n/2; extra[2] = n*n-1; extra[3] = n-1;
+  for (k=0; k<16; k++) ev[k] = 1.0 + k;
+  ierr = Assemble(A,PETSC_TRUE,1,extra,ev);CHKERRQ(ierr);
+  ierr = Assemble(B,PETSC_FALSE,1,extra,ev);CHKERRQ(ierr);
+  ierr = Compare("New nonzeros",A,B);CHKERRQ(ierr);
+  ierr = Assemble(A,PETSC_TRUE,ne,rows,v);CHKERRQ(ierr);
+  ierr = Assemble(B,PETSC_FALSE,ne,rows,v);CHKERRQ(ierr);
+  ierr = Compare("Reassembly with the new pattern",A,B);CHKERRQ(ierr);
+
+  if (timing) {
+    for (k=0; k<its; k++) {
+      ierr = MatZeroEntries(A);CHKERRQ(ierr);
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      ierr = Assemble(A,PETSC_TRUE,ne,rows,v);CHKERRQ(ierr);
+      ierr = PetscTime(&t1);CHKERRQ(ierr);
+      tbatch += t1 - t0;
+      ierr = MatZeroEntries(B);CHKERRQ(ierr);
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      ierr = Assemble(B,PETSC_FALSE,ne,rows,v);CHKERRQ(ierr);
+      ierr = PetscTime(&t1);CHKERRQ(ierr);
+      tvalues += t1 - t0;
+    }
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Reassembly of %D elements: MatSetValuesBatch() %g s, MatSetValues() %g s\n",(n-1)*(n-1),tbatch/its,tvalues/its);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree2(rows,v);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 3
+      output_file: output/ex221_1.out
+
+TEST*/
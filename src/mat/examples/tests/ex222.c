@@ -0,0 +1,90 @@
+static char help[] = "Tests the hardware counters collected by the MatMult() event with -log_hw_counters.\n\
+  -n <n> : number of grid points along each side of the 2D Laplacian\n\
+  -its <its> : number of multiplications of the first measurement\n\n";
+
+#include <petscmat.h>
+#include <petsc/private/logimpl.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode     ierr;
+  Mat                A;
+  Vec                x,y;
+  PetscInt           n = 100,its = 20,i,j,k,row,rstart,rend;
+  PetscLogEvent      event;
+  PetscEventPerfInfo info0,info1,info2;
+  PetscLogDouble     instr1,instr2,ratio;
+  PetscMPIInt        active,minactive;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  ierr = PetscLogDefaultBegin();CHKERRQ(ierr);
+  ierr = PetscLogHWCountersBegin();CHKERRQ(ierr);
+  active = petsc_log_hwcounters ? 1 : 0;
+  ierr = MPI_Allreduce(&active,&minactive,1,MPI_INT,MPI_MIN,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  if (!minactive) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Hardware counters are not available\n");CHKERRQ(ierr);
+    ierr = PetscFinalize();
+    return ierr;
+  }
+
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,n*n,n*n,5,NULL,2,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    i = row/n; j = row%n;
+    if (i>0)   {ierr = MatSetValue(A,row,row-n,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<n-1) {ierr = MatSetValue(A,row,row+n,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {ierr = MatSetValue(A,row,row-1,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {ierr = MatSetValue(A,row,row+1,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,row,row,4.0,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+
+  /* The counters of the event are cumulative: twice the multiplications must take about twice the instructions */
+  ierr = PetscLogEventGetId("MatMult",&event);CHKERRQ(ierr);
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = PetscLogEventGetPerfInfo(PETSC_DETERMINE,event,&info0);CHKERRQ(ierr);
+  for (k=0; k<its; k++) {ierr = MatMult(A,x,y);CHKERRQ(ierr);}
+  ierr = PetscLogEventGetPerfInfo(PETSC_DETERMINE,event,&info1);CHKERRQ(ierr);
+  for (k=0; k<2*its; k++) {ierr = MatMult(A,x,y);CHKERRQ(ierr);}
+  ierr = PetscLogEventGetPerfInfo(PETSC_DETERMINE,event,&info2);CHKERRQ(ierr);
+
+  instr1 = info1.instructions - info0.instructions;
+  instr2 = info2.instructions - info1.instructions;
+  ratio  = instr1 > 0.0 ? instr2/instr1 : 0.0;
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMult cycles: %s\n",info2.cycles > info1.cycles && info1.cycles > info0.cycles ? "nonzero" : "zero");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMult instructions: %s\n",instr1 > 0.0 && instr2 > 0.0 ? "nonzero" : "zero");CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"MatMult instructions of twice the multiplications: %s\n",ratio > 1.5 && ratio < 2.5 ? "about twice" : "not twice");CHKERRQ(ierr);
+  ierr = PetscInfo3(NULL,"MatMult instructions %g then %g, ratio %g\n",instr1,instr2,ratio);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+      requires: define(PETSC_USE_LOG)
+
+   test:
+      suffix: 2
+      nsize: 2
+      requires: define(PETSC_USE_LOG)
+      output_file: output/ex222_1.out
+
+   test:
+      suffix: log_view
+      nsize: 2
+      requires: define(PETSC_USE_LOG)
+      args: -log_view
+      filter: grep -E "^(Hardware counters|MatMult +[1-9][.0-9]*e.[0-9]+ +[1-9])" | sed -e "s~ on all processors: .*~~" -e "s~^MatMult .*~MatMult row with nonzero cycles and instructions~"
+
+TEST*/
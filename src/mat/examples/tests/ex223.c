@@ -0,0 +1,156 @@
+static char help[] = "Tests the hash table assembly of SeqAIJ, MatSeqAIJSetHashAssembly(), with too small a preallocation.\n\
+  -n <nodes> : number of nodes along each side of the grid\n\n";
+
+#include <petscmat.h>
+
+/* Adds the element matrices of a 2D grid of quadrilaterals, each node is shared by up to four elements */
+static PetscErrorCode AddElements(Mat A,PetscInt n,PetscScalar shift)
+{
+  PetscErrorCode ierr;
+  PetscInt       e,i,j,r,c,idx[4];
+  PetscScalar    v[16];
+
+  PetscFunctionBegin;
+  for (e=0; e<(n-1)*(n-1); e++) {
+    i      = e/(n-1);
+    j      = e%(n-1);
+    idx[0] = i*n + j;
+    idx[1] = i*n + j + 1;
+    idx[2] = (i+1)*n + j + 1;
+    idx[3] = (i+1)*n + j;
+    for (r=0; r<4; r++) {
+      for (c=0; c<4; c++) v[4*r+c] = (r == c) ? 4.0 + shift : -1.0 + 0.125*r - 0.0625*c + 0.001*(e%5);
+    }
+    ierr = MatSetValues(A,4,idx,4,idx,v,ADD_VALUES);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Replaces the diagonal and sets the entries of the corners of the grid, one of them outside the element pattern */
+static PetscErrorCode InsertValues(Mat A,PetscInt n)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  for (i=0; i<n*n; i+=3) {
+    ierr = MatSetValue(A,i,i,10.0 + i,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatSetValue(A,0,n*n-1,-2.0,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = MatSetValue(A,n*n-1,0,-3.0,INSERT_VALUES);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Assemble(Mat A,MatAssemblyType type)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatAssemblyBegin(A,type);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,type);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* A is assembled with the hash table, B with an exact preallocation */
+static PetscErrorCode Compare(const char stage[],Mat A,Mat B)
+{
+  PetscErrorCode ierr;
+  PetscBool      equal;
+  MatInfo        info;
+
+  PetscFunctionBegin;
+  ierr = MatEqual(A,B,&equal);CHKERRQ(ierr);
+  ierr = MatGetInfo(A,MAT_LOCAL,&info);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s, %D nonzeros, mallocs %D\n",stage,equal ? "same matrix" : "different matrices",(PetscInt)info.nz_used,(PetscInt)info.mallocs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  Mat            A,B;
+  PetscInt       n = 10;
+  MatInfo        info;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* one nonzero per row is far too few for the 9 of the element pattern */
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n*n,n*n,1,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetHashAssembly(A,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n*n,n*n,10,NULL,&B);CHKERRQ(ierr);
+
+  /* the hash phase: added elements, then a flush and inserted values */
+  ierr = AddElements(A,n,0.0);CHKERRQ(ierr);
+  ierr = AddElements(B,n,0.0);CHKERRQ(ierr);
+  ierr = Assemble(A,MAT_FLUSH_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Assemble(B,MAT_FLUSH_ASSEMBLY);CHKERRQ(ierr);
+  ierr = InsertValues(A,n);CHKERRQ(ierr);
+  ierr = InsertValues(B,n);CHKERRQ(ierr);
+  ierr = Assemble(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Assemble(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Compare("Hash assembly",A,B);CHKERRQ(ierr);
+
+  /* later assemblies go into the CSR storage of the pattern found by the hash phase */
+  ierr = MatZeroEntries(A);CHKERRQ(ierr);
+  ierr = MatZeroEntries(B);CHKERRQ(ierr);
+  ierr = AddElements(A,n,1.0);CHKERRQ(ierr);
+  ierr = AddElements(B,n,1.0);CHKERRQ(ierr);
+  ierr = Assemble(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Assemble(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Compare("Reassembly",A,B);CHKERRQ(ierr);
+
+  /* entries at new locations are dropped */
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_LOCATIONS,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_LOCATIONS,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetValue(A,1,n*n-2,5.0,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatSetValue(B,1,n*n-2,5.0,ADD_VALUES);CHKERRQ(ierr);
+  ierr = AddElements(A,n,0.0);CHKERRQ(ierr);
+  ierr = AddElements(B,n,0.0);CHKERRQ(ierr);
+  ierr = Assemble(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Assemble(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Compare("No new nonzero locations",A,B);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+
+  /* MAT_NEW_NONZERO_LOCATIONS is also respected by the hash table: only the locations of the first assembly remain */
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n*n,n*n,1,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetHashAssembly(A,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n*n,n*n,10,NULL,&B);CHKERRQ(ierr);
+  ierr = AddElements(A,n,0.0);CHKERRQ(ierr);
+  ierr = AddElements(B,n,0.0);CHKERRQ(ierr);
+  ierr = Assemble(A,MAT_FLUSH_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Assemble(B,MAT_FLUSH_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_LOCATIONS,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_LOCATIONS,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = InsertValues(A,n);CHKERRQ(ierr);
+  ierr = InsertValues(B,n);CHKERRQ(ierr);
+  ierr = Assemble(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Assemble(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = Compare("Hash assembly without new nonzero locations",A,B);CHKERRQ(ierr);
+
+  /* without the hash table the same preallocation needs mallocs */
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n*n,n*n,1,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = AddElements(A,n,0.0);CHKERRQ(ierr);
+  ierr = Assemble(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatGetInfo(A,MAT_LOCAL,&info);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Without the hash table: %s\n",info.mallocs > 0 ? "mallocs needed" : "no mallocs");CHKERRQ(ierr);
+
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      args: -n 17
+
+TEST*/
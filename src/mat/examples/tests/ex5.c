@@ -277,4 +277,73 @@ int main(int argc,char **args)
       args: -mat_type sell -test_diagonalscale
       output_file: output/ex5_53.out
 
+   test:
+      suffix: threads_1
+      args: -mat_type seqaij -rectA -mat_aij_threads 2
+      filter: grep -v type
+      output_file: output/ex5_11_A.out
+
+   test:
+      suffix: threads_2
+      nsize: 3
+      args: -mat_type mpiaij -test_diagonalscale -mat_aij_threads 2
+      filter: grep -v type
+      output_file: output/ex5_33.out
+
+   test:
+      suffix: threads_info_1
+      args: -mat_type seqaij -rectA -mat_aij_threads 2 -info
+      filter: grep -E "Split|Threaded MatMult routines" | sed -e "s~, time imbalance.*~~"
+
+   test:
+      suffix: threads_info_2
+      nsize: 3
+      args: -mat_type mpiaij -test_diagonalscale -mat_aij_threads 2 -info
+      filter: grep -E "Split|Threaded MatMult routines" | sed -e "s~, time imbalance.*~~" | sort
+
+   test:
+      suffix: compress_indices_1
+      args: -mat_type seqaij -rectA -mat_aij_compress_indices
+      filter: grep -v type
+      output_file: output/ex5_11_A.out
+
+   test:
+      suffix: compress_indices_2
+      nsize: 3
+      args: -mat_type mpiaij -test_diagonalscale -mat_aij_compress_indices
+      filter: grep -v type
+      output_file: output/ex5_33.out
+
+   test:
+      suffix: split_mult
+      nsize: 3
+      args: -mat_type mpiaij -test_diagonalscale -mat_mpiaij_split_mult
+      filter: grep -v type
+      output_file: output/ex5_33.out
+
+   test:
+      suffix: split_mult_info
+      nsize: 3
+      args: -mat_type mpiaij -test_diagonalscale -mat_mpiaij_split_mult -info
+      filter: grep -E "Split the rows|splitting MatMult" | sort
+
+   test:
+      suffix: split_mult_threads
+      nsize: 3
+      args: -mat_type mpiaij -test_diagonalscale -mat_mpiaij_split_mult -mat_aij_threads 2 -info
+      filter: grep -E "Split the rows|splitting MatMult" | sort
+
+   test:
+      suffix: autotune_1
+      args: -mat_type aijautotune -test_diagonalscale
+      filter: grep -v type
+      output_file: output/ex5_31.out
+
+   test:
+      suffix: autotune_2
+      nsize: 3
+      args: -mat_type aijautotune -test_diagonalscale
+      filter: grep -v type
+      output_file: output/ex5_33.out
+
 TEST*/
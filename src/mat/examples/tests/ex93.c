@@ -268,4 +268,14 @@ PetscErrorCode testPTAPRectangular(void)
       args: -B_matmatmult_via scalable_fast
       output_file: output/ex93_1.out
 
+   test:
+      suffix: threads
+      args: -mat_aij_threads 3
+      output_file: output/ex93_1.out
+
+   test:
+      suffix: threads_scalable
+      args: -mat_aij_threads 3 -B_matmatmult_via scalable -A_matptap_via scalable
+      output_file: output/ex93_1.out
+
 TEST*/
@@ -209,6 +209,7 @@
       PetscEnum MAT_FACTORINFO_ZERO_PIVOT
       PetscEnum MAT_FACTORINFO_SHIFT_TYPE
       PetscEnum MAT_FACTORINFO_SHIFT_AMOUNT
+      PetscEnum MAT_FACTORINFO_SOLVE_ITERATIVE
 
       parameter (MAT_FACTORINFO_DIAGONAL_FILL = 1)
       parameter (MAT_FACTORINFO_USEDT = 2)
@@ -221,6 +222,7 @@
       parameter (MAT_FACTORINFO_ZERO_PIVOT = 9)
       parameter (MAT_FACTORINFO_SHIFT_TYPE = 10)
       parameter (MAT_FACTORINFO_SHIFT_AMOUNT = 11)
+      parameter (MAT_FACTORINFO_SOLVE_ITERATIVE = 12)
 
 
 !
@@ -5,4 +5,4 @@
 ! in a separate include
 !
       PetscEnum MAT_FACTORINFO_SIZE
-      parameter (MAT_FACTORINFO_SIZE=11)
+      parameter (MAT_FACTORINFO_SIZE=12)
@@ -0,0 +1,140 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+typedef struct {
+  /* the operations of the MATMPIAIJ matrix, restored before the format is selected */
+  PetscErrorCode (*AssemblyEnd)(Mat,MatAssemblyType);
+  PetscErrorCode (*Duplicate)(Mat,MatDuplicateOption,Mat*);
+  PetscErrorCode (*Destroy)(Mat);
+} Mat_MPIAIJAutotune;
+
+/* Turns A back into the MATMPIAIJ matrix it was converted from */
+static PetscErrorCode MatMPIAIJAutotuneRestore_Private(Mat A)
+{
+  Mat_MPIAIJAutotune *at = (Mat_MPIAIJAutotune*)A->spptr;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  A->ops->assemblyend = at->AssemblyEnd;
+  A->ops->duplicate   = at->Duplicate;
+  A->ops->destroy     = at->Destroy;
+  A->multsetup        = NULL;
+  ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATMPIAIJ);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Called by MatMult() before the first product of the assembled matrix, see MatMultSetUp_SeqAIJAutotune() */
+static PetscErrorCode MatMultSetUp_MPIAIJAutotune(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJAutotuneRestore_Private(A);CHKERRQ(ierr);
+  ierr = MatAIJAutotune_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_MPIAIJAutotune(Mat A,MatAssemblyType mode)
+{
+  Mat_MPIAIJAutotune *at = (Mat_MPIAIJAutotune*)A->spptr;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = (*at->AssemblyEnd)(A,mode);CHKERRQ(ierr);
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  A->multsetup = MatMultSetUp_MPIAIJAutotune;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDuplicate_MPIAIJAutotune(Mat A,MatDuplicateOption op,Mat *M)
+{
+  Mat_MPIAIJAutotune *at = (Mat_MPIAIJAutotune*)A->spptr;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = (*at->Duplicate)(A,op,M);CHKERRQ(ierr);
+  if ((*M)->assembled) (*M)->multsetup = MatMultSetUp_MPIAIJAutotune;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_MPIAIJAutotune(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJAutotuneRestore_Private(A);CHKERRQ(ierr);
+  ierr = (*A->ops->destroy)(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJAutotune(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode     ierr;
+  Mat                B = *newmat;
+  Mat_MPIAIJAutotune *at;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr     = PetscNewLog(B,&at);CHKERRQ(ierr);
+  B->spptr = (void*)at;
+  at->AssemblyEnd     = B->ops->assemblyend;
+  at->Duplicate       = B->ops->duplicate;
+  at->Destroy         = B->ops->destroy;
+  B->ops->assemblyend = MatAssemblyEnd_MPIAIJAutotune;
+  B->ops->duplicate   = MatDuplicate_MPIAIJAutotune;
+  B->ops->destroy     = MatDestroy_MPIAIJAutotune;
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJAUTOTUNE);CHKERRQ(ierr);
+  /* an assembled matrix is tuned by its next product */
+  if (B->assembled) B->multsetup = MatMultSetUp_MPIAIJAutotune;
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATMPIAIJAUTOTUNE - MATMPIAIJAUTOTUNE = "mpiaijautotune" - A parallel matrix that picks its own storage format.
+
+   The matrix is preallocated and filled exactly like a MATMPIAIJ matrix. Its first MatMult() after the
+   MatAssemblyEnd() with MAT_FINAL_ASSEMBLY times a few MatMult() in each candidate format, including the
+   communication, and converts the matrix in place to the format with the smallest time over all processes. See MATSEQAIJAUTOTUNE for
+   the options.
+
+  Level: beginner
+
+.seealso: MatCreateAIJ(), MATAIJAUTOTUNE, MATSEQAIJAUTOTUNE
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJAutotune(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATMPIAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_MPIAIJ_MPIAIJAutotune(A,MATMPIAIJAUTOTUNE,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATAIJAUTOTUNE - MATAIJAUTOTUNE = "aijautotune" - A matrix that times MatMult() in several storage formats
+   (MATAIJ, MATAIJPERM, MATSELL and, for block sizes larger than one, MATBAIJ) at its first MatMult() after
+   the assembly and converts itself to the fastest one.
+
+   This matrix type is identical to MATSEQAIJAUTOTUNE when constructed with a single process communicator,
+   and MATMPIAIJAUTOTUNE otherwise.  As a result, for single process communicators,
+  MatSeqAIJSetPreallocation() is supported, and similarly MatMPIAIJSetPreallocation() is supported
+  for communicators controlling multiple processes.  It is recommended that you call both of
+  the above preallocation routines for simplicity.
+
+   Options Database Keys:
++  -mat_type aijautotune - sets the matrix type to "aijautotune" during a call to MatSetFromOptions()
+.  -mat_autotune_types <aij,aijperm,sell> - formats to try
+-  -mat_autotune_its <10> - number of MatMult() timed for each format
+
+   Notes:
+   Run with -info to see the measured flop rates and the selected format.
+
+  Level: beginner
+
+.seealso: MATSEQAIJAUTOTUNE, MATMPIAIJAUTOTUNE, MatConvert()
+M*/
@@ -0,0 +1,70 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+static PetscErrorCode MatMPIAIJSetPreallocation_MPIAIJMixed(Mat B,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[])
+{
+  Mat_MPIAIJ     *b = (Mat_MPIAIJ*)B->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJSetPreallocation_MPIAIJ(B,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJMixed(b->A,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJMixed(b->B,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMixed(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_MPIAIJ     *b;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  b = (Mat_MPIAIJ*)B->data;
+  /* an already preallocated matrix has its local blocks converted right away */
+  if (b->A) {ierr = MatConvert_SeqAIJ_SeqAIJMixed(b->A,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);}
+  if (b->B) {ierr = MatConvert_SeqAIJ_SeqAIJMixed(b->B,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);}
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJMIXED);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJMixed);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATMPIAIJMIXED - MATMPIAIJMIXED = "mpiaijmixed" - A parallel AIJ matrix whose diagonal and off-diagonal blocks are
+   MATSEQAIJMIXED matrices, so MatMult(), MatMultAdd() and the local sweeps of MatSOR() read single precision values.
+
+  Level: intermediate
+
+.seealso: MATAIJMIXED, MATSEQAIJMIXED, MATMPIAIJ
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMixed(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATMPIAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_MPIAIJ_MPIAIJMixed(A,MATMPIAIJMIXED,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATAIJMIXED - MATAIJMIXED = "aijmixed" - An AIJ matrix that keeps a single precision copy of its values for
+   MatMult(), MatMultAdd() and MatSOR(), while the vectors and the sums stay in double precision.
+
+   This matrix type is identical to MATSEQAIJMIXED when constructed with a single process communicator,
+   and MATMPIAIJMIXED otherwise.  As a result, for single process communicators,
+  MatSeqAIJSetPreallocation() is supported, and similarly MatMPIAIJSetPreallocation() is supported
+  for communicators controlling multiple processes.  It is recommended that you call both of
+  the above preallocation routines for simplicity.
+
+   Options Database Keys:
+. -mat_type aijmixed - sets the matrix type to "aijmixed" during a call to MatSetFromOptions()
+
+  Level: intermediate
+
+.seealso: MATSEQAIJMIXED, MATMPIAIJMIXED, MatConvert()
+M*/
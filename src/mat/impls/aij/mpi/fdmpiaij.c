@@ -375,7 +375,8 @@ PetscErrorCode MatFDColoringSetUp_MPIXAIJ(Mat mat,ISColoring iscoloring,MatFDCol
   PetscBool              isBAIJ,isSELL;
   PetscInt               bcols=c->bcols;
 #if defined(PETSC_USE_CTABLE)
-  PetscTable             colmap=NULL;
+  PetscTable             colmap=NULL;      /* BAIJ and SELL */
+  PetscHMapI             aijcolmap=NULL;   /* AIJ */
 #else
   PetscInt               *colmap=NULL;     /* local col number of off-diag col */
 #endif
@@ -444,7 +445,11 @@ PetscErrorCode MatFDColoringSetUp_MPIXAIJ(Mat mat,ISColoring iscoloring,MatFDCol
        - creates aij->colmap which maps global column number to local number in part B */
       ierr = MatCreateColmap_MPIAIJ_Private(mat);CHKERRQ(ierr);
     }
+#if defined(PETSC_USE_CTABLE)
+    aijcolmap = aij->colmap;
+#else
     colmap = aij->colmap;
+#endif
     ierr = MatGetColumnIJ_SeqAIJ_Color(A,0,PETSC_FALSE,PETSC_FALSE,&ncols,&A_ci,&A_cj,&spidxA,NULL);CHKERRQ(ierr);
     ierr = MatGetColumnIJ_SeqAIJ_Color(B,0,PETSC_FALSE,PETSC_FALSE,&ncols,&B_ci,&B_cj,&spidxB,NULL);CHKERRQ(ierr);
 
@@ -542,8 +547,12 @@ PetscErrorCode MatFDColoringSetUp_MPIXAIJ(Mat mat,ISColoring iscoloring,MatFDCol
         }
       } else { /* column is in B, off-diagonal block of mat */
 #if defined(PETSC_USE_CTABLE)
-        ierr = PetscTableFind(colmap,col+1,&colb);CHKERRQ(ierr);
-        colb--;
+        if (aijcolmap) {
+          ierr = PetscHMapIGet(aijcolmap,col,&colb);CHKERRQ(ierr);
+        } else {
+          ierr = PetscTableFind(colmap,col+1,&colb);CHKERRQ(ierr);
+          colb--;
+        }
 #else
         colb = colmap[col] - 1; /* local column index */
 #endif
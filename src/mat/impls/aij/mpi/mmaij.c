@@ -5,66 +5,57 @@
 #include <../src/mat/impls/aij/mpi/mpiaij.h>
 #include <petsc/private/vecimpl.h>
 #include <petsc/private/isimpl.h>    /* needed because accesses data structure of ISLocalToGlobalMapping directly */
+#include <petsc/private/hashseti.h>
 
 PetscErrorCode MatSetUpMultiply_MPIAIJ(Mat mat)
 {
   Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
   Mat_SeqAIJ     *B   = (Mat_SeqAIJ*)(aij->B->data);
   PetscErrorCode ierr;
-  PetscInt       i,j,*aj = B->j,ec = 0,*garray;
+  PetscInt       i,*aj = B->j,ec = 0,*garray;
   IS             from,to;
   Vec            gvec;
 #if defined(PETSC_USE_CTABLE)
-  PetscTable         gid1_lid1;
-  PetscTablePosition tpos;
-  PetscInt           gid,lid;
+  PetscHSetI gids;
+  PetscHMapI gid_lid;
+  PetscInt   *lids;
 #else
-  PetscInt N = mat->cmap->N,*indices;
+  PetscInt j,N = mat->cmap->N,*indices;
 #endif
 
   PetscFunctionBegin;
   if (!aij->garray) {
 #if defined(PETSC_USE_CTABLE)
-    /* use a table */
-    ierr = PetscTableCreate(aij->B->rmap->n,mat->cmap->N+1,&gid1_lid1);CHKERRQ(ierr);
+    /* collect the distinct columns of B with a hash set */
+    ierr = PetscHSetICreate(&gids);CHKERRQ(ierr);
     for (i=0; i<aij->B->rmap->n; i++) {
-      for (j=0; j<B->ilen[i]; j++) {
-        PetscInt data,gid1 = aj[B->i[i] + j] + 1;
-        ierr = PetscTableFind(gid1_lid1,gid1,&data);CHKERRQ(ierr);
-        if (!data) {
-          /* one based table */
-          ierr = PetscTableAdd(gid1_lid1,gid1,++ec,INSERT_VALUES);CHKERRQ(ierr);
-        }
-      }
+      ierr = PetscHSetIAddMany(gids,B->ilen[i],aj+B->i[i]);CHKERRQ(ierr);
     }
+    ierr = PetscHSetIGetSize(gids,&ec);CHKERRQ(ierr);
+
     /* form array of columns we need */
     ierr = PetscMalloc1(ec+1,&garray);CHKERRQ(ierr);
-    ierr = PetscTableGetHeadPosition(gid1_lid1,&tpos);CHKERRQ(ierr);
-    while (tpos) {
-      ierr = PetscTableGetNext(gid1_lid1,&tpos,&gid,&lid);CHKERRQ(ierr);
-      gid--;
-      lid--;
-      garray[lid] = gid;
-    }
-    ierr = PetscSortInt(ec,garray);CHKERRQ(ierr); /* sort, and rebuild */
-    ierr = PetscTableRemoveAll(gid1_lid1);CHKERRQ(ierr);
-    for (i=0; i<ec; i++) {
-      ierr = PetscTableAdd(gid1_lid1,garray[i]+1,i+1,INSERT_VALUES);CHKERRQ(ierr);
-    }
+    ierr = PetscMalloc1(ec+1,&lids);CHKERRQ(ierr);
+    i    = 0;
+    ierr = PetscHSetIGetElems(gids,&i,garray);CHKERRQ(ierr);
+    ierr = PetscHSetIDestroy(&gids);CHKERRQ(ierr);
+    ierr = PetscSortInt(ec,garray);CHKERRQ(ierr);
+
+    /* map each global column to its position in garray */
+    for (i=0; i<ec; i++) lids[i] = i;
+    ierr = PetscHMapICreate(&gid_lid);CHKERRQ(ierr);
+    ierr = PetscHMapISetMany(gid_lid,ec,garray,lids);CHKERRQ(ierr);
+    ierr = PetscFree(lids);CHKERRQ(ierr);
+
     /* compact out the extra columns in B */
     for (i=0; i<aij->B->rmap->n; i++) {
-      for (j=0; j<B->ilen[i]; j++) {
-        PetscInt gid1 = aj[B->i[i] + j] + 1;
-        ierr = PetscTableFind(gid1_lid1,gid1,&lid);CHKERRQ(ierr);
-        lid--;
-        aj[B->i[i] + j] = lid;
-      }
+      ierr = PetscHMapIGetMany(gid_lid,B->ilen[i],aj+B->i[i],aj+B->i[i]);CHKERRQ(ierr);
     }
     aij->B->cmap->n = aij->B->cmap->N = ec;
     aij->B->cmap->bs = 1;
 
     ierr = PetscLayoutSetUp((aij->B->cmap));CHKERRQ(ierr);
-    ierr = PetscTableDestroy(&gid1_lid1);CHKERRQ(ierr);
+    ierr = PetscHMapIDestroy(&gid_lid);CHKERRQ(ierr);
 #else
     /* Make an array as long as the number of columns */
     /* mark those columns that are in aij->B */
@@ -168,7 +159,7 @@ PetscErrorCode MatDisAssemble_MPIAIJ(Mat A)
   ierr = VecDestroy(&aij->lvec);CHKERRQ(ierr);
   if (aij->colmap) {
 #if defined(PETSC_USE_CTABLE)
-    ierr = PetscTableDestroy(&aij->colmap);CHKERRQ(ierr);
+    ierr = PetscHMapIDestroy(&aij->colmap);CHKERRQ(ierr);
 #else
     ierr = PetscFree(aij->colmap);CHKERRQ(ierr);
     ierr = PetscLogObjectMemory((PetscObject)A,-aij->B->cmap->n*sizeof(PetscInt));CHKERRQ(ierr);
@@ -5,6 +5,7 @@
 #include <petsc/private/isimpl.h>
 #include <petscblaslapack.h>
 #include <petscsf.h>
+#include <petsctime.h>
 
 /*MC
    MATAIJ - MATAIJ = "aij" - A matrix type to be used for sparse matrices.
@@ -408,14 +409,18 @@ PetscErrorCode MatCreateColmap_MPIAIJ_Private(Mat mat)
   Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
   PetscErrorCode ierr;
   PetscInt       n = aij->B->cmap->n,i;
+#if defined(PETSC_USE_CTABLE)
+  PetscInt       *lid;
+#endif
 
   PetscFunctionBegin;
   if (!aij->garray) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"MPIAIJ Matrix was assembled but is missing garray");
 #if defined(PETSC_USE_CTABLE)
-  ierr = PetscTableCreate(n,mat->cmap->N+1,&aij->colmap);CHKERRQ(ierr);
-  for (i=0; i<n; i++) {
-    ierr = PetscTableAdd(aij->colmap,aij->garray[i]+1,i+1,INSERT_VALUES);CHKERRQ(ierr);
-  }
+  ierr = PetscHMapICreate(&aij->colmap);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&lid);CHKERRQ(ierr);
+  for (i=0; i<n; i++) lid[i] = i;
+  ierr = PetscHMapISetMany(aij->colmap,n,aij->garray,lid);CHKERRQ(ierr);
+  ierr = PetscFree(lid);CHKERRQ(ierr);
 #else
   ierr = PetscCalloc1(mat->cmap->N+1,&aij->colmap);CHKERRQ(ierr);
   ierr = PetscLogObjectMemory((PetscObject)mat,(mat->cmap->N+1)*sizeof(PetscInt));CHKERRQ(ierr);
@@ -585,8 +590,7 @@ PetscErrorCode MatSetValues_MPIAIJ(Mat mat,PetscInt m,const PetscInt im[],PetscI
               ierr = MatCreateColmap_MPIAIJ_Private(mat);CHKERRQ(ierr);
             }
 #if defined(PETSC_USE_CTABLE)
-            ierr = PetscTableFind(aij->colmap,in[j]+1,&col);CHKERRQ(ierr);
-            col--;
+            ierr = PetscHMapIGet(aij->colmap,in[j],&col);CHKERRQ(ierr);
 #else
             col = aij->colmap[in[j]] - 1;
 #endif
@@ -630,6 +634,102 @@ PetscErrorCode MatSetValues_MPIAIJ(Mat mat,PetscInt m,const PetscInt im[],PetscI
   PetscFunctionReturn(0);
 }
 
+/*
+   Adds the batch at the positions found in A and B by the previous call with the same element indices and nonzero
+   pattern; the element rows owned by other processes go to the stash as in MatSetValues_MPIAIJ()
+*/
+static PetscErrorCode MatSetValuesBatch_MPIAIJ(Mat mat,PetscInt nb,PetscInt bs,PetscInt *rows,const PetscScalar *v)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_AIJ_Batch  *batch = &aij->batch;
+  PetscInt       rstart = mat->rmap->rstart,rend = mat->rmap->rend,cstart = mat->cmap->rstart,cend = mat->cmap->rend;
+  PetscInt       b,r,k,q,o,n = nb*bs*bs,row,col,*perm,*idx,*acols,*bcols,*offsets;
+  PetscBool      found,ignorezeroentries = ((Mat_SeqAIJ*)aij->A->data)->ignorezeroentries;
+  MatScalar      *aa,*ba;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* before the first assembly, or after a MatDisAssemble_MPIAIJ(), the nonzero pattern is not known */
+  if (!mat->was_assembled || !aij->roworiented) {
+    ierr = MatSetValuesBatch_AIJ_Sorted(mat,nb,bs,rows,v);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatAIJBatchFind(batch,nb,bs,rows,aij->A,aij->B,&found);CHKERRQ(ierr);
+  if (!found) {
+    ierr = MatAIJBatchSetUp(batch,nb,bs,rows,aij->A,aij->B);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nb*bs,&batch->stash);CHKERRQ(ierr);
+    if (!aij->colmap) {
+      ierr = MatCreateColmap_MPIAIJ_Private(mat);CHKERRQ(ierr);
+    }
+    ierr  = PetscMalloc4(bs,&perm,bs,&idx,bs,&acols,bs,&bcols);CHKERRQ(ierr);
+    found = PETSC_TRUE;
+    for (b=0; b<nb && found; b++) {
+      ierr = MatAIJBatchSortElement(bs,rows+b*bs,perm,idx);CHKERRQ(ierr);
+      /* split the sorted columns between A and B, both remain sorted since garray is */
+      for (k=0; k<bs; k++) {
+        col      = idx[k];
+        acols[k] = -1;
+        bcols[k] = -1;
+        if (col < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+        if (col >= mat->cmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",col,mat->cmap->N-1);
+#endif
+        if (col >= cstart && col < cend) acols[k] = col - cstart;
+        else {
+#if defined(PETSC_USE_CTABLE)
+          ierr = PetscHMapIGet(aij->colmap,col,&bcols[k]);CHKERRQ(ierr);
+#else
+          bcols[k] = aij->colmap[col] - 1;
+#endif
+          /* not in B at all: the merge fails if a local row of the element needs it */
+          if (bcols[k] < 0) bcols[k] = PETSC_MAX_INT;
+        }
+      }
+      for (r=0; r<bs && found; r++) {
+        q       = b*bs + r;
+        row     = rows[q];
+        offsets = batch->offsets + q*bs;
+        for (k=0; k<bs; k++) offsets[k] = -1;
+        if (row < 0) continue;
+        if (row < rstart || row >= rend) {
+          batch->stash[batch->nstash++] = q;
+          continue;
+        }
+        ierr = MatSeqAIJBatchRowOffsets(aij->A,row-rstart,bs,acols,perm,PETSC_FALSE,offsets,&found);CHKERRQ(ierr);
+        if (!found) break;
+        ierr = MatSeqAIJBatchRowOffsets(aij->B,row-rstart,bs,bcols,perm,PETSC_TRUE,offsets,&found);CHKERRQ(ierr);
+      }
+    }
+    ierr = PetscFree4(perm,idx,acols,bcols);CHKERRQ(ierr);
+    if (!found) {
+      ierr = PetscInfo(mat,"The batch adds new nonzeros, inserting it with MatSetValues()\n");CHKERRQ(ierr);
+      ierr = MatAIJBatchReset(batch);CHKERRQ(ierr);
+      ierr = MatSetValuesBatch_AIJ_Sorted(mat,nb,bs,rows,v);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    ierr = PetscInfo3(mat,"Found the positions of the values of %D element matrices of size %D, %D element rows are stashed\n",nb,bs,batch->nstash);CHKERRQ(ierr);
+  }
+  aa      = ((Mat_SeqAIJ*)aij->A->data)->a;
+  ba      = ((Mat_SeqAIJ*)aij->B->data)->a;
+  offsets = batch->offsets;
+  for (k=0; k<n; k++) {
+    o = offsets[k];
+    if (o >= 0)      aa[o]    += v[k];
+    else if (o < -1) ba[-2-o] += v[k];
+  }
+  if (batch->nstash) {
+    if (mat->nooffprocentries) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Setting off process row %D even though MatSetOption(,MAT_NO_OFF_PROC_ENTRIES,PETSC_TRUE) was set",rows[batch->stash[0]]);
+    if (!aij->donotstash) {
+      mat->assembled = PETSC_FALSE;
+      for (k=0; k<batch->nstash; k++) {
+        q    = batch->stash[k];
+        ierr = MatStashValuesRow_Private(&mat->stash,rows[q],bs,rows+(q/bs)*bs,v+q*bs,ignorezeroentries);CHKERRQ(ierr);
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatGetValues_MPIAIJ(Mat mat,PetscInt m,const PetscInt idxm[],PetscInt n,const PetscInt idxn[],PetscScalar v[])
 {
   Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
@@ -654,8 +754,7 @@ PetscErrorCode MatGetValues_MPIAIJ(Mat mat,PetscInt m,const PetscInt idxm[],Pets
             ierr = MatCreateColmap_MPIAIJ_Private(mat);CHKERRQ(ierr);
           }
 #if defined(PETSC_USE_CTABLE)
-          ierr = PetscTableFind(aij->colmap,idxn[j]+1,&col);CHKERRQ(ierr);
-          col--;
+          ierr = PetscHMapIGet(aij->colmap,idxn[j],&col);CHKERRQ(ierr);
 #else
           col = aij->colmap[idxn[j]] - 1;
 #endif
@@ -935,6 +1034,116 @@ PetscErrorCode MatZeroRowsColumns_MPIAIJ(Mat A,PetscInt N,const PetscInt rows[],
   PetscFunctionReturn(0);
 }
 
+/*
+   Splits the local rows into runs of consecutive interior rows, those with no entry in the off-diagonal block, and
+   runs of boundary rows. The runs are computed with MatMultAddRows_SeqAIJ_Private(), which has the SIMD kernels of
+   MATSEQAIJ but not its threaded (-mat_aij_threads) or compressed index (-mat_aij_compress_indices) ones, so the split
+   is only used when both blocks are MATSEQAIJ without those; otherwise splitmult is turned off.
+*/
+static PetscErrorCode MatMPIAIJSplitRows_Private(Mat A)
+{
+  Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
+  Mat_SeqAIJ     *b;
+  PetscErrorCode ierr;
+  PetscInt       i,k,m = A->rmap->n,nruns[2] = {0,0},*runs = NULL;
+  PetscBool      isseqaij[2];
+  int            type,prev;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)a->A,MATSEQAIJ,&isseqaij[0]);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)a->B,MATSEQAIJ,&isseqaij[1]);CHKERRQ(ierr);
+  if (!isseqaij[0] || !isseqaij[1]) {
+    ierr = PetscInfo2(A,"Not splitting MatMult(), the diagonal and off-diagonal blocks are %s and %s\n",((PetscObject)a->A)->type_name,((PetscObject)a->B)->type_name);CHKERRQ(ierr);
+    a->splitmult = PETSC_FALSE;
+    PetscFunctionReturn(0);
+  }
+  for (k=0; k<2; k++) {
+    b = (Mat_SeqAIJ*)(k ? a->B : a->A)->data;
+    if (b->threads.nthreads > 1 || b->jcompress.use) {
+      ierr = PetscInfo1(A,"Not splitting MatMult(), the %s block uses the threaded or compressed index kernels\n",k ? "off-diagonal" : "diagonal");CHKERRQ(ierr);
+      a->splitmult = PETSC_FALSE;
+      PetscFunctionReturn(0);
+    }
+  }
+  b = (Mat_SeqAIJ*)a->B->data;
+  ierr = PetscFree(a->splitruns);CHKERRQ(ierr);
+  /* count the runs, then fill them */
+  for (k=0; k<2; k++) {
+    nruns[0] = nruns[1] = 0;
+    a->nsplitrows[0] = a->nsplitrows[1] = 0;
+    prev = -1;
+    for (i=0; i<m; i++) {
+      type = b->i[i+1] > b->i[i];
+      a->nsplitrows[type]++;
+      if (type == prev) {
+        if (k) runs[2*(type ? a->ninterior + nruns[1] - 1 : nruns[0] - 1) + 1] = i+1;
+        continue;
+      }
+      if (k) {
+        PetscInt r = type ? a->ninterior + nruns[1] : nruns[0];
+        runs[2*r]   = i;
+        runs[2*r+1] = i+1;
+      }
+      nruns[type]++;
+      prev = type;
+    }
+    if (!k) {
+      a->ninterior = nruns[0];
+      a->nboundary = nruns[1];
+      ierr = PetscMalloc1(2*(nruns[0]+nruns[1])+1,&runs);CHKERRQ(ierr);
+    }
+  }
+  a->splitruns          = runs;
+  a->split_nonzerostate = A->nonzerostate;
+  a->split_overlap      = 0.0;
+  a->split_wait         = 0.0;
+  a->split_ncalls       = 0;
+  ierr = PetscInfo4(A,"Split the rows into %D interior rows in %D runs and %D boundary rows in %D runs\n",a->nsplitrows[0],a->ninterior,a->nsplitrows[1],a->nboundary);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatMult_MPIAIJ() with -mat_mpiaij_split_mult: the interior rows are computed while the ghost values are in flight,
+   and the boundary rows once they have arrived. Each row is computed with the kernels, and in the order, of the
+   unsplit MatMult_MPIAIJ(), so the result does not depend on the split. MatMultAdd() is not split.
+*/
+static PetscErrorCode MatMult_MPIAIJ_Split(Mat A,Vec xx,Vec yy)
+{
+  Mat_MPIAIJ        *a = (Mat_MPIAIJ*)A->data;
+  Mat_SeqAIJ        *ad = (Mat_SeqAIJ*)a->A->data,*bd = (Mat_SeqAIJ*)a->B->data;
+  PetscErrorCode    ierr;
+  const PetscScalar *x,*lx;
+  PetscScalar       *y;
+  const PetscInt    *runs = a->splitruns;
+  PetscInt          r;
+  PetscLogDouble    t0,t1,t2;
+
+  PetscFunctionBegin;
+  ierr = VecScatterBegin(a->Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  for (r=0; r<a->ninterior; r++) {
+    ierr = MatMultAddRows_SeqAIJ_Private(a->A,runs[2*r],runs[2*r+1],x,NULL,y);CHKERRQ(ierr);
+  }
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  ierr = VecScatterEnd(a->Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = PetscTime(&t2);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(a->lvec,&lx);CHKERRQ(ierr);
+  for (r=a->ninterior; r<a->ninterior+a->nboundary; r++) {
+    ierr = MatMultAddRows_SeqAIJ_Private(a->A,runs[2*r],runs[2*r+1],x,NULL,y);CHKERRQ(ierr);
+    ierr = MatMultAddRows_SeqAIJ_Private(a->B,runs[2*r],runs[2*r+1],lx,y,y);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(a->lvec,&lx);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  a->split_overlap += t1 - t0;
+  a->split_wait    += t2 - t1;
+  a->split_ncalls++;
+  ierr = PetscLogFlops(2.0*(ad->nz + bd->nz) - ad->nonzerorowcnt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatMult_MPIAIJ(Mat A,Vec xx,Vec yy)
 {
   Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
@@ -946,6 +1155,13 @@ PetscErrorCode MatMult_MPIAIJ(Mat A,Vec xx,Vec yy)
   ierr = VecGetLocalSize(xx,&nt);CHKERRQ(ierr);
   if (nt != A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Incompatible partition of A (%D) and xx (%D)",A->cmap->n,nt);
 
+  if (a->splitmult && (!a->splitruns || a->split_nonzerostate != A->nonzerostate)) {
+    ierr = MatMPIAIJSplitRows_Private(A);CHKERRQ(ierr);
+  }
+  if (a->splitmult) {
+    ierr = MatMult_MPIAIJ_Split(A,xx,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = VecScatterBegin(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = (*a->A->ops->mult)(a->A,xx,yy);CHKERRQ(ierr);
   ierr = VecScatterEnd(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
@@ -1114,7 +1330,7 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   ierr = MatDestroy(&aij->A);CHKERRQ(ierr);
   ierr = MatDestroy(&aij->B);CHKERRQ(ierr);
 #if defined(PETSC_USE_CTABLE)
-  ierr = PetscTableDestroy(&aij->colmap);CHKERRQ(ierr);
+  ierr = PetscHMapIDestroy(&aij->colmap);CHKERRQ(ierr);
 #else
   ierr = PetscFree(aij->colmap);CHKERRQ(ierr);
 #endif
@@ -1124,6 +1340,11 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   if (aij->Mvctx_mpi1) {ierr = VecScatterDestroy(&aij->Mvctx_mpi1);CHKERRQ(ierr);}
   ierr = PetscFree2(aij->rowvalues,aij->rowindices);CHKERRQ(ierr);
   ierr = PetscFree(aij->ld);CHKERRQ(ierr);
+  if (aij->split_ncalls) {
+    ierr = PetscInfo3(mat,"Split MatMult(): %D calls, %g seconds on interior rows while communicating, %g seconds waiting for the ghost values\n",aij->split_ncalls,aij->split_overlap,aij->split_wait);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(aij->splitruns);CHKERRQ(ierr);
+  ierr = MatAIJBatchReset(&aij->batch);CHKERRQ(ierr);
   ierr = PetscFree(mat->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)mat,0);CHKERRQ(ierr);
@@ -1329,6 +1550,10 @@ PetscErrorCode MatView_MPIAIJ_ASCIIorDraworSocket(Mat mat,PetscViewer viewer)
       ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] on-diagonal part: nz %D \n",rank,(PetscInt)info.nz_used);CHKERRQ(ierr);
       ierr = MatGetInfo(aij->B,MAT_LOCAL,&info);CHKERRQ(ierr);
       ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] off-diagonal part: nz %D \n",rank,(PetscInt)info.nz_used);CHKERRQ(ierr);
+      if (aij->splitruns) {
+        ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] split MatMult: %D interior rows, %D boundary rows, %D calls, %g s on interior rows while communicating, %g s waiting\n",
+                                                  rank,aij->nsplitrows[0],aij->nsplitrows[1],aij->split_ncalls,aij->split_overlap,aij->split_wait);CHKERRQ(ierr);
+      }
       ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
       ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
       ierr = PetscViewerASCIIPrintf(viewer,"Information on VecScatter used in matrix-vector product: \n");CHKERRQ(ierr);
@@ -1342,6 +1567,14 @@ PetscErrorCode MatView_MPIAIJ_ASCIIorDraworSocket(Mat mat,PetscViewer viewer)
       } else {
         ierr = PetscViewerASCIIPrintf(viewer,"not using I-node (on process 0) routines\n");CHKERRQ(ierr);
       }
+      if (aij->splitmult) {
+        PetscReal hidden[2],ghidden[2];
+        /* the fraction of the communication time of MatMult() that was covered by work on the interior rows */
+        hidden[0] = aij->split_overlap + aij->split_wait > 0.0 ? aij->split_overlap/(aij->split_overlap + aij->split_wait) : 1.0;
+        hidden[1] = -hidden[0];
+        ierr = MPIU_Allreduce(hidden,ghidden,2,MPIU_REAL,MPIU_MAX,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(viewer,"using split MatMult: fraction of the time between sending and receiving the ghost values spent on interior rows, min %g max %g\n",(double)-ghidden[1],(double)ghidden[0]);CHKERRQ(ierr);
+      }
       PetscFunctionReturn(0);
     } else if (format == PETSC_VIEWER_ASCII_FACTOR_INFO) {
       PetscFunctionReturn(0);
@@ -2445,6 +2678,7 @@ PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap(Mat A,PetscBool sc)
 
 PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat A)
 {
+  Mat_MPIAIJ           *a = (Mat_MPIAIJ*)A->data;
   PetscErrorCode       ierr;
   PetscBool            sc = PETSC_FALSE,flg;
 
@@ -2456,6 +2690,7 @@ PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat
   if (flg) {
     ierr = MatMPIAIJSetUseScalableIncreaseOverlap(A,sc);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsBool("-mat_mpiaij_split_mult","Compute the rows without off-process coupling while the ghost values are communicated","MatMult",a->splitmult,&a->splitmult,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -2626,7 +2861,7 @@ static struct _MatOps MatOps_Values = {MatSetValues_MPIAIJ,
                                        MatInvertBlockDiagonal_MPIAIJ,
                                        0,
                                        MatCreateSubMatricesMPI_MPIAIJ,
-                                /*129*/0,
+                                /*129*/MatSetValuesBatch_MPIAIJ,
                                        MatTransposeMatMult_MPIAIJ_MPIAIJ,
                                        MatTransposeMatMultSymbolic_MPIAIJ_MPIAIJ,
                                        MatTransposeMatMultNumeric_MPIAIJ_MPIAIJ,
@@ -2679,7 +2914,7 @@ PetscErrorCode  MatMPIAIJSetPreallocation_MPIAIJ(Mat B,PetscInt d_nz,const Petsc
   b = (Mat_MPIAIJ*)B->data;
 
 #if defined(PETSC_USE_CTABLE)
-  ierr = PetscTableDestroy(&b->colmap);CHKERRQ(ierr);
+  ierr = PetscHMapIDestroy(&b->colmap);CHKERRQ(ierr);
 #else
   ierr = PetscFree(b->colmap);CHKERRQ(ierr);
 #endif
@@ -2723,7 +2958,7 @@ PetscErrorCode MatResetPreallocation_MPIAIJ(Mat B)
   b = (Mat_MPIAIJ*)B->data;
 
 #if defined(PETSC_USE_CTABLE)
-  ierr = PetscTableDestroy(&b->colmap);CHKERRQ(ierr);
+  ierr = PetscHMapIDestroy(&b->colmap);CHKERRQ(ierr);
 #else
   ierr = PetscFree(b->colmap);CHKERRQ(ierr);
 #endif
@@ -2763,6 +2998,7 @@ PetscErrorCode MatDuplicate_MPIAIJ(Mat matin,MatDuplicateOption cpvalues,Mat *ne
   a->rank         = oldmat->rank;
   a->donotstash   = oldmat->donotstash;
   a->roworiented  = oldmat->roworiented;
+  a->splitmult    = oldmat->splitmult;
   a->rowindices   = 0;
   a->rowvalues    = 0;
   a->getrowactive = PETSC_FALSE;
@@ -2772,7 +3008,7 @@ PetscErrorCode MatDuplicate_MPIAIJ(Mat matin,MatDuplicateOption cpvalues,Mat *ne
 
   if (oldmat->colmap) {
 #if defined(PETSC_USE_CTABLE)
-    ierr = PetscTableCreateCopy(oldmat->colmap,&a->colmap);CHKERRQ(ierr);
+    ierr = PetscHMapIDuplicate(oldmat->colmap,&a->colmap);CHKERRQ(ierr);
 #else
     ierr = PetscMalloc1(mat->cmap->N,&a->colmap);CHKERRQ(ierr);
     ierr = PetscLogObjectMemory((PetscObject)mat,(mat->cmap->N)*sizeof(PetscInt));CHKERRQ(ierr);
@@ -4218,7 +4454,8 @@ $     MatMPIAIJSetPreallocation(A,...);
 
    Options Database Keys:
 +  -mat_no_inode  - Do not use inodes
--  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+-  -mat_aij_threads <n> - Use n threads, on a nonzero-balanced row partition, in MatMult() and friends (requires OpenMP)
 
 
 
@@ -5402,7 +5639,7 @@ PetscErrorCode MatGetBrowsOfAoCols_MPIAIJ(Mat A,Mat B,MatReuse scall,PetscInt **
 
 @*/
 #if defined(PETSC_USE_CTABLE)
-PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscTable *colmap, VecScatter *multScatter)
+PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscHMapI *colmap, VecScatter *multScatter)
 #else
 PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscInt *colmap[], VecScatter *multScatter)
 #endif
@@ -5423,6 +5660,8 @@ PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscInt *colmap[],
 
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJCRL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJPERM(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJAutotune(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMixed(Mat,MatType,MatReuse,Mat*);
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMKL(Mat,MatType,MatReuse,Mat*);
 #endif
@@ -5506,7 +5745,10 @@ PETSC_INTERN PetscErrorCode MatMatMult_MPIDense_MPIAIJ(Mat A,Mat B,MatReuse scal
    MATMPIAIJ - MATMPIAIJ = "mpiaij" - A matrix type to be used for parallel sparse matrices.
 
    Options Database Keys:
-. -mat_type mpiaij - sets the matrix type to "mpiaij" during a call to MatSetFromOptions()
++ -mat_type mpiaij - sets the matrix type to "mpiaij" during a call to MatSetFromOptions()
+- -mat_mpiaij_split_mult - MatMult() computes the rows without off-process coupling while the ghost values are communicated;
+                           MatMultAdd() is not split, and neither is MatMult() when the local blocks use -mat_aij_threads
+                           or -mat_aij_compress_indices
 
   Level: beginner
 
@@ -5560,6 +5802,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocationCSR_C",MatMPIAIJSetPreallocationCSR_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatDiagonalScaleLocal_C",MatDiagonalScaleLocal_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijperm_C",MatConvert_MPIAIJ_MPIAIJPERM);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijautotune_C",MatConvert_MPIAIJ_MPIAIJAutotune);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijmixed_C",MatConvert_MPIAIJ_MPIAIJMixed);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijmkl_C",MatConvert_MPIAIJ_MPIAIJMKL);CHKERRQ(ierr);
 #endif
@@ -5764,8 +6008,7 @@ PETSC_EXTERN void PETSC_STDCALL matsetvaluesmpiaij_(Mat *mmat,PetscInt *mm,const
                 ierr = MatCreateColmap_MPIAIJ_Private(mat);CHKERRQ(ierr);
               }
 #if defined(PETSC_USE_CTABLE)
-              ierr = PetscTableFind(aij->colmap,in[j]+1,&col);CHKERRQ(ierr);
-              col--;
+              ierr = PetscHMapIGet(aij->colmap,in[j],&col);CHKERRQ(ierr);
 #else
               col = aij->colmap[in[j]] - 1;
 #endif
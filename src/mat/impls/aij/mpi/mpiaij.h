@@ -3,6 +3,7 @@
 #define __MPIAIJ_H
 
 #include <../src/mat/impls/aij/seq/aij.h>
+#include <petsc/private/hashmapi.h>
 
 typedef struct { /* used by MatCreateMPIAIJSumSeqAIJ for reusing the merged matrix */
   PetscLayout rowmap;
@@ -49,7 +50,7 @@ typedef struct {
   PetscScalar *svalues,*rvalues;       /* sending and receiving data */
   PetscInt    rmax;                     /* maximum message length */
 #if defined(PETSC_USE_CTABLE)
-  PetscTable colmap;
+  PetscHMapI colmap;                    /* local col number of off-diag col, -1 if absent */
 #else
   PetscInt *colmap;                     /* local col number of off-diag col */
 #endif
@@ -76,6 +77,19 @@ typedef struct {
   /* used by MatMatMatMult() */
   Mat_MatMatMatMult *matmatmatmult;
 
+  /* Used by MatMult_MPIAIJ() with -mat_mpiaij_split_mult */
+  PetscBool        splitmult;         /* compute the rows without off-process columns while the ghost values are in flight */
+  PetscInt         ninterior,nboundary; /* number of runs of consecutive interior and boundary rows */
+  PetscInt         *splitruns;        /* [start,end) of the interior runs followed by those of the boundary runs */
+  PetscInt         nsplitrows[2];     /* number of interior and boundary rows */
+  PetscObjectState split_nonzerostate; /* nonzero state of the matrix when the runs were computed */
+  PetscLogDouble   split_overlap;     /* time spent on the interior rows between VecScatterBegin() and VecScatterEnd() */
+  PetscLogDouble   split_wait;        /* time spent waiting in VecScatterEnd() */
+  PetscInt         split_ncalls;      /* number of timed calls */
+
+  /* Used by MatSetValuesBatch_MPIAIJ() */
+  Mat_AIJ_Batch    batch;             /* positions of the values of the last batch in A and B */
+
   /* Used by MPICUSP and MPICUSPARSE classes */
   void * spptr;
 
@@ -8,7 +8,7 @@
 #include <petscsf.h>
 
 static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Once(Mat,PetscInt,IS*);
-static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Local(Mat,PetscInt,char**,PetscInt*,PetscInt**,PetscTable*);
+static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Local(Mat,PetscInt,char**,PetscInt*,PetscInt**,PetscHMapI*);
 static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Receive(Mat,PetscInt,PetscInt**,PetscInt**,PetscInt*);
 extern PetscErrorCode MatGetRow_MPIAIJ(Mat,PetscInt,PetscInt*,PetscInt**,PetscScalar**);
 extern PetscErrorCode MatRestoreRow_MPIAIJ(Mat,PetscInt,PetscInt*,PetscInt**,PetscScalar**);
@@ -459,7 +459,7 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Once(Mat C,PetscInt imax,IS is[]
   const PetscInt **idx,*idx_i;
   PetscInt       *n,**data,len;
 #if defined(PETSC_USE_CTABLE)
-  PetscTable     *table_data,table_data_i;
+  PetscHMapI     *table_data,table_data_i;
   PetscInt       *tdata,tcount,tcount_max;
 #else
   PetscInt       *data_i,*d_p;
@@ -570,7 +570,7 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Once(Mat C,PetscInt imax,IS is[]
     ierr = PetscIntMultError((M/PETSC_BITS_PER_BYTE+1),imax, &M_BPB_imax);CHKERRQ(ierr);
     ierr = PetscMalloc1(imax,&table_data);CHKERRQ(ierr);
     for (i=0; i<imax; i++) {
-      ierr = PetscTableCreate(n[i]+1,M+1,&table_data[i]);CHKERRQ(ierr);
+      ierr = PetscHMapICreate(&table_data[i]);CHKERRQ(ierr);
     }
     ierr = PetscCalloc4(imax,&table, imax,&data, imax,&isz, M_BPB_imax,&t_p);CHKERRQ(ierr);
     for (i=0; i<imax; i++) {
@@ -613,7 +613,7 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Once(Mat C,PetscInt imax,IS is[]
           ptr[proc]++;
         } else if (!PetscBTLookupSet(table_i,row)) {
 #if defined(PETSC_USE_CTABLE)
-          ierr = PetscTableAdd(table_data_i,row+1,isz_i+1,INSERT_VALUES);CHKERRQ(ierr);
+          ierr = PetscHMapISet(table_data_i,row,isz_i);CHKERRQ(ierr);
 #else
           data_i[isz_i] = row; /* Update the local table */
 #endif
@@ -735,7 +735,7 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Once(Mat C,PetscInt imax,IS is[]
           row = rbuf2_i[ct1];
           if (!PetscBTLookupSet(table_i,row)) {
 #if defined(PETSC_USE_CTABLE)
-            ierr = PetscTableAdd(table_data_i,row+1,isz_i+1,INSERT_VALUES);CHKERRQ(ierr);
+            ierr = PetscHMapISet(table_data_i,row,isz_i);CHKERRQ(ierr);
 #else
             data_i[isz_i] = row;
 #endif
@@ -754,7 +754,7 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Once(Mat C,PetscInt imax,IS is[]
   tcount_max = 0;
   for (i=0; i<imax; ++i) {
     table_data_i = table_data[i];
-    ierr = PetscTableGetCount(table_data_i,&tcount);CHKERRQ(ierr);
+    ierr = PetscHMapIGetSize(table_data_i,&tcount);CHKERRQ(ierr);
     if (tcount_max < tcount) tcount_max = tcount;
   }
   ierr = PetscMalloc1(tcount_max+1,&tdata);CHKERRQ(ierr);
@@ -762,13 +762,15 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Once(Mat C,PetscInt imax,IS is[]
 
   for (i=0; i<imax; ++i) {
 #if defined(PETSC_USE_CTABLE)
-    PetscTablePosition tpos;
+    PetscHashIter tpos;
     table_data_i = table_data[i];
 
-    ierr = PetscTableGetHeadPosition(table_data_i,&tpos);CHKERRQ(ierr);
-    while (tpos) {
-      ierr = PetscTableGetNext(table_data_i,&tpos,&k,&j);CHKERRQ(ierr);
-      tdata[--j] = --k;
+    PetscHashIterBegin(table_data_i,tpos);
+    while (!PetscHashIterAtEnd(table_data_i,tpos)) {
+      PetscHashIterGetKey(table_data_i,tpos,k);
+      PetscHashIterGetVal(table_data_i,tpos,j);
+      tdata[j] = k;
+      PetscHashIterNext(table_data_i,tpos);
     }
     ierr = ISCreateGeneral(iscomms[i],isz[i],tdata,PETSC_COPY_VALUES,is+i);CHKERRQ(ierr);
 #else
@@ -795,7 +797,7 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Once(Mat C,PetscInt imax,IS is[]
   ierr = PetscFree(isz1);CHKERRQ(ierr);
 #if defined(PETSC_USE_CTABLE)
   for (i=0; i<imax; i++) {
-    ierr = PetscTableDestroy((PetscTable*)&table_data[i]);CHKERRQ(ierr);
+    ierr = PetscHMapIDestroy(&table_data[i]);CHKERRQ(ierr);
   }
   ierr = PetscFree(table_data);CHKERRQ(ierr);
   ierr = PetscFree(tdata);CHKERRQ(ierr);
@@ -820,7 +822,7 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Once(Mat C,PetscInt imax,IS is[]
                to each index set;
       data or table_data  - pointer to the solutions
 */
-static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Local(Mat C,PetscInt imax,PetscBT *table,PetscInt *isz,PetscInt **data,PetscTable *table_data)
+static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Local(Mat C,PetscInt imax,PetscBT *table,PetscInt *isz,PetscInt **data,PetscHMapI *table_data)
 {
   Mat_MPIAIJ *c = (Mat_MPIAIJ*)C->data;
   Mat        A  = c->A,B = c->B;
@@ -829,9 +831,9 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Local(Mat C,PetscInt imax,PetscB
   PetscInt   *bi,*bj,*garray,i,j,k,row,isz_i;
   PetscBT    table_i;
 #if defined(PETSC_USE_CTABLE)
-  PetscTable         table_data_i;
+  PetscHMapI         table_data_i;
   PetscErrorCode     ierr;
-  PetscTablePosition tpos;
+  PetscHashIter      tpos;
   PetscInt           tcount,*tdata;
 #else
   PetscInt           *data_i;
@@ -850,15 +852,17 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Local(Mat C,PetscInt imax,PetscB
 #if defined(PETSC_USE_CTABLE)
     /* copy existing entries of table_data_i into tdata[] */
     table_data_i = table_data[i];
-    ierr = PetscTableGetCount(table_data_i,&tcount);CHKERRQ(ierr);
+    ierr = PetscHMapIGetSize(table_data_i,&tcount);CHKERRQ(ierr);
     if (tcount != isz[i]) SETERRQ3(PETSC_COMM_SELF,0," tcount %d != isz[%d] %d",tcount,i,isz[i]);
 
     ierr = PetscMalloc1(tcount,&tdata);CHKERRQ(ierr);
-    ierr = PetscTableGetHeadPosition(table_data_i,&tpos);CHKERRQ(ierr);
-    while (tpos) {
-      ierr = PetscTableGetNext(table_data_i,&tpos,&row,&j);CHKERRQ(ierr);
-      tdata[--j] = --row;
+    PetscHashIterBegin(table_data_i,tpos);
+    while (!PetscHashIterAtEnd(table_data_i,tpos)) {
+      PetscHashIterGetKey(table_data_i,tpos,row);
+      PetscHashIterGetVal(table_data_i,tpos,j);
       if (j > tcount - 1) SETERRQ2(PETSC_COMM_SELF,0," j %d >= tcount %d",j,tcount);
+      tdata[j] = row;
+      PetscHashIterNext(table_data_i,tpos);
     }
 #else
     data_i  = data[i];
@@ -879,7 +883,7 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Local(Mat C,PetscInt imax,PetscB
         val = aj[k] + cstart;
         if (!PetscBTLookupSet(table_i,val)) {
 #if defined(PETSC_USE_CTABLE)
-          ierr = PetscTableAdd(table_data_i,val+1,isz_i+1,INSERT_VALUES);CHKERRQ(ierr);
+          ierr = PetscHMapISet(table_data_i,val,isz_i);CHKERRQ(ierr);
 #else
           data_i[isz_i] = val;
 #endif
@@ -892,7 +896,7 @@ static PetscErrorCode MatIncreaseOverlap_MPIAIJ_Local(Mat C,PetscInt imax,PetscB
         val = garray[bj[k]];
         if (!PetscBTLookupSet(table_i,val)) {
 #if defined(PETSC_USE_CTABLE)
-          ierr = PetscTableAdd(table_data_i,val+1,isz_i+1,INSERT_VALUES);CHKERRQ(ierr);
+          ierr = PetscHMapISet(table_data_i,val,isz_i);CHKERRQ(ierr);
 #else
           data_i[isz_i] = val;
 #endif
@@ -2965,7 +2969,7 @@ PetscErrorCode MatSetSeqMats_MPIAIJ(Mat C,IS rowemb,IS dcolemb,IS ocolemb,MatStr
 
     if (B && pattern == DIFFERENT_NONZERO_PATTERN) {
 #if defined(PETSC_USE_CTABLE)
-      ierr = PetscTableDestroy(&aij->colmap);CHKERRQ(ierr);
+      ierr = PetscHMapIDestroy(&aij->colmap);CHKERRQ(ierr);
 #else
       ierr = PetscFree(aij->colmap);CHKERRQ(ierr);
       /* A bit of a HACK: ideally we should deal with case aij->B all in one code block below. */
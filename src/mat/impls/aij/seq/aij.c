@@ -646,6 +646,9 @@ PetscErrorCode MatView_SeqAIJ_ASCII(Mat A,PetscViewer viewer)
     ierr = PetscViewerASCIIPrintf(viewer,"];\n %s = spconvert(zzz);\n",name);CHKERRQ(ierr);
     ierr = PetscViewerASCIIUseTabs(viewer,PETSC_TRUE);CHKERRQ(ierr);
   } else if (format == PETSC_VIEWER_ASCII_FACTOR_INFO || format == PETSC_VIEWER_ASCII_INFO) {
+    if (a->jacobisweeps) {
+      ierr = PetscViewerASCIIPrintf(viewer,"using MatSolve with %D Jacobi sweeps on each factor: %D threads\n",a->jacobisweeps,PetscMax(a->threads.nthreads,1));CHKERRQ(ierr);
+    }
     PetscFunctionReturn(0);
   } else if (format == PETSC_VIEWER_ASCII_COMMON) {
     ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
@@ -975,6 +978,8 @@ PetscErrorCode MatView_SeqAIJ(Mat A,PetscViewer viewer)
     ierr = MatView_SeqAIJ_Draw(A,viewer);CHKERRQ(ierr);
   }
   ierr = MatView_SeqAIJ_Inode(A,viewer);CHKERRQ(ierr);
+  ierr = MatView_SeqAIJ_Threads(A,viewer);CHKERRQ(ierr);
+  ierr = MatView_SeqAIJ_JCompress(A,viewer);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -982,14 +987,18 @@ PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A,MatAssemblyType mode)
 {
   Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
   PetscErrorCode ierr;
-  PetscInt       fshift = 0,i,j,*ai = a->i,*aj = a->j,*imax = a->imax;
-  PetscInt       m      = A->rmap->n,*ip,N,*ailen = a->ilen,rmax = 0;
-  MatScalar      *aa    = a->a,*ap;
+  PetscInt       fshift = 0,i,j,*ai,*aj,*imax;
+  PetscInt       m      = A->rmap->n,*ip,N,*ailen,rmax = 0;
+  MatScalar      *aa,*ap;
   PetscReal      ratio  = 0.6;
 
   PetscFunctionBegin;
+  ierr = MatAssemblyEnd_SeqAIJ_Hash(A,mode);CHKERRQ(ierr);
   if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
 
+  /* the hash assembly may have just allocated the arrays */
+  ai = a->i; aj = a->j; imax = a->imax; ailen = a->ilen; aa = a->a;
+
   if (m) rmax = ailen[0]; /* determine row with most nonzeros */
   for (i=1; i<m; i++) {
     /* move each row back by the amount of empty slots (fshift) before it*/
@@ -1038,6 +1047,8 @@ PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A,MatAssemblyType mode)
     ierr = MatCheckCompressedRow(A,a->nonzerorowcnt,&a->compressedrow,a->i,m,ratio);CHKERRQ(ierr);
   }
   ierr = MatAssemblyEnd_SeqAIJ_Inode(A,mode);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd_SeqAIJ_Threads(A,mode);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd_SeqAIJ_JCompress(A,mode);CHKERRQ(ierr);
   ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1075,6 +1086,7 @@ PetscErrorCode MatZeroEntries_SeqAIJ(Mat A)
 
   PetscFunctionBegin;
   ierr = PetscMemzero(a->a,(a->i[A->rmap->n])*sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = MatZeroEntries_SeqAIJ_Hash(A);CHKERRQ(ierr);
   ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1097,6 +1109,7 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = PetscFree(a->ipre);CHKERRQ(ierr);
   ierr = PetscFree3(a->idiag,a->mdiag,a->ssor_work);CHKERRQ(ierr);
   ierr = PetscFree(a->solve_work);CHKERRQ(ierr);
+  ierr = PetscFree(a->jacobiwork);CHKERRQ(ierr);
   ierr = ISDestroy(&a->icol);CHKERRQ(ierr);
   ierr = PetscFree(a->saved_values);CHKERRQ(ierr);
   ierr = ISColoringDestroy(&a->coloring);CHKERRQ(ierr);
@@ -1104,15 +1117,22 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = PetscFree(a->matmult_abdense);CHKERRQ(ierr);
 
   ierr = MatDestroy_SeqAIJ_Inode(A);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ_Threads(A);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ_JCompress(A);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ_Hash(A);CHKERRQ(ierr);
+  ierr = MatAIJBatchReset(&a->batch);CHKERRQ(ierr);
   ierr = PetscFree(A->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)A,0);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetColumnIndices_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetHashAssembly_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatStoreValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatRetrieveValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqsbaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqbaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqaijperm_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqaijautotune_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqaijmixed_C",NULL);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_ELEMENTAL)
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_elemental_C",NULL);CHKERRQ(ierr);
 #endif
@@ -1220,6 +1240,48 @@ PetscErrorCode MatGetDiagonal_SeqAIJ(Mat A,Vec v)
 }
 
 #include <../src/mat/impls/aij/seq/ftn-kernels/fmult.h>
+
+#if defined(PETSC_HAVE_ATTRIBUTE_TARGET) && defined(PETSC_HAVE_IMMINTRIN_H) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+#define MAT_SEQAIJ_AVX512_KERNEL
+#include <immintrin.h>
+
+/*
+   z = y + A x, or z = A x if y is NULL; selected when the program runs (see MatGetSIMDType()) so it is compiled for
+   AVX-512 regardless of the compiler flags. The end of each row is handled with masked loads.
+*/
+__attribute((target("avx512f")))
+static void MatMultAdd_SeqAIJ_AVX512_Kernel(PetscInt m,const PetscInt *ii,const PetscInt *aj,const MatScalar *aa,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
+{
+  __m512d  vec_sum,vec_sum2;
+  __mmask8 mask;
+  PetscInt i,j,end;
+
+  for (i=0; i<m; i++) {
+    vec_sum  = _mm512_setzero_pd();
+    vec_sum2 = _mm512_setzero_pd();
+    end      = ii[i+1];
+    for (j=ii[i]; j+16<=end; j+=16) {
+#if defined(PETSC_USE_64BIT_INDICES)
+      vec_sum  = _mm512_fmadd_pd(_mm512_i64gather_pd(_mm512_loadu_si512((const void*)(aj+j)),x,8),_mm512_loadu_pd(aa+j),vec_sum);
+      vec_sum2 = _mm512_fmadd_pd(_mm512_i64gather_pd(_mm512_loadu_si512((const void*)(aj+j+8)),x,8),_mm512_loadu_pd(aa+j+8),vec_sum2);
+#else
+      vec_sum  = _mm512_fmadd_pd(_mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*)(aj+j)),x,8),_mm512_loadu_pd(aa+j),vec_sum);
+      vec_sum2 = _mm512_fmadd_pd(_mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*)(aj+j+8)),x,8),_mm512_loadu_pd(aa+j+8),vec_sum2);
+#endif
+    }
+    for (; j<end; j+=8) {
+      mask = (end-j >= 8) ? (__mmask8)0xff : (__mmask8)(0xff >> (8-(end-j)));
+#if defined(PETSC_USE_64BIT_INDICES)
+      vec_sum = _mm512_fmadd_pd(_mm512_mask_i64gather_pd(_mm512_setzero_pd(),mask,_mm512_maskz_loadu_epi64(mask,aj+j),x,8),_mm512_maskz_loadu_pd(mask,aa+j),vec_sum);
+#else
+      vec_sum = _mm512_fmadd_pd(_mm512_mask_i32gather_pd(_mm512_setzero_pd(),mask,_mm512_castsi512_si256(_mm512_maskz_loadu_epi32((__mmask16)mask,aj+j)),x,8),_mm512_maskz_loadu_pd(mask,aa+j),vec_sum);
+#endif
+    }
+    z[i] = _mm512_reduce_add_pd(_mm512_add_pd(vec_sum,vec_sum2)) + (y ? y[i] : 0.0);
+  }
+}
+#endif
+
 PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A,Vec xx,Vec zz,Vec yy)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
@@ -1316,6 +1378,10 @@ PetscErrorCode MatMult_SeqAIJ(Mat A,Vec xx,Vec yy)
       /* for (j=0; j<n; j++) sum += (*aa++)*x[*aj++]; */
       y[*ridx++] = sum;
     }
+#if defined(MAT_SEQAIJ_AVX512_KERNEL)
+  } else if (a->simd == PETSC_SIMD_AVX512) {
+    MatMultAdd_SeqAIJ_AVX512_Kernel(m,ii,a->j,a->a,x,NULL,y);
+#endif
   } else { /* do not use compressed row format */
 #if defined(PETSC_USE_FORTRAN_KERNEL_MULTAIJ)
     aj   = a->j;
@@ -1468,6 +1534,10 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A,Vec xx,Vec yy,Vec zz)
       PetscSparseDensePlusDot(sum,x,aa,aj,n);
       z[*ridx++] = sum;
     }
+#if defined(MAT_SEQAIJ_AVX512_KERNEL)
+  } else if (a->simd == PETSC_SIMD_AVX512) {
+    MatMultAdd_SeqAIJ_AVX512_Kernel(m,a->i,a->j,a->a,x,y,z);
+#endif
   } else { /* do not use compressed row format */
     ii = a->i;
 #if defined(PETSC_USE_FORTRAN_KERNEL_MULTADDAIJ)
@@ -1491,6 +1561,37 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A,Vec xx,Vec yy,Vec zz)
   PetscFunctionReturn(0);
 }
 
+/*
+   Rows rstart to rend-1 of z = y + A x, or z = A x if y is NULL, computed with the same arithmetic as MatMult_SeqAIJ()
+   and MatMultAdd_SeqAIJ(), including their SIMD kernel; x, y and z are the full local arrays. Used by the split
+   MatMult() of MPIAIJ, which works on runs of rows.
+*/
+PetscErrorCode MatMultAddRows_SeqAIJ_Private(Mat A,PetscInt rstart,PetscInt rend,const PetscScalar x[],const PetscScalar y[],PetscScalar z[])
+{
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt  *ii = a->i,*aj;
+  const MatScalar *aa;
+  PetscScalar     sum;
+  PetscInt        i,n;
+
+  PetscFunctionBegin;
+#if defined(MAT_SEQAIJ_AVX512_KERNEL)
+  if (!a->compressedrow.use && a->simd == PETSC_SIMD_AVX512) {
+    MatMultAdd_SeqAIJ_AVX512_Kernel(rend-rstart,ii+rstart,a->j,a->a,x,y ? y+rstart : NULL,z+rstart);
+    PetscFunctionReturn(0);
+  }
+#endif
+  for (i=rstart; i<rend; i++) {
+    n   = ii[i+1] - ii[i];
+    aj  = a->j + ii[i];
+    aa  = a->a + ii[i];
+    sum = y ? y[i] : 0.0;
+    PetscSparseDensePlusDot(sum,x,aa,aj,n);
+    z[i] = sum;
+  }
+  PetscFunctionReturn(0);
+}
+
 /*
      Adds diagonal pointers to sparse matrix structure.
 */
@@ -3120,6 +3221,21 @@ PetscErrorCode MatShift_SeqAIJ(Mat Y,PetscScalar a)
   PetscFunctionReturn(0);
 }
 
+/* -------------------------------------------------------------------*/
+static PetscErrorCode MatSetFromOptions_SeqAIJ(PetscOptionItems *PetscOptionsObject,Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscBool      flg,set;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"SeqAIJ options");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_aij_hash_assembly","Assemble into a hash table until the first MatAssemblyEnd(), no preallocation needed","MatSeqAIJSetHashAssembly",a->hash.use,&flg,&set);CHKERRQ(ierr);
+  if (set) {ierr = MatSeqAIJSetHashAssembly(A,flg);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* -------------------------------------------------------------------*/
 static struct _MatOps MatOps_Values = { MatSetValues_SeqAIJ,
                                         MatGetRow_SeqAIJ,
@@ -3197,7 +3313,7 @@ static struct _MatOps MatOps_Values = { MatSetValues_SeqAIJ,
                                         0,
                                 /* 74*/ 0,
                                         MatFDColoringApply_AIJ,
-                                        0,
+                                        MatSetFromOptions_SeqAIJ,
                                         0,
                                         0,
                                 /* 79*/ MatFindZeroDiagonals_SeqAIJ,
@@ -3250,7 +3366,7 @@ static struct _MatOps MatOps_Values = { MatSetValues_SeqAIJ,
                                         MatInvertBlockDiagonal_SeqAIJ,
                                         0,
                                         0,
-                                /*129*/ 0,
+                                /*129*/ MatSetValuesBatch_SeqAIJ,
                                         MatTransposeMatMult_SeqAIJ_SeqAIJ,
                                         MatTransposeMatMultSymbolic_SeqAIJ_SeqAIJ,
                                         MatTransposeMatMultNumeric_SeqAIJ_SeqAIJ,
@@ -3440,6 +3556,7 @@ PetscErrorCode  MatRetrieveValues(Mat mat)
   if (!mat->assembled) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Not for unassembled matrix");
   if (mat->factortype) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Not for factored matrix");
   ierr = PetscUseMethod(mat,"MatRetrieveValues_C",(Mat),(mat));CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)mat);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -3489,7 +3606,12 @@ PetscErrorCode  MatRetrieveValues(Mat mat)
 
    Options Database Keys:
 +  -mat_no_inode  - Do not use inodes
--  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_aij_threads <n> - Use n threads, on a nonzero-balanced row partition, in MatMult() and friends, and level by level in MatSolve() with its LU and ILU factors (requires OpenMP)
+.  -mat_aij_threads_reorder_solve - Store the rows of the factors in level order for the threaded MatSolve()
+.  -mat_aij_compress_indices - Store the column indices as 8 or 16 bit offsets per block of rows where possible, for MatMult() and MatMultAdd()
+.  -mat_aij_hash_assembly - Assemble into a hash table until the first MatAssemblyEnd(), the preallocation is then not needed, see MatSeqAIJSetHashAssembly()
+-  -mat_simd <none,avx2,avx512> - Highest instruction set used by MatMult() and MatMultAdd(), see MatGetSIMDType()
 
    Level: intermediate
 
@@ -3550,7 +3672,12 @@ PetscErrorCode  MatCreateSeqAIJ(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,
 
    Options Database Keys:
 +  -mat_no_inode  - Do not use inodes
--  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_aij_threads <n> - Use n threads, on a nonzero-balanced row partition, in MatMult() and friends, and level by level in MatSolve() with its LU and ILU factors (requires OpenMP)
+.  -mat_aij_threads_reorder_solve - Store the rows of the factors in level order for the threaded MatSolve()
+.  -mat_aij_compress_indices - Store the column indices as 8 or 16 bit offsets per block of rows where possible, for MatMult() and MatMultAdd()
+.  -mat_aij_hash_assembly - Assemble into a hash table until the first MatAssemblyEnd(), the preallocation is then not needed, see MatSeqAIJSetHashAssembly()
+-  -mat_simd <none,avx2,avx512> - Highest instruction set used by MatMult() and MatMultAdd(), see MatGetSIMDType()
 
    Level: intermediate
 
@@ -3660,6 +3787,7 @@ PetscErrorCode  MatSeqAIJSetPreallocation_SeqAIJ(Mat B,PetscInt nz,const PetscIn
   }
   B->was_assembled = PETSC_FALSE;
   B->assembled     = PETSC_FALSE;
+  ierr = MatSetUp_SeqAIJ_Hash(B);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -3988,6 +4116,7 @@ PetscErrorCode  MatSeqAIJRestoreArray(Mat A,PetscScalar **array)
 
   PetscFunctionBegin;
   ierr = PetscUseMethod(A,"MatSeqAIJRestoreArray_C",(Mat,PetscScalar**),(A,array));CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)A);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -4037,11 +4166,14 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
 #endif
 
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetColumnIndices_C",MatSeqAIJSetColumnIndices_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetHashAssembly_C",MatSeqAIJSetHashAssembly_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatStoreValues_C",MatStoreValues_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqsbaij_C",MatConvert_SeqAIJ_SeqSBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqbaij_C",MatConvert_SeqAIJ_SeqBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijperm_C",MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijautotune_C",MatConvert_SeqAIJ_SeqAIJAutotune);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijmixed_C",MatConvert_SeqAIJ_SeqAIJMixed);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijmkl_C",MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -4066,6 +4198,10 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultNumeric_seqdense_seqaij_C",MatMatMultNumeric_SeqDense_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_seqaij_C",MatPtAP_IS_XAIJ);CHKERRQ(ierr);
   ierr = MatCreate_SeqAIJ_Inode(B);CHKERRQ(ierr);
+  ierr = MatCreate_SeqAIJ_Threads(B);CHKERRQ(ierr);
+  ierr = MatCreate_SeqAIJ_JCompress(B);CHKERRQ(ierr);
+  ierr = MatCreate_SeqAIJ_Hash(B);CHKERRQ(ierr);
+  ierr = MatGetSIMDType(&b->simd);CHKERRQ(ierr);
   ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
   ierr = MatSeqAIJSetTypeFromOptions(B);CHKERRQ(ierr);  /* this allows changing the matrix subtype to say MATSEQAIJPERM */
   PetscFunctionReturn(0);
@@ -4131,6 +4267,7 @@ PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat C,Mat A,MatDuplicateOption cpvalu
   } else c->diag = 0;
 
   c->solve_work         = 0;
+  c->jacobiwork         = 0;
   c->saved_values       = 0;
   c->idiag              = 0;
   c->ssor_work          = 0;
@@ -4159,6 +4296,8 @@ PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat C,Mat A,MatDuplicateOption cpvalu
   C->nonzerostate  = A->nonzerostate;
 
   ierr = MatDuplicate_SeqAIJ_Inode(A,cpvalues,&C);CHKERRQ(ierr);
+  ierr = MatDuplicate_SeqAIJ_Threads(A,cpvalues,&C);CHKERRQ(ierr);
+  ierr = MatDuplicate_SeqAIJ_JCompress(A,cpvalues,&C);CHKERRQ(ierr);
   ierr = PetscFunctionListDuplicate(((PetscObject)A)->qlist,&((PetscObject)C)->qlist);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -4,6 +4,7 @@
 
 #include <petsc/private/matimpl.h>
 #include <petscctable.h>
+#include <petsc/private/hashmapijv.h>
 
 /*
     Struct header shared by SeqAIJ, SeqBAIJ and SeqSBAIJ matrix formats
@@ -97,6 +98,89 @@ typedef struct {
   PetscObjectState mat_nonzerostate;               /* non-zero state when inodes were checked for */
 } Mat_SeqAIJ_Inode;
 
+/* Level sets of a triangular factor for the threaded MatSolve(), the rows of a level only depend on rows of earlier levels */
+typedef struct {
+  PetscInt  nlevels;                               /* number of levels */
+  PetscInt  *start;                                /* first entry of each level in rows[], start[nlevels] is the number of rows */
+  PetscInt  *rows;                                 /* the rows sorted by level */
+  PetscInt  maxsize;                               /* number of rows of the largest level */
+  PetscInt  *i,*j;                                 /* with -mat_aij_threads_reorder_solve, the rows stored in level order, */
+  MatScalar *a;                                    /* the diagonal of U being stored last in each row */
+} Mat_SeqAIJ_Levels;
+
+/* Info about the nonzero-balanced row partition used by the threaded MatMult() kernels, helper class for SeqAIJ */
+typedef struct {
+  PetscInt         nthreads;                       /* number of threads set with -mat_aij_threads, at most 1 means not used */
+  PetscInt         *rstart;                        /* first row of each thread's chunk, rstart[nthreads] is the number of rows */
+  PetscScalar      *work;                          /* private accumulators for MatMultTranspose(), (nthreads-1)*n entries */
+  PetscLogDouble   *time;                          /* accumulated time spent by each thread in the threaded kernels */
+  PetscInt         ncalls;                         /* number of threaded kernel calls that were timed */
+  PetscObjectState mat_nonzerostate;               /* non-zero state when the partition was computed */
+  PetscBool        reordersolve;                   /* copy the factor rows in level order for the threaded MatSolve() */
+  PetscBool        solvenatural;                   /* the factorization used the natural ordering */
+  Mat_SeqAIJ_Levels levels[2];                     /* level sets of the L and U factors of an LU factorization */
+} Mat_SeqAIJ_Threads;
+
+PETSC_INTERN PetscErrorCode MatView_SeqAIJ_Threads(Mat,PetscViewer);
+PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_Threads(Mat,MatAssemblyType);
+PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_Threads(Mat);
+PETSC_INTERN PetscErrorCode MatCreate_SeqAIJ_Threads(Mat);
+PETSC_INTERN PetscErrorCode MatDuplicate_SeqAIJ_Threads(Mat,MatDuplicateOption,Mat*);
+PETSC_INTERN PetscErrorCode MatSolveSetUp_SeqAIJ_Threads(Mat);
+PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Threads(Mat,Mat,Mat);
+PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable_Threads(Mat,Mat,Mat);
+PETSC_INTERN PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_SparseAxpy_Threads(Mat,Mat,Mat);
+
+/* Info about the compressed column indices used by MatMult() and MatMultAdd(), helper class for SeqAIJ */
+typedef struct {
+  PetscBool        use;                            /* set with -mat_aij_compress_indices */
+  PetscInt         nblocks;                        /* number of blocks of consecutive rows */
+  PetscInt         *base;                          /* smallest column of each block */
+  size_t           *offset;                        /* offset in bytes of the indices of each block in idx, offset[nblocks] is the total */
+  unsigned char    *width;                         /* bytes per index of each block: 1, 2 or 0 for the full width indices of a->j */
+  unsigned char    *idx;                           /* the column offsets from base of the compressed blocks */
+  size_t           nbytes;                         /* allocated length of idx */
+  PetscInt         nblock[3];                      /* number of blocks with 8 bit, 16 bit and full width indices */
+  PetscObjectState mat_nonzerostate;               /* non-zero state when the indices were compressed */
+} Mat_SeqAIJ_JCompress;
+
+PETSC_INTERN PetscErrorCode MatView_SeqAIJ_JCompress(Mat,PetscViewer);
+PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_JCompress(Mat,MatAssemblyType);
+PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_JCompress(Mat);
+PETSC_INTERN PetscErrorCode MatCreate_SeqAIJ_JCompress(Mat);
+PETSC_INTERN PetscErrorCode MatDuplicate_SeqAIJ_JCompress(Mat,MatDuplicateOption,Mat*);
+
+/* Info about the assembly into a hash table that needs no preallocation, helper class for SeqAIJ */
+typedef struct {
+  PetscBool        use;                            /* set with -mat_aij_hash_assembly or MatSeqAIJSetHashAssembly() */
+  PetscHMapIJV     ht;                             /* the entries set since the preallocation, NULL once converted to CSR */
+} Mat_SeqAIJ_Hash;
+
+PETSC_INTERN PetscErrorCode MatSeqAIJSetHashAssembly_SeqAIJ(Mat,PetscBool);
+PETSC_INTERN PetscErrorCode MatSetUp_SeqAIJ_Hash(Mat);
+PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_Hash(Mat,MatAssemblyType);
+PETSC_INTERN PetscErrorCode MatZeroEntries_SeqAIJ_Hash(Mat);
+PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_Hash(Mat);
+PETSC_INTERN PetscErrorCode MatCreate_SeqAIJ_Hash(Mat);
+
+/* Positions in the CSR arrays of the values of the last MatSetValuesBatch(), used by SeqAIJ and MPIAIJ */
+typedef struct {
+  PetscInt         nb,bs;                          /* number and size of the element matrices of the batch */
+  PetscInt         *rows;                          /* copy of their indices, to recognize the batch */
+  PetscInt         *offsets;                       /* position of each value in a->a, -2-position in the MPIAIJ off-diagonal block, -1 to skip it */
+  PetscInt         nstash,*stash;                  /* MPIAIJ: the element rows b*bs+r owned by other processes */
+  PetscObjectId    id[2];                          /* the diagonal and off-diagonal blocks the offsets refer to */
+  PetscObjectState nonzerostate[2];                /* and their non-zero states when the offsets were computed */
+} Mat_AIJ_Batch;
+
+PETSC_INTERN PetscErrorCode MatAIJBatchReset(Mat_AIJ_Batch*);
+PETSC_INTERN PetscErrorCode MatAIJBatchFind(Mat_AIJ_Batch*,PetscInt,PetscInt,const PetscInt[],Mat,Mat,PetscBool*);
+PETSC_INTERN PetscErrorCode MatAIJBatchSetUp(Mat_AIJ_Batch*,PetscInt,PetscInt,const PetscInt[],Mat,Mat);
+PETSC_INTERN PetscErrorCode MatAIJBatchSortElement(PetscInt,const PetscInt[],PetscInt[],PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSeqAIJBatchRowOffsets(Mat,PetscInt,PetscInt,const PetscInt[],const PetscInt[],PetscBool,PetscInt[],PetscBool*);
+PETSC_INTERN PetscErrorCode MatSetValuesBatch_AIJ_Sorted(Mat,PetscInt,PetscInt,const PetscInt[],const PetscScalar[]);
+PETSC_INTERN PetscErrorCode MatSetValuesBatch_SeqAIJ(Mat,PetscInt,PetscInt,PetscInt*,const PetscScalar*);
+
 PETSC_INTERN PetscErrorCode MatView_SeqAIJ_Inode(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_Inode(Mat,MatAssemblyType);
 PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_Inode(Mat);
@@ -110,6 +194,11 @@ PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat,Mat,const MatFac
 typedef struct {
   SEQAIJHEADER(MatScalar);
   Mat_SeqAIJ_Inode inode;
+  Mat_SeqAIJ_Threads threads;
+  Mat_SeqAIJ_JCompress jcompress;
+  Mat_SeqAIJ_Hash  hash;
+  Mat_AIJ_Batch    batch;
+  PetscSIMDType    simd;                      /* instruction set used by the SIMD MatMult kernels */
   MatScalar        *saved_values;             /* location for stashing nonzero values of matrix */
 
   PetscScalar *idiag,*mdiag,*ssor_work;       /* inverse of diagonal entries, diagonal values and workspace for Eisenstat trick */
@@ -118,9 +207,13 @@ typedef struct {
   PetscBool   ibdiagvalid;                    /* inverses of block diagonals are valid. */
   PetscScalar fshift,omega;                   /* last used omega and fshift */
 
+  PetscInt    jacobisweeps;                   /* Jacobi sweeps replacing each triangular solve of a factor, from -pc_factor_solve_iterative */
+  PetscScalar *jacobiwork;                    /* work arrays of the Jacobi sweeps, 3*n entries */
+  PetscInt    chowsweeps;                     /* fixed-point sweeps of a MATSOLVERCHOWILU factor, from -mat_chowilu_sweeps */
+
   ISColoring  coloring;                       /* set with MatADSetColoring() used by MatADSetValues() */
 
-  PetscScalar         *matmult_abdense;    /* used by MatMatMult() */
+  PetscScalar         *matmult_abdense;    /* used by MatMatMult(), one dense row of B per thread with -mat_aij_threads */
   Mat_PtAP            *ptap;               /* used by MatPtAP() */
   Mat_MatMatMatMult   *matmatmatmult;      /* used by MatMatMatMult() */
   Mat_RARt            *rart;               /* used by MatRARt() */
@@ -231,9 +324,11 @@ PETSC_INTERN PetscErrorCode MatFindZeroDiagonals_SeqAIJ_Private(Mat,PetscInt*,Pe
 
 PETSC_INTERN PetscErrorCode MatMult_SeqAIJ(Mat A,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ(Mat A,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAddRows_SeqAIJ_Private(Mat,PetscInt,PetscInt,const PetscScalar[],const PetscScalar[],PetscScalar[]);
 PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJ(Mat A,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+PETSC_INTERN PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat,PetscScalar,PetscScalar);
 
 PETSC_INTERN PetscErrorCode MatSetOption_SeqAIJ(Mat,MatOption,PetscBool);
 
@@ -251,6 +346,7 @@ PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_InplaceWithPerm(Mat,Mat,co
 PETSC_INTERN PetscErrorCode MatLUFactor_SeqAIJ(Mat,IS,IS,const MatFactorInfo*);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSolveSetUp_SeqAIJ(Mat,const MatFactorInfo*);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_Inode_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_Inode(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_NaturalOrdering_inplace(Mat,Vec,Vec);
@@ -348,6 +444,9 @@ PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJCRL(Mat,MatType,MatReuse,Mat
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_Elemental(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_AIJ_HYPRE(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJPERM(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJAutotune(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatAIJAutotune_Private(Mat);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMixed(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMKL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJViennaCL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatReorderForNonzeroDiagonal_SeqAIJ(Mat,PetscReal,IS,IS);
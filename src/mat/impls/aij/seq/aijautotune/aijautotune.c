@@ -0,0 +1,203 @@
+
+/*
+  Defines the MATSEQAIJAUTOTUNE matrix class. The matrix is assembled as a MATSEQAIJ matrix; its first MatMult() after
+  the final assembly times MatMult() in several storage formats and converts the matrix in place to the fastest one.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <petsctime.h>
+
+/*
+   MatAIJAutotune_Private - Times MatMult() for each candidate format and converts A in place to the fastest one
+
+   Collective on Mat
+
+   A must be a MATSEQAIJ or MATMPIAIJ matrix; the candidate formats are given by their base names (for example
+   MATAIJPERM) so the same list serves both. The timings are the maximum over the processes.
+*/
+PetscErrorCode MatAIJAutotune_Private(Mat A)
+{
+  PetscErrorCode ierr;
+  char           *types[16];
+  const char     *deftypes[] = {MATAIJ,MATAIJPERM,MATSELL,MATBAIJ};
+  PetscInt       ntypes,i,k,its = 10,best = -1;
+  PetscBool      flg,isaij;
+  PetscReal      time,besttime = PETSC_MAX_REAL;
+  PetscLogDouble t0,t1;
+  MatInfo        info;
+  Vec            x,y;
+  Mat            B;
+
+  PetscFunctionBegin;
+  if (!A->rmap->N || !A->cmap->N) PetscFunctionReturn(0);
+  ntypes = 16;
+  ierr   = PetscObjectOptionsBegin((PetscObject)A);CHKERRQ(ierr);
+  ierr   = PetscOptionsInt("-mat_autotune_its","Number of MatMult() timed for each format","MatAIJAutotune_Private",its,&its,NULL);CHKERRQ(ierr);
+  ierr   = PetscOptionsStringArray("-mat_autotune_types","Formats to try","MatAIJAutotune_Private",types,&ntypes,&flg);CHKERRQ(ierr);
+  ierr   = PetscOptionsEnd();CHKERRQ(ierr);
+  if (!flg) {
+    /* BAIJ with block size 1 is only a slower AIJ; AIJCRL is left out since it keeps a copy of the values that
+       MatScale(), MatDiagonalScale() and friends do not update */
+    ntypes = A->rmap->bs > 1 ? 4 : 3;
+    for (i=0; i<ntypes; i++) {ierr = PetscStrallocpy(deftypes[i],&types[i]);CHKERRQ(ierr);}
+  }
+  its  = PetscMax(its,1);
+  ierr = MatGetInfo(A,MAT_GLOBAL_SUM,&info);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+  for (i=0; i<ntypes; i++) {
+    ierr = PetscStrcmp(types[i],MATAIJ,&isaij);CHKERRQ(ierr);
+    if (isaij) B = A;
+    else {
+      /* converting a copy in place leaves A alone, some conversions (MPIAIJ to MPISELL) disassemble their source */
+      ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+      ierr = MatConvert(B,types[i],MAT_INPLACE_MATRIX,&B);CHKERRQ(ierr);
+    }
+    ierr = MatMult(B,x,y);CHKERRQ(ierr);
+    ierr = MPI_Barrier(PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
+    ierr = PetscTime(&t0);CHKERRQ(ierr);
+    for (k=0; k<its; k++) {ierr = MatMult(B,x,y);CHKERRQ(ierr);}
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    time = t1 - t0;
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&time,1,MPIU_REAL,MPIU_MAX,PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
+    ierr = PetscInfo3(A,"%s: %g seconds per MatMult, %g GFlop/s\n",types[i],(double)(time/its),(double)(2.0*info.nz_used*its/PetscMax(time,PETSC_SMALL)/1.e9));CHKERRQ(ierr);
+    if (time < besttime) {besttime = time; best = i;}
+    if (!isaij) {ierr = MatDestroy(&B);CHKERRQ(ierr);}
+  }
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  if (best >= 0) {
+    ierr = PetscInfo1(A,"Using format %s\n",types[best]);CHKERRQ(ierr);
+    ierr = PetscStrcmp(types[best],MATAIJ,&isaij);CHKERRQ(ierr);
+    if (!isaij) {ierr = MatConvert(A,types[best],MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);}
+  }
+  for (i=0; i<ntypes; i++) {ierr = PetscFree(types[i]);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+typedef struct {
+  /* the operations of the MATSEQAIJ matrix, restored before the format is selected */
+  PetscErrorCode (*AssemblyEnd)(Mat,MatAssemblyType);
+  PetscErrorCode (*Duplicate)(Mat,MatDuplicateOption,Mat*);
+  PetscErrorCode (*Destroy)(Mat);
+} Mat_SeqAIJAutotune;
+
+/* Turns A back into the MATSEQAIJ matrix it was converted from */
+static PetscErrorCode MatSeqAIJAutotuneRestore_Private(Mat A)
+{
+  Mat_SeqAIJAutotune *at = (Mat_SeqAIJAutotune*)A->spptr;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  A->ops->assemblyend = at->AssemblyEnd;
+  A->ops->duplicate   = at->Duplicate;
+  A->ops->destroy     = at->Destroy;
+  A->multsetup        = NULL;
+  ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Called by MatMult() before the first product of the assembled matrix, outside of the operations of A: selects the
+   format as a plain MATSEQAIJ so that MatConvert() finds the specialized converters
+*/
+static PetscErrorCode MatMultSetUp_SeqAIJAutotune(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJAutotuneRestore_Private(A);CHKERRQ(ierr);
+  ierr = MatAIJAutotune_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_SeqAIJAutotune(Mat A,MatAssemblyType mode)
+{
+  Mat_SeqAIJAutotune *at = (Mat_SeqAIJAutotune*)A->spptr;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = (*at->AssemblyEnd)(A,mode);CHKERRQ(ierr);
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  A->multsetup = MatMultSetUp_SeqAIJAutotune;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDuplicate_SeqAIJAutotune(Mat A,MatDuplicateOption op,Mat *M)
+{
+  Mat_SeqAIJAutotune *at = (Mat_SeqAIJAutotune*)A->spptr;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = (*at->Duplicate)(A,op,M);CHKERRQ(ierr);
+  if ((*M)->assembled) (*M)->multsetup = MatMultSetUp_SeqAIJAutotune;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_SeqAIJAutotune(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJAutotuneRestore_Private(A);CHKERRQ(ierr);
+  ierr = (*A->ops->destroy)(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJAutotune(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode     ierr;
+  Mat                B = *newmat;
+  Mat_SeqAIJAutotune *at;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr     = PetscNewLog(B,&at);CHKERRQ(ierr);
+  B->spptr = (void*)at;
+  at->AssemblyEnd     = B->ops->assemblyend;
+  at->Duplicate       = B->ops->duplicate;
+  at->Destroy         = B->ops->destroy;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJAutotune;
+  B->ops->duplicate   = MatDuplicate_SeqAIJAutotune;
+  B->ops->destroy     = MatDestroy_SeqAIJAutotune;
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJAUTOTUNE);CHKERRQ(ierr);
+  /* an assembled matrix is tuned by its next product */
+  if (B->assembled) B->multsetup = MatMultSetUp_SeqAIJAutotune;
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATSEQAIJAUTOTUNE - MATSEQAIJAUTOTUNE = "seqaijautotune" - A sequential matrix that picks its own storage format.
+
+   The matrix is preallocated and filled exactly like a MATSEQAIJ matrix. Its first MatMult() after the
+   MatAssemblyEnd() with MAT_FINAL_ASSEMBLY times a few MatMult() in each candidate format and converts the matrix in
+   place, with MatConvert(), to the fastest one; its type is then that format. The measured times and flop rates and the
+   selected format are reported with -info.
+
+   Options Database Keys:
++  -mat_type seqaijautotune - sets the matrix type to "seqaijautotune" during a call to MatSetFromOptions()
+.  -mat_autotune_types <aij,aijperm,sell> - formats to try; baij is also tried by default if the block size is larger than one
+-  -mat_autotune_its <10> - number of MatMult() timed for each format
+
+   Notes:
+   The timings use the processor and threads the matrix will run on, so the choice is made for the actual machine;
+   it is not repeated if the nonzero structure changes later.
+
+  Level: beginner
+
+.seealso: MatCreateSeqAIJ(), MATAIJAUTOTUNE, MATMPIAIJAUTOTUNE, MATSEQAIJPERM, MATSEQAIJCRL, MATSEQSELL
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJAutotune(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJAutotune(A,MATSEQAIJAUTOTUNE,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
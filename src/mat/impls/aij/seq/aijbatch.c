@@ -0,0 +1,168 @@
+/*
+  MatSetValuesBatch() for the AIJ formats. The first batch after a change of the nonzero pattern finds the position in
+  the CSR arrays of each value of the element matrices, merging the sorted element indices with the sorted rows of the
+  matrix; while the same batch is added again to the same pattern, as in the reassembly of a Jacobian, the values are
+  added to these positions without any search.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+
+PetscErrorCode MatAIJBatchReset(Mat_AIJ_Batch *batch)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(batch->rows,batch->offsets);CHKERRQ(ierr);
+  ierr = PetscFree(batch->stash);CHKERRQ(ierr);
+  batch->nb     = 0;
+  batch->bs     = 0;
+  batch->nstash = 0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Whether the offsets were computed for this batch, and for the current nonzero patterns of the diagonal block A and
+   of the off-diagonal block B (NULL for SeqAIJ)
+*/
+PetscErrorCode MatAIJBatchFind(Mat_AIJ_Batch *batch,PetscInt nb,PetscInt bs,const PetscInt rows[],Mat A,Mat B,PetscBool *found)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *found = PETSC_FALSE;
+  if (!batch->offsets || batch->nb != nb || batch->bs != bs) PetscFunctionReturn(0);
+  if (batch->id[0] != ((PetscObject)A)->id || batch->nonzerostate[0] != A->nonzerostate) PetscFunctionReturn(0);
+  if (B && (batch->id[1] != ((PetscObject)B)->id || batch->nonzerostate[1] != B->nonzerostate)) PetscFunctionReturn(0);
+  ierr = PetscMemcmp(batch->rows,rows,nb*bs*sizeof(PetscInt),found);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Allocates the offsets of a new batch, to be filled by the caller */
+PetscErrorCode MatAIJBatchSetUp(Mat_AIJ_Batch *batch,PetscInt nb,PetscInt bs,const PetscInt rows[],Mat A,Mat B)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatAIJBatchReset(batch);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nb*bs,&batch->rows,nb*bs*bs,&batch->offsets);CHKERRQ(ierr);
+  ierr = PetscMemcpy(batch->rows,rows,nb*bs*sizeof(PetscInt));CHKERRQ(ierr);
+  batch->nb              = nb;
+  batch->bs              = bs;
+  batch->id[0]           = ((PetscObject)A)->id;
+  batch->nonzerostate[0] = A->nonzerostate;
+  batch->id[1]           = B ? ((PetscObject)B)->id : 0;
+  batch->nonzerostate[1] = B ? B->nonzerostate : 0;
+  PetscFunctionReturn(0);
+}
+
+/* Sorts the bs indices of an element: idx[k] = rows[perm[k]] is nondecreasing */
+PetscErrorCode MatAIJBatchSortElement(PetscInt bs,const PetscInt rows[],PetscInt perm[],PetscInt idx[])
+{
+  PetscErrorCode ierr;
+  PetscInt       k;
+
+  PetscFunctionBegin;
+  for (k=0; k<bs; k++) perm[k] = k;
+  ierr = PetscSortIntWithPermutation(bs,rows,perm);CHKERRQ(ierr);
+  for (k=0; k<bs; k++) idx[k] = rows[perm[k]];
+  PetscFunctionReturn(0);
+}
+
+/*
+   Finds the positions of the sorted columns cols[] in the row of the assembled SeqAIJ matrix A and stores them, or
+   -2-position for the off-diagonal block, in offsets[perm[k]]; the negative columns are left alone. Repeated columns get
+   the same position. found is set to PETSC_FALSE if a column is not in the nonzero pattern.
+*/
+PetscErrorCode MatSeqAIJBatchRowOffsets(Mat A,PetscInt row,PetscInt n,const PetscInt cols[],const PetscInt perm[],PetscBool offdiag,PetscInt offsets[],PetscBool *found)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt *aj;
+  PetscInt       k,p = 0,nrow;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_DEBUG)
+  if (row >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",row,A->rmap->n-1);
+#endif
+  aj   = a->j + a->i[row];
+  nrow = a->ilen[row];
+  for (k=0; k<n; k++) {
+    if (cols[k] < 0) continue;
+    while (p < nrow && aj[p] < cols[k]) p++;
+    if (p == nrow || aj[p] != cols[k]) {
+      *found = PETSC_FALSE;
+      PetscFunctionReturn(0);
+    }
+    offsets[perm[k]] = offdiag ? -2-(a->i[row]+p) : a->i[row]+p;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Adds the element matrices one by one with MatSetValues(), with their indices sorted so that MatSetValues_SeqAIJ()
+   searches each row only once. Used before the first assembly and when the pattern changes.
+*/
+PetscErrorCode MatSetValuesBatch_AIJ_Sorted(Mat mat,PetscInt nb,PetscInt bs,const PetscInt rows[],const PetscScalar v[])
+{
+  PetscErrorCode    ierr;
+  PetscInt          b,r,c,*perm,*idx;
+  PetscScalar       *w;
+  const PetscScalar *ve;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc3(bs,&perm,bs,&idx,bs*bs,&w);CHKERRQ(ierr);
+  for (b=0; b<nb; b++) {
+    ierr = MatAIJBatchSortElement(bs,rows+b*bs,perm,idx);CHKERRQ(ierr);
+    ve   = v + b*bs*bs;
+    for (r=0; r<bs; r++) {
+      for (c=0; c<bs; c++) w[r*bs+c] = ve[perm[r]*bs+perm[c]];
+    }
+    ierr = MatSetValues(mat,bs,idx,bs,idx,w,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = PetscFree3(perm,idx,w);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetValuesBatch_SeqAIJ(Mat A,PetscInt nb,PetscInt bs,PetscInt *rows,const PetscScalar *v)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  Mat_AIJ_Batch  *batch = &a->batch;
+  PetscInt       b,r,k,n = nb*bs*bs,*perm,*idx,*offsets;
+  PetscBool      found;
+  MatScalar      *aa;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* before the first assembly the nonzero pattern is not known yet */
+  if (!A->was_assembled || !a->roworiented || A->structure_only) {
+    ierr = MatSetValuesBatch_AIJ_Sorted(A,nb,bs,rows,v);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatAIJBatchFind(batch,nb,bs,rows,A,NULL,&found);CHKERRQ(ierr);
+  if (!found) {
+    ierr  = MatAIJBatchSetUp(batch,nb,bs,rows,A,NULL);CHKERRQ(ierr);
+    ierr  = PetscMalloc2(bs,&perm,bs,&idx);CHKERRQ(ierr);
+    found = PETSC_TRUE;
+    for (b=0; b<nb && found; b++) {
+      ierr = MatAIJBatchSortElement(bs,rows+b*bs,perm,idx);CHKERRQ(ierr);
+      for (r=0; r<bs && found; r++) {
+        offsets = batch->offsets + (b*bs+r)*bs;
+        for (k=0; k<bs; k++) offsets[k] = -1;
+        if (rows[b*bs+r] < 0) continue;
+        ierr = MatSeqAIJBatchRowOffsets(A,rows[b*bs+r],bs,idx,perm,PETSC_FALSE,offsets,&found);CHKERRQ(ierr);
+      }
+    }
+    ierr = PetscFree2(perm,idx);CHKERRQ(ierr);
+    if (!found) {
+      ierr = PetscInfo(A,"The batch adds new nonzeros, inserting it with MatSetValues()\n");CHKERRQ(ierr);
+      ierr = MatAIJBatchReset(batch);CHKERRQ(ierr);
+      ierr = MatSetValuesBatch_AIJ_Sorted(A,nb,bs,rows,v);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    ierr = PetscInfo2(A,"Found the positions of the values of %D element matrices of size %D\n",nb,bs);CHKERRQ(ierr);
+  }
+  aa      = a->a;
+  offsets = batch->offsets;
+  for (k=0; k<n; k++) {
+    if (offsets[k] >= 0) aa[offsets[k]] += v[k];
+  }
+  PetscFunctionReturn(0);
+}
@@ -592,6 +592,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *info)
   } else {
     C->ops->solve = MatSolve_SeqAIJ;
   }
+  ierr = MatSolveSetUp_SeqAIJ(C,info);CHKERRQ(ierr);
   C->ops->solveadd          = MatSolveAdd_SeqAIJ;
   C->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
   C->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
@@ -3196,6 +3197,105 @@ PetscErrorCode MatSolve_SeqAIJ(Mat A,Vec bb,Vec xx)
   PetscFunctionReturn(0);
 }
 
+/*
+   Approximate forward and backward solves with the factors of an LU factorization: each triangular solve is replaced
+   by a fixed number of Jacobi sweeps, y <- b - (L-I) y and x <- D^{-1} (y - (U-D) x), every row of a sweep only reads
+   the previous iterate so with -mat_aij_threads the rows are split among the OpenMP threads
+*/
+static PetscErrorCode MatSolve_SeqAIJ_Jacobi(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt    *ai = a->i,*aj = a->j,*adiag = a->diag,*r,*c;
+  const MatScalar   *aa = a->a;
+  PetscScalar       *x,*rhs,*work = a->jacobiwork;
+  const PetscScalar *b;
+  PetscInt          n = A->rmap->n,nt = PetscMax(a->threads.nthreads,1),sweeps = a->jacobisweeps;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+  rhs = work;
+#pragma omp parallel num_threads(nt)
+  {
+    PetscScalar     *cur = work + n,*nxt = work + 2*n,*swp,sum;
+    const PetscInt  *vi;
+    const MatScalar *v;
+    PetscInt        i,k,nz;
+
+    /* unit lower triangular: start from y = b */
+#pragma omp for schedule(static)
+    for (i=0; i<n; i++) rhs[i] = cur[i] = b[r[i]];
+    for (k=0; k<sweeps; k++) {
+#pragma omp for schedule(static)
+      for (i=0; i<n; i++) {
+        v   = aa + ai[i];
+        vi  = aj + ai[i];
+        nz  = ai[i+1] - ai[i];
+        sum = rhs[i];
+        PetscSparseDenseMinusDot(sum,cur,v,vi,nz);
+        nxt[i] = sum;
+      }
+      swp = cur; cur = nxt; nxt = swp;
+    }
+    /* upper triangular, whose inverted diagonal follows each row: start from x = D^{-1} y */
+#pragma omp for schedule(static)
+    for (i=0; i<n; i++) {
+      rhs[i] = cur[i];
+      nxt[i] = cur[i]*aa[adiag[i]];
+    }
+    swp = cur; cur = nxt; nxt = swp;
+    for (k=0; k<sweeps; k++) {
+#pragma omp for schedule(static)
+      for (i=0; i<n; i++) {
+        v   = aa + adiag[i+1] + 1;
+        vi  = aj + adiag[i+1] + 1;
+        nz  = adiag[i] - adiag[i+1] - 1;
+        sum = rhs[i];
+        PetscSparseDenseMinusDot(sum,cur,v,vi,nz);
+        nxt[i] = sum*v[nz];
+      }
+      swp = cur; cur = nxt; nxt = swp;
+    }
+#pragma omp for schedule(static)
+    for (i=0; i<n; i++) x[c[i]] = cur[i];
+  }
+  ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(sweeps*(2.0*a->nz - n) + n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Called at the end of the numeric LU and ILU factorizations: with -pc_factor_solve_iterative the Jacobi sweeps replace
+   the triangular solves, otherwise MatSolveSetUp_SeqAIJ_Threads() may install the threaded MatSolve()
+*/
+PetscErrorCode MatSolveSetUp_SeqAIJ(Mat fact,const MatFactorInfo *info)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)fact->data;
+  PetscInt       n = fact->rmap->n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  a->jacobisweeps = info ? (PetscInt)info->solveiterative : 0;
+  if (!a->jacobisweeps) {
+    ierr = MatSolveSetUp_SeqAIJ_Threads(fact);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (!a->jacobiwork) {
+    ierr = PetscMalloc1(3*n,&a->jacobiwork);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)fact,3*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  ierr = PetscInfo2(fact,"MatSolve() approximated by %D Jacobi sweeps on each factor with %D threads\n",a->jacobisweeps,PetscMax(a->threads.nthreads,1));CHKERRQ(ierr);
+  fact->ops->solve = MatSolve_SeqAIJ_Jacobi;
+  PetscFunctionReturn(0);
+}
+
 /*
     This will get a new name and become a varient of MatILUFactor_SeqAIJ() there is no longer separate functions in the matrix function table for dt factors
 */
@@ -0,0 +1,232 @@
+/*
+  This file provides an assembly mode of the SeqAIJ format that needs no preallocation. Between the preallocation and
+  the first MatAssemblyEnd() with MAT_FINAL_ASSEMBLY the entries set with MatSetValues() go into a hash table keyed
+  by their (row,column); MatAssemblyEnd() then counts the exact length of each row, allocates the CSR arrays once and
+  copies the entries into them, so that no row is ever shifted or reallocated. Later assemblies use the CSR arrays.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>  /*I "petscmat.h" I*/
+
+static PetscErrorCode MatSetValues_SeqAIJ_Hash(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode is)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscHMapIJV   ht = a->hash.ht;
+  PetscHashIJKey key;
+  PetscHashIter  it;
+  PetscInt       k,l,nonew = a->nonew;
+  PetscScalar    value = 0.0,old;
+  PetscBool      missing,ignorezeroentries = a->ignorezeroentries,roworiented = a->roworiented;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<m; k++) { /* loop over added rows */
+    key.i = im[k];
+    if (key.i < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+    if (key.i >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",key.i,A->rmap->n-1);
+#endif
+    for (l=0; l<n; l++) { /* loop over added columns */
+      key.j = in[l];
+      if (key.j < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+      if (key.j >= A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",key.j,A->cmap->n-1);
+#endif
+      if (!A->structure_only) value = roworiented ? v[l + k*n] : v[k + l*m];
+      if (value == 0.0 && ignorezeroentries && is == ADD_VALUES && key.i != key.j && !A->structure_only) continue;
+      ierr = PetscHMapIJVPut(ht,key,&it,&missing);CHKERRQ(ierr);
+      if (missing) {
+        if (nonew == 1 || (value == 0.0 && ignorezeroentries && key.i != key.j && !A->structure_only)) {
+          ierr = PetscHMapIJVIterDel(ht,it);CHKERRQ(ierr);
+          continue;
+        }
+        if (nonew == -1) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Inserting a new nonzero at (%D,%D) in the matrix",key.i,key.j);
+        PetscHashIterSetVal(ht,it,value);
+      } else if (is == ADD_VALUES) {
+        PetscHashIterGetVal(ht,it,old);
+        PetscHashIterSetVal(ht,it,old+value);
+      } else {
+        PetscHashIterSetVal(ht,it,value);
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Called at the end of the preallocation: with the hash assembly the entries go into an empty hash table until the
+   next final assembly
+*/
+PetscErrorCode MatSetUp_SeqAIJ_Hash(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!a->hash.use) PetscFunctionReturn(0);
+  if (a->hash.ht) {
+    ierr = PetscHMapIJVClear(a->hash.ht);CHKERRQ(ierr);
+  } else {
+    ierr = PetscHMapIJVCreate(&a->hash.ht);CHKERRQ(ierr);
+  }
+  A->ops->setvalues = MatSetValues_SeqAIJ_Hash;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Moves the entries of the hash table into CSR arrays of the exact size, the rows sorted; this must be called before
+   MatAssemblyEnd_SeqAIJ() compresses the rows
+*/
+PetscErrorCode MatAssemblyEnd_SeqAIJ_Hash(Mat A,MatAssemblyType mode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscHMapIJV   ht = a->hash.ht;
+  PetscHashIter  it;
+  PetscHashIJKey key;
+  PetscScalar    value;
+  PetscInt       i,p,nz,rmax = 0,m = A->rmap->n,*rnz,nonew = a->nonew;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ht || mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  ierr = PetscHMapIJVGetSize(ht,&nz);CHKERRQ(ierr);
+  ierr = PetscCalloc1(m,&rnz);CHKERRQ(ierr);
+  PetscHashIterBegin(ht,it);
+  while (!PetscHashIterAtEnd(ht,it)) {
+    PetscHashIterGetKey(ht,it,key);
+    rnz[key.i]++;
+    PetscHashIterNext(ht,it);
+  }
+
+  /* exact preallocation, which must neither restart the hash assembly nor change the options of the matrix */
+  a->hash.ht  = NULL;
+  a->hash.use = PETSC_FALSE;
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(A,0,rnz);CHKERRQ(ierr);
+  a->hash.use = PETSC_TRUE;
+  a->nonew    = nonew;
+
+  PetscHashIterBegin(ht,it);
+  while (!PetscHashIterAtEnd(ht,it)) {
+    PetscHashIterGetKey(ht,it,key);
+    p        = a->i[key.i] + a->ilen[key.i]++;
+    a->j[p]  = key.j;
+    if (!A->structure_only) {
+      PetscHashIterGetVal(ht,it,value);
+      a->a[p] = value;
+    }
+    PetscHashIterNext(ht,it);
+  }
+  for (i=0; i<m; i++) {
+    if (A->structure_only) {
+      ierr = PetscSortInt(rnz[i],a->j+a->i[i]);CHKERRQ(ierr);
+    } else {
+      ierr = PetscSortIntWithScalarArray(rnz[i],a->j+a->i[i],a->a+a->i[i]);CHKERRQ(ierr);
+    }
+    rmax = PetscMax(rmax,rnz[i]);
+  }
+  a->nz = nz;
+  A->nonzerostate++;
+  ierr = PetscFree(rnz);CHKERRQ(ierr);
+  ierr = PetscHMapIJVDestroy(&ht);CHKERRQ(ierr);
+  A->ops->setvalues = MatSetValues_SeqAIJ;
+  ierr = PetscInfo2(A,"Moved %D entries from the hash table, longest row %D\n",nz,rmax);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatZeroEntries_SeqAIJ_Hash(Mat A)
+{
+  Mat_SeqAIJ    *a = (Mat_SeqAIJ*)A->data;
+  PetscHMapIJV  ht = a->hash.ht;
+  PetscHashIter it;
+
+  PetscFunctionBegin;
+  if (!ht) PetscFunctionReturn(0);
+  PetscHashIterBegin(ht,it);
+  while (!PetscHashIterAtEnd(ht,it)) {
+    PetscHashIterSetVal(ht,it,0.0);
+    PetscHashIterNext(ht,it);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSeqAIJSetHashAssembly_SeqAIJ(Mat A,PetscBool flg)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       n = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (a->hash.ht) {ierr = PetscHMapIJVGetSize(a->hash.ht,&n);CHKERRQ(ierr);}
+  if (n && !flg) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot turn off the hash assembly before MatAssemblyEnd()");
+  a->hash.use = flg;
+  if (!flg) {
+    ierr = PetscHMapIJVDestroy(&a->hash.ht);CHKERRQ(ierr);
+    if (A->ops->setvalues == MatSetValues_SeqAIJ_Hash) A->ops->setvalues = MatSetValues_SeqAIJ;
+  } else if (A->preallocated && !A->assembled && !A->was_assembled && !a->nz) {
+    /* preallocated but still empty: start now */
+    ierr = MatSetUp_SeqAIJ_Hash(A);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatSeqAIJSetHashAssembly - Assembles the matrix into a hash table up to the first final MatAssemblyEnd(), so that
+   no preallocation is needed
+
+   Logically Collective on Mat
+
+   Input Parameters:
++  A - the SeqAIJ matrix
+-  flg - PETSC_TRUE to use the hash table
+
+   Options Database Key:
+.  -mat_aij_hash_assembly - use the hash table, processed by MatSetFromOptions()
+
+   Notes:
+   Call it before setting any value, after MatSetFromOptions() and before or after the preallocation. The entries are
+   kept in a hash table keyed by their row and column, MatAssemblyEnd() with MAT_FINAL_ASSEMBLY then allocates the
+   exact storage and copies them in sorted order. Without an accurate preallocation this avoids the repeated
+   reallocations and shifts of the rows in MatSetValues(), making the first assembly about as fast as with a perfect
+   preallocation, at the price of the memory of the hash table, about twice the memory of the matrix, during the
+   assembly. The preallocation is ignored, but MAT_NEW_NONZERO_LOCATIONS and MAT_IGNORE_ZERO_ENTRIES are respected.
+
+   Later assemblies, with the nonzero pattern found by the first one, go directly into the CSR storage; calling
+   MatSeqAIJSetPreallocation() again restarts the hash assembly.
+
+   This is only for MATSEQAIJ and the types derived from it, the MATMPIAIJ diagonal and off-diagonal blocks are
+   assembled directly.
+
+   Level: intermediate
+
+.keywords: matrix, aij, assembly, hash, preallocation
+.seealso: MatSeqAIJSetPreallocation(), MatSetValues(), MatAssemblyEnd(), MATPREALLOCATOR
+@*/
+PetscErrorCode MatSeqAIJSetHashAssembly(Mat A,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveBool(A,flg,2);
+  ierr = PetscTryMethod(A,"MatSeqAIJSetHashAssembly_C",(Mat,PetscBool),(A,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJ_Hash(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscHMapIJVDestroy(&a->hash.ht);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* MatCreate_SeqAIJ_Hash is a helper for the MATSEQAIJ class, like MatCreate_SeqAIJ_Inode() it is not a type */
+PetscErrorCode MatCreate_SeqAIJ_Hash(Mat B)
+{
+  Mat_SeqAIJ *b = (Mat_SeqAIJ*)B->data;
+
+  PetscFunctionBegin;
+  b->hash.use = PETSC_FALSE;
+  b->hash.ht  = NULL;
+  PetscFunctionReturn(0);
+}
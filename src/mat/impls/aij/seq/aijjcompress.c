@@ -0,0 +1,274 @@
+/*
+  This file provides MatMult() and MatMultAdd() for the SeqAIJ format that read compressed column indices.
+  The rows are grouped in blocks of MAT_AIJ_JCOMPRESS_BS consecutive rows; each block stores its smallest
+  column and the column indices of its nonzeros as 8 or 16 bit offsets from it, or keeps using a->j when
+  the columns of the block span too wide a range. The compressed indices are rebuilt in MatAssemblyEnd()
+  only when the nonzero structure changed.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+
+#define MAT_AIJ_JCOMPRESS_BS 32
+
+/*
+   Computes z[i] for the rows rs to re of a block, whose column indices cols of type T index into xb; each sum starts
+   with init, which may use i
+*/
+#define MatSeqAIJJCompressRows(T,cols,xb,init) do {                      \
+    PetscInt _k,_n;                                                         \
+    for (i=rs; i<re; i++) {                                                 \
+      const T         *_cj = (const T*)(cols) + ii[i] - ii[rs];             \
+      const MatScalar *_aa = a->a + ii[i];                                  \
+      PetscScalar     _sum = init;                                          \
+      _n = ii[i+1] - ii[i];                                                 \
+      for (_k=0; _k<_n; _k++) _sum += _aa[_k]*(xb)[_cj[_k]];                \
+      z[i] = _sum;                                                          \
+    }                                                                       \
+  } while (0)
+
+/*
+   The bytes used by the column indices of the products divided by those of a->j
+*/
+static PetscErrorCode MatSeqAIJJCompressGetRatio_Private(Mat A,PetscReal *ratio)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ*)A->data;
+  PetscInt   b,rs,re,nfull = 0,m = A->rmap->n;
+
+  PetscFunctionBegin;
+  for (b=0; b<a->jcompress.nblocks; b++) {
+    if (a->jcompress.width[b]) continue;
+    rs     = b*MAT_AIJ_JCOMPRESS_BS;
+    re     = PetscMin(rs + MAT_AIJ_JCOMPRESS_BS,m);
+    nfull += a->i[re] - a->i[rs];
+  }
+  *ratio = a->nz ? (PetscReal)(a->jcompress.offset[a->jcompress.nblocks] + nfull*sizeof(PetscInt))/(PetscReal)(a->nz*sizeof(PetscInt)) : 1.0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Chooses the width of each block, the smallest one holding all its column offsets, and fills the offsets
+*/
+static PetscErrorCode MatSeqAIJJCompressBuild_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+  PetscInt       b,k,rs,re,cmin,cmax,nb,m = A->rmap->n,*ai = a->i,*aj = a->j;
+  size_t         nbytes = 0,w;
+  PetscReal      ratio;
+
+  PetscFunctionBegin;
+  nb = (m + MAT_AIJ_JCOMPRESS_BS - 1)/MAT_AIJ_JCOMPRESS_BS;
+  if (nb != a->jcompress.nblocks || !a->jcompress.offset) {
+    ierr = PetscFree3(a->jcompress.base,a->jcompress.offset,a->jcompress.width);CHKERRQ(ierr);
+    ierr = PetscMalloc3(nb,&a->jcompress.base,nb+1,&a->jcompress.offset,nb,&a->jcompress.width);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,nb*(sizeof(PetscInt)+sizeof(size_t)+sizeof(unsigned char)));CHKERRQ(ierr);
+    a->jcompress.nblocks = nb;
+  }
+  a->jcompress.nblock[0] = a->jcompress.nblock[1] = a->jcompress.nblock[2] = 0;
+  for (b=0; b<nb; b++) {
+    rs   = b*MAT_AIJ_JCOMPRESS_BS;
+    re   = PetscMin(rs + MAT_AIJ_JCOMPRESS_BS,m);
+    cmin = PETSC_MAX_INT;
+    cmax = -1;
+    /* the columns are not necessarily sorted, for example in the products of MatPtAP() */
+    for (k=ai[rs]; k<ai[re]; k++) {
+      cmin = PetscMin(cmin,aj[k]);
+      cmax = PetscMax(cmax,aj[k]);
+    }
+    if (cmax < 0) cmin = cmax = 0;
+    if (cmax - cmin < 256) {w = 1; a->jcompress.nblock[0]++;}
+    else if (cmax - cmin < 65536) {w = 2; a->jcompress.nblock[1]++;}
+    else {w = 0; a->jcompress.nblock[2]++;}
+    nbytes                   = (nbytes + 1) & ~(size_t)1; /* keeps the 16 bit offsets aligned */
+    a->jcompress.base[b]     = cmin;
+    a->jcompress.width[b]    = (unsigned char)w;
+    a->jcompress.offset[b]   = nbytes;
+    nbytes                  += w*(ai[re] - ai[rs]);
+  }
+  a->jcompress.offset[nb] = nbytes;
+  if (nbytes > a->jcompress.nbytes || !a->jcompress.idx) {
+    ierr = PetscFree(a->jcompress.idx);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nbytes+1,&a->jcompress.idx);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,nbytes-a->jcompress.nbytes);CHKERRQ(ierr);
+    a->jcompress.nbytes = nbytes;
+  }
+  for (b=0; b<nb; b++) {
+    rs   = b*MAT_AIJ_JCOMPRESS_BS;
+    re   = PetscMin(rs + MAT_AIJ_JCOMPRESS_BS,m);
+    cmin = a->jcompress.base[b];
+    if (a->jcompress.width[b] == 1) {
+      unsigned char *cj = a->jcompress.idx + a->jcompress.offset[b];
+      for (k=ai[rs]; k<ai[re]; k++) cj[k-ai[rs]] = (unsigned char)(aj[k] - cmin);
+    } else if (a->jcompress.width[b] == 2) {
+      unsigned short *cj = (unsigned short*)(a->jcompress.idx + a->jcompress.offset[b]);
+      for (k=ai[rs]; k<ai[re]; k++) cj[k-ai[rs]] = (unsigned short)(aj[k] - cmin);
+    }
+  }
+  a->jcompress.mat_nonzerostate = A->nonzerostate;
+  ierr = MatSeqAIJJCompressGetRatio_Private(A,&ratio);CHKERRQ(ierr);
+  ierr = PetscInfo5(A,"Compressed the column indices of %D row blocks: %D with 8 bit, %D with 16 bit and %D with full width offsets, index bytes %g of uncompressed\n",nb,a->jcompress.nblock[0],a->jcompress.nblock[1],a->jcompress.nblock[2],(double)ratio);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJ_JCompress(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ          *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar         *z;
+  const PetscScalar   *x;
+  const PetscInt      *ii = a->i;
+  const unsigned char *idx;
+  PetscInt            b,i,rs,re,m = A->rmap->n;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  if (!a->jcompress.idx || a->jcompress.mat_nonzerostate != A->nonzerostate) {
+    ierr = MatSeqAIJJCompressBuild_Private(A);CHKERRQ(ierr);
+  }
+  idx  = a->jcompress.idx;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&z);CHKERRQ(ierr);
+  for (b=0; b<a->jcompress.nblocks; b++) {
+    rs = b*MAT_AIJ_JCOMPRESS_BS;
+    re = PetscMin(rs + MAT_AIJ_JCOMPRESS_BS,m);
+    switch (a->jcompress.width[b]) {
+    case 1:  MatSeqAIJJCompressRows(unsigned char,idx + a->jcompress.offset[b],x + a->jcompress.base[b],0.0); break;
+    case 2:  MatSeqAIJJCompressRows(unsigned short,idx + a->jcompress.offset[b],x + a->jcompress.base[b],0.0); break;
+    default: MatSeqAIJJCompressRows(PetscInt,a->j + ii[rs],x,0.0);
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJ_JCompress(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ          *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar         *y,*z;
+  const PetscScalar   *x;
+  const PetscInt      *ii = a->i;
+  const unsigned char *idx;
+  PetscInt            b,i,rs,re,m = A->rmap->n;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  if (!a->jcompress.idx || a->jcompress.mat_nonzerostate != A->nonzerostate) {
+    ierr = MatSeqAIJJCompressBuild_Private(A);CHKERRQ(ierr);
+  }
+  idx  = a->jcompress.idx;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  for (b=0; b<a->jcompress.nblocks; b++) {
+    rs = b*MAT_AIJ_JCOMPRESS_BS;
+    re = PetscMin(rs + MAT_AIJ_JCOMPRESS_BS,m);
+    switch (a->jcompress.width[b]) {
+    case 1:  MatSeqAIJJCompressRows(unsigned char,idx + a->jcompress.offset[b],x + a->jcompress.base[b],y[i]); break;
+    case 2:  MatSeqAIJJCompressRows(unsigned short,idx + a->jcompress.offset[b],x + a->jcompress.base[b],y[i]); break;
+    default: MatSeqAIJJCompressRows(PetscInt,a->j + ii[rs],x,y[i]);
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatView_SeqAIJ_JCompress(Mat A,PetscViewer viewer)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode    ierr;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+  PetscReal         ratio;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii && a->jcompress.idx) {
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO_DETAIL || format == PETSC_VIEWER_ASCII_INFO) {
+      ierr = MatSeqAIJJCompressGetRatio_Private(A,&ratio);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPrintf(viewer,"using compressed column indices: %D row blocks of %d rows, %D with 8 bit, %D with 16 bit and %D with full width indices, index bytes %g of uncompressed\n",a->jcompress.nblocks,MAT_AIJ_JCOMPRESS_BS,a->jcompress.nblock[0],a->jcompress.nblock[1],a->jcompress.nblock[2],(double)ratio);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Rebuilds the compressed indices whenever the nonzero structure changed and installs the kernels; this must be called
+   after MatAssemblyEnd_SeqAIJ_Inode() since it takes precedence over the Inode MatMult(). The threaded kernels of
+   -mat_aij_threads have no compressed version and take precedence over it. The types derived from SeqAIJ keep their
+   own kernels.
+*/
+PetscErrorCode MatAssemblyEnd_SeqAIJ_JCompress(Mat A,MatAssemblyType mode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscBool      seqaij;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!a->jcompress.use || A->factortype || A->structure_only) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJ,&seqaij);CHKERRQ(ierr);
+  if (!seqaij) PetscFunctionReturn(0);
+  if (a->threads.nthreads > 1) {
+    ierr = PetscInfo(A,"Not compressing the column indices, the threaded MatMult() routines of -mat_aij_threads use a->j\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (!a->jcompress.idx || a->jcompress.mat_nonzerostate != A->nonzerostate) {
+    ierr = MatSeqAIJJCompressBuild_Private(A);CHKERRQ(ierr);
+  }
+  A->ops->mult    = MatMult_SeqAIJ_JCompress;
+  A->ops->multadd = MatMultAdd_SeqAIJ_JCompress;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJ_JCompress(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(a->jcompress.base,a->jcompress.offset,a->jcompress.width);CHKERRQ(ierr);
+  ierr = PetscFree(a->jcompress.idx);CHKERRQ(ierr);
+  a->jcompress.nblocks = 0;
+  a->jcompress.nbytes  = 0;
+  PetscFunctionReturn(0);
+}
+
+/* MatCreate_SeqAIJ_JCompress is a helper for the MATSEQAIJ class, like MatCreate_SeqAIJ_Inode() it is not a type */
+PetscErrorCode MatCreate_SeqAIJ_JCompress(Mat B)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ*)B->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  b->jcompress.use     = PETSC_FALSE;
+  b->jcompress.nblocks = 0;
+  b->jcompress.base    = NULL;
+  b->jcompress.offset  = NULL;
+  b->jcompress.width   = NULL;
+  b->jcompress.idx     = NULL;
+  b->jcompress.nbytes  = 0;
+
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"Options for SEQAIJ matrix","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_aij_compress_indices","Use 8 and 16 bit column indices in MatMult() and MatMultAdd() where possible",NULL,b->jcompress.use,&b->jcompress.use,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJ_JCompress(Mat A,MatDuplicateOption cpvalues,Mat *C)
+{
+  Mat            B = *C;
+  Mat_SeqAIJ     *c = (Mat_SeqAIJ*)B->data,*a = (Mat_SeqAIJ*)A->data;
+  PetscBool      seqaij;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* the column indices of B may not be set yet (see MatILUFactorSymbolic_SeqAIJ_ilu0()) so they are compressed by its first product */
+  c->jcompress.use = a->jcompress.use;
+  ierr = PetscObjectTypeCompare((PetscObject)B,MATSEQAIJ,&seqaij);CHKERRQ(ierr);
+  if (a->jcompress.idx && seqaij) {
+    B->ops->mult    = MatMult_SeqAIJ_JCompress;
+    B->ops->multadd = MatMultAdd_SeqAIJ_JCompress;
+  }
+  PetscFunctionReturn(0);
+}
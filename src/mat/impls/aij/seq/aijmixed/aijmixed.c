@@ -0,0 +1,353 @@
+
+/*
+  Defines the MATSEQAIJMIXED matrix class. It is a MATSEQAIJ matrix that also keeps a single precision copy of
+  the nonzero values; MatMult(), MatMultAdd() and MatSOR() stream that copy instead of the double precision one,
+  while the vectors and all the sums stay in double precision. Every other operation uses the SeqAIJ data.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+#if defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+#define PETSC_AIJMIXED_KERNELS
+#endif
+
+typedef struct {
+  float            *af;                 /* single precision copy of the values of the SeqAIJ matrix */
+  PetscInt         maxnz;               /* allocated length of af */
+  PetscObjectState state;               /* state of the matrix when af was filled */
+} Mat_SeqAIJMixed;
+
+/*
+   Refills the single precision values if the matrix changed since they were made; the object state is increased by
+   MatAssemblyEnd(), MatScale(), MatDiagonalScale(), MatZeroRows() etc. so this catches every change of the values
+*/
+static PetscErrorCode MatSeqAIJMixedUpdate_Private(Mat A)
+{
+  Mat_SeqAIJ      *a     = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJMixed *mixed = (Mat_SeqAIJMixed*)A->spptr;
+  PetscInt        i,nz = a->i[A->rmap->n];
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  if (mixed->af && mixed->state == ((PetscObject)A)->state) PetscFunctionReturn(0);
+  if (nz > mixed->maxnz || !mixed->af) {
+    ierr = PetscFree(mixed->af);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz+1,&mixed->af);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,(nz-mixed->maxnz)*sizeof(float));CHKERRQ(ierr);
+    mixed->maxnz = nz;
+  }
+  for (i=0; i<nz; i++) mixed->af[i] = (float)PetscRealPart(a->a[i]);
+  mixed->state = ((PetscObject)A)->state;
+  ierr = PetscInfo1(A,"Made the single precision copy of %D nonzeros\n",nz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_AIJMIXED_KERNELS)
+static PetscErrorCode MatMult_SeqAIJMixed(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJMixed   *mixed;
+  const PetscScalar *x;
+  PetscScalar       *y,sum;
+  const PetscInt    *ii = a->i,*aj;
+  const float       *aa;
+  PetscInt          i,j,n,m = A->rmap->n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr  = MatSeqAIJMixedUpdate_Private(A);CHKERRQ(ierr);
+  mixed = (Mat_SeqAIJMixed*)A->spptr;
+  ierr  = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr  = VecGetArray(yy,&y);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    n   = ii[i+1] - ii[i];
+    aj  = a->j + ii[i];
+    aa  = mixed->af + ii[i];
+    sum = 0.0;
+    for (j=0; j<n; j++) sum += aa[j]*x[aj[j]];
+    y[i] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultAdd_SeqAIJMixed(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJMixed   *mixed;
+  const PetscScalar *x;
+  PetscScalar       *y,*z,sum;
+  const PetscInt    *ii = a->i,*aj;
+  const float       *aa;
+  PetscInt          i,j,n,m = A->rmap->n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr  = MatSeqAIJMixedUpdate_Private(A);CHKERRQ(ierr);
+  mixed = (Mat_SeqAIJMixed*)A->spptr;
+  ierr  = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr  = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    n   = ii[i+1] - ii[i];
+    aj  = a->j + ii[i];
+    aa  = mixed->af + ii[i];
+    sum = y[i];
+    for (j=0; j<n; j++) sum += aa[j]*x[aj[j]];
+    z[i] = sum;
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The local sweeps of MatSOR_SeqAIJ() with the off-diagonal entries read in single precision; the diagonal and its
+   inverse are the double precision ones of MatInvertDiagonal_SeqAIJ(). SOR_APPLY_UPPER and the Eisenstat trick are
+   passed on to MatSOR_SeqAIJ().
+*/
+static PetscErrorCode MatSOR_SeqAIJMixed(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJMixed   *mixed;
+  PetscScalar       *x,sum,*t;
+  const PetscScalar *b,*xb,*idiag,*mdiag;
+  const float       *v;
+  const PetscInt    *idx,*diag;
+  PetscInt          i,j,n,m = A->rmap->n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (flag == SOR_APPLY_UPPER || flag == SOR_APPLY_LOWER || (flag & SOR_EISENSTAT)) {
+    ierr = MatSOR_SeqAIJ(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  its = its*lits;
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJ(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+  ierr      = MatSeqAIJMixedUpdate_Private(A);CHKERRQ(ierr);
+  mixed     = (Mat_SeqAIJMixed*)A->spptr;
+
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+  mdiag = a->mdiag;
+
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        n   = diag[i] - a->i[i];
+        idx = a->j + a->i[i];
+        v   = mixed->af + a->i[i];
+        sum = b[i];
+        for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+        t[i] = sum;
+        x[i] = sum*idiag[i];
+      }
+      xb   = t;
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        n   = a->i[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = mixed->af + diag[i] + 1;
+        sum = xb[i];
+        for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+        if (xb == b) x[i] = sum*idiag[i];
+        else x[i] = (1-omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+      }
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        /* lower */
+        n   = diag[i] - a->i[i];
+        idx = a->j + a->i[i];
+        v   = mixed->af + a->i[i];
+        sum = b[i];
+        for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+        t[i] = sum;             /* save application of the lower-triangular part */
+        /* upper */
+        n   = a->i[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = mixed->af + diag[i] + 1;
+        for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+        x[i] = (1. - omega)*x[i] + sum*idiag[i]; /* omega in idiag */
+      }
+      xb   = t;
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        sum = xb[i];
+        if (xb == b) {
+          /* whole matrix (no checkpointing available) */
+          n   = a->i[i+1] - a->i[i];
+          idx = a->j + a->i[i];
+          v   = mixed->af + a->i[i];
+          for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+          x[i] = (1. - omega)*x[i] + (sum + mdiag[i]*x[i])*idiag[i];
+        } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+          n   = a->i[i+1] - diag[i] - 1;
+          idx = a->j + diag[i] + 1;
+          v   = mixed->af + diag[i] + 1;
+          for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+          x[i] = (1. - omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+      } else {
+        ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
+/* the SeqAIJ assembly installs its own (Inode, threaded or SIMD) kernels, so ours are put back afterwards */
+static PetscErrorCode MatAssemblyEnd_SeqAIJMixed(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+#if defined(PETSC_AIJMIXED_KERNELS)
+  A->ops->mult    = MatMult_SeqAIJMixed;
+  A->ops->multadd = MatMultAdd_SeqAIJMixed;
+  A->ops->sor     = MatSOR_SeqAIJMixed;
+#endif
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_SeqAIJMixed(Mat A)
+{
+  Mat_SeqAIJMixed *mixed = (Mat_SeqAIJMixed*)A->spptr;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  if (mixed) {
+    /* If MatHeaderMerge() was used then this SeqAIJMixed matrix will not have a spptr. */
+    ierr = PetscFree(mixed->af);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaijmixed_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJMixed_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode  ierr;
+  Mat             B = *newmat;
+  Mat_SeqAIJMixed *mixed;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  mixed = (Mat_SeqAIJMixed*)B->spptr;
+
+  /* Reset the original function pointers; MatAssemblyEnd_SeqAIJ() puts back the kernels the matrix would have as MATSEQAIJ */
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy     = MatDestroy_SeqAIJ;
+  B->ops->mult        = MatMult_SeqAIJ;
+  B->ops->multadd     = MatMultAdd_SeqAIJ;
+  B->ops->sor         = MatSOR_SeqAIJ;
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijmixed_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscFree(mixed->af);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+  if (B->assembled) {ierr = MatAssemblyEnd_SeqAIJ(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);}
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJMixed converts a SeqAIJ matrix into a SeqAIJMixed matrix. This routine is called by
+ * MatCreate_SeqAIJMixed(), but can also be used to convert an assembled SeqAIJ matrix into a SeqAIJMixed one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMixed(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode  ierr;
+  Mat             B = *newmat;
+  Mat_SeqAIJMixed *mixed;
+  PetscBool       sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&mixed);CHKERRQ(ierr);
+  B->spptr = (void*)mixed;
+
+  /* Set function pointers for methods that we inherit from AIJ but override. MatDuplicate_SeqAIJ() creates a
+     matrix of the same type, so the duplicate makes its own single precision copy when it is first used. */
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJMixed;
+  B->ops->destroy     = MatDestroy_SeqAIJMixed;
+#if defined(PETSC_AIJMIXED_KERNELS)
+  if (B->assembled) {
+    B->ops->mult    = MatMult_SeqAIJMixed;
+    B->ops->multadd = MatMultAdd_SeqAIJMixed;
+    B->ops->sor     = MatSOR_SeqAIJMixed;
+  }
+#else
+  ierr = PetscInfo(B,"Single precision values are only used with real double precision scalars; using the SeqAIJ kernels\n");CHKERRQ(ierr);
+#endif
+  ierr    = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijmixed_seqaij_C",MatConvert_SeqAIJMixed_SeqAIJ);CHKERRQ(ierr);
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJMIXED);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATSEQAIJMIXED - MATSEQAIJMIXED = "seqaijmixed" - A sequential AIJ matrix whose MatMult(), MatMultAdd() and MatSOR()
+   read a single precision copy of the nonzero values.
+
+   These kernels are bound by memory bandwidth, so reading 4 instead of 8 bytes per value makes them run up to about
+   1.5 to 2 times faster. The vectors and all the accumulations are in double precision, so the result is the product
+   with a matrix whose values are rounded to single precision; this is usually acceptable for preconditioners and
+   smoothers (PCSOR, and the MatMult() inside KSPCHEBYSHEV smoothers of PCMG and PCGAMG). All other operations,
+   including MatGetDiagonal() for PCJACOBI, factorizations and MatMultTranspose(), use the double precision values.
+
+   The single precision copy is made by the first product after the values change, so it follows MatAssemblyEnd(),
+   MatScale(), MatDiagonalScale(), MatShift() and the like automatically. It is in addition to the double precision
+   values, so the matrix takes 50 percent more memory for its values.
+
+   Options Database Keys:
+.  -mat_type seqaijmixed - sets the matrix type to "seqaijmixed" during a call to MatSetFromOptions()
+
+   Notes:
+   The single precision kernels are only used with real, double precision PetscScalar; otherwise this type behaves
+   exactly as MATSEQAIJ.
+
+  Level: intermediate
+
+.seealso: MATAIJMIXED, MATMPIAIJMIXED, MATSEQAIJ
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMixed(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJMixed(A,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
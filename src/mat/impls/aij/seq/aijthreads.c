@@ -0,0 +1,756 @@
+/*
+  This file provides threaded (OpenMP) versions of the MatMult() family of routines for the SeqAIJ format.
+  The rows are split once per nonzero pattern into contiguous chunks holding roughly the same number of
+  nonzeros, and this partition is reused by every MatMult(), MatMultAdd() and MatMultTranspose() until
+  the nonzero structure of the matrix changes. The numeric phases of MatMatMult() and MatPtAP() split the
+  rows of the product C the same way, its pattern being fixed by the symbolic phase. MatSolve() with the
+  factors of an LU or ILU factorization sweeps the level sets of L and U computed by the numeric factorization.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#define MatSeqAIJThreadsWtime() omp_get_wtime()
+#else
+#define MatSeqAIJThreadsWtime() MPI_Wtime()
+#endif
+
+/*
+   Splits the m rows of the row pointer ai[] into nt contiguous chunks, each row is weighted by its number of nonzeros
+   plus one so that long runs of empty rows are also distributed
+*/
+static void MatSeqAIJThreadsSplitRows_Private(PetscInt m,const PetscInt ai[],PetscInt nt,PetscInt rstart[])
+{
+  PetscInt  t,row = 0;
+  PetscReal total = (PetscReal)(ai[m] + m),target;
+
+  rstart[0] = 0;
+  for (t=1; t<nt; t++) {
+    target = (total*t)/nt;
+    while (row < m && (PetscReal)(ai[row] + row) < target) row++;
+    rstart[t] = row;
+  }
+  rstart[nt] = m;
+}
+
+/*
+   Splits the rows of A among its threads, see MatSeqAIJThreadsSplitRows_Private()
+*/
+static PetscErrorCode MatSeqAIJThreadsComputePartition_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+  PetscInt       t,m = A->rmap->n,nt = a->threads.nthreads,*ai = a->i,*rstart;
+  PetscReal      total,maxw = 0.0;
+
+  PetscFunctionBegin;
+  if (!a->threads.rstart) {
+    ierr = PetscMalloc2(nt+1,&a->threads.rstart,nt,&a->threads.time);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,(nt+1)*sizeof(PetscInt)+nt*sizeof(PetscLogDouble));CHKERRQ(ierr);
+  }
+  rstart = a->threads.rstart;
+  total  = (PetscReal)(ai[m] + m);
+  MatSeqAIJThreadsSplitRows_Private(m,ai,nt,rstart);
+  for (t=0; t<nt; t++) {
+    a->threads.time[t] = 0.0;
+    maxw               = PetscMax(maxw,(PetscReal)(ai[rstart[t+1]] - ai[rstart[t]] + rstart[t+1] - rstart[t]));
+  }
+  a->threads.ncalls           = 0;
+  a->threads.mat_nonzerostate = A->nonzerostate;
+  ierr = PetscFree(a->threads.work);CHKERRQ(ierr);
+  ierr = PetscInfo3(A,"Split %D rows among %D threads, work imbalance (max/mean) %g\n",m,nt,(double)(total > 0.0 ? maxw*nt/total : 1.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJ_Threads(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *y;
+  const PetscScalar *x;
+  PetscErrorCode    ierr;
+  const PetscInt    *rstart = a->threads.rstart;
+  PetscInt          t,nt = a->threads.nthreads;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+  for (t=0; t<nt; t++) {
+    const PetscInt  *aj,*ii = a->i;
+    const MatScalar *aa;
+    PetscInt        i,n;
+    PetscScalar     sum;
+    PetscLogDouble  t0 = MatSeqAIJThreadsWtime();
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      n   = ii[i+1] - ii[i];
+      aj  = a->j + ii[i];
+      aa  = a->a + ii[i];
+      sum = 0.0;
+      PetscSparseDensePlusDot(sum,x,aa,aj,n);
+      y[i] = sum;
+    }
+    a->threads.time[t] += MatSeqAIJThreadsWtime() - t0;
+  }
+  a->threads.ncalls++;
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJ_Threads(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *y,*z;
+  const PetscScalar *x;
+  PetscErrorCode    ierr;
+  const PetscInt    *rstart = a->threads.rstart;
+  PetscInt          t,nt = a->threads.nthreads;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+  for (t=0; t<nt; t++) {
+    const PetscInt  *aj,*ii = a->i;
+    const MatScalar *aa;
+    PetscInt        i,n;
+    PetscScalar     sum;
+    PetscLogDouble  t0 = MatSeqAIJThreadsWtime();
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      n   = ii[i+1] - ii[i];
+      aj  = a->j + ii[i];
+      aa  = a->a + ii[i];
+      sum = y[i];
+      PetscSparseDensePlusDot(sum,x,aa,aj,n);
+      z[i] = sum;
+    }
+    a->threads.time[t] += MatSeqAIJThreadsWtime() - t0;
+  }
+  a->threads.ncalls++;
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Thread 0 accumulates directly into y, the other threads into private copies in a->threads.work
+   that are summed into y afterwards, splitting the columns evenly among the threads
+*/
+PetscErrorCode MatMultTransposeAdd_SeqAIJ_Threads(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *y,*work;
+  const PetscScalar *x;
+  PetscErrorCode    ierr;
+  const PetscInt    *rstart = a->threads.rstart;
+  PetscInt          t,j,nt = a->threads.nthreads,n = A->cmap->n;
+
+  PetscFunctionBegin;
+  if (!a->threads.work) {
+    ierr = PetscMalloc1((nt-1)*n,&a->threads.work);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,(nt-1)*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  work = a->threads.work;
+  if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+  for (t=0; t<nt; t++) {
+    const PetscInt  *idx,*ii = a->i;
+    const MatScalar *v;
+    PetscInt        i,j,nz;
+    PetscScalar     alpha,*yt = t ? work + (t-1)*n : y;
+    PetscLogDouble  t0 = MatSeqAIJThreadsWtime();
+
+    if (t) {for (j=0; j<n; j++) yt[j] = 0.0;}
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      idx   = a->j + ii[i];
+      v     = a->a + ii[i];
+      nz    = ii[i+1] - ii[i];
+      alpha = x[i];
+      for (j=0; j<nz; j++) yt[idx[j]] += alpha*v[j];
+    }
+    a->threads.time[t] += MatSeqAIJThreadsWtime() - t0;
+  }
+#pragma omp parallel for num_threads(nt) schedule(static)
+  for (j=0; j<n; j++) {
+    PetscInt k;
+    for (k=0; k<nt-1; k++) y[j] += work[k*n+j];
+  }
+  a->threads.ncalls++;
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJ_Threads(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecSet(yy,0.0);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd_SeqAIJ_Threads(A,xx,yy,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Makes sure the row partition of C matches its nonzero structure, C being the result of a symbolic product
+*/
+static PetscErrorCode MatSeqAIJThreadsSetUpProduct_Private(Mat C)
+{
+  Mat_SeqAIJ     *c = (Mat_SeqAIJ*)C->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!c->threads.rstart || c->threads.mat_nonzerostate != C->nonzerostate) {
+    ierr = MatSeqAIJThreadsComputePartition_Private(C);CHKERRQ(ierr);
+  }
+  if (!c->a) {
+    ierr      = PetscMalloc1(c->i[C->rmap->n]+1,&c->a);CHKERRQ(ierr);
+    c->free_a = PETSC_TRUE;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Row-parallel version of MatMatMultNumeric_SeqAIJ_SeqAIJ(), each thread computes its chunk of rows of C
+   with its own dense accumulator; every entry is summed in the same order as in the sequential routine
+*/
+PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Threads(Mat A,Mat B,Mat C)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c = (Mat_SeqAIJ*)C->data;
+  PetscInt       t,nt = c->threads.nthreads,bn = B->cmap->N;
+  const PetscInt *rstart;
+  PetscLogDouble flops = 0.0;
+
+  PetscFunctionBegin;
+  ierr   = MatSeqAIJThreadsSetUpProduct_Private(C);CHKERRQ(ierr);
+  rstart = c->threads.rstart;
+  if (!c->matmult_abdense) {
+    ierr = PetscCalloc1(nt*bn,&c->matmult_abdense);CHKERRQ(ierr);
+  }
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops)
+  for (t=0; t<nt; t++) {
+    const PetscInt    *ai = a->i,*aj,*bi = b->i,*bj = b->j,*bjj,*ci = c->i,*cj;
+    const PetscScalar *aa,*ba = b->a,*baj;
+    PetscScalar       *ab_dense = c->matmult_abdense + t*bn,*ca,valtmp;
+    PetscInt          i,j,k,anzi,bnzi,cnzi,brow;
+
+    for (k=ci[rstart[t]]; k<ci[rstart[t+1]]; k++) c->a[k] = 0.0;
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      anzi = ai[i+1] - ai[i];
+      aj   = a->j + ai[i];
+      aa   = a->a + ai[i];
+      for (j=0; j<anzi; j++) {
+        brow   = aj[j];
+        bnzi   = bi[brow+1] - bi[brow];
+        bjj    = bj + bi[brow];
+        baj    = ba + bi[brow];
+        valtmp = aa[j];
+        for (k=0; k<bnzi; k++) ab_dense[bjj[k]] += valtmp*baj[k];
+        flops += 2*bnzi;
+      }
+      cnzi = ci[i+1] - ci[i];
+      cj   = c->j + ci[i];
+      ca   = c->a + ci[i];
+      for (k=0; k<cnzi; k++) {
+        ca[k]          += ab_dense[cj[k]];
+        ab_dense[cj[k]] = 0.0;
+      }
+      flops += cnzi;
+    }
+  }
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Row-parallel version of MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(), the sparse axpys need no accumulator
+*/
+PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable_Threads(Mat A,Mat B,Mat C)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c = (Mat_SeqAIJ*)C->data;
+  PetscInt       t,nt = c->threads.nthreads;
+  const PetscInt *rstart;
+  PetscLogDouble flops = 0.0;
+
+  PetscFunctionBegin;
+  ierr   = MatSeqAIJThreadsSetUpProduct_Private(C);CHKERRQ(ierr);
+  rstart = c->threads.rstart;
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops)
+  for (t=0; t<nt; t++) {
+    const PetscInt    *ai = a->i,*aj,*bi = b->i,*bj = b->j,*bjj,*ci = c->i,*cj;
+    const PetscScalar *aa,*ba = b->a,*baj;
+    PetscScalar       *ca,valtmp;
+    PetscInt          i,j,k,anzi,bnzi,brow,nextb;
+
+    for (k=ci[rstart[t]]; k<ci[rstart[t+1]]; k++) c->a[k] = 0.0;
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      anzi = ai[i+1] - ai[i];
+      aj   = a->j + ai[i];
+      aa   = a->a + ai[i];
+      cj   = c->j + ci[i];
+      ca   = c->a + ci[i];
+      for (j=0; j<anzi; j++) {
+        brow   = aj[j];
+        bnzi   = bi[brow+1] - bi[brow];
+        bjj    = bj + bi[brow];
+        baj    = ba + bi[brow];
+        valtmp = aa[j];
+        nextb  = 0;
+        for (k=0; nextb<bnzi; k++) {
+          if (cj[k] == bjj[nextb]) ca[k] += valtmp*baj[nextb++];
+        }
+        flops += 2*bnzi;
+      }
+    }
+  }
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Threaded version of MatPtAPNumeric_SeqAIJ_SeqAIJ_SparseAxpy(), in two phases that each do their share of the work
+   exactly once:
+
+   1) the rows of A*P are formed and stored, the rows of A being split among the threads (a symbolic pass that counts
+      the nonzeros of each row, then a numeric pass that fills them);
+   2) the row crow of C is summed as P[i,crow]*(A*P)[i,:] over the rows i of column crow of P, the rows of C being
+      split among the threads as for MatMult().
+
+   The rows i are visited in increasing order in 2), so every entry of C receives its contributions in the same order
+   as in the sequential routine and the result does not depend on the number of threads.
+*/
+PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_SparseAxpy_Threads(Mat A,Mat P,Mat C)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data,*p = (Mat_SeqAIJ*)P->data,*c = (Mat_SeqAIJ*)C->data;
+  PetscInt       t,i,j,k,nt = c->threads.nthreads,am = A->rmap->N,cn = C->cmap->N,*pi = p->i,*pj = p->j;
+  const PetscInt *rstart;
+  PetscInt       *arstart,*api,*apj,*pti,*ptj,*ptk,*next,*dense;
+  MatScalar      *apa,*work;
+  PetscLogDouble flops = 0.0;
+
+  PetscFunctionBegin;
+  ierr   = MatSeqAIJThreadsSetUpProduct_Private(C);CHKERRQ(ierr);
+  rstart = c->threads.rstart;
+  ierr   = PetscMalloc3(nt+1,&arstart,am+1,&api,nt*cn,&dense);CHKERRQ(ierr);
+  ierr   = PetscMalloc1(nt*cn,&work);CHKERRQ(ierr);
+  for (k=0; k<nt*cn; k++) dense[k] = -1;
+  MatSeqAIJThreadsSplitRows_Private(am,a->i,nt,arstart);
+
+  /* 1a) number of nonzeros of each row of A*P, stored in api[i+1] */
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+  for (t=0; t<nt; t++) {
+    const PetscInt *ai = a->i,*aj;
+    PetscInt       *tdense = dense + t*cn,ii,jj,kk,prow,apnz;
+
+    for (ii=arstart[t]; ii<arstart[t+1]; ii++) {
+      aj   = a->j + ai[ii];
+      apnz = 0;
+      for (jj=0; jj<ai[ii+1]-ai[ii]; jj++) {
+        prow = aj[jj];
+        for (kk=pi[prow]; kk<pi[prow+1]; kk++) {
+          if (tdense[pj[kk]] != ii) {tdense[pj[kk]] = ii; apnz++;}
+        }
+      }
+      api[ii+1] = apnz;
+    }
+  }
+  api[0] = 0;
+  for (i=0; i<am; i++) api[i+1] += api[i];
+  ierr = PetscMalloc2(api[am],&apj,api[am],&apa);CHKERRQ(ierr);
+  for (k=0; k<nt*cn; k++) dense[k] = -1;
+
+  /* 1b) the rows of A*P, summed in the same order as in the sequential routine */
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops)
+  for (t=0; t<nt; t++) {
+    const PetscInt  *ai = a->i,*aj;
+    const MatScalar *aa;
+    PetscInt        *tdense = dense + t*cn,ii,jj,kk,prow,col,apnz;
+    MatScalar       *tapa;
+    PetscInt        *tapj;
+
+    for (ii=arstart[t]; ii<arstart[t+1]; ii++) {
+      aj   = a->j + ai[ii];
+      aa   = a->a + ai[ii];
+      tapj = apj + api[ii];
+      tapa = apa + api[ii];
+      apnz = 0;
+      for (jj=0; jj<ai[ii+1]-ai[ii]; jj++) {
+        prow = aj[jj];
+        for (kk=pi[prow]; kk<pi[prow+1]; kk++) {
+          col = pj[kk];
+          if (tdense[col] < api[ii]) {
+            tdense[col]  = api[ii] + apnz;
+            tapj[apnz]   = col;
+            tapa[apnz++] = 0.0;
+          }
+          apa[tdense[col]] += aa[jj]*p->a[kk];
+        }
+        flops += 2*(pi[prow+1] - pi[prow]);
+      }
+    }
+  }
+
+  /* the columns of P, by increasing row: ptj[] holds the rows and ptk[] the positions of the entries in p->a[] */
+  ierr = PetscCalloc1(cn+1,&pti);CHKERRQ(ierr);
+  ierr = PetscMalloc3(pi[am],&ptj,pi[am],&ptk,cn,&next);CHKERRQ(ierr);
+  for (k=0; k<pi[am]; k++) pti[pj[k]+1]++;
+  for (j=0; j<cn; j++) {pti[j+1] += pti[j]; next[j] = pti[j];}
+  for (i=0; i<am; i++) {
+    for (k=pi[i]; k<pi[i+1]; k++) {
+      ptj[next[pj[k]]]   = i;
+      ptk[next[pj[k]]++] = k;
+    }
+  }
+
+  /* 2) the rows of C, each summed in a dense accumulator that is left zeroed for the next row */
+  ierr = PetscMemzero(work,nt*cn*sizeof(MatScalar));CHKERRQ(ierr);
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops)
+  for (t=0; t<nt; t++) {
+    const PetscInt *ci = c->i,*cjj;
+    MatScalar      *twork = work + t*cn,*caj,pval;
+    PetscInt       crow,q,ii,kk,cnz;
+
+    for (crow=rstart[t]; crow<rstart[t+1]; crow++) {
+      for (q=pti[crow]; q<pti[crow+1]; q++) {
+        ii   = ptj[q];
+        pval = p->a[ptk[q]];
+        for (kk=api[ii]; kk<api[ii+1]; kk++) twork[apj[kk]] += pval*apa[kk];
+        flops += 2*(api[ii+1] - api[ii]);
+      }
+      cnz = ci[crow+1] - ci[crow];
+      cjj = c->j + ci[crow];
+      caj = c->a + ci[crow];
+      for (kk=0; kk<cnz; kk++) {
+        caj[kk]        = twork[cjj[kk]];
+        twork[cjj[kk]] = 0.0;
+      }
+    }
+  }
+  ierr = PetscFree(pti);CHKERRQ(ierr);
+  ierr = PetscFree3(ptj,ptk,next);CHKERRQ(ierr);
+  ierr = PetscFree2(apj,apa);CHKERRQ(ierr);
+  ierr = PetscFree3(arstart,api,dense);CHKERRQ(ierr);
+  ierr = PetscFree(work);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJThreadsLevelsReset_Private(Mat_SeqAIJ_Levels *lv)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(lv->start,lv->rows);CHKERRQ(ierr);
+  ierr = PetscFree3(lv->i,lv->j,lv->a);CHKERRQ(ierr);
+  lv->nlevels = 0;
+  lv->maxsize = 0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Computes the level sets of the L (upper = 0) or U (upper = 1) factor of an LU factorization stored in the SeqAIJ
+   format: a row of L is in the level following the deepest level of the rows it depends on, the same for U going up.
+   With -mat_aij_threads_reorder_solve the rows are also copied in level order, so that each thread streams through
+   consecutive memory; this is redone after each numeric factorization since it copies the values.
+*/
+static PetscErrorCode MatSeqAIJThreadsComputeLevels_Private(Mat A,PetscInt upper,PetscInt *level)
+{
+  Mat_SeqAIJ        *a  = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Levels *lv = &a->threads.levels[upper];
+  const PetscInt    *ai = a->i,*aj = a->j,*adiag = a->diag,*cols;
+  PetscInt          n = A->rmap->n,i,k,l,p,nz,*start,*rows;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJThreadsLevelsReset_Private(lv);CHKERRQ(ierr);
+  for (k=0; k<n; k++) {
+    i = upper ? n-1-k : k;
+    if (upper) {cols = aj + adiag[i+1] + 1; nz = adiag[i] - adiag[i+1] - 1;}
+    else       {cols = aj + ai[i];          nz = ai[i+1] - ai[i];}
+    for (l=0,p=0; p<nz; p++) l = PetscMax(l,level[cols[p]]+1);
+    level[i]    = l;
+    lv->nlevels = PetscMax(lv->nlevels,l+1);
+  }
+
+  /* Bucket the rows by level, in increasing order within a level */
+  ierr  = PetscMalloc2(lv->nlevels+1,&lv->start,n,&lv->rows);CHKERRQ(ierr);
+  start = lv->start;
+  rows  = lv->rows;
+  ierr  = PetscMemzero(start,(lv->nlevels+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  for (i=0; i<n; i++) start[level[i]+1]++;
+  for (l=0; l<lv->nlevels; l++) {
+    lv->maxsize = PetscMax(lv->maxsize,start[l+1]);
+    start[l+1] += start[l];
+  }
+  for (i=0; i<n; i++) rows[start[level[i]]++] = i;
+  for (l=lv->nlevels; l>0; l--) start[l] = start[l-1];
+  start[0] = 0;
+
+  if (a->threads.reordersolve) {
+    const MatScalar *v;
+
+    nz   = upper ? adiag[0] - adiag[n] : ai[n];
+    ierr = PetscMalloc3(n+1,&lv->i,nz,&lv->j,nz,&lv->a);CHKERRQ(ierr);
+    lv->i[0] = 0;
+    for (k=0; k<n; k++) {
+      i = rows[k];
+      if (upper) {cols = aj + adiag[i+1] + 1; v = a->a + adiag[i+1] + 1; nz = adiag[i] - adiag[i+1];} /* the diagonal comes last */
+      else       {cols = aj + ai[i];          v = a->a + ai[i];          nz = ai[i+1] - ai[i];}
+      ierr = PetscMemcpy(lv->j+lv->i[k],cols,nz*sizeof(PetscInt));CHKERRQ(ierr);
+      ierr = PetscMemcpy(lv->a+lv->i[k],v,nz*sizeof(MatScalar));CHKERRQ(ierr);
+      lv->i[k+1] = lv->i[k] + nz;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Forward and backward solves with the factors of an LU factorization, the rows of each level being split among the
+   threads; the threads synchronize between levels
+*/
+PetscErrorCode MatSolve_SeqAIJ_Threads(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ              *a = (Mat_SeqAIJ*)A->data;
+  const Mat_SeqAIJ_Levels *L = &a->threads.levels[0],*U = &a->threads.levels[1];
+  const PetscInt          *ai = a->i,*aj = a->j,*adiag = a->diag,*r = NULL,*c = NULL;
+  const MatScalar         *aa = a->a;
+  PetscScalar             *x,*tmp;
+  const PetscScalar       *b;
+  PetscInt                nt = a->threads.nthreads;
+  PetscErrorCode          ierr;
+
+  PetscFunctionBegin;
+  if (!A->rmap->n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  if (a->threads.solvenatural) tmp = x;
+  else {
+    tmp  = a->solve_work;
+    ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+    ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+  }
+#pragma omp parallel num_threads(nt)
+  {
+    const PetscInt  *vi;
+    const MatScalar *v;
+    PetscInt        l,k,i,nz;
+    PetscScalar     sum;
+
+    /* forward solve the unit lower triangular */
+    for (l=0; l<L->nlevels; l++) {
+#pragma omp for schedule(static)
+      for (k=L->start[l]; k<L->start[l+1]; k++) {
+        i = L->rows[k];
+        if (L->a) {v = L->a + L->i[k]; vi = L->j + L->i[k]; nz = L->i[k+1] - L->i[k];}
+        else      {v = aa + ai[i];      vi = aj + ai[i];      nz = ai[i+1] - ai[i];}
+        sum = r ? b[r[i]] : b[i];
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        tmp[i] = sum;
+      }
+    }
+    /* backward solve the upper triangular, whose inverted diagonal follows each row */
+    for (l=0; l<U->nlevels; l++) {
+#pragma omp for schedule(static)
+      for (k=U->start[l]; k<U->start[l+1]; k++) {
+        i = U->rows[k];
+        if (U->a) {v = U->a + U->i[k];      vi = U->j + U->i[k];      nz = U->i[k+1] - U->i[k] - 1;}
+        else      {v = aa + adiag[i+1] + 1; vi = aj + adiag[i+1] + 1; nz = adiag[i] - adiag[i+1] - 1;}
+        sum = tmp[i];
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        tmp[i] = sum*v[nz];
+        if (c) x[c[i]] = tmp[i];
+      }
+    }
+  }
+  if (!a->threads.solvenatural) {
+    ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+    ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Called by MatSolveSetUp_SeqAIJ() at the end of the numeric LU and ILU factorizations: with -mat_aij_threads the level
+   sets of the factors are computed and the threaded MatSolve() replaces the sequential ones, including the Inode one
+*/
+PetscErrorCode MatSolveSetUp_SeqAIJ_Threads(Mat fact)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)fact->data;
+  PetscInt       *level,n = fact->rmap->n;
+  PetscBool      row_identity,col_identity;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (a->threads.nthreads < 2) PetscFunctionReturn(0);
+  ierr = ISIdentity(a->row,&row_identity);CHKERRQ(ierr);
+  ierr = ISIdentity(a->col,&col_identity);CHKERRQ(ierr);
+  a->threads.solvenatural = (PetscBool)(row_identity && col_identity);
+  ierr = PetscMalloc1(n,&level);CHKERRQ(ierr);
+  ierr = MatSeqAIJThreadsComputeLevels_Private(fact,0,level);CHKERRQ(ierr);
+  ierr = MatSeqAIJThreadsComputeLevels_Private(fact,1,level);CHKERRQ(ierr);
+  ierr = PetscFree(level);CHKERRQ(ierr);
+  ierr = PetscInfo4(fact,"Threaded MatSolve(): L has %D levels of %g rows on average, U has %D levels of %g rows on average\n",a->threads.levels[0].nlevels,(double)(n/(PetscReal)PetscMax(a->threads.levels[0].nlevels,1)),a->threads.levels[1].nlevels,(double)(n/(PetscReal)PetscMax(a->threads.levels[1].nlevels,1)));CHKERRQ(ierr);
+  fact->ops->solve = MatSolve_SeqAIJ_Threads;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Computes the ratio between the slowest thread and the average thread time over all timed kernel calls
+*/
+static PetscErrorCode MatSeqAIJThreadsGetImbalance_Private(Mat A,PetscReal *imbalance)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       t;
+  PetscLogDouble tmax = 0.0,tsum = 0.0;
+
+  PetscFunctionBegin;
+  for (t=0; t<a->threads.nthreads; t++) {
+    tmax  = PetscMax(tmax,a->threads.time[t]);
+    tsum += a->threads.time[t];
+  }
+  *imbalance = tsum > 0.0 ? (PetscReal)(tmax*a->threads.nthreads/tsum) : 1.0;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatView_SeqAIJ_Threads(Mat A,PetscViewer viewer)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode    ierr;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+  PetscReal         imbalance;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (!iascii) PetscFunctionReturn(0);
+  ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+  if (format != PETSC_VIEWER_ASCII_INFO_DETAIL && format != PETSC_VIEWER_ASCII_INFO) PetscFunctionReturn(0);
+  if (a->threads.rstart) {
+    ierr = MatSeqAIJThreadsGetImbalance_Private(A,&imbalance);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"using threaded MatMult routines: %D threads, %D calls, time imbalance (max/mean) %g\n",a->threads.nthreads,a->threads.ncalls,(double)imbalance);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO_DETAIL) {
+      PetscInt t;
+      ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+      for (t=0; t<a->threads.nthreads; t++) {
+        ierr = PetscViewerASCIIPrintf(viewer,"thread %D: rows %D to %D, %D nonzeros, time %g\n",t,a->threads.rstart[t],a->threads.rstart[t+1],a->i[a->threads.rstart[t+1]]-a->i[a->threads.rstart[t]],a->threads.time[t]);CHKERRQ(ierr);
+      }
+      ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+    }
+  }
+  if (a->threads.levels[0].start) {
+    PetscInt u;
+    ierr = PetscViewerASCIIPrintf(viewer,"using threaded MatSolve: %D threads%s\n",a->threads.nthreads,a->threads.reordersolve ? ", factor rows stored in level order" : "");CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+    for (u=0; u<2; u++) {
+      const Mat_SeqAIJ_Levels *lv = &a->threads.levels[u];
+      ierr = PetscViewerASCIIPrintf(viewer,"%s: %D levels, %g rows per level on average, largest level %D rows\n",u ? "U" : "L",lv->nlevels,(double)(A->rmap->n/(PetscReal)PetscMax(lv->nlevels,1)),lv->maxsize);CHKERRQ(ierr);
+    }
+    ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Recomputes the row partition whenever the nonzero structure changed and installs the threaded kernels;
+   this must be called after MatAssemblyEnd_SeqAIJ_Inode() since it takes precedence over the Inode MatMult().
+   The types derived from SeqAIJ (AIJPERM, AIJCRL, AIJMKL, ...) also call MatAssemblyEnd_SeqAIJ() and keep their kernels.
+*/
+PetscErrorCode MatAssemblyEnd_SeqAIJ_Threads(Mat A,MatAssemblyType mode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscBool      seqaij;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (a->threads.nthreads < 2 || A->factortype || A->structure_only) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJ,&seqaij);CHKERRQ(ierr);
+  if (!seqaij) PetscFunctionReturn(0);
+  if (!a->threads.rstart || a->threads.mat_nonzerostate != A->nonzerostate) {
+    ierr = MatSeqAIJThreadsComputePartition_Private(A);CHKERRQ(ierr);
+  }
+  A->ops->mult             = MatMult_SeqAIJ_Threads;
+  A->ops->multadd          = MatMultAdd_SeqAIJ_Threads;
+  A->ops->multtranspose    = MatMultTranspose_SeqAIJ_Threads;
+  A->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ_Threads;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJ_Threads(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+  PetscReal      imbalance;
+
+  PetscFunctionBegin;
+  if (a->threads.rstart && a->threads.ncalls) {
+    ierr = MatSeqAIJThreadsGetImbalance_Private(A,&imbalance);CHKERRQ(ierr);
+    ierr = PetscInfo3(A,"Threaded MatMult routines: %D threads, %D calls, time imbalance (max/mean) %g\n",a->threads.nthreads,a->threads.ncalls,(double)imbalance);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(a->threads.rstart,a->threads.time);CHKERRQ(ierr);
+  ierr = PetscFree(a->threads.work);CHKERRQ(ierr);
+  ierr = MatSeqAIJThreadsLevelsReset_Private(&a->threads.levels[0]);CHKERRQ(ierr);
+  ierr = MatSeqAIJThreadsLevelsReset_Private(&a->threads.levels[1]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* MatCreate_SeqAIJ_Threads is a helper for the MATSEQAIJ class, like MatCreate_SeqAIJ_Inode() it is not a type */
+PetscErrorCode MatCreate_SeqAIJ_Threads(Mat B)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ*)B->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  b->threads.nthreads = 0;
+  b->threads.rstart   = NULL;
+  b->threads.time     = NULL;
+  b->threads.work     = NULL;
+  b->threads.ncalls   = 0;
+
+  b->threads.reordersolve = PETSC_FALSE;
+  b->threads.solvenatural = PETSC_FALSE;
+  ierr = PetscMemzero(b->threads.levels,sizeof(b->threads.levels));CHKERRQ(ierr);
+
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"Options for SEQAIJ matrix","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aij_threads","Number of threads used by MatMult() and friends",NULL,b->threads.nthreads,&b->threads.nthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_aij_threads_reorder_solve","Store the rows of the LU factors in level order for the threaded MatSolve()",NULL,b->threads.reordersolve,&b->threads.reordersolve,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+#if !defined(PETSC_HAVE_OPENMP)
+  if (b->threads.nthreads > 1) {
+    ierr = PetscInfo(B,"PETSc was not configured with OpenMP, -mat_aij_threads partitions the rows but runs them sequentially\n");CHKERRQ(ierr);
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJ_Threads(Mat A,MatDuplicateOption cpvalues,Mat *C)
+{
+  Mat            B = *C;
+  Mat_SeqAIJ     *c = (Mat_SeqAIJ*)B->data,*a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  c->threads.nthreads     = a->threads.nthreads;
+  c->threads.reordersolve = a->threads.reordersolve;
+  /* The symbolic ILU(0) factorization duplicates A without its arrays, the factor gets its own structure later */
+  if (!c->i) PetscFunctionReturn(0);
+  ierr = MatAssemblyEnd_SeqAIJ_Threads(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
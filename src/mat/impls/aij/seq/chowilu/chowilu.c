@@ -0,0 +1,228 @@
+
+/*
+   Fine-grained parallel incomplete LU factorization of Chow and Patel for the SeqAIJ format.
+
+   Instead of the Gaussian elimination row by row of MatLUFactorNumeric_SeqAIJ(), every nonzero of the ILU(k) pattern
+   computed by MatILUFactorSymbolic_SeqAIJ() is a fixed point of
+
+      l_ij = (a_ij - sum_{k<j} l_ik u_kj) / u_jj    for i > j
+      u_ij =  a_ij - sum_{k<i} l_ik u_kj            for i <= j
+
+   and a few sweeps of this fixed-point iteration, started from the entries of A, approximate the factors. All the
+   nonzeros of a sweep can be computed at the same time, the rows of L and the columns of U are split among the threads.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+
+/*MC
+  MATSOLVERCHOWILU - Fine-grained parallel ILU(k) factorization of Chow and Patel, a CPU version of PCCHOWILUVIENNACL
+
+  Works with MATSEQAIJ matrices, through PCILU
+
+  Options Database Keys:
++ -pc_factor_mat_solver_type chowilu - use this factorization with PCILU
+. -pc_factor_levels <k> - number of levels of fill, the pattern of the factors is the one of the PETSc ILU(k)
+. -mat_chowilu_sweeps <sweeps> - number of fixed-point sweeps over the nonzeros of the factors (default 3)
+- -mat_aij_threads <nthreads> - number of OpenMP threads computing each sweep
+
+  Level: intermediate
+
+  Notes:
+    Each sweep costs about as much as the exact ILU(k) numeric factorization but all its nonzeros are computed
+    independently, so the factorization scales with the number of threads. The sweeps are Jacobi-like: a sweep only
+    reads the values of the previous one, so the factors do not depend on the number of threads. The iteration is
+    exact after as many sweeps as the factors have levels, few sweeps usually give a preconditioner as good as the
+    exact ILU(k), in particular when refactoring a slowly changing matrix, for example at each Newton step.
+
+    The matrix ordering of -pc_factor_mat_ordering_type is applied. The shifts of PCFactorSetShiftType() are not, a
+    zero pivot is reported as with the PETSc ILU. Combine it with -pc_factor_solve_iterative to also replace the
+    triangular solves by parallel sweeps.
+
+  References:
+.  1. - E. Chow and A. Patel, Fine-grained parallel incomplete LU factorization, SIAM J. Sci. Comput., 37(2), 2015.
+
+.seealso: PCILU, PCFactorSetMatSolverType(), MatSolverType, PCFactorSetLevels(), PCFactorSetSolveIterative(), PCCHOWILUVIENNACL
+M*/
+
+static PetscErrorCode MatLUFactorNumeric_SeqAIJ_ChowILU(Mat B,Mat A,const MatFactorInfo *info)
+{
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data;
+  const PetscInt  n = A->rmap->n,*ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*bdiag = b->diag;
+  const MatScalar *aa = a->a;
+  const PetscInt  *r,*ic;
+  PetscInt        i,j,p,q,s,nzL = bi[n],nzU = bdiag[0] - bdiag[n],sweeps = b->chowsweeps;
+  PetscInt        nt = PetscMax(b->threads.nthreads,1),*uci,*ucr,*ucpos;
+  MatScalar       *av,*lbuf[2],*ubuf[2],*lv,*uv,*lnew,*unew,*rtmp,d;
+  PetscLogDouble  flops = 0.0;
+  PetscBool       row_identity,col_identity;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  /* the entries of the permuted A on the pattern of the factors, stored like the factors */
+  ierr = PetscMalloc2(bdiag[0]+1,&av,n,&rtmp);CHKERRQ(ierr);
+  ierr = PetscMemzero(rtmp,n*sizeof(MatScalar));CHKERRQ(ierr);
+  ierr = ISGetIndices(b->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(b->icol,&ic);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (p=ai[r[i]]; p<ai[r[i]+1]; p++) rtmp[ic[aj[p]]] = aa[p];
+    for (p=bi[i]; p<bi[i+1]; p++) {av[p] = rtmp[bj[p]]; rtmp[bj[p]] = 0.0;}
+    for (p=bdiag[i+1]+1; p<=bdiag[i]; p++) {av[p] = rtmp[bj[p]]; rtmp[bj[p]] = 0.0;}
+    for (p=ai[r[i]]; p<ai[r[i]+1]; p++) rtmp[ic[aj[p]]] = 0.0; /* entries of A outside of the pattern */
+  }
+  ierr = ISRestoreIndices(b->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(b->icol,&ic);CHKERRQ(ierr);
+
+  /* U by columns, the rows of each column in increasing order so its diagonal comes last */
+  ierr = PetscCalloc1(n+1,&uci);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nzU,&ucr,nzU,&ucpos);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (p=bdiag[i+1]+1; p<=bdiag[i]; p++) uci[bj[p]+1]++;
+  }
+  for (j=0; j<n; j++) uci[j+1] += uci[j];
+  for (i=0; i<n; i++) {
+    for (p=bdiag[i+1]+1; p<bdiag[i]; p++) {q = uci[bj[p]]++; ucr[q] = i; ucpos[q] = p;}
+    q = uci[i]++; ucr[q] = i; ucpos[q] = bdiag[i];
+  }
+  for (j=n; j>0; j--) uci[j] = uci[j-1];
+  uci[0] = 0;
+
+  /* the initial guess is L = strict lower part of A scaled by the diagonal of A, U = upper part of A */
+  ierr = PetscMalloc4(nzL,&lbuf[0],nzL,&lbuf[1],nzU,&ubuf[0],nzU,&ubuf[1]);CHKERRQ(ierr);
+  lv   = lbuf[0];
+  uv   = ubuf[0];
+  for (q=0; q<nzU; q++) uv[q] = av[ucpos[q]];
+  for (i=0; i<n; i++) {
+    for (p=bi[i]; p<bi[i+1]; p++) {
+      d     = av[bdiag[bj[p]]];
+      lv[p] = d != (MatScalar)0.0 ? av[p]/d : av[p];
+    }
+  }
+
+  for (s=0; s<sweeps; s++) {
+    lv   = lbuf[s%2]; lnew = lbuf[(s+1)%2];
+    uv   = ubuf[s%2]; unew = ubuf[(s+1)%2];
+#pragma omp parallel num_threads(nt)
+    {
+      PetscInt  i,j,p,q,lp,lend,uq,uend;
+      MatScalar sum;
+
+#pragma omp for schedule(static) reduction(+:flops)
+      for (i=0; i<n; i++) {
+        for (p=bi[i]; p<bi[i+1]; p++) {
+          j   = bj[p];
+          sum = av[p];
+          /* merge the columns k < j of row i of L with the rows k < j of column j of U */
+          for (lp=bi[i],uq=uci[j],uend=uci[j+1]-1; lp<p && uq<uend;) {
+            if (bj[lp] < ucr[uq])      lp++;
+            else if (bj[lp] > ucr[uq]) uq++;
+            else {sum -= lv[lp++]*uv[uq++]; flops += 2.0;}
+          }
+          lnew[p] = sum/uv[uend];
+          flops  += 1.0;
+        }
+      }
+#pragma omp for schedule(static) reduction(+:flops)
+      for (j=0; j<n; j++) {
+        for (q=uci[j]; q<uci[j+1]; q++) {
+          i   = ucr[q];
+          sum = av[ucpos[q]];
+          /* merge row i of L, all its columns are k < i, with the rows k < i of column j of U */
+          for (lp=bi[i],lend=bi[i+1],uq=uci[j]; lp<lend && uq<q;) {
+            if (bj[lp] < ucr[uq])      lp++;
+            else if (bj[lp] > ucr[uq]) uq++;
+            else {sum -= lv[lp++]*uv[uq++]; flops += 2.0;}
+          }
+          unew[q] = sum;
+        }
+      }
+    }
+  }
+  lv = lbuf[sweeps%2];
+  uv = ubuf[sweeps%2];
+
+  /* store the factors, with the inverted diagonal of U, as MatLUFactorNumeric_SeqAIJ() does */
+  B->factorerrortype = MAT_FACTOR_NOERROR;
+  ierr = PetscMemcpy(b->a,lv,nzL*sizeof(MatScalar));CHKERRQ(ierr);
+  for (q=0; q<nzU; q++) b->a[ucpos[q]] = uv[q];
+  for (i=0; i<n; i++) {
+    d = b->a[bdiag[i]];
+    if (PetscAbsScalar(d) <= info->zeropivot && !PetscIsNanScalar(d)) {
+      if (A->erroriffailure) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_MAT_LU_ZRPVT,"Zero pivot row %D value %g tolerance %g",i,(double)PetscAbsScalar(d),(double)info->zeropivot);
+      if (B->factorerrortype == MAT_FACTOR_NOERROR) {
+        ierr = PetscInfo3(A,"Detected zero pivot in factorization in row %D value %g tolerance %g\n",i,(double)PetscAbsScalar(d),(double)info->zeropivot);CHKERRQ(ierr);
+        B->factorerrortype             = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+        B->factorerror_zeropivot_value = PetscAbsScalar(d);
+        B->factorerror_zeropivot_row   = i;
+      }
+    } else b->a[bdiag[i]] = 1.0/d;
+  }
+  ierr = PetscFree4(lbuf[0],lbuf[1],ubuf[0],ubuf[1]);CHKERRQ(ierr);
+  ierr = PetscFree2(ucr,ucpos);CHKERRQ(ierr);
+  ierr = PetscFree(uci);CHKERRQ(ierr);
+  ierr = PetscFree2(av,rtmp);CHKERRQ(ierr);
+  ierr = PetscInfo3(A,"%D sweeps with %D threads, %D nonzeros in the factors\n",sweeps,nt,nzL+nzU);CHKERRQ(ierr);
+
+  ierr = ISIdentity(b->row,&row_identity);CHKERRQ(ierr);
+  ierr = ISIdentity(b->icol,&col_identity);CHKERRQ(ierr);
+  if (b->inode.size) {
+    B->ops->solve = MatSolve_SeqAIJ_Inode;
+  } else if (row_identity && col_identity) {
+    B->ops->solve = MatSolve_SeqAIJ_NaturalOrdering;
+  } else {
+    B->ops->solve = MatSolve_SeqAIJ;
+  }
+  ierr = MatSolveSetUp_SeqAIJ(B,info);CHKERRQ(ierr);
+  B->ops->solveadd          = MatSolveAdd_SeqAIJ;
+  B->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
+  B->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
+  B->ops->matsolve          = MatMatSolve_SeqAIJ;
+  B->assembled              = PETSC_TRUE;
+  B->preallocated           = PETSC_TRUE;
+  ierr = PetscLogFlops(flops + n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* The pattern of the factors is the one of the PETSc ILU(k), only the numeric factorization differs */
+static PetscErrorCode MatILUFactorSymbolic_SeqAIJ_ChowILU(Mat fact,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (info->dt > 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"ILU with drop tolerance is not supported by the Chow-Patel ILU");
+  ierr = MatILUFactorSymbolic_SeqAIJ(fact,A,isrow,iscol,info);CHKERRQ(ierr);
+  fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_ChowILU;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatFactorGetSolverType_seqaij_chowilu(Mat A,MatSolverType *type)
+{
+  PetscFunctionBegin;
+  *type = MATSOLVERCHOWILU;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_chowilu(Mat A,MatFactorType ftype,Mat *B)
+{
+  PetscInt       n = A->rmap->n,sweeps = 3;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ftype != MAT_FACTOR_ILU) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Factor type not supported");
+  ierr = MatCreate(PetscObjectComm((PetscObject)A),B);CHKERRQ(ierr);
+  ierr = MatSetSizes(*B,n,n,n,n);CHKERRQ(ierr);
+  ierr = MatSetType(*B,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSetBlockSizesFromMats(*B,A,A);CHKERRQ(ierr);
+
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)*B),((PetscObject)*B)->prefix,"Chow-Patel ILU options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_chowilu_sweeps","Number of fixed-point sweeps over the nonzeros of the factors","None",sweeps,&sweeps,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (sweeps < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of sweeps %D must be positive",sweeps);
+  ((Mat_SeqAIJ*)(*B)->data)->chowsweeps = sweeps;
+
+  (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJ_ChowILU;
+  (*B)->factortype             = ftype;
+  ierr = PetscObjectComposeFunction((PetscObject)*B,"MatFactorGetSolverType_C",MatFactorGetSolverType_seqaij_chowilu);CHKERRQ(ierr);
+
+  ierr = PetscFree((*B)->solvertype);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(MATSOLVERCHOWILU,&(*B)->solvertype);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -185,6 +185,10 @@ PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ(Mat A,Mat B,Mat C)
   PetscScalar    *ab_dense;
 
   PetscFunctionBegin;
+  if (c->threads.nthreads > 1) {
+    ierr = MatMatMultNumeric_SeqAIJ_SeqAIJ_Threads(A,B,C);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   if (!c->a) { /* first call of MatMatMultNumeric_SeqAIJ_SeqAIJ, allocate ca and matmult_abdense */
     ierr      = PetscMalloc1(ci[cm]+1,&ca);CHKERRQ(ierr);
     c->a      = ca;
@@ -248,6 +252,10 @@ PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(Mat A,Mat B,Mat C)
   PetscInt       nextb;
 
   PetscFunctionBegin;
+  if (c->threads.nthreads > 1) {
+    ierr = MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable_Threads(A,B,C);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   if (!ca) { /* first call of MatMatMultNumeric_SeqAIJ_SeqAIJ, allocate ca and matmult_abdense */
     ierr      = PetscMalloc1(ci[cm]+1,&ca);CHKERRQ(ierr);
     c->a      = ca;
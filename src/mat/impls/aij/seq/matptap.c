@@ -222,6 +222,10 @@ PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_SparseAxpy(Mat A,Mat P,Mat C)
   MatScalar      *aa=a->a,*apa,*pa=p->a,*pA=p->a,*paj,*ca=c->a,*caj;
 
   PetscFunctionBegin;
+  if (c->threads.nthreads > 1) {
+    ierr = MatPtAPNumeric_SeqAIJ_SeqAIJ_SparseAxpy_Threads(A,P,C);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   /* Allocate temporary array for storage of one row of A*P (cn: non-scalable) */
   ierr = PetscMalloc3(cn,&apa,cn,&apjdense,cn,&apj);CHKERRQ(ierr);
   ierr = PetscMemzero(apa,cn*sizeof(MatScalar));CHKERRQ(ierr);
@@ -688,7 +688,7 @@ PetscErrorCode MatMultTransposeAdd_SeqSELL(Mat A,Vec xx,Vec zz,Vec yy)
       for (r=0; r<(A->rmap->n & 0x07); ++r) {
         row        = 8*i + r;
         nnz_in_row = a->rlen[row];
-        for (j=0; j<nnz_in_row; ++j) y[acolidx[8*j+r]] += aval[8*j+r] * x[row];
+        for (j=0; j<nnz_in_row; ++j) y[acolidx[a->sliidx[i]+8*j+r]] += aval[a->sliidx[i]+8*j+r] * x[row];
       }
       break;
     }
@@ -715,10 +715,10 @@ PetscErrorCode MatMultTranspose_SeqSELL(Mat A,Vec xx,Vec yy)
 
   PetscFunctionBegin;
   if (A->symmetric) {
-    ierr = MatMult_SeqSELL(A,xx,yy);CHKERRQ(ierr);
+    ierr = (*A->ops->mult)(A,xx,yy);CHKERRQ(ierr);
   } else {
     ierr = VecSet(yy,0.0);CHKERRQ(ierr);
-    ierr = MatMultTransposeAdd_SeqSELL(A,xx,yy,yy);CHKERRQ(ierr);
+    ierr = (*A->ops->multtransposeadd)(A,xx,yy,yy);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
@@ -1947,6 +1947,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqSELL(Mat B)
   B->data = (void*)b;
 
   ierr = PetscMemcpy(B->ops,&MatOps_Values,sizeof(struct _MatOps));CHKERRQ(ierr);
+  ierr = MatSeqSELLSetSIMDKernels_Private(B);CHKERRQ(ierr);
 
   b->row                = 0;
   b->col                = 0;
@@ -0,0 +1,295 @@
+/*
+  Defines SIMD variants of the SELL matrix-vector products that are compiled for a specific instruction set with
+  __attribute((target())) and selected when the program runs, see MatGetSIMDType(). This allows one PETSc build to
+  use AVX-512 or AVX2 on the machines that have them. The kernels in sell.c are used if none of these apply.
+
+  Slices are always 8 rows high, so a slice column is one AVX-512 vector of doubles, two AVX2 vectors of doubles or
+  one AVX2 vector of floats; AVX-512 brings nothing over AVX2 for single precision and is not used for it.
+  Both 32 and 64 bit PetscInt are supported, complex scalars are not.
+*/
+#include <../src/mat/impls/sell/seq/sell.h>  /*I   "petscmat.h"  I*/
+
+#if defined(PETSC_HAVE_ATTRIBUTE_TARGET) && defined(PETSC_HAVE_IMMINTRIN_H) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_REAL_MAT_SINGLE) && (defined(PETSC_USE_REAL_DOUBLE) || defined(PETSC_USE_REAL_SINGLE))
+#define MAT_SEQSELL_SIMD_KERNELS
+#include <immintrin.h>
+
+/*
+   Gathers x at the column indices of one slice column (or half of one for AVX2 double)
+*/
+#if defined(PETSC_USE_64BIT_INDICES)
+#define MatSeqSELLGather_AVX512(x,idx) _mm512_i64gather_pd(_mm512_loadu_si512((const void*)(idx)),(x),8)
+#define MatSeqSELLGather_AVX2(x,idx)   _mm256_i64gather_pd((x),_mm256_loadu_si256((const __m256i*)(idx)),8)
+#define MatSeqSELLGatherS_AVX2(x,idx)  _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_i64gather_ps((x),_mm256_loadu_si256((const __m256i*)(idx)),4)),_mm256_i64gather_ps((x),_mm256_loadu_si256((const __m256i*)((idx)+4)),4),1)
+#else
+#define MatSeqSELLGather_AVX512(x,idx) _mm512_i32gather_pd(_mm256_loadu_si256((const __m256i*)(idx)),(x),8)
+#define MatSeqSELLGather_AVX2(x,idx)   _mm256_i32gather_pd((x),_mm_loadu_si128((const __m128i*)(idx)),8)
+#define MatSeqSELLGatherS_AVX2(x,idx)  _mm256_i32gather_ps((x),_mm256_loadu_si256((const __m256i*)(idx)),4)
+#endif
+
+/*
+   Scalar version of the transpose product for the last slice if it has padding rows, since x has no entries there
+*/
+PETSC_STATIC_INLINE void MatMultTransposeAdd_SeqSELL_LastSlice(PetscInt m,PetscInt i,const PetscInt *sliidx,const PetscInt *rlen,const MatScalar *aval,const PetscInt *acolidx,const PetscScalar *x,PetscScalar *y)
+{
+  PetscInt r,j,row,shift = sliidx[i];
+
+  for (r=0; r<(m & 0x07); r++) {
+    row = 8*i + r;
+    for (j=0; j<rlen[row]; j++) y[acolidx[shift+8*j+r]] += aval[shift+8*j+r]*x[row];
+  }
+}
+
+#if defined(PETSC_USE_REAL_DOUBLE)
+/*
+   z = y + A x, or z = A x if y is NULL; padding rows of the last slice have valid column indices and zero values
+   (see MatAssemblyEnd_SeqSELL()) so only the stores need to be masked
+*/
+__attribute((target("avx512f")))
+static void MatMultAdd_SeqSELL_AVX512_Kernel(PetscInt m,PetscInt totalslices,const PetscInt *sliidx,const MatScalar *aval,const PetscInt *acolidx,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
+{
+  __m512d  vec_y,vec_y2;
+  __mmask8 mask = 0xff;
+  PetscInt i,j;
+
+  for (i=0; i<totalslices; i++) {
+    if (i == totalslices-1 && (m & 0x07)) mask = (__mmask8)(0xff >> (8-(m & 0x07)));
+    vec_y  = y ? _mm512_maskz_loadu_pd(mask,y+8*i) : _mm512_setzero_pd();
+    vec_y2 = _mm512_setzero_pd();
+    for (j=sliidx[i]; j+8<sliidx[i+1]; j+=16) {
+      vec_y  = _mm512_fmadd_pd(MatSeqSELLGather_AVX512(x,acolidx+j),_mm512_loadu_pd(aval+j),vec_y);
+      vec_y2 = _mm512_fmadd_pd(MatSeqSELLGather_AVX512(x,acolidx+j+8),_mm512_loadu_pd(aval+j+8),vec_y2);
+    }
+    if (j < sliidx[i+1]) vec_y = _mm512_fmadd_pd(MatSeqSELLGather_AVX512(x,acolidx+j),_mm512_loadu_pd(aval+j),vec_y);
+    _mm512_mask_storeu_pd(z+8*i,mask,_mm512_add_pd(vec_y,vec_y2));
+  }
+}
+
+/*
+   y = y + A^T x; conflict detection is needed because two rows of a slice may share a column (padding entries always do)
+*/
+__attribute((target("avx512f,avx512cd")))
+static void MatMultTransposeAdd_SeqSELL_AVX512_Kernel(PetscInt m,PetscInt totalslices,const PetscInt *sliidx,const PetscInt *rlen,const MatScalar *aval,const PetscInt *acolidx,const PetscScalar *x,PetscScalar *y)
+{
+  __m512d  vec_x,vec_v;
+  __m512i  vec_idx;
+  PetscInt i,j,r;
+
+  for (i=0; i<totalslices; i++) {
+    if (i == totalslices-1 && (m & 0x07)) {
+      MatMultTransposeAdd_SeqSELL_LastSlice(m,i,sliidx,rlen,aval,acolidx,x,y);
+      break;
+    }
+    vec_x = _mm512_loadu_pd(x+8*i);
+    for (j=sliidx[i]; j<sliidx[i+1]; j+=8) {
+#if defined(PETSC_USE_64BIT_INDICES)
+      vec_idx = _mm512_loadu_si512((const void*)(acolidx+j));
+#else
+      vec_idx = _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i*)(acolidx+j)));
+#endif
+      if (_mm512_test_epi64_mask(_mm512_conflict_epi64(vec_idx),_mm512_set1_epi64(-1))) {
+        for (r=0; r<8; r++) y[acolidx[j+r]] += aval[j+r]*x[8*i+r];
+      } else {
+        vec_v = _mm512_fmadd_pd(_mm512_loadu_pd(aval+j),vec_x,_mm512_i64gather_pd(vec_idx,y,8));
+        _mm512_i64scatter_pd(y,vec_idx,vec_v,8);
+      }
+    }
+  }
+}
+
+__attribute((target("avx2,fma")))
+static void MatMultAdd_SeqSELL_AVX2_Kernel(PetscInt m,PetscInt totalslices,const PetscInt *sliidx,const MatScalar *aval,const PetscInt *acolidx,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
+{
+  __m256d  vec_y,vec_y2;
+  PetscInt i,j,r,nr;
+  double   tmp[8];
+
+  for (i=0; i<totalslices; i++) {
+    nr = (i == totalslices-1 && (m & 0x07)) ? (m & 0x07) : 8;
+    if (nr == 8) {
+      vec_y  = y ? _mm256_loadu_pd(y+8*i) : _mm256_setzero_pd();
+      vec_y2 = y ? _mm256_loadu_pd(y+8*i+4) : _mm256_setzero_pd();
+    } else {
+      for (r=0; r<8; r++) tmp[r] = (y && r < nr) ? y[8*i+r] : 0.0;
+      vec_y  = _mm256_loadu_pd(tmp);
+      vec_y2 = _mm256_loadu_pd(tmp+4);
+    }
+    for (j=sliidx[i]; j<sliidx[i+1]; j+=8) {
+      vec_y  = _mm256_fmadd_pd(MatSeqSELLGather_AVX2(x,acolidx+j),_mm256_loadu_pd(aval+j),vec_y);
+      vec_y2 = _mm256_fmadd_pd(MatSeqSELLGather_AVX2(x,acolidx+j+4),_mm256_loadu_pd(aval+j+4),vec_y2);
+    }
+    if (nr == 8) {
+      _mm256_storeu_pd(z+8*i,vec_y);
+      _mm256_storeu_pd(z+8*i+4,vec_y2);
+    } else {
+      _mm256_storeu_pd(tmp,vec_y);
+      _mm256_storeu_pd(tmp+4,vec_y2);
+      for (r=0; r<nr; r++) z[8*i+r] = tmp[r];
+    }
+  }
+}
+
+/*
+   AVX2 has no scatter, the products of a slice column are formed in vector registers and added one by one
+*/
+__attribute((target("avx2,fma")))
+static void MatMultTransposeAdd_SeqSELL_AVX2_Kernel(PetscInt m,PetscInt totalslices,const PetscInt *sliidx,const PetscInt *rlen,const MatScalar *aval,const PetscInt *acolidx,const PetscScalar *x,PetscScalar *y)
+{
+  __m256d  vec_x,vec_x2;
+  PetscInt i,j,r;
+  double   tmp[8];
+
+  for (i=0; i<totalslices; i++) {
+    if (i == totalslices-1 && (m & 0x07)) {
+      MatMultTransposeAdd_SeqSELL_LastSlice(m,i,sliidx,rlen,aval,acolidx,x,y);
+      break;
+    }
+    vec_x  = _mm256_loadu_pd(x+8*i);
+    vec_x2 = _mm256_loadu_pd(x+8*i+4);
+    for (j=sliidx[i]; j<sliidx[i+1]; j+=8) {
+      _mm256_storeu_pd(tmp,_mm256_mul_pd(_mm256_loadu_pd(aval+j),vec_x));
+      _mm256_storeu_pd(tmp+4,_mm256_mul_pd(_mm256_loadu_pd(aval+j+4),vec_x2));
+      for (r=0; r<8; r++) y[acolidx[j+r]] += tmp[r];
+    }
+  }
+}
+#else
+__attribute((target("avx2,fma")))
+static void MatMultAdd_SeqSELL_AVX2_Kernel(PetscInt m,PetscInt totalslices,const PetscInt *sliidx,const MatScalar *aval,const PetscInt *acolidx,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
+{
+  __m256   vec_y;
+  PetscInt i,j,r,nr;
+  float    tmp[8];
+
+  for (i=0; i<totalslices; i++) {
+    nr = (i == totalslices-1 && (m & 0x07)) ? (m & 0x07) : 8;
+    if (nr == 8) {
+      vec_y = y ? _mm256_loadu_ps(y+8*i) : _mm256_setzero_ps();
+    } else {
+      for (r=0; r<8; r++) tmp[r] = (y && r < nr) ? y[8*i+r] : 0.0f;
+      vec_y = _mm256_loadu_ps(tmp);
+    }
+    for (j=sliidx[i]; j<sliidx[i+1]; j+=8) {
+      vec_y = _mm256_fmadd_ps(MatSeqSELLGatherS_AVX2(x,acolidx+j),_mm256_loadu_ps(aval+j),vec_y);
+    }
+    if (nr == 8) {
+      _mm256_storeu_ps(z+8*i,vec_y);
+    } else {
+      _mm256_storeu_ps(tmp,vec_y);
+      for (r=0; r<nr; r++) z[8*i+r] = tmp[r];
+    }
+  }
+}
+
+__attribute((target("avx2,fma")))
+static void MatMultTransposeAdd_SeqSELL_AVX2_Kernel(PetscInt m,PetscInt totalslices,const PetscInt *sliidx,const PetscInt *rlen,const MatScalar *aval,const PetscInt *acolidx,const PetscScalar *x,PetscScalar *y)
+{
+  __m256   vec_x;
+  PetscInt i,j,r;
+  float    tmp[8];
+
+  for (i=0; i<totalslices; i++) {
+    if (i == totalslices-1 && (m & 0x07)) {
+      MatMultTransposeAdd_SeqSELL_LastSlice(m,i,sliidx,rlen,aval,acolidx,x,y);
+      break;
+    }
+    vec_x = _mm256_loadu_ps(x+8*i);
+    for (j=sliidx[i]; j<sliidx[i+1]; j+=8) {
+      _mm256_storeu_ps(tmp,_mm256_mul_ps(_mm256_loadu_ps(aval+j),vec_x));
+      for (r=0; r<8; r++) y[acolidx[j+r]] += tmp[r];
+    }
+  }
+}
+#endif
+
+#define MatSeqSELLDefineSIMDOps(isa) \
+static PetscErrorCode MatMult_SeqSELL_##isa(Mat A,Vec xx,Vec yy) \
+{ \
+  Mat_SeqSELL       *a = (Mat_SeqSELL*)A->data; \
+  PetscScalar       *y; \
+  const PetscScalar *x; \
+  PetscErrorCode    ierr; \
+ \
+  PetscFunctionBegin; \
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr); \
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr); \
+  MatMultAdd_SeqSELL_##isa##_Kernel(A->rmap->n,a->totalslices,a->sliidx,a->val,a->colidx,x,NULL,y); \
+  ierr = PetscLogFlops(2.0*a->nz-a->nonzerorowcnt);CHKERRQ(ierr); \
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr); \
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr); \
+  PetscFunctionReturn(0); \
+} \
+ \
+static PetscErrorCode MatMultAdd_SeqSELL_##isa(Mat A,Vec xx,Vec yy,Vec zz) \
+{ \
+  Mat_SeqSELL       *a = (Mat_SeqSELL*)A->data; \
+  PetscScalar       *y,*z; \
+  const PetscScalar *x; \
+  PetscErrorCode    ierr; \
+ \
+  PetscFunctionBegin; \
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr); \
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr); \
+  MatMultAdd_SeqSELL_##isa##_Kernel(A->rmap->n,a->totalslices,a->sliidx,a->val,a->colidx,x,y,z); \
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr); \
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr); \
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr); \
+  PetscFunctionReturn(0); \
+} \
+ \
+static PetscErrorCode MatMultTransposeAdd_SeqSELL_##isa(Mat A,Vec xx,Vec zz,Vec yy) \
+{ \
+  Mat_SeqSELL       *a = (Mat_SeqSELL*)A->data; \
+  PetscScalar       *y; \
+  const PetscScalar *x; \
+  PetscErrorCode    ierr; \
+ \
+  PetscFunctionBegin; \
+  if (A->symmetric) { \
+    ierr = MatMultAdd_SeqSELL_##isa(A,xx,zz,yy);CHKERRQ(ierr); \
+    PetscFunctionReturn(0); \
+  } \
+  if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);} \
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr); \
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr); \
+  MatMultTransposeAdd_SeqSELL_##isa##_Kernel(A->rmap->n,a->totalslices,a->sliidx,a->rlen,a->val,a->colidx,x,y); \
+  ierr = PetscLogFlops(2.0*a->sliidx[a->totalslices]);CHKERRQ(ierr); \
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr); \
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr); \
+  PetscFunctionReturn(0); \
+}
+
+#if defined(PETSC_USE_REAL_DOUBLE)
+MatSeqSELLDefineSIMDOps(AVX512)
+#endif
+MatSeqSELLDefineSIMDOps(AVX2)
+#endif
+
+/*
+   Replaces the SELL matrix-vector products with the variants for the instruction set given by MatGetSIMDType()
+*/
+PetscErrorCode MatSeqSELLSetSIMDKernels_Private(Mat A)
+{
+  PetscErrorCode ierr;
+  PetscSIMDType  simd;
+
+  PetscFunctionBegin;
+  ierr = MatGetSIMDType(&simd);CHKERRQ(ierr);
+#if defined(MAT_SEQSELL_SIMD_KERNELS)
+#if defined(PETSC_USE_REAL_DOUBLE)
+  if (simd == PETSC_SIMD_AVX512) {
+    A->ops->mult             = MatMult_SeqSELL_AVX512;
+    A->ops->multadd          = MatMultAdd_SeqSELL_AVX512;
+    A->ops->multtransposeadd = MatMultTransposeAdd_SeqSELL_AVX512;
+    ierr = PetscInfo(A,"Using AVX-512 kernels\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
+  if (simd >= PETSC_SIMD_AVX2) {
+    A->ops->mult             = MatMult_SeqSELL_AVX2;
+    A->ops->multadd          = MatMultAdd_SeqSELL_AVX2;
+    A->ops->multtransposeadd = MatMultTransposeAdd_SeqSELL_AVX2;
+    ierr = PetscInfo(A,"Using AVX2 kernels\n");CHKERRQ(ierr);
+  }
+#endif
+  PetscFunctionReturn(0);
+}
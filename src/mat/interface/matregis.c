@@ -24,6 +24,12 @@ PETSC_EXTERN PetscErrorCode MatCreate_Composite(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJPERM(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJPERM(Mat);
 
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJAutotune(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJAutotune(Mat);
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMixed(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMixed(Mat);
+
 #if defined PETSC_HAVE_MKL_SPARSE
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMKL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMKL(Mat);
@@ -101,6 +107,14 @@ PetscErrorCode  MatRegisterAll(void)
   ierr = MatRegister(MATMPIAIJPERM,     MatCreate_MPIAIJPERM);CHKERRQ(ierr);
   ierr = MatRegister(MATSEQAIJPERM,     MatCreate_SeqAIJPERM);CHKERRQ(ierr);
 
+  ierr = MatRegisterBaseName(MATAIJAUTOTUNE,MATSEQAIJAUTOTUNE,MATMPIAIJAUTOTUNE);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJAUTOTUNE, MatCreate_MPIAIJAutotune);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJAUTOTUNE, MatCreate_SeqAIJAutotune);CHKERRQ(ierr);
+
+  ierr = MatRegisterBaseName(MATAIJMIXED,MATSEQAIJMIXED,MATMPIAIJMIXED);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJMIXED,    MatCreate_MPIAIJMixed);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJMIXED,    MatCreate_SeqAIJMixed);CHKERRQ(ierr);
+
 #if defined PETSC_HAVE_MKL_SPARSE
   ierr = MatRegisterBaseName(MATAIJMKL, MATSEQAIJMKL,MATMPIAIJMKL);CHKERRQ(ierr);
   ierr = MatRegister(MATMPIAIJMKL,      MatCreate_MPIAIJMKL);CHKERRQ(ierr);
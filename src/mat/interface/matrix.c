@@ -1923,7 +1923,7 @@ PetscErrorCode MatGetValues(Mat mat,PetscInt m,const PetscInt idxm[],PetscInt n,
 
 /*@
   MatSetValuesBatch - Adds (ADD_VALUES) many blocks of values into a matrix at once. The blocks must all be square and
-  the same size. Currently, this can only be called once and creates the given matrix.
+  the same size, for example the element matrices of a finite element assembly.
 
   Not Collective
 
@@ -1935,7 +1935,16 @@ PetscErrorCode MatGetValues(Mat mat,PetscInt m,const PetscInt idxm[],PetscInt n,
 - v - a concatenation of logically two-dimensional arrays of values
 
   Notes:
-  In the future, we will extend this routine to handle rectangular blocks, and to allow multiple calls for a given matrix.
+  Block b adds the bs by bs values v[b*bs*bs+i*bs+j] at the global row rows[b*bs+i] and column rows[b*bs+j], negative
+  indices are ignored. The routine may be called several times between assemblies, and the same index may appear in
+  several blocks, or several times in one block.
+
+  For MATSEQAIJ and MATMPIAIJ the blocks are added with their indices sorted until the matrix has been assembled. Later,
+  the first call finds the position in the compressed row storage of each value by merging the sorted indices of the
+  blocks with the rows of the matrix, and keeps these positions, one PetscInt per value; calling it again with the same
+  rows[] and an unchanged nonzero pattern, as when reassembling a Jacobian, then adds the values at these positions
+  without any search. Only the last batch is remembered, so reassemblies are fastest when all the blocks are given in
+  one call. A batch that needs new nonzeros is added with MatSetValues().
 
   Level: advanced
 
@@ -1951,15 +1960,30 @@ PetscErrorCode MatSetValuesBatch(Mat mat, PetscInt nb, PetscInt bs, PetscInt row
   PetscFunctionBegin;
   PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
   PetscValidType(mat,1);
-  PetscValidScalarPointer(rows,4);
+  if (!nb || !bs) PetscFunctionReturn(0);
+  PetscValidIntPointer(rows,4);
   PetscValidScalarPointer(v,5);
+  MatCheckPreallocated(mat,1);
+  if (mat->insertmode == NOT_SET_VALUES) {
+    mat->insertmode = ADD_VALUES;
+  }
 #if defined(PETSC_USE_DEBUG)
+  else if (mat->insertmode != ADD_VALUES) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot mix add values and insert values");
   if (mat->factortype) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Not for factored matrix");
 #endif
 
   ierr = PetscLogEventBegin(MAT_SetValuesBatch,mat,0,0,0);CHKERRQ(ierr);
   if (mat->ops->setvaluesbatch) {
+    if (mat->assembled) {
+      mat->was_assembled = PETSC_TRUE;
+      mat->assembled     = PETSC_FALSE;
+    }
     ierr = (*mat->ops->setvaluesbatch)(mat,nb,bs,rows,v);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_VECCUDA)
+    if (mat->valid_GPU_matrix != PETSC_OFFLOAD_UNALLOCATED) {
+      mat->valid_GPU_matrix = PETSC_OFFLOAD_CPU;
+    }
+#endif
   } else {
     PetscInt b;
     for (b = 0; b < nb; ++b) {
@@ -2333,6 +2357,13 @@ PetscErrorCode MatMult(Mat mat,Vec x,Vec y)
   VecLocked(y,3);
   if (mat->erroriffailure) {ierr = VecValidValues(x,2,PETSC_TRUE);CHKERRQ(ierr);}
   MatCheckPreallocated(mat,1);
+  if (mat->multsetup) {
+    PetscErrorCode (*multsetup)(Mat) = mat->multsetup;
+
+    /* this may replace the implementation of mat, for example by MatConvert() with MAT_INPLACE_MATRIX */
+    mat->multsetup = NULL;
+    ierr = (*multsetup)(mat);CHKERRQ(ierr);
+  }
 
   ierr = VecLockPush(x);CHKERRQ(ierr);
   if (!mat->ops->mult) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_SUP,"This matrix type does not have a multiply defined");
@@ -0,0 +1,54 @@
+/*
+    Run time selection of the instruction set extensions used by the SIMD matrix kernels.
+*/
+
+#include <petsc/private/matimpl.h>       /*I  "petscmat.h"  I*/
+
+static PetscSIMDType MatSIMD = PETSC_SIMD_NONE;
+
+/*
+    Queries the processor and -mat_simd once, called by MatInitializePackage()
+*/
+PetscErrorCode MatSIMDInitializePackage_Private(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscGetSIMDType("-mat_simd",&MatSIMD);CHKERRQ(ierr);
+  ierr = PetscInfo1(NULL,"Using %s kernels for the SeqAIJ and SeqSELL matrix-vector products\n",PetscSIMDTypes[MatSIMD]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+    MatGetSIMDType - Determines the instruction set extensions that the SIMD kernels of the matrices should use
+
+    Not Collective
+
+    Output Parameter:
+.   type - PETSC_SIMD_AVX512, PETSC_SIMD_AVX2 or PETSC_SIMD_NONE
+
+    Options Database Keys:
+.   -mat_simd <none,avx2,avx512> - use at most this instruction set (default is the best one supported by the processor)
+
+    Notes:
+    The processor and the option are queried once by MatInitializePackage(), see PetscGetSIMDType(). A request for
+    an instruction set the processor does not support is lowered to the best supported one, run with -info to see
+    the instruction set that is used.
+
+    Developer Notes:
+    This is called by the matrix constructors, the kernels themselves decide which scalar and integer sizes they support.
+
+    Level: developer
+
+.seealso: PetscGetSIMDType(), MatMult(), MATSEQAIJ, MATSEQSELL
+@*/
+PetscErrorCode MatGetSIMDType(PetscSIMDType *type)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(type,1);
+  ierr  = MatInitializePackage();CHKERRQ(ierr);
+  *type = MatSIMD;
+  PetscFunctionReturn(0);
+}
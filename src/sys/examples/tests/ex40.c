@@ -101,6 +101,18 @@ int main(int argc,char **argv)
   PetscAssert(vals[1] == 42);
   ierr = PetscHMapIDestroy(&hd);CHKERRQ(ierr);
 
+  keys[0] = 7; keys[1] = 123; keys[2] = 5; keys[3] = 7;
+  vals[0] = 1; vals[1] = 2;   vals[2] = 3; vals[3] = 4;
+  ierr = PetscHMapISetMany(ht,4,keys,vals);CHKERRQ(ierr);
+  ierr = PetscHMapIGetSize(ht,&n);CHKERRQ(ierr);
+  PetscAssert(n == 4);
+  keys[0] = 5; keys[1] = 7; keys[2] = 8; keys[3] = 123;
+  ierr = PetscHMapIGetMany(ht,4,keys,keys);CHKERRQ(ierr);
+  PetscAssert(keys[0] == 3);
+  PetscAssert(keys[1] == 4);
+  PetscAssert(keys[2] == -1);
+  PetscAssert(keys[3] == 2);
+
   ierr = PetscHMapISet(ht,0,0);CHKERRQ(ierr);
   ierr = PetscHMapIGetSize(ht,&n);CHKERRQ(ierr);
   PetscAssert(n != 0);
@@ -91,6 +91,13 @@ int main(int argc,char **argv)
   PetscAssert(array[1] == 42);
   ierr = PetscHSetIDestroy(&hd);CHKERRQ(ierr);
 
+  array[0] = 7; array[1] = 42; array[2] = 5; array[3] = 7;
+  ierr = PetscHSetIAddMany(ht,4,array);CHKERRQ(ierr);
+  ierr = PetscHSetIGetSize(ht,&n);CHKERRQ(ierr);
+  PetscAssert(n == 4);
+  ierr = PetscHSetIHas(ht,5,&has);CHKERRQ(ierr);
+  PetscAssert(has == PETSC_TRUE);
+
   ierr = PetscHSetIAdd(ht,0);CHKERRQ(ierr);
   ierr = PetscHSetIGetSize(ht,&n);CHKERRQ(ierr);
   PetscAssert(n != 0);
@@ -0,0 +1,118 @@
+
+static char help[] = "Compares the quicksort and radix sort paths of PetscSortInt() and PetscSortIntWithArray().\n\
+  -n <n> : length of the arrays\n\
+  -its <its> : number of sorts to time\n\
+  -timing : print the time of each sort\n\n";
+
+#include <petscsys.h>
+#include <petsctime.h>
+
+typedef enum {INPUT_RANDOM,INPUT_NARROW,INPUT_SORTED,INPUT_NEARLY_SORTED,INPUT_RUNS,INPUT_REVERSED} InputType;
+static const char *InputTypes[] = {"random","narrow","sorted","nearly sorted","sorted runs","reversed"};
+
+static PetscErrorCode FillInput(PetscRandom rnd,InputType type,PetscInt n,PetscInt v[])
+{
+  PetscErrorCode ierr;
+  PetscReal      r;
+  PetscInt       i,k;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    ierr = PetscRandomGetValueReal(rnd,&r);CHKERRQ(ierr);
+    switch (type) {
+    case INPUT_RANDOM:        v[i] = (PetscInt)(r*PETSC_MAX_INT) - PETSC_MAX_INT/2; break;
+    case INPUT_NARROW:        v[i] = 1000 + (PetscInt)(r*n/4); break;
+    case INPUT_SORTED:        v[i] = 3*i; break;
+    case INPUT_NEARLY_SORTED: v[i] = 3*i; break;
+    case INPUT_RUNS:          v[i] = 3*(i % (n/5+1)); break; /* five sorted pieces put end to end */
+    case INPUT_REVERSED:      v[i] = n-i; break;
+    }
+  }
+  if (type == INPUT_NEARLY_SORTED) {
+    for (k=0; k<n/100+1; k++) {
+      ierr = PetscRandomGetValueReal(rnd,&r);CHKERRQ(ierr);
+      i    = (PetscInt)(r*(n-1));
+      v[i] = -v[i];
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* checks that v[] is sorted and that the companion array still holds the position of each value in orig[] */
+static PetscErrorCode CheckSorted(const char name[],InputType type,PetscInt n,const PetscInt v[],const PetscInt perm[],const PetscInt orig[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    if ((i && v[i] < v[i-1]) || (perm && orig[perm[i]] != v[i])) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%s %s: wrong result at %D\n",name,InputTypes[type],i);CHKERRQ(ierr);
+      break;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = 10000,its = 10,i,k,t,radix,*orig,*v,*perm;
+  PetscBool      timing = PETSC_FALSE;
+  PetscRandom    rnd;
+  PetscLogDouble t0,t1,tsort,tarray;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-timing",&timing,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rnd);CHKERRQ(ierr);
+  ierr = PetscMalloc3(n,&orig,n,&v,n,&perm);CHKERRQ(ierr);
+
+  for (t=INPUT_RANDOM; t<=INPUT_REVERSED; t++) {
+    ierr = FillInput(rnd,(InputType)t,n,orig);CHKERRQ(ierr);
+    for (radix=0; radix<2; radix++) {
+      ierr   = PetscSortIntSetRadixThreshold(radix ? 1 : 0);CHKERRQ(ierr);
+      tsort  = 0.0;
+      tarray = 0.0;
+      for (k=0; k<its; k++) {
+        ierr   = PetscMemcpy(v,orig,n*sizeof(PetscInt));CHKERRQ(ierr);
+        ierr   = PetscTime(&t0);CHKERRQ(ierr);
+        ierr   = PetscSortInt(n,v);CHKERRQ(ierr);
+        ierr   = PetscTime(&t1);CHKERRQ(ierr);
+        tsort += t1 - t0;
+        if (!k) {ierr = CheckSorted("PetscSortInt",(InputType)t,n,v,NULL,orig);CHKERRQ(ierr);}
+
+        ierr    = PetscMemcpy(v,orig,n*sizeof(PetscInt));CHKERRQ(ierr);
+        for (i=0; i<n; i++) perm[i] = i;
+        ierr    = PetscTime(&t0);CHKERRQ(ierr);
+        ierr    = PetscSortIntWithArray(n,v,perm);CHKERRQ(ierr);
+        ierr    = PetscTime(&t1);CHKERRQ(ierr);
+        tarray += t1 - t0;
+        if (!k) {ierr = CheckSorted("PetscSortIntWithArray",(InputType)t,n,v,perm,orig);CHKERRQ(ierr);}
+      }
+      if (timing) {
+        ierr = PetscPrintf(PETSC_COMM_SELF,"%-13s %-9s: PetscSortInt %g s, PetscSortIntWithArray %g s\n",InputTypes[t],radix ? "radix" : "quicksort",tsort/its,tarray/its);CHKERRQ(ierr);
+      }
+    }
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%s: done\n",InputTypes[t]);CHKERRQ(ierr);
+  }
+  ierr = PetscSortIntSetRadixThreshold(0);CHKERRQ(ierr);
+
+  ierr = PetscFree3(orig,v,perm);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rnd);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+     args: -its 1
+
+   test:
+     suffix: 2
+     args: -n 37 -its 1
+
+TEST*/
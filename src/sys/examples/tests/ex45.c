@@ -0,0 +1,89 @@
+
+static char help[] = "Tests PetscMalloc(), PetscRealloc() and PetscFree() of many sizes, for example with -malloc no -malloc_pool.\n\
+  -threads <nt> : also malloc and free from nt OpenMP threads at once\n\
+  -free_after_finalize : keep one array alive until after PetscFinalize()\n\n";
+
+#include <petscsys.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,k,n,its = 3,nt = 1,*a[24],*kept = NULL;
+  PetscLogDouble start,used,end;
+  PetscBool      after = PETSC_FALSE;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-threads",&nt,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-free_after_finalize",&after,NULL);CHKERRQ(ierr);
+  ierr = PetscMallocGetCurrentUsage(&start);CHKERRQ(ierr);
+  for (k=0; k<its; k++) {
+    /* sizes from a few bytes to well past the largest pool class, so both reused and bypassing blocks are exercised */
+    for (i=0, n=1; i<24; i++, n*=2) {
+      ierr = PetscMalloc1(n+k,&a[i]);CHKERRQ(ierr);
+      a[i][0] = i; a[i][n+k-1] = -i;
+    }
+    ierr = PetscMallocGetCurrentUsage(&used);CHKERRQ(ierr);
+    if (start && used - start < 24*sizeof(PetscInt)) {ierr = PetscPrintf(PETSC_COMM_SELF,"Current usage %g does not include the arrays\n",used-start);CHKERRQ(ierr);}
+    /* grow within the same block, into the next class, and shrink */
+    for (i=0, n=1; i<24; i++, n*=2) {
+      ierr = PetscRealloc((n+k+1)*sizeof(PetscInt),&a[i]);CHKERRQ(ierr);
+      if (a[i][0] != i) {ierr = PetscPrintf(PETSC_COMM_SELF,"Realloc lost the first entry of array %D\n",i);CHKERRQ(ierr);}
+      ierr = PetscRealloc(2*(n+k)*sizeof(PetscInt),&a[i]);CHKERRQ(ierr);
+      if (a[i][0] != i || a[i][n+k-1] != -i) {ierr = PetscPrintf(PETSC_COMM_SELF,"Realloc lost the entries of array %D\n",i);CHKERRQ(ierr);}
+      ierr = PetscRealloc(sizeof(PetscInt),&a[i]);CHKERRQ(ierr);
+      if (a[i][0] != i) {ierr = PetscPrintf(PETSC_COMM_SELF,"Shrinking realloc lost the first entry of array %D\n",i);CHKERRQ(ierr);}
+    }
+    for (i=0; i<24; i+=2) {ierr = PetscFree(a[i]);CHKERRQ(ierr);}
+    for (i=1; i<24; i+=2) {ierr = PetscFree(a[i]);CHKERRQ(ierr);}
+  }
+#if defined(PETSC_HAVE_OPENMP)
+  if (nt > 1) {
+    PetscErrorCode terr = 0;
+
+    /* every thread takes blocks of the same few classes, so they all pop and push the same free lists */
+#pragma omp parallel for num_threads(nt) private(i,n) reduction(|:terr)
+    for (k=0; k<64*nt; k++) {
+      PetscInt *b[8];
+
+      for (i=0, n=1; i<8; i++, n*=4) {
+        terr |= PetscMalloc1(n,&b[i]);
+        if (!terr) b[i][n-1] = k;
+      }
+      for (i=0, n=1; i<8; i++, n*=4) {
+        if (!terr && b[i][n-1] != k) terr = 1;
+        terr |= PetscFree(b[i]);
+      }
+    }
+    if (terr) {ierr = PetscPrintf(PETSC_COMM_SELF,"Malloc from OpenMP threads failed\n");CHKERRQ(ierr);}
+  }
+#endif
+  ierr = PetscMallocGetCurrentUsage(&end);CHKERRQ(ierr);
+  if (end != start) {ierr = PetscPrintf(PETSC_COMM_SELF,"Current usage changed from %g to %g\n",start,end);CHKERRQ(ierr);}
+  ierr = PetscPrintf(PETSC_COMM_SELF,"done\n");CHKERRQ(ierr);
+  if (after) {ierr = PetscMalloc1(100,&kept);CHKERRQ(ierr);}
+  ierr = PetscFinalize();if (ierr) return ierr;
+  /* PetscFree() must still know how to release it */
+  ierr = PetscFree(kept);
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+
+   test:
+     suffix: pool
+     args: -malloc no -malloc_pool
+     output_file: output/ex45_1.out
+
+   test:
+     suffix: pool_threads
+     args: -malloc no -malloc_pool -threads 4 -free_after_finalize
+     output_file: output/ex45_1.out
+
+TEST*/
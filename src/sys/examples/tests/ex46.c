@@ -0,0 +1,75 @@
+
+static char help[] = "Tests the Chrome trace of PETSc events written by PetscLogTraceJSONDump().\n\n";
+
+#include <petscsys.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscClassId   classid;
+  PetscLogEvent  outer,inner;
+  PetscMPIInt    rank,size;
+  PetscInt       i,nbegin = 0,nend = 0,nescaped = 0;
+  PetscScalar    send[10],recv[10];
+  PetscReal      sum;
+  MPI_Request    reqs[2];
+  FILE           *fd;
+  char           line[1024],*args;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscClassIdRegister("Trace test",&classid);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("TraceOuter",classid,&outer);CHKERRQ(ierr);
+  /* a name that must be escaped in JSON */
+  ierr = PetscLogEventRegister("Trace\"Inner\"\\",classid,&inner);CHKERRQ(ierr);
+  /* Does nothing if -log_trace_json already started the trace */
+  ierr = PetscLogTraceJSONBegin(PETSC_DEFAULT);CHKERRQ(ierr);
+
+  for (i=0; i<10; i++) send[i] = rank;
+  ierr = PetscLogEventBegin(outer,0,0,0,0);CHKERRQ(ierr);
+  for (i=0; i<3; i++) {
+    ierr = PetscLogEventBegin(inner,0,0,0,0);CHKERRQ(ierr);
+    ierr = PetscLogFlops(100.0);CHKERRQ(ierr);
+    ierr = MPI_Irecv(recv,10,MPIU_SCALAR,(rank+size-1)%size,0,PETSC_COMM_WORLD,&reqs[0]);CHKERRQ(ierr);
+    ierr = MPI_Isend(send,10,MPIU_SCALAR,(rank+1)%size,0,PETSC_COMM_WORLD,&reqs[1]);CHKERRQ(ierr);
+    ierr = MPI_Waitall(2,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    /* not MPIU_Allreduce(), whose check in debugging builds is itself counted as a reduction */
+    ierr = MPI_Allreduce(&recv[0],&sum,1,MPIU_REAL,MPIU_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(inner,0,0,0,0);CHKERRQ(ierr);
+  }
+  ierr = PetscLogFlops(50.0);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(outer,0,0,0,0);CHKERRQ(ierr);
+  ierr = PetscLogTraceJSONDump("ex46_trace.json");CHKERRQ(ierr);
+
+  /* The timestamps vary, the number of records and the arguments of the first rank do not */
+  if (!rank) {
+    fd = fopen("ex46_trace.json","r");
+    if (!fd) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_OPEN,"Unable to open the trace");
+    while (fgets(line,sizeof(line),fd)) {
+      if (strstr(line,"\"ph\":\"B\"")) nbegin++;
+      if (strstr(line,"\"ph\":\"E\"")) nend++;
+      if (strstr(line,"\"name\":\"Trace\\\"Inner\\\"\\\\\",")) nescaped++;
+      if (strstr(line,"\"pid\":0,") && strstr(line,"\"ph\":\"E\"") && (args = strstr(line,"\"args\""))) {
+        ierr = PetscPrintf(PETSC_COMM_SELF,"%s",args);CHKERRQ(ierr);
+      }
+    }
+    fclose(fd);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%D beginnings, %D ends, %D with an escaped name\n",nbegin,nend,nescaped);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+      nsize: 2
+
+   test:
+      suffix: 2
+      nsize: 2
+      args: -log_trace_json_size 5 -log_trace_json ex46_finalize.json
+
+TEST*/
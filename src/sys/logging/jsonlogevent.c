@@ -0,0 +1,273 @@
+/*
+   Event tracing in the Chrome Trace Event format, which chrome://tracing and https://ui.perfetto.dev display as a
+   timeline of every process.
+
+   The beginning and the end of every event are recorded, with the time and the flop and message counters, in a ring
+   buffer of fixed size on each process so that recording costs a few stores and no allocation. The events are paired
+   and written out by PetscLogTraceJSONDump().
+*/
+#include <petsc/private/logimpl.h>        /*I "petscsys.h" I*/
+#include <petsctime.h>
+
+#if defined(PETSC_USE_LOG)
+
+typedef struct {
+  PetscLogDouble time;
+  PetscLogDouble flops;                   /* counters of the process at that time */
+  PetscLogDouble messages,bytes,reductions;
+  PetscLogEvent  event;
+  PetscBool      begin;
+} PetscTraceRecord;
+
+static PetscTraceRecord *petsc_trace_records = NULL;
+static PetscInt         petsc_trace_size     = 0;           /* capacity of the ring buffer */
+static PetscInt         petsc_trace_next     = 0;           /* slot of the next record */
+static PetscBool        petsc_trace_wrapped  = PETSC_FALSE; /* older records have been overwritten */
+static PetscLogDouble   petsc_trace_start    = 0.0;
+
+/* Handlers that were active when tracing started, they are still called so that -log_view can be used along */
+static PetscErrorCode (*petsc_trace_PLB)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject) = NULL;
+static PetscErrorCode (*petsc_trace_PLE)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject) = NULL;
+
+PETSC_STATIC_INLINE void PetscLogTraceJSONRecord(PetscLogEvent event,PetscBool begin)
+{
+  PetscTraceRecord *r = &petsc_trace_records[petsc_trace_next];
+
+  PetscTime(&r->time);
+  r->flops      = petsc_TotalFlops;
+  r->messages   = petsc_send_ct + petsc_isend_ct + petsc_recv_ct + petsc_irecv_ct;
+  r->bytes      = petsc_send_len + petsc_isend_len + petsc_recv_len + petsc_irecv_len;
+  r->reductions = petsc_allreduce_ct;
+  r->event      = event;
+  r->begin      = begin;
+  if (++petsc_trace_next == petsc_trace_size) {
+    petsc_trace_next    = 0;
+    petsc_trace_wrapped = PETSC_TRUE;
+  }
+}
+
+static PetscErrorCode PetscLogEventBeginTraceJSON(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (petsc_trace_PLB) {ierr = (*petsc_trace_PLB)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);}
+  PetscLogTraceJSONRecord(event,PETSC_TRUE);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscLogEventEndTraceJSON(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscLogTraceJSONRecord(event,PETSC_FALSE);
+  if (petsc_trace_PLE) {ierr = (*petsc_trace_PLE)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscLogTraceJSONDestroy(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(petsc_trace_records);CHKERRQ(ierr);
+  petsc_trace_size    = 0;
+  petsc_trace_next    = 0;
+  petsc_trace_wrapped = PETSC_FALSE;
+  petsc_trace_PLB     = NULL;
+  petsc_trace_PLE     = NULL;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscLogTraceJSONBegin - Turns on the recording of a timeline of the events of every process, written in the
+  Chrome Trace Event format by PetscLogTraceJSONDump()
+
+  Collective on PETSC_COMM_WORLD
+
+  Input Parameter:
+. size - the number of event beginnings and ends kept on each process, or PETSC_DEFAULT
+
+  Options Database Keys:
++ -log_trace_json [filename] - Traces the events and writes the trace to filename (default trace.json) in PetscFinalize()
+- -log_trace_json_size <size> - Number of records kept on each process
+
+  Notes:
+  Each beginning and end of an event stores its time and the flop and message counters of the process in a ring buffer,
+  when the buffer is full the oldest records are overwritten. The default size holds 100000 records, about 5 MB.
+
+  The logging handlers already installed, for example by -log_view, are still called.
+
+  Level: advanced
+
+.keywords: log, trace, timeline
+.seealso: PetscLogTraceJSONDump(), PetscLogTraceBegin(), PetscLogDefaultBegin(), PetscLogNestedBegin()
+@*/
+PetscErrorCode PetscLogTraceJSONBegin(PetscInt size)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (petsc_trace_records) PetscFunctionReturn(0);
+  if (size == PETSC_DEFAULT || size == PETSC_DECIDE) size = 100000;
+  if (size < 2) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Trace buffer must hold at least 2 records, not %D",size);
+  ierr = PetscMalloc1(size,&petsc_trace_records);CHKERRQ(ierr);
+  ierr = PetscRegisterFinalize(PetscLogTraceJSONDestroy);CHKERRQ(ierr);
+  petsc_trace_size = size;
+  petsc_trace_PLB  = PetscLogPLB;
+  petsc_trace_PLE  = PetscLogPLE;
+  ierr = PetscLogSet(PetscLogEventBeginTraceJSON,PetscLogEventEndTraceJSON);CHKERRQ(ierr);
+  /* The processes start their clocks together so that their timelines line up */
+  ierr = MPI_Barrier(PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscTime(&petsc_trace_start);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Appends formatted text to a growing buffer */
+static PetscErrorCode PetscTraceAppend(char **buf,size_t *len,size_t *cap,const char format[],...)
+{
+  PetscErrorCode ierr;
+  va_list        Argp;
+  size_t         n;
+  char           *nbuf;
+
+  PetscFunctionBegin;
+  while (PETSC_TRUE) {
+    if (*cap - *len > 1) {
+      va_start(Argp,format);
+      ierr = PetscVSNPrintf(*buf+*len,*cap-*len,format,NULL,Argp);CHKERRQ(ierr);
+      va_end(Argp);
+      ierr = PetscStrlen(*buf+*len,&n);CHKERRQ(ierr);
+      if (n < *cap - *len - 1) break; /* otherwise the text may have been truncated */
+    }
+    ierr = PetscMalloc1(2*(*cap)+4096,&nbuf);CHKERRQ(ierr);
+    ierr = PetscMemcpy(nbuf,*buf,*len);CHKERRQ(ierr);
+    ierr = PetscFree(*buf);CHKERRQ(ierr);
+    *buf = nbuf;
+    *cap = 2*(*cap)+4096;
+  }
+  *len += n;
+  PetscFunctionReturn(0);
+}
+
+/* Copies an event name as a JSON string, escaping the quotes, backslashes and control characters */
+static PetscErrorCode PetscTraceEscapeName(const char name[],char **escaped)
+{
+  PetscErrorCode ierr;
+  size_t         len,i,n = 0;
+  char           *e;
+
+  PetscFunctionBegin;
+  ierr = PetscStrlen(name,&len);CHKERRQ(ierr);
+  ierr = PetscMalloc1(6*len+1,&e);CHKERRQ(ierr);
+  for (i=0; i<len; i++) {
+    unsigned char c = (unsigned char)name[i];
+
+    if (c == '"' || c == '\\') {
+      e[n++] = '\\';
+      e[n++] = (char)c;
+    } else if (c < 0x20) {
+      ierr = PetscSNPrintf(e+n,7,"\\u%04x",(unsigned int)c);CHKERRQ(ierr);
+      n   += 6;
+    } else e[n++] = (char)c;
+  }
+  e[n]     = 0;
+  *escaped = e;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscLogTraceJSONDump - Writes the events recorded since PetscLogTraceJSONBegin() in the Chrome Trace Event format
+
+  Collective on PETSC_COMM_WORLD
+
+  Input Parameter:
+. filename - the name of the file, written by the first process
+
+  Notes:
+  The file can be loaded in chrome://tracing or https://ui.perfetto.dev, where each process is a row of nested events.
+  The end of each event carries the flops, messages, message bytes and reductions of the process during the event as
+  arguments. Ends whose beginning was overwritten in the ring buffer are dropped.
+
+  Level: advanced
+
+.keywords: log, trace, timeline
+.seealso: PetscLogTraceJSONBegin(), PetscLogDump()
+@*/
+PetscErrorCode PetscLogTraceJSONDump(const char filename[])
+{
+  PetscErrorCode   ierr;
+  PetscStageLog    stageLog;
+  PetscEventRegLog eventRegLog;
+  PetscMPIInt      rank,size,r,n,tag;
+  PetscInt         k,nrec,first,nstack = 0,*stack,ndropped = 0;
+  MPI_Comm         comm;
+  char             *buf = NULL,**names;
+  size_t           len = 0,cap = 0;
+  FILE             *fd;
+
+  PetscFunctionBegin;
+  if (!petsc_trace_records) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call PetscLogTraceJSONBegin() first");
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscLogGetStageLog(&stageLog);CHKERRQ(ierr);
+  ierr = PetscStageLogGetEventRegLog(stageLog,&eventRegLog);CHKERRQ(ierr);
+
+  /* Events of the process, in chronological order; the first process does not start its part with a separator */
+  ierr = PetscTraceAppend(&buf,&len,&cap,"%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"rank %d\"}}",rank ? ",\n" : "",rank,rank);CHKERRQ(ierr);
+  ierr = PetscTraceAppend(&buf,&len,&cap,",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"sort_index\":%d}}",rank,rank);CHKERRQ(ierr);
+  nrec  = petsc_trace_wrapped ? petsc_trace_size : petsc_trace_next;
+  first = petsc_trace_wrapped ? petsc_trace_next : 0;
+  ierr  = PetscMalloc1(nrec,&stack);CHKERRQ(ierr);
+  ierr  = PetscCalloc1(eventRegLog->numEvents,&names);CHKERRQ(ierr);
+  for (k=0; k<nrec; k++) {
+    const PetscTraceRecord *rec = &petsc_trace_records[(first + k) % petsc_trace_size],*beg;
+    const char             *name;
+
+    if (!names[rec->event]) {ierr = PetscTraceEscapeName(eventRegLog->eventInfo[rec->event].name,&names[rec->event]);CHKERRQ(ierr);}
+    name = names[rec->event];
+    if (rec->begin) {
+      stack[nstack++] = (first + k) % petsc_trace_size;
+      ierr = PetscTraceAppend(&buf,&len,&cap,",\n{\"name\":\"%s\",\"cat\":\"PETSc\",\"ph\":\"B\",\"pid\":%d,\"tid\":0,\"ts\":%.3f}",name,rank,1.e6*(rec->time - petsc_trace_start));CHKERRQ(ierr);
+    } else if (nstack && petsc_trace_records[stack[nstack-1]].event == rec->event) {
+      beg  = &petsc_trace_records[stack[--nstack]];
+      ierr = PetscTraceAppend(&buf,&len,&cap,",\n{\"name\":\"%s\",\"cat\":\"PETSc\",\"ph\":\"E\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"args\":{\"flops\":%.0f,\"messages\":%.0f,\"message_bytes\":%.0f,\"reductions\":%.0f}}",
+                              name,rank,1.e6*(rec->time - petsc_trace_start),rec->flops - beg->flops,rec->messages - beg->messages,rec->bytes - beg->bytes,rec->reductions - beg->reductions);CHKERRQ(ierr);
+    } else ndropped++;
+  }
+  ierr = PetscFree(stack);CHKERRQ(ierr);
+  for (k=0; k<eventRegLog->numEvents; k++) {ierr = PetscFree(names[k]);CHKERRQ(ierr);}
+  ierr = PetscFree(names);CHKERRQ(ierr);
+  if (ndropped) {ierr = PetscInfo1(NULL,"Dropped %D event ends whose beginning was overwritten in the trace buffer\n",ndropped);CHKERRQ(ierr);}
+
+  /* The first process writes its part and then those of the others, one at a time; the parts are sent on the inner
+     communicator of PETSc so that they cannot match messages of the application */
+  ierr = PetscCommDuplicate(PETSC_COMM_WORLD,&comm,&tag);CHKERRQ(ierr);
+  ierr = PetscFOpen(PETSC_COMM_WORLD,filename,"w",&fd);CHKERRQ(ierr);
+  if (!rank) {
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");CHKERRQ(ierr);
+    if (fwrite(buf,1,len,fd) != len) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Unable to write trace file");
+    for (r=1; r<size; r++) {
+      ierr = MPI_Recv(&n,1,MPI_INT,r,tag,comm,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+      if ((size_t)n > cap) {
+        ierr = PetscFree(buf);CHKERRQ(ierr);
+        ierr = PetscMalloc1(n,&buf);CHKERRQ(ierr);
+        cap  = n;
+      }
+      ierr = MPI_Recv(buf,n,MPI_CHAR,r,tag,comm,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+      if (fwrite(buf,1,n,fd) != (size_t)n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_WRITE,"Unable to write trace file");
+    }
+    ierr = PetscFPrintf(PETSC_COMM_SELF,fd,"\n]}\n");CHKERRQ(ierr);
+  } else {
+    ierr = PetscMPIIntCast((PetscInt)len,&n);CHKERRQ(ierr);
+    ierr = MPI_Send(&n,1,MPI_INT,0,tag,comm);CHKERRQ(ierr);
+    ierr = MPI_Send(buf,n,MPI_CHAR,0,tag,comm);CHKERRQ(ierr);
+  }
+  ierr = PetscFClose(PETSC_COMM_WORLD,fd);CHKERRQ(ierr);
+  ierr = PetscCommDestroy(&comm);CHKERRQ(ierr);
+  ierr = PetscFree(buf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#endif
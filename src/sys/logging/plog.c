@@ -1245,6 +1245,70 @@ static PetscErrorCode PetscLogViewWarnDebugging(MPI_Comm comm,FILE *fd)
 #endif
 }
 
+/* Reports the hardware counters of the same stages and events as the event table */
+static PetscErrorCode PetscLogViewHWCounters(MPI_Comm comm,FILE *fd,PetscStageLog stageLog,int numStages,const PetscBool localStageUsed[],const PetscBool stageVisible[])
+{
+  PetscEventPerfInfo *eventInfo = NULL;
+  PetscLogDouble     loc[3],tot[3],zero[3] = {0.0,0.0,0.0},maxt,ipc,gbs;
+  PetscMPIInt        active,minactive,requested,maxrequested,maxC;
+  int                stage,localNumEvents,numEvents;
+  PetscLogEvent      event;
+  const char         *name;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  active    = petsc_log_hwcounters ? 1 : 0;
+  requested = (active || petsc_log_hwcounters_error[0]) ? 1 : 0;
+  ierr = MPI_Allreduce(&requested,&maxrequested,1,MPI_INT,MPI_MAX,comm);CHKERRQ(ierr);
+  if (!maxrequested) PetscFunctionReturn(0);
+  ierr = MPI_Allreduce(&active,&minactive,1,MPI_INT,MPI_MIN,comm);CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm, fd, "------------------------------------------------------------------------------------------------------------------------\n");CHKERRQ(ierr);
+  if (!minactive) {
+    ierr = PetscFPrintf(comm, fd, "Hardware counters are not available on all processors: %s\n",petsc_log_hwcounters_error[0] ? petsc_log_hwcounters_error : "see -info");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscFPrintf(comm, fd, "Hardware counters of the events, summed over all processors (user mode, main thread of each process):\n");CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm, fd, "   Only the thread that called PetscInitialize() is counted: the work of OpenMP or other threads is missing\n");CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm, fd, "   IPC: instructions per cycle\n");CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm, fd, "   GB/s: last level cache misses times the %d byte line size over the max time, a lower bound of the memory bandwidth\n",(int)petsc_log_hwcounters_linesize);CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm, fd, "%-16s %11s %11s %6s %11s %7s\n", "Event", "Cycles", "Instr", "IPC", "LLC Misses", "GB/s");CHKERRQ(ierr);
+  ierr = PetscFPrintf(comm, fd, "------------------------------------------------------------------------------------------------------------------------\n");CHKERRQ(ierr);
+  for (stage = 0; stage < numStages; stage++) {
+    if (!stageVisible[stage]) continue;
+    if (localStageUsed[stage]) {
+      ierr = PetscFPrintf(comm, fd, "\n--- Event Stage %d: %s\n\n", stage, stageLog->stageInfo[stage].name);CHKERRQ(ierr);
+      eventInfo      = stageLog->stageInfo[stage].eventLog->eventInfo;
+      localNumEvents = stageLog->stageInfo[stage].eventLog->numEvents;
+    } else {
+      ierr = PetscFPrintf(comm, fd, "\n--- Event Stage %d: Unknown\n\n", stage);CHKERRQ(ierr);
+      localNumEvents = 0;
+    }
+    ierr = MPI_Allreduce(&localNumEvents, &numEvents, 1, MPI_INT, MPI_MAX, comm);CHKERRQ(ierr);
+    for (event = 0; event < numEvents; event++) {
+      if (localStageUsed[stage] && (event < localNumEvents) && (eventInfo[event].depth == 0)) {
+        loc[0] = eventInfo[event].cycles;
+        loc[1] = eventInfo[event].instructions;
+        loc[2] = eventInfo[event].cacheMisses;
+        ierr = MPI_Allreduce(loc,                     tot,   3, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+        ierr = MPI_Allreduce(&eventInfo[event].time,  &maxt, 1, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm);CHKERRQ(ierr);
+        ierr = MPI_Allreduce(&eventInfo[event].count, &maxC, 1, MPI_INT,             MPI_MAX, comm);CHKERRQ(ierr);
+        name = stageLog->eventLog->eventInfo[event].name;
+      } else {
+        ierr = MPI_Allreduce(zero,                    tot,   3, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+        ierr = MPI_Allreduce(&zero[0],                &maxt, 1, MPIU_PETSCLOGDOUBLE, MPI_MAX, comm);CHKERRQ(ierr);
+        ierr = MPI_Allreduce(&ierr,                   &maxC, 1, MPI_INT,             MPI_MAX, comm);CHKERRQ(ierr);
+        name = "";
+      }
+      if (maxC != 0) {
+        if (tot[0] != 0.0) ipc = tot[1]/tot[0];                                 else ipc = 0.0;
+        if (maxt   != 0.0) gbs = tot[2]*petsc_log_hwcounters_linesize/maxt/1.0e9; else gbs = 0.0;
+        ierr = PetscFPrintf(comm, fd, "%-16s %11.4e %11.4e %6.2f %11.4e %7.2f\n", name, tot[0], tot[1], ipc, tot[2], gbs);CHKERRQ(ierr);
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
 {
   FILE               *fd;
@@ -1562,6 +1626,7 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
       }
     }
   }
+  ierr = PetscLogViewHWCounters(comm,fd,stageLog,numStages,localStageUsed,stageVisible);CHKERRQ(ierr);
 
   /* Memory usage and object creation */
   ierr = PetscFPrintf(comm, fd, "------------------------------------------------------------------------------------------------------------------------\n");CHKERRQ(ierr);
@@ -1684,7 +1749,8 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
 .  -log_view :filename.py:ascii_info_detail - Saves logging information from each process as a Python file
 .  -log_view :filename.xml:ascii_xml - Saves a summary of the logging information in a nested format (see below for how to view it)
 .  -log_all - Saves a file Log.rank for each MPI process with details of each step of the computation
--  -log_trace [filename] - Displays a trace of what each process is doing
+.  -log_trace [filename] - Displays a trace of what each process is doing
+-  -log_hw_counters - Adds the instructions per cycle and memory bandwidth of each event, see PetscLogHWCountersBegin()
 
   Notes:
   It is possible to control the logging programatically but we recommend using the options database approach whenever possible
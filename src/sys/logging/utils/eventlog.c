@@ -148,6 +148,9 @@ PetscErrorCode PetscEventPerfInfoClear(PetscEventPerfInfo *eventInfo)
   eventInfo->numMessages   = 0.0;
   eventInfo->messageLength = 0.0;
   eventInfo->numReductions = 0.0;
+  eventInfo->cycles        = 0.0;
+  eventInfo->instructions  = 0.0;
+  eventInfo->cacheMisses   = 0.0;
   PetscFunctionReturn(0);
 }
 
@@ -640,6 +643,14 @@ PetscErrorCode PetscLogEventBeginDefault(PetscLogEvent event,int t,PetscObject o
   eventLog->eventInfo[event].numMessages   -= petsc_irecv_ct  + petsc_isend_ct  + petsc_recv_ct  + petsc_send_ct;
   eventLog->eventInfo[event].messageLength -= petsc_irecv_len + petsc_isend_len + petsc_recv_len + petsc_send_len;
   eventLog->eventInfo[event].numReductions -= petsc_allreduce_ct + petsc_gather_ct + petsc_scatter_ct;
+  if (petsc_log_hwcounters) {
+    PetscLogDouble cycles,instructions,misses;
+
+    ierr = PetscLogHWCountersRead(&cycles,&instructions,&misses);CHKERRQ(ierr);
+    eventLog->eventInfo[event].cycles       -= cycles;
+    eventLog->eventInfo[event].instructions -= instructions;
+    eventLog->eventInfo[event].cacheMisses  -= misses;
+  }
   PetscFunctionReturn(0);
 }
 
@@ -668,6 +679,14 @@ PetscErrorCode PetscLogEventEndDefault(PetscLogEvent event,int t,PetscObject o1,
   eventLog->eventInfo[event].numMessages   += petsc_irecv_ct  + petsc_isend_ct  + petsc_recv_ct  + petsc_send_ct;
   eventLog->eventInfo[event].messageLength += petsc_irecv_len + petsc_isend_len + petsc_recv_len + petsc_send_len;
   eventLog->eventInfo[event].numReductions += petsc_allreduce_ct + petsc_gather_ct + petsc_scatter_ct;
+  if (petsc_log_hwcounters) {
+    PetscLogDouble cycles,instructions,misses;
+
+    ierr = PetscLogHWCountersRead(&cycles,&instructions,&misses);CHKERRQ(ierr);
+    eventLog->eventInfo[event].cycles       += cycles;
+    eventLog->eventInfo[event].instructions += instructions;
+    eventLog->eventInfo[event].cacheMisses  += misses;
+  }
   PetscFunctionReturn(0);
 }
 
@@ -0,0 +1,157 @@
+
+/*
+     Hardware performance counters of each event, read through the Linux perf_event_open() interface.
+
+   The counters are opened once as a group, so they are scheduled together on the processor, and the whole group is read
+   with one system call at the beginning and at the end of each event by PetscLogEventBeginDefault() and
+   PetscLogEventEndDefault().
+*/
+#include <petsc/private/logimpl.h>  /*I    "petscsys.h"   I*/
+
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+PetscBool      petsc_log_hwcounters            = PETSC_FALSE; /* the counters are open and read by the events */
+char           petsc_log_hwcounters_error[256] = "";          /* why they could not be opened */
+PetscLogDouble petsc_log_hwcounters_linesize   = PETSC_LEVEL1_DCACHE_LINESIZE;
+
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H) && defined(__NR_perf_event_open)
+#define PETSC_LOG_NUM_HWCOUNTERS 3
+static int petsc_hwcounters_fd[PETSC_LOG_NUM_HWCOUNTERS] = {-1,-1,-1};
+
+/* The layout of read() on the group leader with PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING */
+typedef struct {
+  __u64 nr;
+  __u64 enabled,running;
+  __u64 values[PETSC_LOG_NUM_HWCOUNTERS];
+} PetscHWCountersGroup;
+
+static PetscErrorCode PetscLogHWCountersEnd(void)
+{
+  int i;
+
+  PetscFunctionBegin;
+  for (i=PETSC_LOG_NUM_HWCOUNTERS-1; i>=0; i--) {
+    if (petsc_hwcounters_fd[i] >= 0) close(petsc_hwcounters_fd[i]);
+    petsc_hwcounters_fd[i] = -1;
+  }
+  petsc_log_hwcounters = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+#endif
+
+/*@C
+  PetscLogHWCountersBegin - Turns on the collection of hardware performance counters for each event logged by
+  PetscLogDefaultBegin(), which -log_view reports as instructions per cycle and achieved memory bandwidth
+
+  Not Collective
+
+  Options Database Key:
+. -log_hw_counters - Collect the counters, to be used with -log_view
+
+  Notes:
+  The processor cycles, the completed instructions and the last level cache misses of the calling thread in user mode are
+  counted with the Linux perf_event_open() system call. The memory bandwidth is estimated as the number of cache misses
+  times the cache line size, it ignores the traffic of the hardware prefetchers and of the write backs so it is a lower
+  bound of the actual bandwidth.
+  The counters are not inherited by the threads the calling thread creates, so the work of OpenMP threads is missing
+  from the counts and the events with threaded kernels are undercounted.
+
+  If the counters cannot be opened, because PETSc was not configured on Linux, the processor exposes no performance
+  monitoring unit (as in many virtual machines) or /proc/sys/kernel/perf_event_paranoid forbids it, the events are
+  logged without them and -log_view says why.
+
+  Call it before the events to be measured begin, PetscInitialize() does so with -log_hw_counters. Only the events
+  logged by PetscLogDefaultBegin() collect the counters, not the nested -log_view :file.xml:ascii_xml
+  format. Reading the counters is a system call, about a microsecond, at the beginning and end of each event.
+
+  Level: advanced
+
+.keywords: log, hardware, counters, bandwidth
+.seealso: PetscLogDefaultBegin(), PetscLogView(), PetscLogEventGetPerfInfo()
+@*/
+PetscErrorCode PetscLogHWCountersBegin(void)
+{
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H) && defined(__NR_perf_event_open)
+  struct perf_event_attr attr;
+  const __u64            config[PETSC_LOG_NUM_HWCOUNTERS] = {PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS,PERF_COUNT_HW_CACHE_MISSES};
+  const char             *names[PETSC_LOG_NUM_HWCOUNTERS] = {"cycles","instructions","cache misses"};
+  int                    i;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  if (petsc_log_hwcounters) PetscFunctionReturn(0);
+  for (i=0; i<PETSC_LOG_NUM_HWCOUNTERS; i++) {
+    ierr = PetscMemzero(&attr,sizeof(attr));CHKERRQ(ierr);
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = config[i];
+    attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.disabled       = i ? 0 : 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    petsc_hwcounters_fd[i] = (int)syscall(__NR_perf_event_open,&attr,0,-1,i ? petsc_hwcounters_fd[0] : -1,0);
+    if (petsc_hwcounters_fd[i] < 0) {
+      ierr = PetscSNPrintf(petsc_log_hwcounters_error,sizeof(petsc_log_hwcounters_error),"perf_event_open() of the %s counter failed: %s",names[i],strerror(errno));CHKERRQ(ierr);
+      ierr = PetscInfo1(NULL,"%s\n",petsc_log_hwcounters_error);CHKERRQ(ierr);
+      ierr = PetscLogHWCountersEnd();CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+  }
+  if (ioctl(petsc_hwcounters_fd[0],PERF_EVENT_IOC_ENABLE,PERF_IOC_FLAG_GROUP) < 0) {
+    ierr = PetscSNPrintf(petsc_log_hwcounters_error,sizeof(petsc_log_hwcounters_error),"Enabling the hardware counters failed: %s",strerror(errno));CHKERRQ(ierr);
+    ierr = PetscInfo1(NULL,"%s\n",petsc_log_hwcounters_error);CHKERRQ(ierr);
+    ierr = PetscLogHWCountersEnd();CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#if defined(_SC_LEVEL3_CACHE_LINESIZE)
+  {
+    long linesize = sysconf(_SC_LEVEL3_CACHE_LINESIZE);
+    if (linesize > 0) petsc_log_hwcounters_linesize = (PetscLogDouble)linesize;
+  }
+#endif
+  ierr = PetscRegisterFinalize(PetscLogHWCountersEnd);CHKERRQ(ierr);
+  petsc_log_hwcounters          = PETSC_TRUE;
+  petsc_log_hwcounters_error[0] = 0;
+  ierr = PetscInfo1(NULL,"Collecting hardware counters of the events, cache line size %d bytes\n",(int)petsc_log_hwcounters_linesize);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#else
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscStrncpy(petsc_log_hwcounters_error,"PETSc was configured without linux/perf_event.h",sizeof(petsc_log_hwcounters_error));CHKERRQ(ierr);
+  ierr = PetscInfo1(NULL,"%s\n",petsc_log_hwcounters_error);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#endif
+}
+
+/*
+  PetscLogHWCountersRead - Reads the cumulative cycles, instructions and last level cache misses of the calling thread,
+  scaled up if the kernel had to multiplex the counters with others
+*/
+PetscErrorCode PetscLogHWCountersRead(PetscLogDouble *cycles,PetscLogDouble *instructions,PetscLogDouble *misses)
+{
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H) && defined(__NR_perf_event_open)
+  PetscHWCountersGroup group;
+  PetscLogDouble       scale = 1.0;
+  ssize_t              n;
+
+  PetscFunctionBegin;
+  n = read(petsc_hwcounters_fd[0],&group,sizeof(group));
+  if (n != (ssize_t)sizeof(group)) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SYS,"Reading the hardware counters returned %d bytes",(int)n);
+  if (group.running && group.running < group.enabled) scale = (PetscLogDouble)group.enabled/(PetscLogDouble)group.running;
+  *cycles       = scale*(PetscLogDouble)group.values[0];
+  *instructions = scale*(PetscLogDouble)group.values[1];
+  *misses       = scale*(PetscLogDouble)group.values[2];
+  PetscFunctionReturn(0);
+#else
+  PetscFunctionBegin;
+  SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP_SYS,"Hardware counters need linux/perf_event.h");
+  PetscFunctionReturn(0);
+#endif
+}
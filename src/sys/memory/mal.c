@@ -181,6 +181,7 @@ PetscErrorCode (*PetscTrRealloc)(size_t,int,const char[],const char[],void**) =
 
 PETSC_INTERN PetscBool petscsetmallocvisited;
 PetscBool petscsetmallocvisited = PETSC_FALSE;
+PETSC_INTERN PetscErrorCode PetscMallocPoolClear_Private(PetscBool*);
 
 /*@C
    PetscMallocSet - Sets the routines used to do mallocs and frees.
@@ -223,10 +224,18 @@ PetscErrorCode PetscMallocSet(PetscErrorCode (*imalloc)(size_t,int,const char[],
     free() settings for different parts; this is because one NEVER wants to
     free() an address that was malloced by a different memory management system
 
+    With -malloc_pool the pool routines are kept while blocks obtained from the pool are still in use,
+    since only they can free those blocks
+
 @*/
 PetscErrorCode PetscMallocClear(void)
 {
+  PetscErrorCode ierr;
+  PetscBool      poolinuse;
+
   PetscFunctionBegin;
+  ierr = PetscMallocPoolClear_Private(&poolinuse);CHKERRQ(ierr);
+  if (poolinuse) PetscFunctionReturn(0); /* blocks still held by the caller can only be freed by the -malloc_pool routines */
   PetscTrMalloc         = PetscMallocAlign;
   PetscTrFree           = PetscFreeAlign;
   petscsetmallocvisited = PETSC_FALSE;
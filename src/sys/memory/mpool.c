@@ -0,0 +1,265 @@
+/*
+     A size-class pool in front of PetscMallocAlign(). Freed blocks are kept on a free list for their
+  size class and handed out again by later mallocs of the same class, so the many small, short lived
+  allocations done during setup (index sets, scatters, hash tables, work arrays) do not all go to the system.
+*/
+#include <petscsys.h>             /*I   "petscsys.h"   I*/
+#include <petscviewer.h>
+
+/*
+   These are defined in mal.c and ensure that malloced space is PetscScalar aligned
+*/
+PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t,int,const char[],const char[],void**);
+PETSC_EXTERN PetscErrorCode PetscFreeAlign(void*,int,const char[],const char[]);
+PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t,int,const char[],const char[],void**);
+
+#define POOL_CLASSID   ((PetscClassId) 0x0d0e0f0a)
+#define POOL_MINSHIFT  6                        /* the smallest class holds 64 bytes */
+#define POOL_NCLASSES  17                       /* the largest class holds 4 MiB; larger requests bypass the pool */
+#define POOL_MAXCACHED ((size_t)256 << 20)      /* at most this many bytes are kept on the free lists */
+
+typedef struct _n_PoolBlock {
+  size_t              size;                     /* bytes requested by the caller */
+  int                 cls;                      /* size class, or -1 if the block bypassed the pool */
+  PetscClassId        classid;
+  struct _n_PoolBlock *next;                    /* next block on the free list of the class */
+} PoolBlock;
+
+/* the header is padded so that the space returned to the caller keeps an alignment of PETSC_MEMALIGN */
+#define POOL_HEADER_BYTES ((sizeof(PoolBlock)+(PETSC_MEMALIGN-1)) & ~(PETSC_MEMALIGN-1))
+
+typedef struct {
+  PoolBlock *freelist[POOL_NCLASSES];
+  size_t    ncached[POOL_NCLASSES];
+  size_t    hits,misses,bypasses;               /* mallocs served from a free list, from the system within a class, and above the classes */
+  size_t    requested,maxrequested;             /* bytes the caller asked for that are currently in use */
+  size_t    held;                               /* bytes of the classes (or bypass blocks) that are currently in use */
+  size_t    cached;                             /* bytes sitting on the free lists */
+  PetscBool draining;                           /* set by PetscMallocPoolClear_Private(), freed blocks then go back to the system */
+} PetscMallocPool;
+
+static PetscMallocPool pool;
+static PetscBool       poolactive = PETSC_FALSE;
+
+/*
+   The free lists and the statistics are shared by all the threads, so with OpenMP they are only touched while
+   holding poollock. The system malloc() and free() are called outside of it.
+*/
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+static omp_lock_t poollock;
+#define PoolLockCreate()  omp_init_lock(&poollock)
+#define PoolLockDestroy() omp_destroy_lock(&poollock)
+#define PoolLock()        omp_set_lock(&poollock)
+#define PoolUnlock()      omp_unset_lock(&poollock)
+#else
+#define PoolLockCreate()
+#define PoolLockDestroy()
+#define PoolLock()
+#define PoolUnlock()
+#endif
+
+PETSC_STATIC_INLINE size_t PoolClassSize(int cls) {return ((size_t)1) << (cls + POOL_MINSHIFT);}
+
+PETSC_STATIC_INLINE int PoolClass(size_t a)
+{
+  int cls = 0;
+  while (cls < POOL_NCLASSES && PoolClassSize(cls) < a) cls++;
+  return cls < POOL_NCLASSES ? cls : -1;
+}
+
+/*
+   PetscPoolMalloc - Returns space from the free list of the size class of a, getting a new block
+   with PetscMallocAlign() if the list is empty.
+
+   Input Parameters:
+   +   a   - number of bytes to allocate
+   .   lineno - line number where used
+   .   function - function calling routine
+   -   filename  - file name where used
+
+   Returns:
+   double aligned pointer to requested storage, or null if not
+   available.
+*/
+static PetscErrorCode PetscPoolMalloc(size_t a,int lineno,const char function[],const char filename[],void **result)
+{
+  PetscErrorCode ierr;
+  PoolBlock      *head = NULL;
+  int            cls;
+
+  if (!a) {*result = NULL; return 0;}
+  cls = PoolClass(a);
+  PoolLock();
+  if (cls >= 0 && pool.freelist[cls]) {
+    head                 = pool.freelist[cls];
+    pool.freelist[cls]   = head->next;
+    pool.ncached[cls]--;
+    pool.cached         -= PoolClassSize(cls);
+    pool.hits++;
+  } else if (cls >= 0) pool.misses++;
+  else pool.bypasses++;
+  pool.requested    += a;
+  pool.maxrequested  = PetscMax(pool.maxrequested,pool.requested);
+  pool.held         += cls >= 0 ? PoolClassSize(cls) : a;
+  PoolUnlock();
+  if (!head) {
+    ierr = PetscMallocAlign((cls >= 0 ? PoolClassSize(cls) : a)+POOL_HEADER_BYTES,lineno,function,filename,(void**)&head);if (ierr) return ierr;
+  }
+  head->size    = a;
+  head->cls     = cls;
+  head->classid = POOL_CLASSID;
+  head->next    = NULL;
+  *result       = (void*)(((char*)head) + POOL_HEADER_BYTES);
+  return 0;
+}
+
+static PetscErrorCode PetscPoolFree(void *aa,int lineno,const char function[],const char filename[])
+{
+  PoolBlock *head;
+  size_t    csize;
+  PetscBool keep = PETSC_FALSE;
+
+  if (!aa) return 0;
+  head = (PoolBlock*)(((char*)aa) - POOL_HEADER_BYTES);
+  if (head->classid != POOL_CLASSID) return PetscError(PETSC_COMM_SELF,lineno,function,filename,PETSC_ERR_MEMC,PETSC_ERROR_INITIAL,"Freeing memory that was not obtained from the -malloc_pool allocator, or was already freed");
+  head->classid = 0;
+  csize         = head->cls >= 0 ? PoolClassSize(head->cls) : head->size;
+  PoolLock();
+  pool.requested -= head->size;
+  pool.held      -= csize;
+  if (head->cls >= 0 && !pool.draining && pool.cached + csize <= POOL_MAXCACHED) {
+    head->next               = pool.freelist[head->cls];
+    pool.freelist[head->cls] = head;
+    pool.ncached[head->cls]++;
+    pool.cached             += csize;
+    keep                     = PETSC_TRUE;
+  }
+  PoolUnlock();
+  if (!keep) return PetscFreeAlign(head,lineno,function,filename);
+  return 0;
+}
+
+static PetscErrorCode PetscPoolRealloc(size_t a,int lineno,const char function[],const char filename[],void **result)
+{
+  PetscErrorCode ierr;
+  PoolBlock      *head;
+  void           *newresult;
+
+  if (!a) {
+    ierr = PetscPoolFree(*result,lineno,function,filename);if (ierr) return ierr;
+    *result = NULL;
+    return 0;
+  }
+  if (!*result) return PetscPoolMalloc(a,lineno,function,filename,result);
+  head = (PoolBlock*)(((char*)*result) - POOL_HEADER_BYTES);
+  if (head->classid != POOL_CLASSID) return PetscError(PETSC_COMM_SELF,lineno,function,filename,PETSC_ERR_MEMC,PETSC_ERROR_INITIAL,"Reallocating memory that was not obtained from the -malloc_pool allocator, or was already freed");
+  /* the block already has room for the new size */
+  if (head->cls >= 0 && a <= PoolClassSize(head->cls)) {
+    PoolLock();
+    pool.requested    = pool.requested - head->size + a;
+    pool.maxrequested = PetscMax(pool.maxrequested,pool.requested);
+    PoolUnlock();
+    head->size        = a;
+    return 0;
+  }
+  ierr = PetscPoolMalloc(a,lineno,function,filename,&newresult);if (ierr) return ierr;
+  ierr = PetscMemcpy(newresult,*result,PetscMin(a,head->size));if (ierr) return ierr;
+  ierr = PetscPoolFree(*result,lineno,function,filename);if (ierr) return ierr;
+  *result = newresult;
+  return 0;
+}
+
+PETSC_INTERN PetscErrorCode PetscSetUsePoolMalloc_Private(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMallocSet(PetscPoolMalloc,PetscPoolFree);CHKERRQ(ierr);
+  PetscTrRealloc = PetscPoolRealloc;
+  ierr = PetscMemzero(&pool,sizeof(pool));CHKERRQ(ierr);
+  PoolLockCreate();
+  poolactive = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscMallocPoolClear_Private - Returns the blocks on the free lists to the system; called from PetscMallocClear()
+
+   Output Parameter:
+.  inuse - PETSC_TRUE if some blocks obtained from the pool have not been freed yet. They carry the pool header, so
+           the pool routines must stay installed to free them; the pool then stops caching and returns every block
+           freed later to the system.
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPoolClear_Private(PetscBool *inuse)
+{
+  PetscErrorCode ierr;
+  PoolBlock      *head;
+  int            cls;
+
+  PetscFunctionBegin;
+  *inuse = PETSC_FALSE;
+  if (!poolactive) PetscFunctionReturn(0);
+  PoolLock();
+  pool.draining = PETSC_TRUE;
+  PoolUnlock();
+  for (cls=0; cls<POOL_NCLASSES; cls++) {
+    while ((head = pool.freelist[cls])) {
+      pool.freelist[cls] = head->next;
+      ierr = PetscFreeAlign(head,__LINE__,PETSC_FUNCTION_NAME,__FILE__);CHKERRQ(ierr);
+    }
+    pool.ncached[cls] = 0;
+  }
+  pool.cached = 0;
+  if (pool.held) {*inuse = PETSC_TRUE; PetscFunctionReturn(0);}
+  PetscTrRealloc = PetscReallocAlign;
+  PoolLockDestroy();
+  poolactive     = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscMallocPoolGetUsage_Private - The current and maximum number of bytes PetscMalloc()ed through the pool
+
+   Output Parameters:
++  active - PETSC_TRUE if -malloc_pool is in use; the other outputs are only set in that case
+.  current - bytes currently requested by the callers
+-  max - maximum of current during the run
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPoolGetUsage_Private(PetscBool *active,PetscLogDouble *current,PetscLogDouble *max)
+{
+  PetscFunctionBegin;
+  *active = poolactive;
+  if (!poolactive) PetscFunctionReturn(0);
+  if (current) *current = (PetscLogDouble)pool.requested;
+  if (max)     *max     = (PetscLogDouble)pool.maxrequested;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscMallocPoolView_Private - Prints the hit rate and fragmentation of the pool, called from PetscMemoryView()
+
+   The hit rate is the fraction of the pooled mallocs served from a free list. The fragmentation is the fraction of
+   the memory owned by the pool (blocks in use plus blocks on the free lists) that is not holding requested bytes.
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPoolView_Private(PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  MPI_Comm       comm;
+  PetscLogDouble stats[3],gstats[3],gmax[2],gmin[2],owned;
+
+  PetscFunctionBegin;
+  if (!poolactive) PetscFunctionReturn(0);
+  ierr     = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  owned    = (PetscLogDouble)(pool.held + pool.cached);
+  stats[0] = (pool.hits + pool.misses) ? (PetscLogDouble)pool.hits/(PetscLogDouble)(pool.hits + pool.misses) : 0.0;
+  stats[1] = owned > 0.0 ? 1.0 - (PetscLogDouble)pool.requested/owned : 0.0;
+  stats[2] = (PetscLogDouble)pool.cached;
+  ierr = MPI_Reduce(stats,gstats,3,MPIU_PETSCLOGDOUBLE,MPI_SUM,0,comm);CHKERRQ(ierr);
+  ierr = MPI_Reduce(stats,gmax,2,MPIU_PETSCLOGDOUBLE,MPI_MAX,0,comm);CHKERRQ(ierr);
+  ierr = MPI_Reduce(stats,gmin,2,MPIU_PETSCLOGDOUBLE,MPI_MIN,0,comm);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"PetscMalloc() pool hit rate:                              max %5.4e min %5.4e\n",gmax[0],gmin[0]);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"PetscMalloc() pool fragmentation:                         max %5.4e min %5.4e\n",gmax[1],gmin[1]);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"Space held on the PetscMalloc() pool free lists:          total %5.4e\n",gstats[2]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
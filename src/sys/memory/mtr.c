@@ -19,6 +19,8 @@ PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t,int,const char[],const char
 PETSC_EXTERN PetscErrorCode PetscTrMallocDefault(size_t,int,const char[],const char[],void**);
 PETSC_EXTERN PetscErrorCode PetscTrFreeDefault(void*,int,const char[],const char[]);
 PETSC_EXTERN PetscErrorCode PetscTrReallocDefault(size_t,int,const char[],const char[],void**);
+PETSC_INTERN PetscErrorCode PetscMallocPoolGetUsage_Private(PetscBool*,PetscLogDouble*,PetscLogDouble*);
+PETSC_INTERN PetscErrorCode PetscMallocPoolView_Private(PetscViewer);
 
 
 #define CLASSID_VALUE  ((PetscClassId) 0xf0e0d0c9)
@@ -451,6 +453,7 @@ PetscErrorCode PetscTrReallocDefault(size_t len, int lineno, const char function
 
     Options Database:
 +    -malloc - have PETSc track how much memory it has allocated
+.    -malloc_pool - allocate through the size-class pool; its hit rate and fragmentation are then also shown
 -    -memory_view - during PetscFinalize() have this routine called
 
     Level: intermediate
@@ -521,6 +524,7 @@ PetscErrorCode  PetscMemoryView(PetscViewer viewer,const char message[])
   } else {
     ierr = PetscViewerASCIIPrintf(viewer,"Run with -malloc to get statistics on PetscMalloc() calls\nOS cannot compute process memory\n");CHKERRQ(ierr);
   }
+  ierr = PetscMallocPoolView_Private(viewer);CHKERRQ(ierr);
   ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -542,8 +546,12 @@ PetscErrorCode  PetscMemoryView(PetscViewer viewer,const char message[])
  @*/
 PetscErrorCode  PetscMallocGetCurrentUsage(PetscLogDouble *space)
 {
+  PetscErrorCode ierr;
+  PetscBool      pool;
+
   PetscFunctionBegin;
-  *space = (PetscLogDouble) TRallocated;
+  ierr = PetscMallocPoolGetUsage_Private(&pool,space,NULL);CHKERRQ(ierr);
+  if (!pool) *space = (PetscLogDouble) TRallocated;
   PetscFunctionReturn(0);
 }
 
@@ -565,8 +573,12 @@ PetscErrorCode  PetscMallocGetCurrentUsage(PetscLogDouble *space)
  @*/
 PetscErrorCode  PetscMallocGetMaximumUsage(PetscLogDouble *space)
 {
+  PetscErrorCode ierr;
+  PetscBool      pool;
+
   PetscFunctionBegin;
-  *space = (PetscLogDouble) TRMaxMem;
+  ierr = PetscMallocPoolGetUsage_Private(&pool,NULL,space);CHKERRQ(ierr);
+  if (!pool) *space = (PetscLogDouble) TRMaxMem;
   PetscFunctionReturn(0);
 }
 
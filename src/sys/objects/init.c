@@ -213,6 +213,7 @@ PetscErrorCode  PetscEnd(void)
 PetscBool PetscOptionsPublish = PETSC_FALSE;
 PETSC_INTERN PetscErrorCode PetscSetUseTrMalloc_Private(void);
 PETSC_INTERN PetscErrorCode PetscSetUseHBWMalloc_Private(void);
+PETSC_INTERN PetscErrorCode PetscSetUsePoolMalloc_Private(void);
 PETSC_INTERN PetscBool      petscsetmallocvisited;
 static       char           emacsmachinename[256];
 
@@ -252,7 +253,7 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
   PetscBool         flg1 = PETSC_FALSE,flg2 = PETSC_FALSE,flg3 = PETSC_FALSE,flag;
   PetscErrorCode    ierr;
   PetscReal         si;
-  PetscInt          intensity;
+  PetscInt          intensity,radixthreshold;
   int               i;
   PetscMPIInt       rank;
   char              version[256],helpoptions[256];
@@ -312,6 +313,10 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
   ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_hbw",&flg1,NULL);CHKERRQ(ierr);
   /* ignore this option if malloc is already set */
   if (flg1 && !petscsetmallocvisited) {ierr = PetscSetUseHBWMalloc_Private();CHKERRQ(ierr);}
+  flg1 = PETSC_FALSE;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_pool",&flg1,NULL);CHKERRQ(ierr);
+  /* ignore this option if malloc is already set; in debug builds use -malloc no -malloc_pool */
+  if (flg1 && !petscsetmallocvisited) {ierr = PetscSetUsePoolMalloc_Private();CHKERRQ(ierr);}
 
   flg1 = PETSC_FALSE;
   ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_info",&flg1,NULL);CHKERRQ(ierr);
@@ -404,6 +409,8 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
   if (flg1) {ierr = PetscSetFPTrap(PETSC_FP_TRAP_ON);CHKERRQ(ierr);}
   ierr = PetscOptionsGetInt(NULL,NULL,"-check_pointer_intensity",&intensity,&flag);CHKERRQ(ierr);
   if (flag) {ierr = PetscCheckPointerSetIntensity(intensity);CHKERRQ(ierr);}
+  ierr = PetscOptionsGetInt(NULL,NULL,"-sort_int_radix_threshold",&radixthreshold,&flag);CHKERRQ(ierr);
+  if (flag) {ierr = PetscSortIntSetRadixThreshold(radixthreshold);CHKERRQ(ierr);}
 
   /*
       Setup debugger information
@@ -538,6 +545,18 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     ierr = PetscOptionsGetReal(NULL,NULL,"-log_threshold",&threshold,&flg1);CHKERRQ(ierr);
     if (flg1) {ierr = PetscLogSetThreshold((PetscLogDouble)threshold,NULL);CHKERRQ(ierr);}
   }
+
+  flg1 = PETSC_FALSE;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-log_hw_counters",&flg1,NULL);CHKERRQ(ierr);
+  if (flg1) {ierr = PetscLogHWCountersBegin();CHKERRQ(ierr);}
+
+  /* After the other handlers, which keep being called while tracing */
+  ierr = PetscOptionsHasName(NULL,NULL,"-log_trace_json",&flg1);CHKERRQ(ierr);
+  if (flg1) {
+    PetscInt size = PETSC_DEFAULT;
+    ierr = PetscOptionsGetInt(NULL,NULL,"-log_trace_json_size",&size,NULL);CHKERRQ(ierr);
+    ierr = PetscLogTraceJSONBegin(size);CHKERRQ(ierr);
+  }
 #endif
 
   ierr = PetscOptionsGetBool(NULL,NULL,"-saws_options",&PetscOptionsPublish,NULL);CHKERRQ(ierr);
@@ -637,10 +656,12 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     ierr = (*PetscHelpPrintf)(comm," -mpi_return_on_error: MPI returns error code, rather than abort on internal error\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -fp_trap: stop on floating point exceptions\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm,"           note on IBM RS6000 this slows run greatly\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -sort_int_radix_threshold <n>: radix sort integer arrays of length n or more\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_dump <optional filename>: dump list of unfreed memory at conclusion\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc: use our error checking malloc\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc no: don't use error checking malloc\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_info: prints total memory usage\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_pool: keep freed blocks in size classes for reuse by later mallocs (with -malloc no in debug builds)\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_log: keeps log of all memory allocations\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_debug: enables extended checking for memory corruption\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_table: dump list of options inputted\n");CHKERRQ(ierr);
@@ -654,6 +675,9 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     ierr = (*PetscHelpPrintf)(comm," -get_total_flops: total flops over all processors\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -log_view [:filename:[format]]: logging objects and events\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -log_trace [filename]: prints trace of all PETSc calls\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_hw_counters: adds the instructions per cycle and memory bandwidth of each event to -log_view\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_trace_json [filename]: writes a timeline of the events of all processes for chrome://tracing\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -log_trace_json_size <size>: number of event beginnings and ends kept on each process\n");CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MPE)
     ierr = (*PetscHelpPrintf)(comm," -log_mpe: Also create logfile viewable through Jumpshot\n");CHKERRQ(ierr);
 #endif
@@ -0,0 +1,60 @@
+/*
+    Run time detection of the instruction set extensions used by the SIMD kernels of the Mat and Vec packages.
+*/
+#include <petsc/private/petscimpl.h>  /*I "petscsys.h" I*/
+
+const char *const PetscSIMDTypes[] = {"none","avx2","avx512","PetscSIMDType","PETSC_SIMD_",0};
+
+static PetscBool     PetscSIMDDetected = PETSC_FALSE;
+static PetscSIMDType PetscSIMDBest     = PETSC_SIMD_NONE;
+
+/*@C
+    PetscGetSIMDType - Determines the instruction set extensions that SIMD kernels should use
+
+    Not Collective
+
+    Input Parameter:
+.   option - name of the option that can lower the choice, for example "-mat_simd", or NULL
+
+    Output Parameter:
+.   type - PETSC_SIMD_AVX512, PETSC_SIMD_AVX2 or PETSC_SIMD_NONE
+
+    Notes:
+    The processor is queried when the program runs, not when PETSc is compiled, so a single PETSc build can use
+    AVX-512 kernels on the machines that support it and fall back to AVX2 or plain C kernels on the others. The
+    processor is only queried the first time, the packages call this once from their XXXInitializePackage().
+    A request for an instruction set the processor does not support is lowered to the best supported one.
+
+    Kernels compiled for a given instruction set are only available if the compiler supports __attribute((target())),
+    otherwise this always returns PETSC_SIMD_NONE.
+
+    Level: developer
+
+.seealso: MatGetSIMDType(), VecMultiSetTileSize()
+@*/
+PetscErrorCode PetscGetSIMDType(const char option[],PetscSIMDType *type)
+{
+  PetscErrorCode ierr;
+  PetscSIMDType  req;
+
+  PetscFunctionBegin;
+  PetscValidPointer(type,2);
+  if (!PetscSIMDDetected) {
+#if defined(PETSC_HAVE_ATTRIBUTE_TARGET) && defined(PETSC_HAVE_BUILTIN_CPU_SUPPORTS) && defined(PETSC_HAVE_IMMINTRIN_H)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd")) PetscSIMDBest = PETSC_SIMD_AVX512;
+    else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) PetscSIMDBest = PETSC_SIMD_AVX2;
+#endif
+    PetscSIMDDetected = PETSC_TRUE;
+  }
+  req = PetscSIMDBest;
+  if (option) {
+    ierr = PetscOptionsGetEnum(NULL,NULL,option,PetscSIMDTypes,(PetscEnum*)&req,NULL);CHKERRQ(ierr);
+    if (req > PetscSIMDBest) {
+      ierr = PetscInfo3(NULL,"%s %s kernels are not supported by this processor or compiler, using %s\n",option,PetscSIMDTypes[req],PetscSIMDTypes[PetscSIMDBest]);CHKERRQ(ierr);
+      req = PetscSIMDBest;
+    }
+  }
+  *type = req;
+  PetscFunctionReturn(0);
+}
@@ -19,6 +19,187 @@
 
 /* -----------------------------------------------------------------------*/
 
+/* arrays with at least this many entries are radix sorted; 0 means never */
+static PetscInt PetscSortIntRadixThreshold = 0;
+
+/*@
+   PetscSortIntSetRadixThreshold - Sets the length above which PetscSortInt(), PetscSortIntWithArray(),
+   PetscSortIntWithArrayPair(), PetscSortIntWithScalarArray() and PetscSortIntWithDataArray() use a radix sort
+   instead of quicksort.
+
+   Not Collective
+
+   Input Parameter:
+.  n - the smallest array length that is radix sorted, 0 to always use quicksort (the default)
+
+   Options Database Key:
+.  -sort_int_radix_threshold <n> - sets the threshold
+
+   Notes:
+   The radix sort is stable, needs a work array as long as the input and takes one pass over the data per byte
+   of the range of the values (largest minus smallest), so it is fastest for long arrays of indices that lie in a
+   narrow range, as when sorting the stashed rows or the column indices of a matrix. Input that is already sorted is
+   detected and left alone, and input made of at most 16 sorted runs (nearly sorted input, or sorted pieces put end to
+   end) is sorted by merging the runs, which takes at most four passes over the data whatever the range of the values.
+   Since quicksort is not stable, entries with equal keys may end up in a different order in the companion arrays.
+
+   Level: advanced
+
+   Concepts: sorting^ints
+
+.seealso: PetscSortInt(), PetscSortIntWithArray()
+@*/
+PetscErrorCode PetscSortIntSetRadixThreshold(PetscInt n)
+{
+  PetscFunctionBegin;
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Radix sort threshold %D cannot be negative",n);
+  PetscSortIntRadixThreshold = n;
+  PetscFunctionReturn(0);
+}
+
+#define PetscSortIntUseRadix(n) (PetscSortIntRadixThreshold && (n) >= PetscSortIntRadixThreshold)
+
+#define RADIX_BITS 8
+#define RADIX_SIZE (1<<RADIX_BITS)
+#define RADIX_DIGIT(a,min,shift) ((((a)-(min)) >> (shift)) & (RADIX_SIZE-1))
+
+/* input with at most this many nondecreasing runs is merged instead of radix sorted */
+#define SORT_MAX_RUNS 16
+
+/*
+   Stable bottom-up merge of the nruns nondecreasing runs of v[] that start at start[0] = 0 < start[1] < ..., with
+   start[nruns] = n, moving perm[] (if not NULL) along. Neighbouring runs are merged pairwise, so this takes
+   ceil(log2(nruns)) passes over the data. start[] is overwritten.
+*/
+static PetscErrorCode PetscSortIntMergeRuns_Private(PetscInt n,PetscInt v[],PetscInt perm[],PetscInt nruns,PetscInt start[])
+{
+  PetscErrorCode ierr;
+  PetscInt       r,m,i,j,k,mid,end;
+  PetscInt       *vw,*pw,*v1 = v,*v2,*p1 = perm,*p2,*t;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc2(n,&vw,perm ? n : 0,&pw);CHKERRQ(ierr);
+  v2 = vw; p2 = pw;
+  while (nruns > 1) {
+    for (r=0,m=0; r<nruns; r+=2,m++) {
+      k   = start[r];
+      mid = start[r+1];
+      end = r+1 < nruns ? start[r+2] : mid;
+      for (i=k,j=mid; i<mid && j<end; k++) {
+        if (v1[j] < v1[i]) {v2[k] = v1[j]; if (p1) p2[k] = p1[j]; j++;}
+        else               {v2[k] = v1[i]; if (p1) p2[k] = p1[i]; i++;}
+      }
+      for (; i<mid; i++,k++) {v2[k] = v1[i]; if (p1) p2[k] = p1[i];}
+      for (; j<end; j++,k++) {v2[k] = v1[j]; if (p1) p2[k] = p1[j];}
+      start[m] = start[r];
+    }
+    start[m] = n;
+    nruns    = m;
+    t = v1; v1 = v2; v2 = t;
+    if (p1) {t = p1; p1 = p2; p2 = t;}
+  }
+  if (v1 != v) {
+    ierr = PetscMemcpy(v,v1,n*sizeof(PetscInt));CHKERRQ(ierr);
+    if (perm) {ierr = PetscMemcpy(perm,p1,n*sizeof(PetscInt));CHKERRQ(ierr);}
+  }
+  ierr = PetscFree2(vw,pw);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Stable sort of v[], moving perm[] (if not NULL) along. Input made of at most SORT_MAX_RUNS nondecreasing runs is
+   merged; anything else gets an LSD radix sort on the bytes of v[i]-min. Bytes that are the same for all entries are
+   skipped, so the number of radix passes depends on the range of the values and not on the width of PetscInt. Sets
+   *sorted to PETSC_FALSE and does nothing when the range does not fit in a PetscInt.
+*/
+static PetscErrorCode PetscSortIntRadix_Private(PetscInt n,PetscInt v[],PetscInt perm[],PetscBool *sorted)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,b,d,min,max,shift,cnt[RADIX_SIZE],sum,c,nruns,start[SORT_MAX_RUNS+1];
+  PetscInt       *vw,*pw,*v1 = v,*v2,*p1 = perm,*p2,*t;
+
+  PetscFunctionBegin;
+  *sorted  = PETSC_TRUE;
+  start[0] = 0;
+  for (i=1,nruns=1; i<n && nruns<=SORT_MAX_RUNS; i++) {
+    if (v[i] < v[i-1]) {
+      if (nruns < SORT_MAX_RUNS) start[nruns] = i;
+      nruns++;
+    }
+  }
+  if (nruns == 1) PetscFunctionReturn(0);
+  if (nruns <= SORT_MAX_RUNS) {
+    start[nruns] = n;
+    ierr = PetscSortIntMergeRuns_Private(n,v,perm,nruns,start);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  min = max = v[0];
+  for (i=1; i<n; i++) {
+    if (v[i] < min) min = v[i];
+    else if (v[i] > max) max = v[i];
+  }
+  if (min < 0 && max > PETSC_MAX_INT + min) {*sorted = PETSC_FALSE; PetscFunctionReturn(0);}
+  ierr = PetscMalloc2(n,&vw,perm ? n : 0,&pw);CHKERRQ(ierr);
+  v2 = vw; p2 = pw;
+  for (shift=0; shift<(PetscInt)(8*sizeof(PetscInt)) && ((max-min) >> shift); shift+=RADIX_BITS) {
+    ierr = PetscMemzero(cnt,sizeof(cnt));CHKERRQ(ierr);
+    for (i=0; i<n; i++) cnt[RADIX_DIGIT(v1[i],min,shift)]++;
+    if (cnt[RADIX_DIGIT(v1[0],min,shift)] == n) continue;
+    for (b=0,sum=0; b<RADIX_SIZE; b++) {c = cnt[b]; cnt[b] = sum; sum += c;}
+    if (p1) {
+      for (i=0; i<n; i++) {
+        d = cnt[RADIX_DIGIT(v1[i],min,shift)]++;
+        v2[d] = v1[i];
+        p2[d] = p1[i];
+      }
+      t = p1; p1 = p2; p2 = t;
+    } else {
+      for (i=0; i<n; i++) v2[cnt[RADIX_DIGIT(v1[i],min,shift)]++] = v1[i];
+    }
+    t = v1; v1 = v2; v2 = t;
+  }
+  if (v1 != v) {
+    ierr = PetscMemcpy(v,v1,n*sizeof(PetscInt));CHKERRQ(ierr);
+    if (perm) {ierr = PetscMemcpy(perm,p1,n*sizeof(PetscInt));CHKERRQ(ierr);}
+  }
+  ierr    = PetscFree2(vw,pw);CHKERRQ(ierr);
+  *sorted = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Radix sorts v[] and permutes the n entries of size bytes in V[] to match. Sets *sorted to PETSC_FALSE and does
+   nothing if the radix sort cannot be used.
+*/
+static PetscErrorCode PetscSortIntRadixWithData_Private(PetscInt n,PetscInt v[],void *V,size_t size,PetscBool *sorted)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,*perm;
+  char           *data = (char*)V,*work;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(n,&perm);CHKERRQ(ierr);
+  for (i=0; i<n; i++) perm[i] = i;
+  ierr = PetscSortIntRadix_Private(n,v,perm,sorted);CHKERRQ(ierr);
+  if (*sorted) {
+    ierr = PetscMalloc1(n*size,&work);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {ierr = PetscMemcpy(work+i*size,data+perm[i]*size,size);CHKERRQ(ierr);}
+    ierr = PetscMemcpy(data,work,n*size);CHKERRQ(ierr);
+    ierr = PetscFree(work);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(perm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* PETSC_TRUE if v[] is in nondecreasing order; lets the callers skip building a permutation */
+static PetscBool PetscSortIntSorted_Private(PetscInt n,const PetscInt v[])
+{
+  PetscInt i;
+
+  for (i=1; i<n; i++) if (v[i] < v[i-1]) return PETSC_FALSE;
+  return PETSC_TRUE;
+}
+
 /*
    A simple version of quicksort; taken from Kernighan and Ritchie, page 87.
    Assumes 0 origin for v, number of elements = right+1 (right is index of
@@ -65,9 +246,15 @@ static void PetscSortInt_Private(PetscInt *v,PetscInt right)
 @*/
 PetscErrorCode  PetscSortInt(PetscInt n,PetscInt i[])
 {
-  PetscInt j,k,tmp,ik;
+  PetscErrorCode ierr;
+  PetscInt       j,k,tmp,ik;
+  PetscBool      sorted;
 
   PetscFunctionBegin;
+  if (PetscSortIntUseRadix(n)) {
+    ierr = PetscSortIntRadix_Private(n,i,NULL,&sorted);CHKERRQ(ierr);
+    if (sorted) PetscFunctionReturn(0);
+  }
   if (n<8) {
     for (k=0; k<n; k++) {
       ik = i[k];
@@ -268,8 +455,13 @@ PetscErrorCode  PetscSortIntWithArray(PetscInt n,PetscInt i[],PetscInt Ii[])
 {
   PetscErrorCode ierr;
   PetscInt       j,k,tmp,ik;
+  PetscBool      sorted;
 
   PetscFunctionBegin;
+  if (PetscSortIntUseRadix(n)) {
+    ierr = PetscSortIntRadix_Private(n,i,Ii,&sorted);CHKERRQ(ierr);
+    if (sorted) PetscFunctionReturn(0);
+  }
   if (n<8) {
     for (k=0; k<n; k++) {
       ik = i[k];
@@ -339,9 +531,24 @@ static PetscErrorCode PetscSortIntWithArrayPair_Private(PetscInt *L,PetscInt *J,
 PetscErrorCode  PetscSortIntWithArrayPair(PetscInt n,PetscInt L[],PetscInt J[], PetscInt K[])
 {
   PetscErrorCode ierr;
-  PetscInt       j,k,tmp,ik;
+  PetscInt       j,k,tmp,ik,*perm,*work;
+  PetscBool      sorted;
 
   PetscFunctionBegin;
+  if (PetscSortIntUseRadix(n)) {
+    if (PetscSortIntSorted_Private(n,L)) PetscFunctionReturn(0);
+    ierr = PetscMalloc2(n,&perm,n,&work);CHKERRQ(ierr);
+    for (k=0; k<n; k++) perm[k] = k;
+    ierr = PetscSortIntRadix_Private(n,L,perm,&sorted);CHKERRQ(ierr);
+    if (sorted) {
+      for (k=0; k<n; k++) work[k] = J[perm[k]];
+      ierr = PetscMemcpy(J,work,n*sizeof(PetscInt));CHKERRQ(ierr);
+      for (k=0; k<n; k++) work[k] = K[perm[k]];
+      ierr = PetscMemcpy(K,work,n*sizeof(PetscInt));CHKERRQ(ierr);
+    }
+    ierr = PetscFree2(perm,work);CHKERRQ(ierr);
+    if (sorted) PetscFunctionReturn(0);
+  }
   if (n<8) {
     for (k=0; k<n; k++) {
       ik = L[k];
@@ -578,8 +785,14 @@ PetscErrorCode  PetscSortIntWithScalarArray(PetscInt n,PetscInt i[],PetscScalar
   PetscErrorCode ierr;
   PetscInt       j,k,tmp,ik;
   PetscScalar    stmp;
+  PetscBool      sorted;
 
   PetscFunctionBegin;
+  if (PetscSortIntUseRadix(n)) {
+    if (PetscSortIntSorted_Private(n,i)) PetscFunctionReturn(0);
+    ierr = PetscSortIntRadixWithData_Private(n,i,Ii,sizeof(PetscScalar),&sorted);CHKERRQ(ierr);
+    if (sorted) PetscFunctionReturn(0);
+  }
   if (n<8) {
     for (k=0; k<n; k++) {
       ik = i[k];
@@ -657,8 +870,14 @@ PetscErrorCode  PetscSortIntWithDataArray(PetscInt n,PetscInt i[],void *Ii,size_
   char           *V = (char *) Ii;
   PetscErrorCode ierr;
   PetscInt       j,k,tmp,ik;
+  PetscBool      sorted;
 
   PetscFunctionBegin;
+  if (PetscSortIntUseRadix(n)) {
+    if (PetscSortIntSorted_Private(n,i)) PetscFunctionReturn(0);
+    ierr = PetscSortIntRadixWithData_Private(n,i,Ii,size,&sorted);CHKERRQ(ierr);
+    if (sorted) PetscFunctionReturn(0);
+  }
   if (n<8) {
     for (k=0; k<n; k++) {
       ik = i[k];
@@ -304,6 +304,17 @@ int main(int argc,char **argv)
       nsize: 4
       args: -test_reduce -sf_type basic
 
+   test:
+      suffix: 2_basic_nonpersistent
+      nsize: 4
+      args: -test_reduce -test_fetchandop -sf_type basic -sf_basic_persistent 0
+      output_file: output/ex1_2_basic_persistent.out
+
+   test:
+      suffix: 2_basic_persistent
+      nsize: 4
+      args: -test_reduce -test_fetchandop -sf_type basic
+
    test:
       suffix: 3
       nsize: 4
@@ -375,6 +386,42 @@ int main(int argc,char **argv)
       args: -test_bcast -sf_type basic
       output_file: output/ex1_1_basic.out
 
+   test:
+      suffix: neighbor
+      nsize: 4
+      args: -test_bcast -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 2_neighbor
+      nsize: 4
+      args: -test_reduce -test_fetchandop -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 4_neighbor
+      nsize: 4
+      args: -test_gather -sf_type neighbor -stride 2
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: shared
+      nsize: 4
+      args: -test_bcast -sf_type shared
+      requires: define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE) define(PETSC_HAVE_MPI_SHARED_COMM)
+
+   test:
+      suffix: 2_shared
+      nsize: 4
+      args: -test_reduce -test_fetchandop -sf_type shared -sf_shared_node_size 2
+      requires: define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE) define(PETSC_HAVE_MPI_SHARED_COMM)
+
+   test:
+      suffix: 4_shared
+      nsize: 4
+      args: -test_gather -sf_type shared -sf_shared_node_size 3 -stride 2
+      requires: define(PETSC_HAVE_MPI_WIN_CREATE_FEATURE) define(PETSC_HAVE_MPI_SHARED_COMM)
+
    test:
       suffix: 8
       nsize: 3
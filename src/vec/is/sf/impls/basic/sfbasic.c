@@ -1,57 +1,5 @@
 
-#include <petsc/private/sfimpl.h> /*I "petscsf.h" I*/
-
-typedef struct _n_PetscSFBasicPack *PetscSFBasicPack;
-struct _n_PetscSFBasicPack {
-  void (*Pack)(PetscInt,PetscInt,const PetscInt*,const void*,void*);
-  void (*UnpackInsert)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackAdd)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMin)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMax)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMinloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMult)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*FetchAndInsert)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndAdd)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMin)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMax)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMinloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMult)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-
-  MPI_Datatype     unit;
-  size_t           unitbytes;   /* Number of bytes in a unit */
-  PetscInt         bs;          /* Number of basic units in a unit */
-  const void       *key;        /* Array used as key for operation */
-  char             **root;      /* Packed root data, indexed by leaf rank */
-  char             **leaf;      /* Packed leaf data, indexed by root rank */
-  MPI_Request      *requests;   /* Array of root requests followed by leaf requests */
-  PetscSFBasicPack next;
-};
-
-typedef struct {
-  PetscMPIInt      tag;
-  PetscMPIInt      niranks;     /* Number of incoming ranks (ranks accessing my roots) */
-  PetscMPIInt      ndiranks;    /* Number of incoming ranks (ranks accessing my roots) in distinguished set */
-  PetscMPIInt      *iranks;     /* Array of ranks that reference my roots */
-  PetscInt         itotal;      /* Total number of graph edges referencing my roots */
-  PetscInt         *ioffset;    /* Array of length niranks+1 holding offset in irootloc[] for each rank */
-  PetscInt         *irootloc;   /* Incoming roots referenced by ranks starting at ioffset[rank] */
-  PetscSFBasicPack avail;       /* One or more entries per MPI Datatype, lazily constructed */
-  PetscSFBasicPack inuse;       /* Buffers being used for transactions that have not yet completed */
-} PetscSF_Basic;
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
 
 #if !defined(PETSC_HAVE_MPI_TYPE_DUP)
 PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype)
@@ -531,7 +479,7 @@ DEF_Block(int,6)
 DEF_Block(int,7)
 DEF_Block(int,8)
 
-static PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
+PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode ierr;
@@ -601,7 +549,7 @@ static PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack link,MPI_Datatype unit)
+PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack link,MPI_Datatype unit)
 {
   PetscErrorCode ierr;
   PetscBool      isInt,isPetscInt,isPetscReal,is2Int,is2PetscInt;
@@ -682,7 +630,7 @@ static PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack link,MPI_Dataty
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicPackGetUnpackOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*))
+PetscErrorCode PetscSFBasicPackGetUnpackOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*))
 {
   PetscFunctionBegin;
   *UnpackOp = NULL;
@@ -702,7 +650,7 @@ static PetscErrorCode PetscSFBasicPackGetUnpackOp(PetscSF sf,PetscSFBasicPack li
   else *UnpackOp = NULL;
   PetscFunctionReturn(0);
 }
-static PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*))
+PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*))
 {
   PetscFunctionBegin;
   *FetchAndOp = NULL;
@@ -728,6 +676,8 @@ static PetscErrorCode PetscSFBasicPackGetReqs(PetscSF sf,PetscSFBasicPack link,M
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
   PetscFunctionBegin;
+  link->active  = link->requests;
+  link->nactive = bas->niranks+sf->nranks-(bas->ndiranks+sf->ndranks);
   if (rootreqs) *rootreqs = link->requests;
   if (leafreqs) *leafreqs = link->requests + (bas->niranks - bas->ndiranks);
   PetscFunctionReturn(0);
@@ -735,15 +685,16 @@ static PetscErrorCode PetscSFBasicPackGetReqs(PetscSF sf,PetscSFBasicPack link,M
 
 static PetscErrorCode PetscSFBasicPackWaitall(PetscSF sf,PetscSFBasicPack link)
 {
-  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = MPI_Waitall(bas->niranks+sf->nranks-(bas->ndiranks+sf->ndranks),link->requests,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_Wait,sf,0,0,0);CHKERRQ(ierr);
+  ierr = MPI_Waitall(link->nactive,link->active,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PETSCSF_Wait,sf,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,PetscInt *ndrootranks,const PetscMPIInt **rootranks,const PetscInt **rootoffset,const PetscInt **rootloc)
+PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,PetscInt *ndrootranks,const PetscMPIInt **rootranks,const PetscInt **rootoffset,const PetscInt **rootloc)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -756,7 +707,7 @@ static PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,Pe
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,PetscInt *ndleafranks,const PetscMPIInt **leafranks,const PetscInt **leafoffset,const PetscInt **leafloc)
+PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,PetscInt *ndleafranks,const PetscMPIInt **leafranks,const PetscInt **leafoffset,const PetscInt **leafloc)
 {
   PetscFunctionBegin;
   if (nleafranks)  *nleafranks  = sf->nranks;
@@ -767,7 +718,80 @@ static PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,Pe
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFBasicPack *mylink)
+/*
+   Gets the persistent requests of the link for one direction of communication, creating them at first use. The
+   buffers are the pack buffers of the link, so the requests stay valid for as long as the link exists. For a
+   broadcast the roots send and the leaves receive, for a reduction it is the other way around.
+*/
+static PetscErrorCode PetscSFBasicPackGetPersistentReqs(PetscSF sf,PetscSFBasicPack link,PetscBool bcast,MPI_Request **rootreqs,MPI_Request **leafreqs)
+{
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode    ierr;
+  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscInt    *rootoffset,*leafoffset;
+  const PetscMPIInt *rootranks,*leafranks;
+  MPI_Request       **reqs = bcast ? &link->bcastreqs : &link->reducereqs;
+  MPI_Comm          comm;
+
+  PetscFunctionBegin;
+  if (!*reqs) {
+    ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+    ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,NULL);CHKERRQ(ierr);
+    ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,NULL);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nrootranks-ndrootranks+nleafranks-ndleafranks,reqs);CHKERRQ(ierr);
+    for (i=ndrootranks; i<nrootranks; i++) {
+      PetscMPIInt n = rootoffset[i+1] - rootoffset[i];
+      if (bcast) {
+        ierr = MPI_Send_init(link->root[i],n,link->unit,rootranks[i],bas->tag,comm,*reqs+i-ndrootranks);CHKERRQ(ierr);
+      } else {
+        ierr = MPI_Recv_init(link->root[i],n,link->unit,rootranks[i],bas->tag,comm,*reqs+i-ndrootranks);CHKERRQ(ierr);
+      }
+    }
+    for (i=ndleafranks; i<nleafranks; i++) {
+      PetscMPIInt n = leafoffset[i+1] - leafoffset[i];
+      if (bcast) {
+        ierr = MPI_Recv_init(link->leaf[i],n,link->unit,leafranks[i],bas->tag,comm,*reqs+nrootranks-ndrootranks+i-ndleafranks);CHKERRQ(ierr);
+      } else {
+        ierr = MPI_Send_init(link->leaf[i],n,link->unit,leafranks[i],bas->tag,comm,*reqs+nrootranks-ndrootranks+i-ndleafranks);CHKERRQ(ierr);
+      }
+    }
+  }
+  link->active  = *reqs;
+  link->nactive = bas->niranks+sf->nranks-(bas->ndiranks+sf->ndranks);
+  if (rootreqs) *rootreqs = *reqs;
+  if (leafreqs) *leafreqs = *reqs + (bas->niranks - bas->ndiranks);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBasicPackFreePersistentReqs(PetscSF sf,MPI_Request **reqs)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  if (!*reqs) PetscFunctionReturn(0);
+  for (i=0; i<bas->niranks+sf->nranks-(bas->ndiranks+sf->ndranks); i++) {ierr = MPI_Request_free(*reqs+i);CHKERRQ(ierr);}
+  ierr = PetscFree(*reqs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Starts the persistent receives (or sends) of ranks [start,end) of one side, logging them as VecScatter does */
+static PetscErrorCode PetscSFBasicPackStartall(PetscSFBasicPack link,PetscBool send,PetscInt start,PetscInt end,const PetscInt *offset,MPI_Request *reqs)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    nreqs;
+  PetscInt       count = (offset[end] - offset[start])*link->unitbytes/sizeof(PetscScalar);
+
+  PetscFunctionBegin;
+  ierr = PetscMPIIntCast(end - start,&nreqs);CHKERRQ(ierr);
+  if (!nreqs) PetscFunctionReturn(0);
+  if (send) {ierr = MPI_Startall_isend(count,nreqs,reqs);CHKERRQ(ierr);}
+  else      {ierr = MPI_Startall_irecv(count,nreqs,reqs);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFBasicPack *mylink)
 {
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
@@ -792,18 +816,18 @@ static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const voi
   ierr = PetscNew(&link);CHKERRQ(ierr);
   ierr = PetscSFBasicPackTypeSetup(link,unit);CHKERRQ(ierr);
   ierr = PetscMalloc2(nrootranks,&link->root,nleafranks,&link->leaf);CHKERRQ(ierr);
-  for (i=0; i<nrootranks; i++) {
-    ierr = PetscMalloc((rootoffset[i+1]-rootoffset[i])*link->unitbytes,&link->root[i]);CHKERRQ(ierr);
-  }
+  /* The buffers of all ranks of each side are contiguous, so they can also be sent with a single collective */
+  ierr = PetscMalloc2(rootoffset[nrootranks]*link->unitbytes,&link->rootbuf,(leafoffset[nleafranks]-leafoffset[ndleafranks])*link->unitbytes,&link->leafbuf);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) link->root[i] = link->rootbuf + rootoffset[i]*link->unitbytes;
   for (i=0; i<nleafranks; i++) {
     if (i < ndleafranks) {      /* Leaf buffers for distinguished ranks are pointers directly into root buffers */
       if (ndrootranks != 1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Cannot match distinguished ranks");
       link->leaf[i] = link->root[0];
       continue;
     }
-    ierr = PetscMalloc((leafoffset[i+1]-leafoffset[i])*link->unitbytes,&link->leaf[i]);CHKERRQ(ierr);
+    link->leaf[i] = link->leafbuf + (leafoffset[i]-leafoffset[ndleafranks])*link->unitbytes;
   }
-  ierr = PetscCalloc1(nrootranks+nleafranks,&link->requests);CHKERRQ(ierr);
+  ierr = PetscCalloc1(nrootranks+nleafranks+1,&link->requests);CHKERRQ(ierr);
 
 found:
   link->key  = key;
@@ -853,15 +877,17 @@ static PetscErrorCode PetscSFBasicReclaimPack(PetscSF sf,PetscSFBasicPack *link)
 
 static PetscErrorCode PetscSFSetFromOptions_Basic(PetscOptionItems *PetscOptionsObject,PetscSF sf)
 {
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Basic options");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-sf_basic_persistent","Restart persistent MPI requests on the pack buffers instead of posting new ones for each operation","None",bas->persistent,&bas->persistent,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFReset_Basic(PetscSF sf)
+PetscErrorCode PetscSFReset_Basic(PetscSF sf)
 {
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
@@ -872,13 +898,13 @@ static PetscErrorCode PetscSFReset_Basic(PetscSF sf)
   ierr = PetscFree2(bas->iranks,bas->ioffset);CHKERRQ(ierr);
   ierr = PetscFree(bas->irootloc);CHKERRQ(ierr);
   for (link=bas->avail; link; link=next) {
-    PetscInt i;
     next = link->next;
     ierr = MPI_Type_free(&link->unit);CHKERRQ(ierr);
-    for (i=0; i<bas->niranks; i++) {ierr = PetscFree(link->root[i]);CHKERRQ(ierr);}
-    for (i=sf->ndranks; i<sf->nranks; i++) {ierr = PetscFree(link->leaf[i]);CHKERRQ(ierr);} /* Free only non-distinguished leaf buffers */
+    ierr = PetscFree2(link->rootbuf,link->leafbuf);CHKERRQ(ierr);
     ierr = PetscFree2(link->root,link->leaf);CHKERRQ(ierr);
     ierr = PetscFree(link->requests);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackFreePersistentReqs(sf,&link->bcastreqs);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackFreePersistentReqs(sf,&link->reducereqs);CHKERRQ(ierr);
     ierr = PetscFree(link);CHKERRQ(ierr);
   }
   bas->avail = NULL;
@@ -895,7 +921,7 @@ static PetscErrorCode PetscSFDestroy_Basic(PetscSF sf)
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
+PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
 {
   /* PetscSF_Basic *bas = (PetscSF_Basic*)sf->data; */
   PetscErrorCode ierr;
@@ -925,19 +951,31 @@ static PetscErrorCode PetscSFBcastBegin_Basic(PetscSF sf,MPI_Datatype unit,const
   ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
   ierr = PetscSFBasicGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
 
-  ierr = PetscSFBasicPackGetReqs(sf,link,&rootreqs,&leafreqs);CHKERRQ(ierr);
-  /* Eagerly post leaf receives, but only from non-distinguished ranks -- distinguished ranks will receive via shared memory */
-  for (i=ndleafranks; i<nleafranks; i++) {
-    PetscMPIInt n = leafoffset[i+1] - leafoffset[i];
-    ierr = MPI_Irecv(link->leaf[i],n,unit,leafranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
+  if (bas->persistent) {
+    ierr = PetscSFBasicPackGetPersistentReqs(sf,link,PETSC_TRUE,&rootreqs,&leafreqs);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackStartall(link,PETSC_FALSE,ndleafranks,nleafranks,leafoffset,leafreqs);CHKERRQ(ierr);
+  } else {
+    ierr = PetscSFBasicPackGetReqs(sf,link,&rootreqs,&leafreqs);CHKERRQ(ierr);
+    /* Eagerly post leaf receives, but only from non-distinguished ranks -- distinguished ranks will receive via shared memory */
+    for (i=ndleafranks; i<nleafranks; i++) {
+      PetscMPIInt n = leafoffset[i+1] - leafoffset[i];
+      ierr = MPI_Irecv(link->leaf[i],n,unit,leafranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
+    }
   }
   /* Pack and send root data */
+  ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
   for (i=0; i<nrootranks; i++) {
-    PetscMPIInt n          = rootoffset[i+1] - rootoffset[i];
-    void        *packstart = link->root[i];
-    (*link->Pack)(n,link->bs,rootloc+rootoffset[i],rootdata,packstart);
-    if (i < ndrootranks) continue; /* shared memory */
-    ierr = MPI_Isend(packstart,n,unit,rootranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+    PetscMPIInt n = rootoffset[i+1] - rootoffset[i];
+    (*link->Pack)(n,link->bs,rootloc+rootoffset[i],rootdata,link->root[i]);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  if (bas->persistent) {
+    ierr = PetscSFBasicPackStartall(link,PETSC_TRUE,ndrootranks,nrootranks,rootoffset,rootreqs);CHKERRQ(ierr);
+  } else {
+    for (i=ndrootranks; i<nrootranks; i++) { /* distinguished ranks use shared memory */
+      PetscMPIInt n = rootoffset[i+1] - rootoffset[i];
+      ierr = MPI_Isend(link->root[i],n,unit,rootranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+    }
   }
   PetscFunctionReturn(0);
 }
@@ -953,11 +991,13 @@ PetscErrorCode PetscSFBcastEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *ro
   ierr = PetscSFBasicGetPackInUse(sf,unit,rootdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
   ierr = PetscSFBasicPackWaitall(sf,link);CHKERRQ(ierr);
   ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   for (i=0; i<nleafranks; i++) {
     PetscMPIInt n          = leafoffset[i+1] - leafoffset[i];
     const void  *packstart = link->leaf[i];
     (*link->UnpackInsert)(n,link->bs,leafloc+leafoffset[i],leafdata,packstart);
   }
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -978,24 +1018,36 @@ PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,const void
   ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
   ierr = PetscSFBasicGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
 
-  ierr = PetscSFBasicPackGetReqs(sf,link,&rootreqs,&leafreqs);CHKERRQ(ierr);
-  /* Eagerly post root receives for non-distinguished ranks */
-  for (i=ndrootranks; i<nrootranks; i++) {
-    PetscMPIInt n = rootoffset[i+1] - rootoffset[i];
-    ierr = MPI_Irecv(link->root[i],n,unit,rootranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+  if (bas->persistent) {
+    ierr = PetscSFBasicPackGetPersistentReqs(sf,link,PETSC_FALSE,&rootreqs,&leafreqs);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackStartall(link,PETSC_FALSE,ndrootranks,nrootranks,rootoffset,rootreqs);CHKERRQ(ierr);
+  } else {
+    ierr = PetscSFBasicPackGetReqs(sf,link,&rootreqs,&leafreqs);CHKERRQ(ierr);
+    /* Eagerly post root receives for non-distinguished ranks */
+    for (i=ndrootranks; i<nrootranks; i++) {
+      PetscMPIInt n = rootoffset[i+1] - rootoffset[i];
+      ierr = MPI_Irecv(link->root[i],n,unit,rootranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+    }
   }
   /* Pack and send leaf data */
+  ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
   for (i=0; i<nleafranks; i++) {
-    PetscMPIInt n          = leafoffset[i+1] - leafoffset[i];
-    void        *packstart = link->leaf[i];
-    (*link->Pack)(n,link->bs,leafloc+leafoffset[i],leafdata,packstart);
-    if (i < ndleafranks) continue; /* shared memory */
-    ierr = MPI_Isend(packstart,n,unit,leafranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
+    PetscMPIInt n = leafoffset[i+1] - leafoffset[i];
+    (*link->Pack)(n,link->bs,leafloc+leafoffset[i],leafdata,link->leaf[i]);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  if (bas->persistent) {
+    ierr = PetscSFBasicPackStartall(link,PETSC_TRUE,ndleafranks,nleafranks,leafoffset,leafreqs);CHKERRQ(ierr);
+  } else {
+    for (i=ndleafranks; i<nleafranks; i++) { /* distinguished ranks use shared memory */
+      PetscMPIInt n = leafoffset[i+1] - leafoffset[i];
+      ierr = MPI_Isend(link->leaf[i],n,unit,leafranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
+    }
   }
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
 {
   void             (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
   PetscErrorCode   ierr;
@@ -1016,6 +1068,7 @@ static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const
   else {
     ierr = MPI_Type_size(unit,&typesize);CHKERRQ(ierr);
   }
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   for (i=0; i<nrootranks; i++) {
     PetscMPIInt n   = rootoffset[i+1] - rootoffset[i];
     char *packstart = (char *) link->root[i];
@@ -1037,11 +1090,12 @@ static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const
     }
 #endif
   }
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
 {
   PetscErrorCode ierr;
 
@@ -1050,7 +1104,7 @@ static PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
 {
   PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   void              (*FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*);
@@ -1067,28 +1121,41 @@ static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,vo
   ierr      = PetscSFBasicPackWaitall(sf,link);CHKERRQ(ierr);
   ierr      = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
   ierr      = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
-  ierr      = PetscSFBasicPackGetReqs(sf,link,&rootreqs,&leafreqs);CHKERRQ(ierr);
   /* Post leaf receives */
-  for (i=ndleafranks; i<nleafranks; i++) {
-    PetscMPIInt n = leafoffset[i+1] - leafoffset[i];
-    ierr = MPI_Irecv(link->leaf[i],n,unit,leafranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
+  if (bas->persistent) {
+    ierr = PetscSFBasicPackGetPersistentReqs(sf,link,PETSC_TRUE,&rootreqs,&leafreqs);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackStartall(link,PETSC_FALSE,ndleafranks,nleafranks,leafoffset,leafreqs);CHKERRQ(ierr);
+  } else {
+    ierr = PetscSFBasicPackGetReqs(sf,link,&rootreqs,&leafreqs);CHKERRQ(ierr);
+    for (i=ndleafranks; i<nleafranks; i++) {
+      PetscMPIInt n = leafoffset[i+1] - leafoffset[i];
+      ierr = MPI_Irecv(link->leaf[i],n,unit,leafranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
+    }
   }
   /* Process local fetch-and-op, post root sends */
   ierr = PetscSFBasicPackGetFetchAndOp(sf,link,op,&FetchAndOp);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   for (i=0; i<nrootranks; i++) {
-    PetscMPIInt n          = rootoffset[i+1] - rootoffset[i];
-    void        *packstart = link->root[i];
-
-    (*FetchAndOp)(n,link->bs,rootloc+rootoffset[i],rootdata,packstart);
-    if (i < ndrootranks) continue; /* shared memory */
-    ierr = MPI_Isend(packstart,n,unit,rootranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+    PetscMPIInt n = rootoffset[i+1] - rootoffset[i];
+    (*FetchAndOp)(n,link->bs,rootloc+rootoffset[i],rootdata,link->root[i]);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  if (bas->persistent) {
+    ierr = PetscSFBasicPackStartall(link,PETSC_TRUE,ndrootranks,nrootranks,rootoffset,rootreqs);CHKERRQ(ierr);
+  } else {
+    for (i=ndrootranks; i<nrootranks; i++) { /* distinguished ranks use shared memory */
+      PetscMPIInt n = rootoffset[i+1] - rootoffset[i];
+      ierr = MPI_Isend(link->root[i],n,unit,rootranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+    }
   }
   ierr = PetscSFBasicPackWaitall(sf,link);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   for (i=0; i<nleafranks; i++) {
     PetscMPIInt n          = leafoffset[i+1] - leafoffset[i];
     const void  *packstart = link->leaf[i];
     (*link->UnpackInsert)(n,link->bs,leafloc+leafoffset[i],leafupdate,packstart);
   }
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
   ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1112,6 +1179,7 @@ PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF sf)
   sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Basic;
 
   ierr = PetscNewLog(sf,&bas);CHKERRQ(ierr);
+  bas->persistent = PETSC_TRUE;
   sf->data = (void*)bas;
   PetscFunctionReturn(0);
 }
@@ -0,0 +1,178 @@
+
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
+
+/*
+   PETSCSFNEIGHBOR uses the setup and the pack buffers of PETSCSFBASIC, but sends all the messages of a broadcast or a
+   reduction with a single MPI_Ineighbor_alltoallv() on a distributed graph communicator instead of one MPI_Isend()
+   and one MPI_Irecv() per rank. The ends of the operations and the fetch-and-op are those of PETSCSFBASIC.
+*/
+typedef struct {
+  PetscSF_Basic bas;                     /* Must be first, the routines of PETSCSFBASIC find it at sf->data */
+  MPI_Comm      comms[2];                /* Distributed graph communicators for root to leaf and leaf to root communication, created at first use */
+  PetscMPIInt   *rootcounts,*rootdispls; /* Number of units, and their offset in the packed buffer, of each non-distinguished root rank */
+  PetscMPIInt   *leafcounts,*leafdispls; /* Same for the non-distinguished leaf ranks */
+} PetscSF_Neighbor;
+
+/*
+   Gets the distributed graph communicator of one direction of communication. For a broadcast the roots send to the
+   ranks referencing them and the leaves receive from the ranks owning their roots, for a reduction it is the other
+   way around. Distinguished ranks are not part of the graph, they communicate through the shared pack buffer.
+*/
+static PetscErrorCode PetscSFNeighborGetComm(PetscSF sf,PetscBool bcast,MPI_Comm *distcomm)
+{
+  PetscSF_Neighbor  *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode    ierr;
+  PetscInt          nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscMPIInt *rootranks,*leafranks,*roots,*leaves;
+  PetscMPIInt       i,nroot,nleaf,nweights,empty = 0,*weights;
+  MPI_Comm          *comm = &dat->comms[bcast ? 0 : 1];
+
+  PetscFunctionBegin;
+  if (*comm == MPI_COMM_NULL) {
+    ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,NULL,NULL);CHKERRQ(ierr);
+    ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,NULL,NULL);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(nrootranks-ndrootranks,&nroot);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(nleafranks-ndleafranks,&nleaf);CHKERRQ(ierr);
+    /* without neighbors in a direction the rank arrays may be empty, MPI still gets a valid address */
+    roots  = nroot ? rootranks + ndrootranks : &empty;
+    leaves = nleaf ? leafranks + ndleafranks : &empty;
+    /* equal weights rather than MPI_UNWEIGHTED, which some MPI implementations define as an invalid address */
+    nweights = PetscMax(PetscMax(nroot,nleaf),1);
+    ierr     = PetscMalloc1(nweights,&weights);CHKERRQ(ierr);
+    for (i=0; i<nweights; i++) weights[i] = 1;
+    if (bcast) {
+      ierr = MPI_Dist_graph_create_adjacent(PetscObjectComm((PetscObject)sf),nleaf,leaves,weights,nroot,roots,weights,MPI_INFO_NULL,0,comm);CHKERRQ(ierr);
+    } else {
+      ierr = MPI_Dist_graph_create_adjacent(PetscObjectComm((PetscObject)sf),nroot,roots,weights,nleaf,leaves,weights,MPI_INFO_NULL,0,comm);CHKERRQ(ierr);
+    }
+    ierr = PetscFree(weights);CHKERRQ(ierr);
+  }
+  *distcomm = *comm;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetUp_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscInt         i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscInt   *rootoffset,*leafoffset;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSetUp_Basic(sf);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscMalloc4(nrootranks-ndrootranks,&dat->rootcounts,nrootranks-ndrootranks,&dat->rootdispls,nleafranks-ndleafranks,&dat->leafcounts,nleafranks-ndleafranks,&dat->leafdispls);CHKERRQ(ierr);
+  for (i=ndrootranks; i<nrootranks; i++) {
+    ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&dat->rootcounts[i-ndrootranks]);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(rootoffset[i]-rootoffset[ndrootranks],&dat->rootdispls[i-ndrootranks]);CHKERRQ(ierr);
+  }
+  for (i=ndleafranks; i<nleafranks; i++) {
+    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&dat->leafcounts[i-ndleafranks]);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(leafoffset[i]-leafoffset[ndleafranks],&dat->leafdispls[i-ndleafranks]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscInt         i;
+
+  PetscFunctionBegin;
+  for (i=0; i<2; i++) {
+    if (dat->comms[i] != MPI_COMM_NULL) {ierr = MPI_Comm_free(&dat->comms[i]);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree4(dat->rootcounts,dat->rootdispls,dat->leafcounts,dat->leafdispls);CHKERRQ(ierr);
+  ierr = PetscSFReset_Basic(sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Neighbor(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Neighbor(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Send from roots to leaves */
+static PetscErrorCode PetscSFBcastBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nrootranks,ndrootranks;
+  const PetscInt   *rootoffset,*rootloc;
+  MPI_Comm         distcomm;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFNeighborGetComm(sf,PETSC_TRUE,&distcomm);CHKERRQ(ierr);
+  /* Pack all root data, distinguished ranks get theirs through the shared buffer */
+  ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) {
+    PetscMPIInt n = rootoffset[i+1] - rootoffset[i];
+    (*link->Pack)(n,link->bs,rootloc+rootoffset[i],rootdata,link->root[i]);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  link->active  = link->requests;
+  link->nactive = 1;
+  ierr = MPI_Ineighbor_alltoallv(link->rootbuf+rootoffset[ndrootranks]*link->unitbytes,dat->rootcounts,dat->rootdispls,unit,link->leafbuf,dat->leafcounts,dat->leafdispls,unit,distcomm,link->active);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* leaf -> root with reduction */
+static PetscErrorCode PetscSFReduceBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nrootranks,ndrootranks,nleafranks;
+  const PetscInt   *rootoffset,*leafoffset,*leafloc;
+  MPI_Comm         distcomm;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFNeighborGetComm(sf,PETSC_FALSE,&distcomm);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) {
+    PetscMPIInt n = leafoffset[i+1] - leafoffset[i];
+    (*link->Pack)(n,link->bs,leafloc+leafoffset[i],leafdata,link->leaf[i]);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  link->active  = link->requests;
+  link->nactive = 1;
+  ierr = MPI_Ineighbor_alltoallv(link->leafbuf,dat->leafcounts,dat->leafdispls,unit,link->rootbuf+rootoffset[ndrootranks]*link->unitbytes,dat->rootcounts,dat->rootdispls,unit,distcomm,link->active);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode PetscSFCreate_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_Neighbor;
+  sf->ops->Reset           = PetscSFReset_Neighbor;
+  sf->ops->Destroy         = PetscSFDestroy_Neighbor;
+  sf->ops->View            = PetscSFView_Basic;
+  sf->ops->BcastBegin      = PetscSFBcastBegin_Neighbor;
+  sf->ops->BcastEnd        = PetscSFBcastEnd_Basic;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_Neighbor;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_Basic;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_Basic;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Basic;
+
+  ierr = PetscNewLog(sf,&dat);CHKERRQ(ierr);
+  dat->comms[0] = MPI_COMM_NULL;
+  dat->comms[1] = MPI_COMM_NULL;
+  sf->data = (void*)dat;
+  PetscFunctionReturn(0);
+}
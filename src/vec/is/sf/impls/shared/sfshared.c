@@ -0,0 +1,487 @@
+
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
+
+/*
+   PETSCSFSHARED splits the graph into the edges whose roots are on the same node (in the same MPI shared memory
+   communicator) as the leaf and the other edges. The other edges are handed to an internal PETSCSFBASIC. For the
+   on-node edges each process owns a segment of an MPI_Win_allocate_shared() window: the roots pack their values into
+   the segment of their process and the leaves unpack them by reading the segment of the root process directly, so
+   no message is sent and no receive buffer is filled. Reductions go the other way around, the leaves pack and the
+   roots read.
+
+   Every segment is split in two halves used by successive operations of a link. An operation writes its half before
+   a barrier of the node and reads the halves of the other processes after it; a process can only write the same half
+   again after the barrier of the next operation, which no process passes before it has finished reading.
+*/
+
+typedef struct _n_PetscSFSharedLink *PetscSFSharedLink;
+struct _n_PetscSFSharedLink {
+  struct _n_PetscSFBasicPack pack; /* Only the pack kernels, the unit and its size are used */
+  const void                 *key; /* Array used as key for operation */
+  MPI_Win                    win;  /* Window holding the segments of all processes of the node */
+  char                       **base; /* Start of the segment of each process of the node */
+  PetscInt                   half; /* Half of the segments used by the next operation */
+  PetscSFSharedLink          next;
+};
+
+typedef struct {
+  PetscMPIInt       nodesize;    /* If positive, processes of a shared memory communicator are split into nodes of this many ranks */
+  MPI_Comm          comm;        /* Processes of this node */
+  PetscMPIInt       rank,size;   /* Rank and size in comm */
+  PetscSF           remote;      /* PETSCSFBASIC on the edges to roots on other nodes */
+  PetscMPIInt       *lranks;     /* Node rank of each of the sf->ndranks on-node ranks owning roots of my leaves */
+  PetscInt          *lremoteoff; /* Offset of my section in the segment of each of them */
+  PetscMPIInt       niranks;     /* Number of node processes having leaves on my roots */
+  PetscMPIInt       *iranks;     /* Their node ranks, sorted */
+  PetscInt          *ioffset;    /* Offset of each of them in irootloc[], and of their section in my segment */
+  PetscInt          *irootloc;   /* My roots referenced by each of them */
+  PetscInt          *iremoteoff; /* Offset of the section for me in the segment of each of them */
+  PetscInt          *halfcount;  /* Number of units in half the segment of each node process */
+  PetscSFSharedLink avail;       /* Links not in use, one or more per MPI datatype, lazily constructed */
+  PetscSFSharedLink inuse;       /* Links of operations that have not yet completed */
+} PetscSF_Shared;
+
+PETSC_STATIC_INLINE char *PetscSFSharedLinkHalf(PetscSF_Shared *sh,PetscSFSharedLink link,PetscMPIInt rank)
+{
+  return link->base[rank] + link->half*sh->halfcount[rank]*link->pack.unitbytes;
+}
+
+static PetscErrorCode PetscSFSetUp_Shared(PetscSF sf)
+{
+  PetscSF_Shared  *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode  ierr;
+  MPI_Comm        comm,shmcomm;
+  PetscCommShared scomm;
+  MPI_Group       group,nodegroup;
+  MPI_Request     *reqs;
+  MPI_Win         win;
+  PetscMPIInt     tag,ndranks,*lcounts,*fromcounts,*perm,nfrom,*fromranks;
+  PetscInt        i,j,*offsets,*peer,nremote;
+  PetscSFNode     *iremote;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = PetscCommSharedGet(comm,&scomm);CHKERRQ(ierr);
+  ierr = PetscCommSharedGetComm(scomm,&shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(shmcomm,&sh->rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_split(shmcomm,sh->nodesize > 0 ? sh->rank/sh->nodesize : 0,sh->rank,&sh->comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(sh->comm,&sh->rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(sh->comm,&sh->size);CHKERRQ(ierr);
+
+  /* The ranks of the node are the distinguished ones, they come first in sf->ranks */
+  ierr = MPI_Comm_group(sh->comm,&nodegroup);CHKERRQ(ierr);
+  ierr = PetscSFSetUpRanks(sf,nodegroup);CHKERRQ(ierr);
+  ierr = MPI_Comm_group(comm,&group);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(sf->ndranks,&ndranks);CHKERRQ(ierr);
+  ierr = PetscMalloc2(ndranks,&sh->lranks,ndranks,&sh->lremoteoff);CHKERRQ(ierr);
+  if (ndranks) {ierr = MPI_Group_translate_ranks(group,ndranks,sf->ranks,nodegroup,sh->lranks);CHKERRQ(ierr);}
+  ierr = MPI_Group_free(&group);CHKERRQ(ierr);
+  ierr = MPI_Group_free(&nodegroup);CHKERRQ(ierr);
+
+  /* The other edges are communicated with messages */
+  nremote = sf->roffset[sf->nranks] - sf->roffset[sf->ndranks];
+  ierr = PetscMalloc1(nremote,&iremote);CHKERRQ(ierr);
+  for (i=sf->ndranks; i<sf->nranks; i++) {
+    for (j=sf->roffset[i]; j<sf->roffset[i+1]; j++) {
+      iremote[j-sf->roffset[sf->ndranks]].rank  = sf->ranks[i];
+      iremote[j-sf->roffset[sf->ndranks]].index = sf->rremote[j];
+    }
+  }
+  ierr = PetscSFCreate(comm,&sh->remote);CHKERRQ(ierr);
+  ierr = PetscSFSetType(sh->remote,PETSCSFBASIC);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sh->remote,sf->nroots,nremote,sf->rmine+sf->roffset[sf->ndranks],PETSC_COPY_VALUES,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sh->remote);CHKERRQ(ierr);
+
+  /* Tell the node processes owning roots of my leaves which roots I reference */
+  ierr = PetscMalloc1(ndranks,&lcounts);CHKERRQ(ierr);
+  for (i=0; i<ndranks; i++) {ierr = PetscMPIIntCast(sf->roffset[i+1]-sf->roffset[i],&lcounts[i]);CHKERRQ(ierr);}
+  ierr = PetscCommBuildTwoSided(sh->comm,1,MPI_INT,ndranks,sh->lranks,lcounts,&nfrom,&fromranks,&fromcounts);CHKERRQ(ierr);
+  sh->niranks = nfrom;
+  ierr = PetscMalloc3(nfrom,&sh->iranks,nfrom+1,&sh->ioffset,nfrom,&sh->iremoteoff);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nfrom,&perm);CHKERRQ(ierr);
+  for (i=0; i<nfrom; i++) {
+    sh->iranks[i] = fromranks[i];
+    perm[i]       = (PetscMPIInt)i;
+  }
+  /* Sorted by rank so the reductions are deterministic */
+  ierr = PetscSortMPIIntWithArray(nfrom,sh->iranks,perm);CHKERRQ(ierr);
+  sh->ioffset[0] = 0;
+  for (i=0; i<nfrom; i++) sh->ioffset[i+1] = sh->ioffset[i] + fromcounts[perm[i]];
+  ierr = PetscFree(fromranks);CHKERRQ(ierr);
+  ierr = PetscFree(fromcounts);CHKERRQ(ierr);
+  ierr = PetscFree(perm);CHKERRQ(ierr);
+  ierr = PetscMalloc1(sh->ioffset[nfrom],&sh->irootloc);CHKERRQ(ierr);
+  ierr = PetscObjectGetNewTag((PetscObject)sf,&tag);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nfrom+ndranks,&reqs);CHKERRQ(ierr);
+  for (i=0; i<nfrom; i++) {
+    PetscMPIInt n = sh->ioffset[i+1] - sh->ioffset[i];
+    ierr = MPI_Irecv(sh->irootloc+sh->ioffset[i],n,MPIU_INT,sh->iranks[i],tag,sh->comm,&reqs[i]);CHKERRQ(ierr);
+  }
+  for (i=0; i<ndranks; i++) {
+    ierr = MPI_Isend(sf->rremote+sf->roffset[i],lcounts[i],MPIU_INT,sh->lranks[i],tag,sh->comm,&reqs[nfrom+i]);CHKERRQ(ierr);
+  }
+  ierr = MPI_Waitall(nfrom+ndranks,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = PetscFree(reqs);CHKERRQ(ierr);
+  ierr = PetscFree(lcounts);CHKERRQ(ierr);
+
+  /*
+     Publish where the sections are in the segments: for each node process the offset of its section in my roots
+     part, then the offset of the section for it in my leaves part, then the size of half my segment
+  */
+  ierr = PetscMalloc1(sh->size,&sh->halfcount);CHKERRQ(ierr);
+  ierr = MPIU_Win_allocate_shared((2*sh->size+1)*sizeof(PetscInt),sizeof(PetscInt),MPI_INFO_NULL,sh->comm,&offsets,&win);CHKERRQ(ierr);
+  for (i=0; i<2*sh->size; i++) offsets[i] = -1;
+  for (i=0; i<nfrom; i++)         offsets[sh->iranks[i]]          = sh->ioffset[i];
+  for (i=0; i<sf->ndranks; i++)   offsets[sh->size+sh->lranks[i]] = sf->roffset[i];
+  offsets[2*sh->size] = PetscMax(sh->ioffset[nfrom],sf->roffset[sf->ndranks]);
+  ierr = MPI_Barrier(sh->comm);CHKERRQ(ierr);
+  for (i=0; i<sh->size; i++) {
+    MPI_Aint    sz;
+    PetscMPIInt dispunit;
+    ierr = MPIU_Win_shared_query(win,(PetscMPIInt)i,&sz,&dispunit,&peer);CHKERRQ(ierr);
+    sh->halfcount[i] = peer[2*sh->size];
+    for (j=0; j<sf->ndranks; j++) if (sh->lranks[j] == i) sh->lremoteoff[j] = peer[sh->rank];
+    for (j=0; j<nfrom; j++)       if (sh->iranks[j] == i) sh->iremoteoff[j] = peer[sh->size+sh->rank];
+  }
+  ierr = MPI_Barrier(sh->comm);CHKERRQ(ierr);
+  ierr = MPI_Win_free(&win);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Gets a link for the unit, creating its window if none is available; this is collective on the node */
+static PetscErrorCode PetscSFSharedGetLink(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFSharedLink *mylink)
+{
+  PetscSF_Shared    *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscSFSharedLink link,*p;
+  PetscMPIInt       i,dispunit;
+  MPI_Aint          sz;
+
+  PetscFunctionBegin;
+  for (p=&sh->avail; (link=*p); p=&link->next) {
+    PetscBool match;
+    ierr = MPIPetsc_Type_compare(unit,link->pack.unit,&match);CHKERRQ(ierr);
+    if (match) {
+      *p = link->next;
+      goto found;
+    }
+  }
+  ierr = PetscNew(&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackTypeSetup(&link->pack,unit);CHKERRQ(ierr);
+  ierr = PetscMalloc1(sh->size,&link->base);CHKERRQ(ierr);
+  ierr = MPIU_Win_allocate_shared(2*sh->halfcount[sh->rank]*link->pack.unitbytes,16,MPI_INFO_NULL,sh->comm,&link->base[sh->rank],&link->win);CHKERRQ(ierr);
+  for (i=0; i<sh->size; i++) {
+    if (i == sh->rank) continue;
+    ierr = MPIU_Win_shared_query(link->win,i,&sz,&dispunit,&link->base[i]);CHKERRQ(ierr);
+  }
+
+found:
+  link->key = key;
+  link->next = sh->inuse;
+  sh->inuse  = link;
+  *mylink    = link;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSharedGetLinkInUse(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFSharedLink *mylink)
+{
+  PetscSF_Shared    *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscSFSharedLink link,*p;
+
+  PetscFunctionBegin;
+  for (p=&sh->inuse; (link=*p); p=&link->next) {
+    PetscBool match;
+    ierr = MPIPetsc_Type_compare(unit,link->pack.unit,&match);CHKERRQ(ierr);
+    if (match && key == link->key) {
+      *p      = link->next;
+      *mylink = link;
+      PetscFunctionReturn(0);
+    }
+  }
+  SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Could not find pack");
+  PetscFunctionReturn(0);
+}
+
+/* Makes the link available again, the next operation on it uses the other half of the segments */
+static PetscErrorCode PetscSFSharedReclaimLink(PetscSF sf,PetscSFSharedLink *link)
+{
+  PetscSF_Shared *sh = (PetscSF_Shared*)sf->data;
+
+  PetscFunctionBegin;
+  (*link)->half = !(*link)->half;
+  (*link)->key  = NULL;
+  (*link)->next = sh->avail;
+  sh->avail     = *link;
+  *link         = NULL;
+  PetscFunctionReturn(0);
+}
+
+/* Waits for all the processes of the node to have written their half of the segments */
+static PetscErrorCode PetscSFSharedBarrier(PetscSF sf)
+{
+  PetscSF_Shared *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(PETSCSF_Wait,sf,0,0,0);CHKERRQ(ierr);
+  ierr = MPI_Barrier(sh->comm);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PETSCSF_Wait,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetFromOptions_Shared(PetscOptionItems *PetscOptionsObject,PetscSF sf)
+{
+  PetscSF_Shared *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Shared options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-sf_shared_node_size","Treat groups of this many consecutive processes of a shared memory node as separate nodes","None",sh->nodesize,&sh->nodesize,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Shared(PetscSF sf)
+{
+  PetscSF_Shared    *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscSFSharedLink link,next;
+
+  PetscFunctionBegin;
+  if (sh->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
+  for (link=sh->avail; link; link=next) {
+    next = link->next;
+    ierr = MPI_Type_free(&link->pack.unit);CHKERRQ(ierr);
+    ierr = MPI_Win_free(&link->win);CHKERRQ(ierr);
+    ierr = PetscFree(link->base);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+  }
+  sh->avail = NULL;
+  ierr = PetscFree2(sh->lranks,sh->lremoteoff);CHKERRQ(ierr);
+  ierr = PetscFree3(sh->iranks,sh->ioffset,sh->iremoteoff);CHKERRQ(ierr);
+  ierr = PetscFree(sh->irootloc);CHKERRQ(ierr);
+  ierr = PetscFree(sh->halfcount);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sh->remote);CHKERRQ(ierr);
+  if (sh->comm != MPI_COMM_NULL) {ierr = MPI_Comm_free(&sh->comm);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Shared(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Shared(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFView_Shared(PetscSF sf,PetscViewer viewer)
+{
+  PetscSF_Shared *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii && sh->nodesize > 0) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  node size %d\n",sh->nodesize);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDuplicate_Shared(PetscSF sf,PetscSFDuplicateOption opt,PetscSF newsf)
+{
+  PetscSF_Shared *sh = (PetscSF_Shared*)sf->data,*nsh = (PetscSF_Shared*)newsf->data;
+
+  PetscFunctionBegin;
+  nsh->nodesize = sh->nodesize;
+  PetscFunctionReturn(0);
+}
+
+/* Send from roots to leaves */
+static PetscErrorCode PetscSFBcastBegin_Shared(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscSF_Shared    *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscSFSharedLink link;
+  PetscInt          i;
+  char              *buf;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastBegin(sh->remote,unit,rootdata,leafdata);CHKERRQ(ierr);
+  ierr = PetscSFSharedGetLink(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  buf  = PetscSFSharedLinkHalf(sh,link,sh->rank);
+  ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  for (i=0; i<sh->niranks; i++) {
+    (*link->pack.Pack)(sh->ioffset[i+1]-sh->ioffset[i],link->pack.bs,sh->irootloc+sh->ioffset[i],rootdata,buf+sh->ioffset[i]*link->pack.unitbytes);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastEnd_Shared(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscSF_Shared    *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscSFSharedLink link;
+  PetscInt          i;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSharedGetLinkInUse(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFSharedBarrier(sf);CHKERRQ(ierr);
+  /* Unpack directly from the segments of the processes owning the roots */
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  for (i=0; i<sf->ndranks; i++) {
+    const char *src = PetscSFSharedLinkHalf(sh,link,sh->lranks[i]) + sh->lremoteoff[i]*link->pack.unitbytes;
+    (*link->pack.UnpackInsert)(sf->roffset[i+1]-sf->roffset[i],link->pack.bs,sf->rmine+sf->roffset[i],leafdata,src);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFSharedReclaimLink(sf,&link);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sh->remote,unit,rootdata,leafdata);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Packs the leaf data for the roots of the node in the half of the segment of this process */
+static PetscErrorCode PetscSFSharedPackLeaves(PetscSF sf,PetscSFSharedLink link,const void *leafdata)
+{
+  PetscSF_Shared *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode ierr;
+  PetscInt       i;
+  char           *buf = PetscSFSharedLinkHalf(sh,link,sh->rank);
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  for (i=0; i<sf->ndranks; i++) {
+    (*link->pack.Pack)(sf->roffset[i+1]-sf->roffset[i],link->pack.bs,sf->rmine+sf->roffset[i],leafdata,buf+sf->roffset[i]*link->pack.unitbytes);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* leaf -> root with reduction */
+static PetscErrorCode PetscSFReduceBegin_Shared(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Shared    *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscSFSharedLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBegin(sh->remote,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFSharedGetLink(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFSharedPackLeaves(sf,link,leafdata);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Shared(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Shared    *sh = (PetscSF_Shared*)sf->data;
+  void              (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  PetscErrorCode    ierr;
+  PetscSFSharedLink link;
+  PetscInt          i;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSharedGetLinkInUse(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackGetUnpackOp(sf,&link->pack,op,&UnpackOp);CHKERRQ(ierr);
+  ierr = PetscSFSharedBarrier(sf);CHKERRQ(ierr);
+  /* Reduce directly from the segments of the processes owning the leaves, in rank order */
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  for (i=0; i<sh->niranks; i++) {
+    PetscInt   n    = sh->ioffset[i+1] - sh->ioffset[i];
+    const char *src = PetscSFSharedLinkHalf(sh,link,sh->iranks[i]) + sh->iremoteoff[i]*link->pack.unitbytes;
+
+    if (UnpackOp) {
+      (*UnpackOp)(n,link->pack.bs,sh->irootloc+sh->ioffset[i],rootdata,src);
+    }
+#if PETSC_HAVE_MPI_REDUCE_LOCAL
+    else { /* the op should be defined to operate on the whole datatype, so we ignore bs */
+      PetscInt j;
+
+      for (j=0; j<n; j++) {
+        ierr = MPI_Reduce_local((void*)(src+j*link->pack.unitbytes),(char*)rootdata+sh->irootloc[sh->ioffset[i]+j]*link->pack.unitbytes,1,unit,op);CHKERRQ(ierr);
+      }
+    }
+#else
+    else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
+#endif
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFSharedReclaimLink(sf,&link);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(sh->remote,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpBegin_Shared(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF_Shared    *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscSFSharedLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFFetchAndOpBegin(sh->remote,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  ierr = PetscSFSharedGetLink(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFSharedPackLeaves(sf,link,leafdata);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The roots apply the operation with the values in the segments of the leaf processes and leave the previous root
+   values there, a second barrier lets the leaves read them back from their own segment.
+*/
+static PetscErrorCode PetscSFFetchAndOpEnd_Shared(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF_Shared    *sh = (PetscSF_Shared*)sf->data;
+  void              (*FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  PetscErrorCode    ierr;
+  PetscSFSharedLink link;
+  PetscInt          i;
+  char              *buf;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSharedGetLinkInUse(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackGetFetchAndOp(sf,&link->pack,op,&FetchAndOp);CHKERRQ(ierr);
+  ierr = PetscSFSharedBarrier(sf);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  for (i=0; i<sh->niranks; i++) {
+    char *peer = PetscSFSharedLinkHalf(sh,link,sh->iranks[i]) + sh->iremoteoff[i]*link->pack.unitbytes;
+    (*FetchAndOp)(sh->ioffset[i+1]-sh->ioffset[i],link->pack.bs,sh->irootloc+sh->ioffset[i],rootdata,peer);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFSharedBarrier(sf);CHKERRQ(ierr);
+  buf  = PetscSFSharedLinkHalf(sh,link,sh->rank);
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  for (i=0; i<sf->ndranks; i++) {
+    (*link->pack.UnpackInsert)(sf->roffset[i+1]-sf->roffset[i],link->pack.bs,sf->rmine+sf->roffset[i],leafupdate,buf+sf->roffset[i]*link->pack.unitbytes);
+  }
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFSharedReclaimLink(sf,&link);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpEnd(sh->remote,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode PetscSFCreate_Shared(PetscSF sf)
+{
+  PetscSF_Shared *sh = (PetscSF_Shared*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_Shared;
+  sf->ops->SetFromOptions  = PetscSFSetFromOptions_Shared;
+  sf->ops->Reset           = PetscSFReset_Shared;
+  sf->ops->Destroy         = PetscSFDestroy_Shared;
+  sf->ops->View            = PetscSFView_Shared;
+  sf->ops->Duplicate       = PetscSFDuplicate_Shared;
+  sf->ops->BcastBegin      = PetscSFBcastBegin_Shared;
+  sf->ops->BcastEnd        = PetscSFBcastEnd_Shared;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_Shared;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_Shared;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_Shared;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Shared;
+
+  ierr = PetscNewLog(sf,&sh);CHKERRQ(ierr);
+  sh->comm = MPI_COMM_NULL;
+  sf->data = (void*)sh;
+  PetscFunctionReturn(0);
+}
@@ -12,6 +12,9 @@ PetscLogEvent PETSCSF_ReduceBegin;
 PetscLogEvent PETSCSF_ReduceEnd;
 PetscLogEvent PETSCSF_FetchAndOpBegin;
 PetscLogEvent PETSCSF_FetchAndOpEnd;
+PetscLogEvent PETSCSF_Pack;
+PetscLogEvent PETSCSF_Unpack;
+PetscLogEvent PETSCSF_Wait;
 
 /*@C
    PetscSFInitializePackage - Initialize SF package
@@ -44,6 +47,9 @@ PetscErrorCode PetscSFInitializePackage(void)
   ierr = PetscLogEventRegister("SFReduceEnd"    , PETSCSF_CLASSID, &PETSCSF_ReduceEnd);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("SFFetchOpBegin" , PETSCSF_CLASSID, &PETSCSF_FetchAndOpBegin);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("SFFetchOpEnd"   , PETSCSF_CLASSID, &PETSCSF_FetchAndOpEnd);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("SFPack"         , PETSCSF_CLASSID, &PETSCSF_Pack);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("SFUnpack"       , PETSCSF_CLASSID, &PETSCSF_Unpack);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("SFWait"         , PETSCSF_CLASSID, &PETSCSF_Wait);CHKERRQ(ierr);
   /* Process info exclusions */
   ierr = PetscOptionsGetString(NULL,NULL,"-info_exclude",logList,sizeof(logList),&opt);CHKERRQ(ierr);
   if (opt) {
@@ -0,0 +1,97 @@
+
+static char help[] = "Tests VecFusedOps against the separate vector operations.\n\
+  -n <n> : local length of the vectors\n\n";
+
+#include <petscvec.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = 1500,i,k = 4;
+  PetscRandom    rnd;
+  Vec            x[4],y[4],z,w;
+  VecFusedOps    fops;
+  PetscScalar    alpha[3] = {0.5,-2.0,1.5},dot[2],fdot[2];
+  PetscReal      nrm[2],fnrm[2],err,maxerr = 0.0;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rnd);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rnd);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_WORLD,&z);CHKERRQ(ierr);
+  ierr = VecSetSizes(z,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(z);CHKERRQ(ierr);
+  ierr = VecDuplicate(z,&w);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {
+    ierr = VecDuplicate(z,&x[i]);CHKERRQ(ierr);
+    ierr = VecDuplicate(z,&y[i]);CHKERRQ(ierr);
+    ierr = VecSetRandom(x[i],rnd);CHKERRQ(ierr);
+    ierr = VecCopy(x[i],y[i]);CHKERRQ(ierr);
+  }
+
+  /* the separate operations on x[] */
+  ierr = VecAXPY(x[0],alpha[0],x[1]);CHKERRQ(ierr);
+  ierr = VecAYPX(x[1],alpha[1],x[2]);CHKERRQ(ierr);
+  ierr = VecDot(x[0],x[1],&dot[0]);CHKERRQ(ierr);
+  ierr = VecWAXPY(x[3],alpha[2],x[0],x[1]);CHKERRQ(ierr);
+  ierr = VecNorm(x[3],NORM_2,&nrm[0]);CHKERRQ(ierr);
+  ierr = VecAXPBYPCZ(x[2],alpha[0],alpha[1],alpha[2],x[0],x[3]);CHKERRQ(ierr);
+  ierr = VecMAXPY(x[0],3,alpha,x+1);CHKERRQ(ierr);
+  ierr = VecTDot(x[0],x[2],&dot[1]);CHKERRQ(ierr);
+  ierr = VecNorm(x[0],NORM_1,&nrm[1]);CHKERRQ(ierr);
+
+  /* the same operations on y[] in one pass */
+  ierr = VecFusedOpsCreate(&fops);CHKERRQ(ierr);
+  ierr = VecFusedOpsAXPY(fops,y[0],alpha[0],y[1]);CHKERRQ(ierr);
+  ierr = VecFusedOpsAYPX(fops,y[1],alpha[1],y[2]);CHKERRQ(ierr);
+  ierr = VecFusedOpsDot(fops,y[0],y[1],&fdot[0]);CHKERRQ(ierr);
+  ierr = VecFusedOpsWAXPY(fops,y[3],alpha[2],y[0],y[1]);CHKERRQ(ierr);
+  ierr = VecFusedOpsNorm(fops,y[3],NORM_2,&fnrm[0]);CHKERRQ(ierr);
+  ierr = VecFusedOpsAXPBYPCZ(fops,y[2],alpha[0],alpha[1],alpha[2],y[0],y[3]);CHKERRQ(ierr);
+  ierr = VecFusedOpsMAXPY(fops,y[0],3,alpha,y+1);CHKERRQ(ierr);
+  ierr = VecFusedOpsTDot(fops,y[0],y[2],&fdot[1]);CHKERRQ(ierr);
+  ierr = VecFusedOpsNorm(fops,y[0],NORM_1,&fnrm[1]);CHKERRQ(ierr);
+  ierr = VecFusedOpsExecute(fops);CHKERRQ(ierr);
+
+  for (i=0; i<k; i++) {
+    ierr   = VecWAXPY(w,-1.0,x[i],y[i]);CHKERRQ(ierr);
+    ierr   = VecNorm(w,NORM_INFINITY,&err);CHKERRQ(ierr);
+    maxerr = PetscMax(maxerr,err);
+  }
+  for (i=0; i<2; i++) {
+    maxerr = PetscMax(maxerr,PetscAbsScalar(dot[i]-fdot[i])/PetscAbsScalar(dot[i]));
+    maxerr = PetscMax(maxerr,PetscAbsReal(nrm[i]-fnrm[i])/nrm[i]);
+  }
+  if (maxerr > 100*PETSC_MACHINE_EPSILON) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Fused and separate operations differ by %g\n",(double)maxerr);CHKERRQ(ierr);}
+
+  /* an empty sequence, and reuse after VecFusedOpsExecute() */
+  ierr = VecFusedOpsExecute(fops);CHKERRQ(ierr);
+  ierr = VecFusedOpsNorm(fops,y[0],NORM_1,&fnrm[0]);CHKERRQ(ierr);
+  ierr = VecFusedOpsExecute(fops);CHKERRQ(ierr);
+  if (fnrm[0] != fnrm[1]) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm changed on reuse\n");CHKERRQ(ierr);}
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"done\n");CHKERRQ(ierr);
+
+  ierr = VecFusedOpsDestroy(&fops);CHKERRQ(ierr);
+  for (i=0; i<k; i++) {
+    ierr = VecDestroy(&x[i]);CHKERRQ(ierr);
+    ierr = VecDestroy(&y[i]);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rnd);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+
+   test:
+     suffix: 2
+     nsize: 3
+     args: -n 37
+     output_file: output/ex48_1.out
+
+TEST*/
@@ -0,0 +1,111 @@
+
+static char help[] = "Compares the tiled and untiled VecMDot() and VecMAXPY() kernels, as used by GMRES with a long restart.\n\
+  -n <n> : length of the vectors\n\
+  -nv <nv> : number of vectors\n\
+  -its <its> : number of products to time\n\
+  -tile <tile> : tile size of the tiled kernels\n\
+  -timing : print the effective bandwidth of each kernel\n\n";
+
+#include <petscvec.h>
+#include <petsctime.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = 100000,nv = 30,its = 10,tile = 2048,i,k,t;
+  PetscBool      timing = PETSC_FALSE,tileset;
+  PetscRandom    rnd;
+  Vec            x,y,w,*v;
+  PetscScalar    *dots[3],*alpha;
+  PetscReal      err = 0.0,nrm,ynrm;
+  PetscLogDouble t0,t1,tmdot,tmaxpy;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nv",&nv,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-tile",&tile,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-timing",&timing,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rnd);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rnd);CHKERRQ(ierr);
+  ierr = VecCreateSeq(PETSC_COMM_SELF,n,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,nv,&v);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rnd);CHKERRQ(ierr);
+  for (k=0; k<nv; k++) {ierr = VecSetRandom(v[k],rnd);CHKERRQ(ierr);}
+  ierr = PetscMalloc4(nv,&dots[0],nv,&dots[1],nv,&dots[2],nv,&alpha);CHKERRQ(ierr);
+  for (k=0; k<nv; k++) alpha[k] = -1.0/(k+1);
+
+  /* the tiles are opt-in, the default must give exactly the results of the untiled kernels */
+  ierr = PetscOptionsHasName(NULL,NULL,"-vec_multi_tile_size",&tileset);CHKERRQ(ierr);
+  ierr = VecMDot(x,nv,v,dots[2]);CHKERRQ(ierr);
+
+  for (t=0; t<2; t++) {
+    ierr   = VecMultiSetTileSize(t ? tile : 0);CHKERRQ(ierr);
+    tmdot  = 0.0;
+    tmaxpy = 0.0;
+    for (i=0; i<its; i++) {
+      ierr   = PetscTime(&t0);CHKERRQ(ierr);
+      ierr   = VecMDot(x,nv,v,dots[t]);CHKERRQ(ierr);
+      ierr   = PetscTime(&t1);CHKERRQ(ierr);
+      tmdot += t1 - t0;
+      ierr   = VecCopy(x,y);CHKERRQ(ierr);
+      ierr   = PetscTime(&t0);CHKERRQ(ierr);
+      ierr   = VecMAXPY(y,nv,alpha,v);CHKERRQ(ierr);
+      ierr   = PetscTime(&t1);CHKERRQ(ierr);
+      tmaxpy += t1 - t0;
+    }
+    if (!t) {
+      ierr = VecCopy(y,w);CHKERRQ(ierr);
+    } else {
+      ierr = VecAXPY(w,-1.0,y);CHKERRQ(ierr);
+      ierr = VecNorm(w,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+      ierr = VecNorm(y,NORM_INFINITY,&ynrm);CHKERRQ(ierr);
+      err  = nrm/ynrm;
+    }
+    /* bytes that must move at least once: x and the nv vectors, plus writing x for VecMAXPY() */
+    if (timing) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%-8s VecMDot %8.3f GB/s  VecMAXPY %8.3f GB/s\n",t ? "tiled" : "untiled",
+                         1.e-9*its*(nv+1)*n*sizeof(PetscScalar)/tmdot,1.e-9*its*(nv+2)*n*sizeof(PetscScalar)/tmaxpy);CHKERRQ(ierr);
+    }
+  }
+  for (k=0; k<nv; k++) {
+    if (!tileset && dots[2][k] != dots[0][k]) {ierr = PetscPrintf(PETSC_COMM_SELF,"Default VecMDot() differs from the untiled kernels\n");CHKERRQ(ierr); break;}
+  }
+  for (k=0; k<nv; k++) err = PetscMax(err,PetscAbsScalar(dots[0][k]-dots[1][k])/PetscAbsScalar(dots[0][k]));
+  if (err > 1.e3*PETSC_MACHINE_EPSILON) {ierr = PetscPrintf(PETSC_COMM_SELF,"Tiled and untiled kernels differ by %g\n",(double)err);CHKERRQ(ierr);}
+  ierr = PetscPrintf(PETSC_COMM_SELF,"done\n");CHKERRQ(ierr);
+
+  ierr = PetscFree4(dots[0],dots[1],dots[2],alpha);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nv,&v);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rnd);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+
+/*TEST
+
+   test:
+     args: -n 5000 -nv 37 -its 1 -tile 512
+
+   test:
+     suffix: 2
+     args: -n 3001 -nv 7 -its 2 -tile 1000
+     output_file: output/ex49_1.out
+
+   test:
+     suffix: none
+     args: -n 5000 -nv 37 -its 1 -tile 512 -vec_simd none
+     output_file: output/ex49_1.out
+
+   test:
+     suffix: avx2
+     args: -n 5000 -nv 37 -its 1 -tile 512 -vec_simd avx2
+     output_file: output/ex49_1.out
+
+TEST*/
@@ -6,7 +6,300 @@
 #include <../src/vec/vec/impls/dvecimpl.h>
 #include <petsc/private/kernels/petscaxpy.h>
 
+/*
+   Blocked VecMDot_Seq() and VecMAXPY_Seq() for many long vectors, as in GMRES with a large restart. The unblocked
+   kernels stream x through memory once for every group of four y vectors. The blocked ones work on tiles of
+   VecMultiTileSize entries, short enough for the tile of x to stay in cache while all the y vectors of a block
+   of VEC_MULTI_NV are applied to it, so x is read (and for VecMAXPY() written) once per block of vectors instead.
+
+   The kernels applied to a tile have AVX2 and AVX-512 variants compiled with __attribute((target())) and selected
+   when the program runs by VecMultiSetSIMDKernels_Private(), with the instruction set given by PetscGetSIMDType().
+
+   The tiles are off by default (VecMultiTileSize = 0): a tiled VecMDot() adds the partial sums of the tiles, which
+   rounds differently from the untiled kernels and so changes, for example, the residual history of GMRES.
+*/
+#define VEC_MULTI_NV 32
+static PetscInt VecMultiTileSize = 0;
+
+#if defined(PETSC_HAVE_ATTRIBUTE_TARGET) && defined(PETSC_HAVE_IMMINTRIN_H) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+#define VEC_MULTI_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
+/*@
+   VecMultiSetTileSize - Sets the number of entries of the tiles used by VecMDot() and VecMAXPY() on sequential
+   (and the local part of parallel) vectors with more than four other vectors
+
+   Not Collective
+
+   Input Parameter:
+.  n - the tile size, or 0 (the default) to process each group of four vectors over the whole length
+
+   Options Database Keys:
++  -vec_multi_tile_size <n> - sets the tile size
+-  -vec_simd <none,avx2,avx512> - use at most this instruction set for the tiles, see PetscGetSIMDType()
+
+   Level: advanced
+
+   Notes:
+   The tiled kernels are off by default since they sum the entries of VecMDot() in a different order, so with them
+   the results change in the last bits, as does the convergence history of GMRES. A tile size of 2048 keeps a tile of
+   x and of four other vectors in the level 1 or 2 cache. The tiled kernels are only used for vectors longer than one
+   tile, so the results for shorter vectors do not change.
+
+.seealso: VecMDot(), VecMAXPY(), KSPGMRES, PetscGetSIMDType()
+@*/
+PetscErrorCode VecMultiSetTileSize(PetscInt n)
+{
+  PetscFunctionBegin;
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Tile size %D cannot be negative",n);
+  VecMultiTileSize = n;
+  PetscFunctionReturn(0);
+}
+
+/* z[k] += sum_i x[i] conj(y_k[i]) for the four vectors y_k */
+static void VecMDotTile4_Private(PetscInt n,const PetscScalar *x,const PetscScalar *y0,const PetscScalar *y1,const PetscScalar *y2,const PetscScalar *y3,PetscScalar *z)
+{
+  PetscInt    i;
+  PetscScalar s0 = 0.0,s1 = 0.0,s2 = 0.0,s3 = 0.0,xi;
+
+  for (i=0; i<n; i++) {
+    xi  = x[i];
+    s0 += xi*PetscConj(y0[i]); s1 += xi*PetscConj(y1[i]);
+    s2 += xi*PetscConj(y2[i]); s3 += xi*PetscConj(y3[i]);
+  }
+  z[0] += s0; z[1] += s1; z[2] += s2; z[3] += s3;
+}
+
+static void VecMDotTile1_Private(PetscInt n,const PetscScalar *x,const PetscScalar *y0,PetscScalar *z)
+{
+  PetscInt    i;
+  PetscScalar s0 = 0.0;
+
+  for (i=0; i<n; i++) s0 += x[i]*PetscConj(y0[i]);
+  z[0] += s0;
+}
+
+/* x[i] += sum_k a[k] y_k[i] for the four vectors y_k */
+static void VecMAXPYTile4_Private(PetscInt n,PetscScalar *x,const PetscScalar *a,const PetscScalar *y0,const PetscScalar *y1,const PetscScalar *y2,const PetscScalar *y3)
+{
+  PetscInt    i;
+  PetscScalar a0 = a[0],a1 = a[1],a2 = a[2],a3 = a[3];
+
+  for (i=0; i<n; i++) x[i] += a0*y0[i] + a1*y1[i] + a2*y2[i] + a3*y3[i];
+}
+
+#if defined(VEC_MULTI_SIMD_KERNELS)
+__attribute((target("avx2,fma")))
+PETSC_STATIC_INLINE double VecMultiReduce_AVX2(__m256d v)
+{
+  __m128d lo = _mm_add_pd(_mm256_castpd256_pd128(v),_mm256_extractf128_pd(v,1));
+  return _mm_cvtsd_f64(_mm_add_sd(lo,_mm_unpackhi_pd(lo,lo)));
+}
+
+__attribute((target("avx2,fma")))
+static void VecMDotTile4_AVX2(PetscInt n,const PetscScalar *x,const PetscScalar *y0,const PetscScalar *y1,const PetscScalar *y2,const PetscScalar *y3,PetscScalar *z)
+{
+  __m256d     v0 = _mm256_setzero_pd(),v1 = _mm256_setzero_pd(),v2 = _mm256_setzero_pd(),v3 = _mm256_setzero_pd(),xv;
+  PetscScalar s0,s1,s2,s3,xi;
+  PetscInt    i;
+
+  for (i=0; i+4<=n; i+=4) {
+    xv = _mm256_loadu_pd(x+i);
+    v0 = _mm256_fmadd_pd(xv,_mm256_loadu_pd(y0+i),v0);
+    v1 = _mm256_fmadd_pd(xv,_mm256_loadu_pd(y1+i),v1);
+    v2 = _mm256_fmadd_pd(xv,_mm256_loadu_pd(y2+i),v2);
+    v3 = _mm256_fmadd_pd(xv,_mm256_loadu_pd(y3+i),v3);
+  }
+  s0 = VecMultiReduce_AVX2(v0); s1 = VecMultiReduce_AVX2(v1);
+  s2 = VecMultiReduce_AVX2(v2); s3 = VecMultiReduce_AVX2(v3);
+  for (; i<n; i++) {
+    xi  = x[i];
+    s0 += xi*y0[i]; s1 += xi*y1[i]; s2 += xi*y2[i]; s3 += xi*y3[i];
+  }
+  z[0] += s0; z[1] += s1; z[2] += s2; z[3] += s3;
+}
+
+__attribute((target("avx2,fma")))
+static void VecMDotTile1_AVX2(PetscInt n,const PetscScalar *x,const PetscScalar *y0,PetscScalar *z)
+{
+  __m256d     v0 = _mm256_setzero_pd();
+  PetscScalar s0;
+  PetscInt    i;
+
+  for (i=0; i+4<=n; i+=4) v0 = _mm256_fmadd_pd(_mm256_loadu_pd(x+i),_mm256_loadu_pd(y0+i),v0);
+  s0 = VecMultiReduce_AVX2(v0);
+  for (; i<n; i++) s0 += x[i]*y0[i];
+  z[0] += s0;
+}
+
+__attribute((target("avx2,fma")))
+static void VecMAXPYTile4_AVX2(PetscInt n,PetscScalar *x,const PetscScalar *a,const PetscScalar *y0,const PetscScalar *y1,const PetscScalar *y2,const PetscScalar *y3)
+{
+  __m256d  va0 = _mm256_set1_pd(a[0]),va1 = _mm256_set1_pd(a[1]),va2 = _mm256_set1_pd(a[2]),va3 = _mm256_set1_pd(a[3]),xv;
+  PetscInt i;
+
+  for (i=0; i+4<=n; i+=4) {
+    xv = _mm256_loadu_pd(x+i);
+    xv = _mm256_fmadd_pd(va0,_mm256_loadu_pd(y0+i),xv);
+    xv = _mm256_fmadd_pd(va1,_mm256_loadu_pd(y1+i),xv);
+    xv = _mm256_fmadd_pd(va2,_mm256_loadu_pd(y2+i),xv);
+    xv = _mm256_fmadd_pd(va3,_mm256_loadu_pd(y3+i),xv);
+    _mm256_storeu_pd(x+i,xv);
+  }
+  for (; i<n; i++) x[i] += a[0]*y0[i] + a[1]*y1[i] + a[2]*y2[i] + a[3]*y3[i];
+}
+
+__attribute((target("avx512f")))
+static void VecMDotTile4_AVX512(PetscInt n,const PetscScalar *x,const PetscScalar *y0,const PetscScalar *y1,const PetscScalar *y2,const PetscScalar *y3,PetscScalar *z)
+{
+  __m512d     v0 = _mm512_setzero_pd(),v1 = _mm512_setzero_pd(),v2 = _mm512_setzero_pd(),v3 = _mm512_setzero_pd(),xv;
+  PetscScalar s0,s1,s2,s3,xi;
+  PetscInt    i;
+
+  for (i=0; i+8<=n; i+=8) {
+    xv = _mm512_loadu_pd(x+i);
+    v0 = _mm512_fmadd_pd(xv,_mm512_loadu_pd(y0+i),v0);
+    v1 = _mm512_fmadd_pd(xv,_mm512_loadu_pd(y1+i),v1);
+    v2 = _mm512_fmadd_pd(xv,_mm512_loadu_pd(y2+i),v2);
+    v3 = _mm512_fmadd_pd(xv,_mm512_loadu_pd(y3+i),v3);
+  }
+  s0 = _mm512_reduce_add_pd(v0); s1 = _mm512_reduce_add_pd(v1);
+  s2 = _mm512_reduce_add_pd(v2); s3 = _mm512_reduce_add_pd(v3);
+  for (; i<n; i++) {
+    xi  = x[i];
+    s0 += xi*y0[i]; s1 += xi*y1[i]; s2 += xi*y2[i]; s3 += xi*y3[i];
+  }
+  z[0] += s0; z[1] += s1; z[2] += s2; z[3] += s3;
+}
+
+__attribute((target("avx512f")))
+static void VecMDotTile1_AVX512(PetscInt n,const PetscScalar *x,const PetscScalar *y0,PetscScalar *z)
+{
+  __m512d     v0 = _mm512_setzero_pd();
+  PetscScalar s0;
+  PetscInt    i;
+
+  for (i=0; i+8<=n; i+=8) v0 = _mm512_fmadd_pd(_mm512_loadu_pd(x+i),_mm512_loadu_pd(y0+i),v0);
+  s0 = _mm512_reduce_add_pd(v0);
+  for (; i<n; i++) s0 += x[i]*y0[i];
+  z[0] += s0;
+}
+
+__attribute((target("avx512f")))
+static void VecMAXPYTile4_AVX512(PetscInt n,PetscScalar *x,const PetscScalar *a,const PetscScalar *y0,const PetscScalar *y1,const PetscScalar *y2,const PetscScalar *y3)
+{
+  __m512d  va0 = _mm512_set1_pd(a[0]),va1 = _mm512_set1_pd(a[1]),va2 = _mm512_set1_pd(a[2]),va3 = _mm512_set1_pd(a[3]),xv;
+  PetscInt i;
+
+  for (i=0; i+8<=n; i+=8) {
+    xv = _mm512_loadu_pd(x+i);
+    xv = _mm512_fmadd_pd(va0,_mm512_loadu_pd(y0+i),xv);
+    xv = _mm512_fmadd_pd(va1,_mm512_loadu_pd(y1+i),xv);
+    xv = _mm512_fmadd_pd(va2,_mm512_loadu_pd(y2+i),xv);
+    xv = _mm512_fmadd_pd(va3,_mm512_loadu_pd(y3+i),xv);
+    _mm512_storeu_pd(x+i,xv);
+  }
+  for (; i<n; i++) x[i] += a[0]*y0[i] + a[1]*y1[i] + a[2]*y2[i] + a[3]*y3[i];
+}
+#endif
+
+static void (*VecMDotTile4)(PetscInt,const PetscScalar*,const PetscScalar*,const PetscScalar*,const PetscScalar*,const PetscScalar*,PetscScalar*) = VecMDotTile4_Private;
+static void (*VecMDotTile1)(PetscInt,const PetscScalar*,const PetscScalar*,PetscScalar*) = VecMDotTile1_Private;
+static void (*VecMAXPYTile4)(PetscInt,PetscScalar*,const PetscScalar*,const PetscScalar*,const PetscScalar*,const PetscScalar*,const PetscScalar*) = VecMAXPYTile4_Private;
+
+/*
+   Selects the tile kernels for the instruction set given by PetscGetSIMDType(), which a lower one can be requested
+   from with -vec_simd <none,avx2,avx512>. Called by VecInitializePackage().
+*/
+PetscErrorCode VecMultiSetSIMDKernels_Private(void)
+{
+  PetscErrorCode ierr;
+  PetscSIMDType  req;
+
+  PetscFunctionBegin;
+  ierr = PetscGetSIMDType("-vec_simd",&req);CHKERRQ(ierr);
+#if !defined(VEC_MULTI_SIMD_KERNELS)
+  req = PETSC_SIMD_NONE;
+#endif
+  VecMDotTile4  = VecMDotTile4_Private;
+  VecMDotTile1  = VecMDotTile1_Private;
+  VecMAXPYTile4 = VecMAXPYTile4_Private;
+#if defined(VEC_MULTI_SIMD_KERNELS)
+  if (req == PETSC_SIMD_AVX512) {
+    VecMDotTile4  = VecMDotTile4_AVX512;
+    VecMDotTile1  = VecMDotTile1_AVX512;
+    VecMAXPYTile4 = VecMAXPYTile4_AVX512;
+  } else if (req == PETSC_SIMD_AVX2) {
+    VecMDotTile4  = VecMDotTile4_AVX2;
+    VecMDotTile1  = VecMDotTile1_AVX2;
+    VecMAXPYTile4 = VecMAXPYTile4_AVX2;
+  }
+#endif
+  ierr = PetscInfo1(NULL,"Using %s kernels for the tiles of VecMDot() and VecMAXPY()\n",PetscSIMDTypes[req]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecMDot_Seq_Tiled(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,i,k,k0,kn,len;
+  const PetscScalar *x,*y[VEC_MULTI_NV];
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xin,&x);CHKERRQ(ierr);
+  for (k0=0; k0<nv; k0+=VEC_MULTI_NV) {
+    kn = PetscMin(VEC_MULTI_NV,nv-k0);
+    for (k=0; k<kn; k++) {
+      ierr     = VecGetArrayRead(yin[k0+k],&y[k]);CHKERRQ(ierr);
+      z[k0+k]  = 0.0;
+    }
+    for (i=0; i<n; i+=VecMultiTileSize) {
+      len = PetscMin(VecMultiTileSize,n-i);
+      for (k=0; k+4<=kn; k+=4) (*VecMDotTile4)(len,x+i,y[k]+i,y[k+1]+i,y[k+2]+i,y[k+3]+i,z+k0+k);
+      for (; k<kn; k++) (*VecMDotTile1)(len,x+i,y[k]+i,z+k0+k);
+    }
+    for (k=0; k<kn; k++) {
+      ierr = VecRestoreArrayRead(yin[k0+k],&y[k]);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(PetscMax(nv*(2.0*n-1),0.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecMAXPY_Seq_Tiled(Vec xin,PetscInt nv,const PetscScalar *alpha,Vec *yin)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,i,j,k,k0,kn,len;
+  PetscScalar       *x;
+  const PetscScalar *y[VEC_MULTI_NV];
 
+  PetscFunctionBegin;
+  ierr = PetscLogFlops(nv*2.0*n);CHKERRQ(ierr);
+  ierr = VecGetArray(xin,&x);CHKERRQ(ierr);
+  for (k0=0; k0<nv; k0+=VEC_MULTI_NV) {
+    kn = PetscMin(VEC_MULTI_NV,nv-k0);
+    for (k=0; k<kn; k++) {
+      ierr = VecGetArrayRead(yin[k0+k],&y[k]);CHKERRQ(ierr);
+    }
+    for (i=0; i<n; i+=VecMultiTileSize) {
+      len = PetscMin(VecMultiTileSize,n-i);
+      for (k=0; k+4<=kn; k+=4) (*VecMAXPYTile4)(len,x+i,alpha+k0+k,y[k]+i,y[k+1]+i,y[k+2]+i,y[k+3]+i);
+      for (; k<kn; k++) {
+        const PetscScalar a = alpha[k0+k],*yk = y[k]+i;
+        PetscScalar       *xi = x+i;
+
+        for (j=0; j<len; j++) xi[j] += a*yk[j];
+      }
+    }
+    for (k=0; k<kn; k++) {
+      ierr = VecRestoreArrayRead(yin[k0+k],&y[k]);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecRestoreArray(xin,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
 #if defined(PETSC_USE_FORTRAN_KERNEL_MDOT)
 #include <../src/vec/vec/impls/seq/ftn-kernels/fmdot.h>
@@ -19,6 +312,10 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
   Vec               *yy;
 
   PetscFunctionBegin;
+  if (VecMultiTileSize && nv > 4 && xin->map->n > VecMultiTileSize) {
+    ierr = VecMDot_Seq_Tiled(xin,nv,yin,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   sum0 = 0.0;
   sum1 = 0.0;
   sum2 = 0.0;
@@ -100,6 +397,10 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
   Vec               *yy;
 
   PetscFunctionBegin;
+  if (VecMultiTileSize && nv > 4 && xin->map->n > VecMultiTileSize) {
+    ierr = VecMDot_Seq_Tiled(xin,nv,yin,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   sum0 = 0.;
   sum1 = 0.;
   sum2 = 0.;
@@ -565,6 +866,10 @@ PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv,const PetscScalar *alpha,Vec *y
 #endif
 
   PetscFunctionBegin;
+  if (VecMultiTileSize && nv > 4 && n > VecMultiTileSize) {
+    ierr = VecMAXPY_Seq_Tiled(xin,nv,alpha,y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscLogFlops(nv*2.0*n);CHKERRQ(ierr);
   ierr = VecGetArray(xin,&xx);CHKERRQ(ierr);
   switch (j_rem=nv&0x3) {
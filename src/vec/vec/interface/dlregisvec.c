@@ -149,6 +149,7 @@ PetscErrorCode  VecInitializePackage(void)
 {
   char           logList[256];
   PetscBool      opt,pkg;
+  PetscInt       tile;
   PetscErrorCode ierr;
   PetscInt       i;
 
@@ -177,6 +178,7 @@ PetscErrorCode  VecInitializePackage(void)
   ierr = PetscLogEventRegister("VecAXPBYCZ",       VEC_CLASSID,&VEC_AXPBYPCZ);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecWAXPY",         VEC_CLASSID,&VEC_WAXPY);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecMAXPY",         VEC_CLASSID,&VEC_MAXPY);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecFusedOps",      VEC_CLASSID,&VEC_FusedOps);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecSwap",          VEC_CLASSID,&VEC_Swap);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecOps",           VEC_CLASSID,&VEC_Ops);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecAssemblyBegin", VEC_CLASSID,&VEC_AssemblyBegin);CHKERRQ(ierr);
@@ -234,6 +236,11 @@ PetscErrorCode  VecInitializePackage(void)
     if (pkg) {ierr = PetscLogEventExcludeClass(VEC_SCATTER_CLASSID);CHKERRQ(ierr);}
   }
 
+  /* Process the tile size and the SIMD kernels of VecMDot() and VecMAXPY() */
+  ierr = PetscOptionsGetInt(NULL,NULL,"-vec_multi_tile_size",&tile,&opt);CHKERRQ(ierr);
+  if (opt) {ierr = VecMultiSetTileSize(tile);CHKERRQ(ierr);}
+  ierr = VecMultiSetSIMDKernels_Private();CHKERRQ(ierr);
+
   /*
     Create the special MPI reduction operation that may be used by VecNorm/DotBegin()
   */
@@ -0,0 +1,607 @@
+
+/*
+      Fused vector operations: a short sequence of AXPY-like updates, dot products and norms is recorded and
+   then performed in one pass over the vectors, with all the reductions combined into one MPI_Allreduce().
+
+       Usage:
+             VecFusedOpsAXPY(fops,x,alpha,p);
+             VecFusedOpsAXPY(fops,r,-alpha,w);
+             VecFusedOpsNorm(fops,r,NORM_2,&rnorm);
+             VecFusedOpsExecute(fops);
+
+      The pass goes over the vectors in chunks that are small enough to stay in cache; all the operations are
+   applied to a chunk, in the order they were recorded, before moving on to the next chunk. Since every operation
+   only combines entries with the same index this gives the same result as performing the operations one after
+   the other, except for the rounding of the dot products and norms.
+*/
+
+#include <petsc/private/vecimpl.h>    /*I   "petscvec.h"    I*/
+
+#define VEC_FUSED_CHUNK 512
+
+typedef enum {VEC_FUSED_AXPY,VEC_FUSED_AYPX,VEC_FUSED_WAXPY,VEC_FUSED_AXPBYPCZ,VEC_FUSED_MAXPY,VEC_FUSED_DOT,VEC_FUSED_TDOT,VEC_FUSED_NORM_1,VEC_FUSED_NORM_2} VecFusedOpType;
+
+typedef struct {
+  VecFusedOpType    type;
+  PetscScalar       alpha,beta,gamma;
+  const PetscScalar *coef;            /* coefficients of VEC_FUSED_MAXPY */
+  PetscInt          first,nvec;       /* the operands are vecs[first] to vecs[first+nvec-1], the updated vector first */
+  PetscInt          red;              /* location of the local and global result of a reduction */
+  void              *result;          /* where the dot product or norm is returned */
+} VecFusedOp;
+
+struct _n_VecFusedOps {
+  PetscInt    nops,maxops;
+  VecFusedOp  *ops;
+  PetscInt    nvecs,maxvecs;
+  Vec         *vecs;
+  PetscBool   *write;                 /* the operand is updated by its operation */
+  PetscScalar **arrays;
+  PetscInt    nred,maxred;
+  PetscScalar *lred,*gred;
+};
+
+/*@C
+   VecFusedOpsCreate - Creates an empty sequence of fused vector operations
+
+   Not Collective
+
+   Output Parameter:
+.  fops - the sequence
+
+   Level: advanced
+
+   Notes:
+   The operations are recorded with VecFusedOpsAXPY(), VecFusedOpsAYPX(), VecFusedOpsWAXPY(), VecFusedOpsAXPBYPCZ(),
+   VecFusedOpsMAXPY(), VecFusedOpsDot(), VecFusedOpsTDot() and VecFusedOpsNorm(), and performed by VecFusedOpsExecute(),
+   after which the sequence is empty and can be reused.
+
+   Concepts: vector^fused operations
+
+.seealso: VecFusedOpsExecute(), VecFusedOpsDestroy(), VecDotBegin()
+@*/
+PetscErrorCode VecFusedOpsCreate(VecFusedOps *fops)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  ierr = PetscNew(fops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   VecFusedOpsDestroy - Destroys a sequence of fused vector operations
+
+   Not Collective
+
+   Input Parameter:
+.  fops - the sequence
+
+   Level: advanced
+
+   Notes:
+   Operations recorded since the last VecFusedOpsExecute() are discarded.
+
+.seealso: VecFusedOpsCreate()
+@*/
+PetscErrorCode VecFusedOpsDestroy(VecFusedOps *fops)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!*fops) PetscFunctionReturn(0);
+  ierr = PetscFree((*fops)->ops);CHKERRQ(ierr);
+  ierr = PetscFree3((*fops)->vecs,(*fops)->write,(*fops)->arrays);CHKERRQ(ierr);
+  ierr = PetscFree2((*fops)->lred,(*fops)->gred);CHKERRQ(ierr);
+  ierr = PetscFree(*fops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Appends an operation on y and the nx vectors x to the sequence; y is updated if write is true
+*/
+static PetscErrorCode VecFusedOpsAdd_Private(VecFusedOps fops,VecFusedOpType type,Vec y,PetscInt nx,const Vec x[],PetscBool write,void *result,VecFusedOp **op)
+{
+  PetscErrorCode ierr;
+  PetscInt       k,nvec = nx+1;
+  Vec            v = fops->nvecs ? fops->vecs[0] : y,*nvecs;
+  PetscBool      *nwrite;
+  PetscScalar    **narrays,*nlred,*ngred;
+  VecFusedOp     *nops;
+
+  PetscFunctionBegin;
+  for (k=0; k<nvec; k++) {
+    Vec w = k ? x[k-1] : y;
+    PetscCheckSameTypeAndComm(v,1,w,2);
+    if (v->map->n != w->map->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"All the vectors of a VecFusedOps must have the same local size, %D != %D",v->map->n,w->map->n);
+  }
+  if (fops->nops == fops->maxops) {
+    fops->maxops = fops->maxops ? 2*fops->maxops : 8;
+    ierr = PetscMalloc1(fops->maxops,&nops);CHKERRQ(ierr);
+    ierr = PetscMemcpy(nops,fops->ops,fops->nops*sizeof(VecFusedOp));CHKERRQ(ierr);
+    ierr = PetscFree(fops->ops);CHKERRQ(ierr);
+    fops->ops = nops;
+  }
+  if (fops->nvecs + nvec > fops->maxvecs) {
+    PetscInt maxvecs = PetscMax(2*fops->maxvecs,fops->nvecs + nvec + 8);
+
+    ierr = PetscMalloc3(maxvecs,&nvecs,maxvecs,&nwrite,maxvecs,&narrays);CHKERRQ(ierr);
+    ierr = PetscMemcpy(nvecs,fops->vecs,fops->nvecs*sizeof(Vec));CHKERRQ(ierr);
+    ierr = PetscMemcpy(nwrite,fops->write,fops->nvecs*sizeof(PetscBool));CHKERRQ(ierr);
+    ierr = PetscFree3(fops->vecs,fops->write,fops->arrays);CHKERRQ(ierr);
+    fops->vecs    = nvecs;
+    fops->write   = nwrite;
+    fops->arrays  = narrays;
+    fops->maxvecs = maxvecs;
+  }
+  if (result && fops->nred == fops->maxred) {
+    fops->maxred = fops->maxred ? 2*fops->maxred : 8;
+    ierr = PetscMalloc2(fops->maxred,&nlred,fops->maxred,&ngred);CHKERRQ(ierr);
+    ierr = PetscFree2(fops->lred,fops->gred);CHKERRQ(ierr);
+    fops->lred = nlred;
+    fops->gred = ngred;
+  }
+  *op           = fops->ops + fops->nops++;
+  ierr          = PetscMemzero(*op,sizeof(VecFusedOp));CHKERRQ(ierr);
+  (*op)->type   = type;
+  (*op)->first  = fops->nvecs;
+  (*op)->nvec   = nvec;
+  (*op)->red    = result ? fops->nred++ : -1;
+  (*op)->result = result;
+  for (k=0; k<nvec; k++) {
+    fops->vecs[fops->nvecs]  = k ? x[k-1] : y;
+    fops->write[fops->nvecs] = (PetscBool)(write && !k);
+    fops->nvecs++;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecFusedOpsAXPY - Records y = alpha x + y in a sequence of fused vector operations
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  fops - the sequence
+.  y - the vector to update
+.  alpha - the scalar
+-  x - the other vector
+
+   Level: advanced
+
+   Notes:
+   x and y MUST be different vectors. The update is done by VecFusedOpsExecute().
+
+.seealso: VecAXPY(), VecFusedOpsCreate(), VecFusedOpsExecute()
+@*/
+PetscErrorCode VecFusedOpsAXPY(VecFusedOps fops,Vec y,PetscScalar alpha,Vec x)
+{
+  PetscErrorCode ierr;
+  VecFusedOp     *op;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,4);
+  if (x == y) SETERRQ(PetscObjectComm((PetscObject)x),PETSC_ERR_ARG_IDN,"x and y cannot be the same vector");
+  PetscValidLogicalCollectiveScalar(y,alpha,3);
+  ierr = VecFusedOpsAdd_Private(fops,VEC_FUSED_AXPY,y,1,&x,PETSC_TRUE,NULL,&op);CHKERRQ(ierr);
+  op->alpha = alpha;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecFusedOpsAYPX - Records y = x + beta y in a sequence of fused vector operations
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  fops - the sequence
+.  y - the vector to update
+.  beta - the scalar
+-  x - the other vector
+
+   Level: advanced
+
+   Notes:
+   x and y MUST be different vectors. The update is done by VecFusedOpsExecute().
+
+.seealso: VecAYPX(), VecFusedOpsCreate(), VecFusedOpsExecute()
+@*/
+PetscErrorCode VecFusedOpsAYPX(VecFusedOps fops,Vec y,PetscScalar beta,Vec x)
+{
+  PetscErrorCode ierr;
+  VecFusedOp     *op;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,4);
+  if (x == y) SETERRQ(PetscObjectComm((PetscObject)x),PETSC_ERR_ARG_IDN,"x and y must be different vectors");
+  PetscValidLogicalCollectiveScalar(y,beta,3);
+  ierr = VecFusedOpsAdd_Private(fops,VEC_FUSED_AYPX,y,1,&x,PETSC_TRUE,NULL,&op);CHKERRQ(ierr);
+  op->beta = beta;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecFusedOpsWAXPY - Records w = alpha x + y in a sequence of fused vector operations
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  fops - the sequence
+.  w - the result vector
+.  alpha - the scalar
+-  x, y - the vectors
+
+   Level: advanced
+
+   Notes:
+   w must be different from x and y. The update is done by VecFusedOpsExecute().
+
+.seealso: VecWAXPY(), VecFusedOpsCreate(), VecFusedOpsExecute()
+@*/
+PetscErrorCode VecFusedOpsWAXPY(VecFusedOps fops,Vec w,PetscScalar alpha,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+  Vec            v[2];
+  VecFusedOp     *op;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  PetscValidHeaderSpecific(w,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,4);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,5);
+  if (w == y) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Result vector w cannot be same as input vector y, suggest VecFusedOpsAXPY()");
+  if (w == x) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Result vector w cannot be same as input vector x, suggest VecFusedOpsAYPX()");
+  PetscValidLogicalCollectiveScalar(w,alpha,3);
+  v[0] = x; v[1] = y;
+  ierr = VecFusedOpsAdd_Private(fops,VEC_FUSED_WAXPY,w,2,v,PETSC_TRUE,NULL,&op);CHKERRQ(ierr);
+  op->alpha = alpha;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecFusedOpsAXPBYPCZ - Records z = alpha x + beta y + gamma z in a sequence of fused vector operations
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  fops - the sequence
+.  z - the vector to update
+.  alpha, beta, gamma - the scalars
+-  x, y - the other vectors
+
+   Level: advanced
+
+   Notes:
+   x, y and z must be different vectors. The update is done by VecFusedOpsExecute().
+
+.seealso: VecAXPBYPCZ(), VecFusedOpsCreate(), VecFusedOpsExecute()
+@*/
+PetscErrorCode VecFusedOpsAXPBYPCZ(VecFusedOps fops,Vec z,PetscScalar alpha,PetscScalar beta,PetscScalar gamma,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+  Vec            v[2];
+  VecFusedOp     *op;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  PetscValidHeaderSpecific(z,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,6);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,7);
+  if (x == y || x == z || y == z) SETERRQ(PetscObjectComm((PetscObject)x),PETSC_ERR_ARG_IDN,"x, y, and z must be different vectors");
+  PetscValidLogicalCollectiveScalar(z,alpha,3);
+  PetscValidLogicalCollectiveScalar(z,beta,4);
+  PetscValidLogicalCollectiveScalar(z,gamma,5);
+  v[0] = x; v[1] = y;
+  ierr = VecFusedOpsAdd_Private(fops,VEC_FUSED_AXPBYPCZ,z,2,v,PETSC_TRUE,NULL,&op);CHKERRQ(ierr);
+  op->alpha = alpha;
+  op->beta  = beta;
+  op->gamma = gamma;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecFusedOpsMAXPY - Records y = y + sum alpha[i] x[i] in a sequence of fused vector operations
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  fops - the sequence
+.  y - the vector to update
+.  nv - number of scalars and x-vectors
+.  alpha - array of scalars
+-  x - array of vectors
+
+   Level: advanced
+
+   Notes:
+   The alpha array is only read by VecFusedOpsExecute(), so it must not be changed or freed before then.
+
+.seealso: VecMAXPY(), VecFusedOpsCreate(), VecFusedOpsExecute()
+@*/
+PetscErrorCode VecFusedOpsMAXPY(VecFusedOps fops,Vec y,PetscInt nv,const PetscScalar alpha[],Vec x[])
+{
+  PetscErrorCode ierr;
+  PetscInt       k;
+  VecFusedOp     *op;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,2);
+  if (nv < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors (given %D) cannot be negative",nv);
+  if (nv) {
+    PetscValidScalarPointer(alpha,4);
+    PetscValidPointer(x,5);
+  }
+  for (k=0; k<nv; k++) PetscValidHeaderSpecific(x[k],VEC_CLASSID,5);
+  ierr = VecFusedOpsAdd_Private(fops,VEC_FUSED_MAXPY,y,nv,x,PETSC_TRUE,NULL,&op);CHKERRQ(ierr);
+  op->coef = alpha;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecFusedOpsDot - Records the dot product val = y^H x in a sequence of fused vector operations
+
+   Collective on Vec
+
+   Input Parameters:
++  fops - the sequence
+.  x - first vector
+.  y - second vector
+-  val - where the dot product is returned by VecFusedOpsExecute()
+
+   Level: advanced
+
+   Notes:
+   The product is computed with the values the vectors have after the operations recorded before it.
+
+.seealso: VecDot(), VecFusedOpsTDot(), VecFusedOpsCreate(), VecFusedOpsExecute()
+@*/
+PetscErrorCode VecFusedOpsDot(VecFusedOps fops,Vec x,Vec y,PetscScalar *val)
+{
+  PetscErrorCode ierr;
+  VecFusedOp     *op;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,3);
+  PetscValidScalarPointer(val,4);
+  ierr = VecFusedOpsAdd_Private(fops,VEC_FUSED_DOT,x,1,&y,PETSC_FALSE,val,&op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecFusedOpsTDot - Records the indefinite dot product val = y^T x in a sequence of fused vector operations
+
+   Collective on Vec
+
+   Input Parameters:
++  fops - the sequence
+.  x - first vector
+.  y - second vector
+-  val - where the dot product is returned by VecFusedOpsExecute()
+
+   Level: advanced
+
+.seealso: VecTDot(), VecFusedOpsDot(), VecFusedOpsCreate(), VecFusedOpsExecute()
+@*/
+PetscErrorCode VecFusedOpsTDot(VecFusedOps fops,Vec x,Vec y,PetscScalar *val)
+{
+  PetscErrorCode ierr;
+  VecFusedOp     *op;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,2);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,3);
+  PetscValidScalarPointer(val,4);
+  ierr = VecFusedOpsAdd_Private(fops,VEC_FUSED_TDOT,x,1,&y,PETSC_FALSE,val,&op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecFusedOpsNorm - Records the norm of a vector in a sequence of fused vector operations
+
+   Collective on Vec
+
+   Input Parameters:
++  fops - the sequence
+.  x - the vector
+.  type - NORM_1 or NORM_2
+-  val - where the norm is returned by VecFusedOpsExecute()
+
+   Level: advanced
+
+   Notes:
+   The norm is not cached in the vector, as VecNorm() does.
+
+.seealso: VecNorm(), VecFusedOpsCreate(), VecFusedOpsExecute()
+@*/
+PetscErrorCode VecFusedOpsNorm(VecFusedOps fops,Vec x,NormType type,PetscReal *val)
+{
+  PetscErrorCode ierr;
+  VecFusedOp     *op;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,2);
+  PetscValidRealPointer(val,4);
+  if (type != NORM_1 && type != NORM_2) SETERRQ1(PetscObjectComm((PetscObject)x),PETSC_ERR_SUP,"Norm type %s is not supported by VecFusedOpsNorm()",NormTypes[type]);
+  ierr = VecFusedOpsAdd_Private(fops,type == NORM_1 ? VEC_FUSED_NORM_1 : VEC_FUSED_NORM_2,x,0,NULL,PETSC_FALSE,val,&op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Performs the operations one after the other with the usual Vec routines, for vector types whose arrays cannot
+   be accessed directly
+*/
+static PetscErrorCode VecFusedOpsExecute_Default(VecFusedOps fops)
+{
+  PetscErrorCode ierr;
+  PetscInt       o;
+  VecFusedOp     *op;
+  Vec            *v;
+
+  PetscFunctionBegin;
+  for (o=0; o<fops->nops; o++) {
+    op = fops->ops + o;
+    v  = fops->vecs + op->first;
+    switch (op->type) {
+    case VEC_FUSED_AXPY:     ierr = VecAXPY(v[0],op->alpha,v[1]);CHKERRQ(ierr);break;
+    case VEC_FUSED_AYPX:     ierr = VecAYPX(v[0],op->beta,v[1]);CHKERRQ(ierr);break;
+    case VEC_FUSED_WAXPY:    ierr = VecWAXPY(v[0],op->alpha,v[1],v[2]);CHKERRQ(ierr);break;
+    case VEC_FUSED_AXPBYPCZ: ierr = VecAXPBYPCZ(v[0],op->alpha,op->beta,op->gamma,v[1],v[2]);CHKERRQ(ierr);break;
+    case VEC_FUSED_MAXPY:    ierr = VecMAXPY(v[0],op->nvec-1,op->coef,v+1);CHKERRQ(ierr);break;
+    case VEC_FUSED_DOT:      ierr = VecDot(v[0],v[1],(PetscScalar*)op->result);CHKERRQ(ierr);break;
+    case VEC_FUSED_TDOT:     ierr = VecTDot(v[0],v[1],(PetscScalar*)op->result);CHKERRQ(ierr);break;
+    case VEC_FUSED_NORM_1:   ierr = VecNorm(v[0],NORM_1,(PetscReal*)op->result);CHKERRQ(ierr);break;
+    case VEC_FUSED_NORM_2:   ierr = VecNorm(v[0],NORM_2,(PetscReal*)op->result);CHKERRQ(ierr);break;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecFusedOpsExecute - Performs the vector operations recorded in a sequence and empties it
+
+   Collective on Vec
+
+   Input Parameter:
+.  fops - the sequence
+
+   Level: advanced
+
+   Notes:
+   For VECSEQ and VECMPI vectors the operations are done in one pass over the vectors, and the dot products and
+   norms of a VECMPI vector share one MPI_Allreduce(). For other vector types the operations are done one after
+   the other with VecAXPY(), VecDot(), etc.
+
+   Concepts: vector^fused operations
+
+.seealso: VecFusedOpsCreate(), VecFusedOpsAXPY(), VecFusedOpsDot(), VecFusedOpsNorm()
+@*/
+PetscErrorCode VecFusedOpsExecute(VecFusedOps fops)
+{
+  PetscErrorCode ierr;
+  PetscBool      fused,same;
+  PetscInt       o,k,i,j,start,end,n;
+  VecFusedOp     *op;
+  PetscScalar    **v,*y,sum;
+  PetscReal      rsum;
+  PetscLogDouble flops = 0.0;
+  MPI_Comm       comm;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  PetscValidPointer(fops,1);
+  if (!fops->nops) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompareAny((PetscObject)fops->vecs[0],&fused,VECSEQ,VECMPI,"");CHKERRQ(ierr);
+  for (k=1; k<fops->nvecs && fused; k++) {
+    ierr  = PetscObjectTypeCompare((PetscObject)fops->vecs[k],((PetscObject)fops->vecs[0])->type_name,&same);CHKERRQ(ierr);
+    fused = same;
+  }
+  if (!fused) {
+    ierr = VecFusedOpsExecute_Default(fops);CHKERRQ(ierr);
+    fops->nops = fops->nvecs = fops->nred = 0;
+    PetscFunctionReturn(0);
+  }
+
+  ierr = PetscLogEventBegin(VEC_FusedOps,0,0,0,0);CHKERRQ(ierr);
+  n    = fops->vecs[0]->map->n;
+  for (k=0; k<fops->nvecs; k++) {
+    if (fops->write[k]) {ierr = VecGetArray(fops->vecs[k],&fops->arrays[k]);CHKERRQ(ierr);}
+    else {ierr = VecGetArrayRead(fops->vecs[k],(const PetscScalar**)&fops->arrays[k]);CHKERRQ(ierr);}
+  }
+  for (k=0; k<fops->nred; k++) fops->lred[k] = 0.0;
+
+  for (start=0; start<n; start+=VEC_FUSED_CHUNK) {
+    end = PetscMin(n,start+VEC_FUSED_CHUNK);
+    for (o=0; o<fops->nops; o++) {
+      op = fops->ops + o;
+      v  = fops->arrays + op->first;
+      y  = v[0];
+      switch (op->type) {
+      case VEC_FUSED_AXPY:
+        for (i=start; i<end; i++) y[i] += op->alpha*v[1][i];
+        break;
+      case VEC_FUSED_AYPX:
+        for (i=start; i<end; i++) y[i] = v[1][i] + op->beta*y[i];
+        break;
+      case VEC_FUSED_WAXPY:
+        for (i=start; i<end; i++) y[i] = op->alpha*v[1][i] + v[2][i];
+        break;
+      case VEC_FUSED_AXPBYPCZ:
+        for (i=start; i<end; i++) y[i] = op->alpha*v[1][i] + op->beta*v[2][i] + op->gamma*y[i];
+        break;
+      case VEC_FUSED_MAXPY:
+        for (j=1; j<op->nvec; j++) {
+          const PetscScalar a = op->coef[j-1],*x = v[j];
+          for (i=start; i<end; i++) y[i] += a*x[i];
+        }
+        break;
+      case VEC_FUSED_DOT:
+        sum = 0.0;
+        for (i=start; i<end; i++) sum += v[0][i]*PetscConj(v[1][i]);
+        fops->lred[op->red] += sum;
+        break;
+      case VEC_FUSED_TDOT:
+        sum = 0.0;
+        for (i=start; i<end; i++) sum += v[0][i]*v[1][i];
+        fops->lred[op->red] += sum;
+        break;
+      case VEC_FUSED_NORM_1:
+        rsum = 0.0;
+        for (i=start; i<end; i++) rsum += PetscAbsScalar(v[0][i]);
+        fops->lred[op->red] += rsum;
+        break;
+      case VEC_FUSED_NORM_2:
+        rsum = 0.0;
+        for (i=start; i<end; i++) rsum += PetscRealPart(v[0][i]*PetscConj(v[0][i]));
+        fops->lred[op->red] += rsum;
+        break;
+      }
+    }
+  }
+
+  for (k=0; k<fops->nvecs; k++) {
+    if (fops->write[k]) {ierr = VecRestoreArray(fops->vecs[k],&fops->arrays[k]);CHKERRQ(ierr);}
+    else {ierr = VecRestoreArrayRead(fops->vecs[k],(const PetscScalar**)&fops->arrays[k]);CHKERRQ(ierr);}
+  }
+  for (o=0; o<fops->nops; o++) {
+    switch (fops->ops[o].type) {
+    case VEC_FUSED_AXPBYPCZ: flops += 5.0*n; break;
+    case VEC_FUSED_MAXPY:    flops += 2.0*n*(fops->ops[o].nvec-1); break;
+    case VEC_FUSED_NORM_1:   flops += 1.0*n; break;
+    default:                 flops += 2.0*n; break;
+    }
+  }
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+
+  if (fops->nred) {
+    comm = PetscObjectComm((PetscObject)fops->vecs[0]);
+    ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+    if (size > 1) {
+      ierr = MPIU_Allreduce(fops->lred,fops->gred,fops->nred,MPIU_SCALAR,MPIU_SUM,comm);CHKERRQ(ierr);
+    } else {
+      ierr = PetscMemcpy(fops->gred,fops->lred,fops->nred*sizeof(PetscScalar));CHKERRQ(ierr);
+    }
+    for (o=0; o<fops->nops; o++) {
+      op = fops->ops + o;
+      switch (op->type) {
+      case VEC_FUSED_DOT:
+      case VEC_FUSED_TDOT:   *(PetscScalar*)op->result = fops->gred[op->red];break;
+      case VEC_FUSED_NORM_1: *(PetscReal*)op->result   = PetscRealPart(fops->gred[op->red]);break;
+      case VEC_FUSED_NORM_2: *(PetscReal*)op->result   = PetscSqrtReal(PetscRealPart(fops->gred[op->red]));break;
+      default: break;
+      }
+    }
+  }
+  fops->nops = fops->nvecs = fops->nred = 0;
+  ierr = PetscLogEventEnd(VEC_FusedOps,0,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}